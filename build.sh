@@ -177,7 +177,7 @@ minify() {
 }
 
 createassets() {
-  check_cmd jq
+  check_cmd jq sha256sum
 
   [ -z "${MYMPD_BUILDDIR+x}" ] && MYMPD_BUILDDIR="release"
 
@@ -285,6 +285,21 @@ createassets() {
   cp -v dist/material-icons/MaterialIcons-Regular.woff2 "$MYMPD_BUILDDIR/htdocs/assets/"
   $ZIPCAT dist/material-icons/ligatures.json > "$MYMPD_BUILDDIR/htdocs/assets/ligatures.json.gz"
 
+  echo "Creating brotli and zstd compressed variants"
+  for ASSET in index.html js/combined.js css/combined.css
+  do
+    if check_cmd_silent brotli
+    then
+      gzip -dc "$MYMPD_BUILDDIR/htdocs/${ASSET}.gz" | brotli -q 11 -c > "$MYMPD_BUILDDIR/htdocs/${ASSET}.br"
+    fi
+    if check_cmd_silent zstd
+    then
+      gzip -dc "$MYMPD_BUILDDIR/htdocs/${ASSET}.gz" | zstd -q -19 -c > "$MYMPD_BUILDDIR/htdocs/${ASSET}.zst"
+    fi
+  done
+
+  create_etags
+
   [ -z "${MYMPD_ENABLE_LUA+x}" ] && MYMPD_ENABLE_LUA="ON"
   if [ "${MYMPD_ENABLE_LUA}" = "on" ] || [ "${MYMPD_ENABLE_LUA}" = "ON" ]
   then
@@ -296,6 +311,24 @@ createassets() {
   return 0
 }
 
+#creates the etags for the embedded assets
+create_etags() {
+  echo "Creating etags"
+  DST="$MYMPD_BUILDDIR/htdocs/etags.h"
+  echo "//generated by build.sh createassets" > "${DST}.tmp"
+  find "$MYMPD_BUILDDIR/htdocs" -type f \( -name "*.gz" -o -name "*.br" -o -name "*.zst" \
+    -o -name "*.png" -o -name "*.woff2" \) | sort | while read -r F
+  do
+    NAME=$(basename "$F" | tr '.-' '__')
+    case "$F" in
+      */assets/i18n/*) NAME="i18n_${NAME}" ;;
+    esac
+    HASH=$(sha256sum "$F" | cut -c1-16)
+    printf '#define ETAG_%s "\\"%s\\""\n' "$NAME" "$HASH" >> "${DST}.tmp"
+  done
+  mv "${DST}.tmp" "$DST"
+}
+
 lualibs() {
   [ -z "${MYMPD_ENABLE_MYGPIOD+x}" ] && MYMPD_ENABLE_MYGPIOD="OFF"
   [ -z "${MYMPD_BUILDDIR+x}" ] && MYMPD_BUILDDIR="release"
@@ -832,26 +865,26 @@ installdeps() {
       apt-get install -y --no-install-recommends liblua5.3-dev lua5.3
     fi
     apt-get install -y --no-install-recommends \
-      gcc cmake perl libssl-dev libid3tag0-dev libflac-dev \
+      gcc cmake perl libssl-dev libid3tag0-dev libflac-dev libjpeg-dev libpng-dev \
       build-essential pkg-config libpcre2-dev gzip jq whiptail
   elif [ -f /etc/arch-release ]
   then
     #arch
-    pacman -Sy gcc base-devel cmake perl openssl libid3tag flac lua pkgconf pcre2 gzip jq libnewt
+    pacman -Sy gcc base-devel cmake perl openssl libid3tag flac libjpeg-turbo libpng lua pkgconf pcre2 gzip jq libnewt
   elif [ -f /etc/alpine-release ]
   then
     #alpine
-    apk add cmake perl openssl-dev libid3tag-dev flac-dev lua5.4-dev lua5.4 \
+    apk add cmake perl openssl-dev libid3tag-dev flac-dev libjpeg-turbo-dev libpng-dev lua5.4-dev lua5.4 \
       alpine-sdk linux-headers pkgconf pcre2-dev gzip jq newt
   elif [ -f /etc/SuSE-release ]
   then
     #suse
-    zypper install gcc cmake pkgconfig perl openssl-devel libid3tag-devel flac-devel \
+    zypper install gcc cmake pkgconfig perl openssl-devel libid3tag-devel flac-devel libjpeg-devel libpng-devel \
       lua-devel unzip pcre2-devel gzip jq whiptail
   elif [ -f /etc/redhat-release ]
   then
     #fedora
-    yum install gcc cmake pkgconfig perl openssl-devel libid3tag-devel flac-devel \
+    yum install gcc cmake pkgconfig perl openssl-devel libid3tag-devel flac-devel libjpeg-devel libpng-devel \
       lua-devel unzip pcre2-devel gzip jq whiptail
   else
     echo_warn "Unsupported distribution detected."
@@ -865,6 +898,7 @@ installdeps() {
     echo "  - openssl (devel)"
     echo "  - flac (devel)"
     echo "  - libid3tag (devel)"
+    echo "  - libjpeg and libpng (devel)"
     echo "  - liblua5.4 or liblua5.3 (devel)"
     echo "  - libpcre2 (devel)"
   fi
@@ -19,6 +19,32 @@ function mympd.api(method, params)
   return rc, result["error"]
 end
 
+--- Calls the myMPD jsonrpc api without waiting for the response
+-- @param method
+-- @param params
+-- @return handle for mympd.api_wait
+function mympd.api_async(method, params)
+  return mympd_api_async(mympd_env.partition, method, json.encode(params))
+end
+
+--- Waits for the responses of mympd.api_async calls
+-- @param handles list of handles returned by mympd.api_async
+-- @return list of responses with rc (0 for success, else 1) and result (jsonrpc result for success, else error)
+function mympd.api_wait(handles)
+  local raw_results = { mympd_api_wait(table.unpack(handles)) }
+  local results = {}
+  for i = 1, #handles do
+    local rc = raw_results[i * 2 - 1]
+    local result = json.decode(raw_results[i * 2])
+    if rc == 0 then
+      results[i] = { rc = rc, result = result["result"] }
+    else
+      results[i] = { rc = rc, result = result["error"] }
+    end
+  end
+  return results
+end
+
 --- Returns an Jsonrpc response for a script dialog.
 -- @param title Dialog title
 -- @param data Dialog definition
@@ -1641,6 +1641,11 @@ const APImethods = {
                 "example": true,
                 "desc": "Ignores hated songs."
             },
+            "jukeboxWeighting": {
+                "type": APItypes.string,
+                "example": "off",
+                "desc": "Weighting of the random selection: \"off\", \"stickers\", \"stratified\""
+            },
             "jukeboxFilterInclude": APIparams.expression,
             "jukeboxFilterExclude": APIparams.expression,
             "jukeboxMinSongDuration": {
@@ -2288,6 +2293,20 @@ const APImethods = {
             }
         }
     },
+    "MYMPD_API_WORKER_STATUS": {
+        "desc": "Shows the status of the background worker threads: queue depth, running and pending jobs.",
+        "params": {}
+    },
+    "MYMPD_API_WORKER_CANCEL": {
+        "desc": "Cancels a background job. Pending jobs are removed, running jobs are stopped at the next checkpoint.",
+        "params": {
+            "jobId": {
+                "type": APItypes.uint,
+                "example": 1,
+                "desc": "Job id from MYMPD_API_WORKER_STATUS."
+            }
+        }
+    },
     "MYMPD_API_CLOUD_RADIOBROWSER_CLICK_COUNT": {
         "desc": "Returns radio-browser.info station details.",
         "params": {
@@ -1063,6 +1063,18 @@ const settingsPlaybackFields = {
         "help": "helpJukeboxIgnoreHated",
         "class": ["jukeboxSongOnly"]
     },
+    "jukeboxWeighting": {
+        "inputType": "select",
+        "defaultValue": "off",
+        "validValues": {
+            "off": "Uniform",
+            "stickers": "Playback statistics",
+            "stratified": "Uniq tag values"
+        },
+        "title": "Weighting",
+        "form": "modalPlaybackJukeboxCollapse",
+        "help": "helpJukeboxWeighting"
+    },
     "jukeboxMinSongDuration": {
         "inputType": "text",
         "contentType": "number",
@@ -0,0 +1,14 @@
+const i18n = {
+    "default": {"desc":"Browser default", "missingPhrases": 0},
+    "de-DE": {"desc":"Deutsch (de-DE)", "missingPhrases": 9},
+    "en-US": {"desc":"English (en-US)", "missingPhrases": 0},
+    "es-AR": {"desc":"Español (es-AR)", "missingPhrases": 10},
+    "fr-FR": {"desc":"Français (fr-FR)", "missingPhrases": 10},
+    "it-IT": {"desc":"Italiano (it-IT)", "missingPhrases": 10},
+    "ja-JP": {"desc":"日本語 (ja-JP)", "missingPhrases": 10},
+    "ko-KR": {"desc":"한국어 (ko-KR)", "missingPhrases": 10},
+    "nl-NL": {"desc":"Nederlands (nl-NL)", "missingPhrases": 10},
+    "pl-PL": {"desc":"Polish (pl-PL)", "missingPhrases": 83},
+    "zh-Hans": {"desc":"简体中文 (zh-Hans)", "missingPhrases": 10},
+    "zh-Hant": {"desc":"简体中文 (zh-Hant)", "missingPhrases": 83}
+};
@@ -12,10 +12,27 @@
 #include "src/lib/msg_queue.h"
 #include "src/lib/sds_extras.h"
 
+#ifdef MYMPD_ENABLE_LUA
+    #include "src/scripts/mailbox.h"
+#endif
+
 #include <string.h>
+#include <time.h>
 
 static const char *mympd_cmd_strs[] = { MYMPD_CMDS(GEN_STR) };
 
+/**
+ * Result of the flow control check for the next part of a streamed response
+ */
+enum stream_window_states {
+    STREAM_WINDOW_SEND,     //!< send the part
+    STREAM_WINDOW_FULL,     //!< the client is behind, keep the part
+    STREAM_WINDOW_ABORTED   //!< drop the part
+};
+
+static struct t_stream_window *stream_window_new(void);
+static enum stream_window_states stream_window_reserve(struct t_stream_window *window, size_t len, bool wait);
+
 /**
  * Converts a string to the mympd_cmd_ids enum
  * @param cmd string to convert
@@ -203,6 +220,9 @@ struct t_work_response *create_response_new(enum work_response_types type, unsig
     response->binary = sdsempty();
     response->extra = NULL;
     response->partition = sdsnew(partition);
+    response->chunks = 0;
+    response->window = NULL;
+    response->stream_wait = false;
     return response;
 }
 
@@ -254,6 +274,9 @@ void free_response(struct t_work_response *response) {
         FREE_SDS(response->data);
         FREE_SDS(response->binary);
         FREE_SDS(response->partition);
+        if (response->window != NULL) {
+            stream_window_unref(response->window);
+        }
         FREE_PTR(response);
     }
 }
@@ -272,13 +295,16 @@ bool push_response(struct t_work_response *response) {
         case RESPONSE_TYPE_SCRIPT_DIALOG:
             MYMPD_LOG_DEBUG(NULL, "Push response to webserver queue for connection %lu: %s", response->conn_id, response->data);
             return mympd_queue_push(web_server_queue, response, 0);
+        case RESPONSE_TYPE_CHUNK:
+            MYMPD_LOG_DEBUG(NULL, "Push response chunk to webserver queue for connection %lu with %lu bytes", response->conn_id, (unsigned long)sdslen(response->data));
+            return mympd_queue_push(web_server_queue, response, 0);
         case RESPONSE_TYPE_RAW:
             MYMPD_LOG_DEBUG(NULL, "Push raw response to webserver queue for connection %lu with %lu bytes", response->conn_id, (unsigned long)sdslen(response->data));
             return mympd_queue_push(web_server_queue, response, 0);
         case RESPONSE_TYPE_SCRIPT:
             #ifdef MYMPD_ENABLE_LUA
-                MYMPD_LOG_DEBUG(NULL, "Push response to script_worker_queue for thread %u: %s", response->id, response->data);
-                return mympd_queue_push(script_worker_queue, response, response->id);
+                MYMPD_LOG_DEBUG(NULL, "Deliver response to script mailbox for request %u: %s", response->id, response->data);
+                return script_mailbox_deliver(response);
             #endif
         case RESPONSE_TYPE_DISCARD:
             // discard response
@@ -291,6 +317,135 @@ bool push_response(struct t_work_response *response) {
     return false;
 }
 
+/**
+ * Sends the already printed part of a long list response to the webserver,
+ * if it has reached JSONRPC_CHUNK_SIZE. This bounds the memory of
+ * the response, the webserver sends the parts with chunked transfer encoding.
+ * Only responses for http connections are streamed.
+ * No part is sent while the client has more than JSONRPC_STREAM_WINDOW bytes
+ * not received. Worker threads wait for the client and abort the response if
+ * it receives nothing for JSONRPC_STREAM_STALL_TIMEOUT. The mympd_api thread
+ * never waits, it keeps the part in the buffer and sends it later.
+ * The remaining parts are dropped if the connection is closed.
+ * @param stream the response to stream or NULL
+ * @param buffer the already printed part of the response
+ * @return pointer to buffer or a new empty buffer if the part was sent
+ */
+sds response_stream_flush(struct t_work_response *stream, sds buffer) {
+    if (stream == NULL ||
+        stream->type != RESPONSE_TYPE_DEFAULT ||
+        sdslen(buffer) < JSONRPC_CHUNK_SIZE)
+    {
+        return buffer;
+    }
+    if (stream->window == NULL) {
+        stream->window = stream_window_new();
+    }
+    switch(stream_window_reserve(stream->window, sdslen(buffer), stream->stream_wait)) {
+        case STREAM_WINDOW_SEND:
+            break;
+        case STREAM_WINDOW_FULL:
+            return buffer;
+        case STREAM_WINDOW_ABORTED:
+            sdsclear(buffer);
+            return buffer;
+    }
+    struct t_work_response *chunk = create_response_new(RESPONSE_TYPE_CHUNK, stream->conn_id, stream->id, stream->cmd_id, stream->partition);
+    FREE_SDS(chunk->data);
+    chunk->data = buffer;
+    chunk->window = stream_window_ref(stream->window);
+    push_response(chunk);
+    stream->chunks++;
+    return sdsempty();
+}
+
+/**
+ * Handles an error after the first part of a streamed response was already sent.
+ * The error message can not be appended to the already sent json,
+ * the buffer is cleared and the webserver closes the connection.
+ * @param stream the response to stream or NULL
+ * @param buffer the error response
+ * @return pointer to buffer
+ */
+sds response_stream_abort(struct t_work_response *stream, sds buffer) {
+    if (stream != NULL &&
+        stream->chunks > 0)
+    {
+        MYMPD_LOG_ERROR(stream->partition, "Aborting streamed response for connection %lu: %s", stream->conn_id, buffer);
+        sdsclear(buffer);
+    }
+    return buffer;
+}
+
+/**
+ * Adds a reference to the flow control of a streamed response
+ * @param window the flow control
+ * @return pointer to window
+ */
+struct t_stream_window *stream_window_ref(struct t_stream_window *window) {
+    pthread_mutex_lock(&window->mutex);
+    window->refs++;
+    pthread_mutex_unlock(&window->mutex);
+    return window;
+}
+
+/**
+ * Removes a reference to the flow control of a streamed response
+ * and frees it after the last reference is removed
+ * @param window the flow control
+ */
+void stream_window_unref(struct t_stream_window *window) {
+    pthread_mutex_lock(&window->mutex);
+    window->refs--;
+    unsigned refs = window->refs;
+    pthread_mutex_unlock(&window->mutex);
+    if (refs == 0) {
+        pthread_mutex_destroy(&window->mutex);
+        pthread_cond_destroy(&window->wakeup);
+        FREE_PTR(window);
+    }
+}
+
+/**
+ * Updates the flow control of a streamed response after data was sent.
+ * Called from the webserver thread.
+ * @param window the flow control
+ * @param appended bytes of the part appended to the send buffer
+ * @param buffered bytes in the send buffer of the connection
+ */
+void stream_window_sent(struct t_stream_window *window, size_t appended, size_t buffered) {
+    pthread_mutex_lock(&window->mutex);
+    window->queued = appended < window->queued
+        ? window->queued - appended
+        : 0;
+    window->buffered = buffered;
+    pthread_cond_signal(&window->wakeup);
+    pthread_mutex_unlock(&window->mutex);
+}
+
+/**
+ * Drops the remaining parts of a streamed response
+ * @param window the flow control
+ */
+void stream_window_abort(struct t_stream_window *window) {
+    pthread_mutex_lock(&window->mutex);
+    window->aborted = true;
+    pthread_cond_signal(&window->wakeup);
+    pthread_mutex_unlock(&window->mutex);
+}
+
+/**
+ * Checks if the remaining parts of a streamed response are dropped
+ * @param window the flow control
+ * @return true if aborted, else false
+ */
+bool stream_window_is_aborted(struct t_stream_window *window) {
+    pthread_mutex_lock(&window->mutex);
+    bool aborted = window->aborted;
+    pthread_mutex_unlock(&window->mutex);
+    return aborted;
+}
+
 /**
  * Pushes the request to a queue
  * @param request pointer to request struct to push
@@ -320,3 +475,69 @@ bool push_request(struct t_work_request *request, unsigned id) {
             return mympd_queue_push(mympd_api_queue, request, id);
     }
 }
+
+// private functions
+
+/**
+ * Creates the flow control of a streamed response,
+ * the reference belongs to the response
+ * @return the new flow control
+ */
+static struct t_stream_window *stream_window_new(void) {
+    struct t_stream_window *window = malloc_assert(sizeof(struct t_stream_window));
+    pthread_mutex_init(&window->mutex, NULL);
+    pthread_cond_init(&window->wakeup, NULL);
+    window->queued = 0;
+    window->buffered = 0;
+    window->aborted = false;
+    window->stall_timeout = JSONRPC_STREAM_STALL_TIMEOUT;
+    window->refs = 1;
+    return window;
+}
+
+/**
+ * Checks if the client has received enough data to send the next part.
+ * @param window the flow control
+ * @param len length of the next part
+ * @param wait true to wait for the client, the response is aborted if the client
+ *             receives nothing for stall_timeout seconds
+ * @return STREAM_WINDOW_SEND if the part can be sent
+ */
+static enum stream_window_states stream_window_reserve(struct t_stream_window *window, size_t len, bool wait) {
+    pthread_mutex_lock(&window->mutex);
+    size_t pending = window->queued + window->buffered;
+    time_t deadline = time(NULL) + window->stall_timeout;
+    while (wait == true &&
+        pending > JSONRPC_STREAM_WINDOW &&
+        window->aborted == false)
+    {
+        if (s_signal_received != 0 ||
+            time(NULL) >= deadline)
+        {
+            MYMPD_LOG_WARN(NULL, "Client does not receive the streamed response, aborting");
+            window->aborted = true;
+            break;
+        }
+        struct timespec max_wait;
+        clock_gettime(CLOCK_REALTIME, &max_wait);
+        max_wait.tv_sec += 1;
+        pthread_cond_timedwait(&window->wakeup, &window->mutex, &max_wait);
+        if (window->queued + window->buffered < pending) {
+            //the client is receiving
+            deadline = time(NULL) + window->stall_timeout;
+        }
+        pending = window->queued + window->buffered;
+    }
+    enum stream_window_states state = STREAM_WINDOW_SEND;
+    if (window->aborted == true) {
+        state = STREAM_WINDOW_ABORTED;
+    }
+    else if (pending > JSONRPC_STREAM_WINDOW) {
+        state = STREAM_WINDOW_FULL;
+    }
+    else {
+        window->queued += len;
+    }
+    pthread_mutex_unlock(&window->mutex);
+    return state;
+}
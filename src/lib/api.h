@@ -10,7 +10,9 @@
 #include "dist/sds/sds.h"
 #include "src/lib/list.h"
 
+#include <pthread.h>
 #include <stdbool.h>
+#include <time.h>
 
 /**
  * myMPD api methods
@@ -33,6 +35,7 @@
     X(INTERNAL_API_SCRIPT_EXECUTE) \
     X(INTERNAL_API_SCRIPT_INIT) \
     X(INTERNAL_API_SCRIPT_POST_EXECUTE) \
+    X(INTERNAL_API_SONG_INDEX_CREATED) \
     X(INTERNAL_API_STATE_SAVE) \
     X(INTERNAL_API_STICKER_FEATURES) \
     X(INTERNAL_API_TAGART) \
@@ -215,6 +218,8 @@
     X(MYMPD_API_WEBRADIO_FAVORITE_LIST) \
     X(MYMPD_API_WEBRADIO_FAVORITE_RM) \
     X(MYMPD_API_WEBRADIO_FAVORITE_SAVE) \
+    X(MYMPD_API_WORKER_CANCEL) \
+    X(MYMPD_API_WORKER_STATUS) \
     X(TOTAL_API_COUNT)
 
 /**
@@ -241,7 +246,8 @@ enum work_response_types {
     RESPONSE_TYPE_SCRIPT,            //!< Respond is for the script thread
     RESPONSE_TYPE_DISCARD,           //!< Response will be discarded
     RESPONSE_TYPE_RAW,               //!< Raw http message
-    RESPONSE_TYPE_SCRIPT_DIALOG      //!< Script dialog
+    RESPONSE_TYPE_SCRIPT_DIALOG,     //!< Script dialog
+    RESPONSE_TYPE_CHUNK              //!< Part of a streamed api response, the last part is sent as RESPONSE_TYPE_DEFAULT
 };
 
 /**
@@ -267,6 +273,19 @@ struct t_work_request {
     sds partition;                 //!< mpd partition
 };
 
+/**
+ * Flow control of a streamed response, shared by the producing thread and the webserver
+ */
+struct t_stream_window {
+    pthread_mutex_t mutex;   //!< mutex for the members
+    pthread_cond_t wakeup;   //!< signals sent data and aborts
+    size_t queued;           //!< bytes of parts in the webserver queue
+    size_t buffered;         //!< bytes in the send buffer of the connection
+    bool aborted;            //!< the remaining parts are dropped
+    time_t stall_timeout;    //!< seconds without progress until a waiting producer aborts
+    unsigned refs;           //!< number of references
+};
+
 /**
  * Struct for work responses in the queue
  */
@@ -279,6 +298,9 @@ struct t_work_response {
     sds binary;                     //!< binary data for the response
     void *extra;                    //!< extra data for the response
     sds partition;                  //!< mpd partition
+    unsigned chunks;                //!< number of already sent parts of a streamed response
+    struct t_stream_window *window; //!< flow control of a streamed response or NULL
+    bool stream_wait;               //!< the producer may wait for the client, never set in the mympd_api thread
 };
 
 /**
@@ -314,6 +336,13 @@ struct t_work_request *create_request(enum work_request_types type, unsigned lon
 void free_request(struct t_work_request *request);
 void free_response(struct t_work_response *response);
 bool push_response(struct t_work_response *response);
+sds response_stream_flush(struct t_work_response *stream, sds buffer);
+sds response_stream_abort(struct t_work_response *stream, sds buffer);
+struct t_stream_window *stream_window_ref(struct t_stream_window *window);
+void stream_window_unref(struct t_stream_window *window);
+void stream_window_sent(struct t_stream_window *window, size_t appended, size_t buffered);
+void stream_window_abort(struct t_stream_window *window);
+bool stream_window_is_aborted(struct t_stream_window *window);
 bool push_request(struct t_work_request *request, unsigned id);
 
 #endif
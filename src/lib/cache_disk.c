@@ -14,6 +14,7 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <stdatomic.h>
 #include <sys/stat.h>
 #include <time.h>
 
@@ -21,8 +22,22 @@
 
 static int crop_dir(sds cache_basedir, const char *type, int keepdays);
 
+/**
+ * Incremented after each crop, readers of the disk caches
+ * compare it to invalidate their in-memory copies
+ */
+static atomic_uint cache_disk_generation;
+
 // public functions
 
+/**
+ * Returns the generation of the disk caches
+ * @return generation
+ */
+unsigned cache_disk_get_generation(void) {
+    return atomic_load(&cache_disk_generation);
+}
+
 /**
  * Clears the caches unconditionally
  * @param config pointer to static config
@@ -32,6 +47,7 @@ void cache_disk_clear(struct t_config *config) {
     crop_dir(config->cachedir, DIR_CACHE_LYRICS, 0);
     crop_dir(config->cachedir, DIR_CACHE_THUMBS, 0);
     crop_dir(config->cachedir, DIR_CACHE_MISC, 0);
+    atomic_fetch_add(&cache_disk_generation, 1);
 }
 
 /**
@@ -49,6 +65,7 @@ void cache_disk_crop(struct t_config *config) {
         crop_dir(config->cachedir, DIR_CACHE_THUMBS, config->cache_thumbs_keep_days);
     }
     crop_dir(config->cachedir, DIR_CACHE_MISC, config->cache_misc_keep_days);
+    atomic_fetch_add(&cache_disk_generation, 1);
 }
 
 /**
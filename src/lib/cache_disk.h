@@ -18,5 +18,6 @@ enum cache_disk_conf {
 
 void cache_disk_clear(struct t_config *config);
 void cache_disk_crop(struct t_config *config);
+unsigned cache_disk_get_generation(void);
 
 #endif
@@ -22,11 +22,15 @@
  * @param type image type
  * @param uri uri of the song for the cover
  * @param offset number of the coverimage
+ * @param thumbnail true for the downscaled version of the image
  * @return path / basename as newly allocated sds string
  */
-sds cache_disk_images_get_basename(const char *cachedir, const char *type, const char *uri, int offset) {
+sds cache_disk_images_get_basename(const char *cachedir, const char *type, const char *uri, int offset, bool thumbnail) {
     sds filename = sds_hash_sha1(uri);
     sds filepath = sdscatfmt(sdsempty(), "%s/%s/%S-%i", cachedir, type, filename, offset);
+    if (thumbnail == true) {
+        filepath = sdscat(filepath, "-thumb");
+    }
     FREE_SDS(filename);
     return filepath;
 }
@@ -40,9 +44,10 @@ sds cache_disk_images_get_basename(const char *cachedir, const char *type, const
  * @param mime_type mime_type of binary buffer
  * @param binary binary data to save
  * @param offset number of the coverimage
+ * @param thumbnail true for the downscaled version of the image
  * @return written filename (full path) as newly allocated sds string
  */
-sds cache_disk_images_write_file(sds cachedir, const char *type, const char *uri, const char *mime_type, sds binary, int offset) {
+sds cache_disk_images_write_file(sds cachedir, const char *type, const char *uri, const char *mime_type, sds binary, int offset, bool thumbnail) {
     if (mime_type[0] == '\0') {
         MYMPD_LOG_WARN(NULL, "Covercache file for \"%s\" not written, mime_type is empty", uri);
         return false;
@@ -53,7 +58,7 @@ sds cache_disk_images_write_file(sds cachedir, const char *type, const char *uri
         return false;
     }
     MYMPD_LOG_DEBUG(NULL, "Writing image cache for \"%s\"", uri);
-    sds filepath = cache_disk_images_get_basename(cachedir, type, uri, offset);
+    sds filepath = cache_disk_images_get_basename(cachedir, type, uri, offset, thumbnail);
     filepath = sdscatfmt(filepath, ".%s", ext);
     MYMPD_LOG_DEBUG(NULL, "Writing image cache file \"%s\"", filepath);
     bool rc = write_data_to_file(filepath, binary, sdslen(binary));
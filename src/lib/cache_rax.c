@@ -16,6 +16,7 @@
 bool cache_init(struct t_cache *cache) {
     cache->building = false;
     cache->cache = NULL;
+    cache->folded = false;
     int rc = pthread_rwlock_init(&cache->rwlock, NULL);
     if (rc == 0) {
         return true;
@@ -31,6 +32,7 @@ bool cache_init(struct t_cache *cache) {
  */
 bool cache_free(struct t_cache *cache) {
     cache->cache = NULL;
+    cache->folded = false;
     int rc = pthread_rwlock_destroy(&cache->rwlock);
     if (rc == 0) {
         return true;
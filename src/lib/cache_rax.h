@@ -16,9 +16,10 @@
  * Holds cache information
  */
 struct t_cache {
-    bool building;             //!< true if the mpd_worker thread is creating the cache
-    rax *cache;                //!< pointer to the cache
-    pthread_rwlock_t rwlock;   //!< pthreads read-write lock object
+    bool building;                         //!< true if the mpd_worker thread is creating the cache
+    rax *cache;                            //!< pointer to the cache
+    bool folded;                           //!< true if the tag values carry a case folded twin
+    pthread_rwlock_t rwlock;               //!< pthreads read-write lock object
 };
 
 bool cache_init(struct t_cache *cache);
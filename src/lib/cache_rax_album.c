@@ -17,6 +17,7 @@
 #include "src/lib/log.h"
 #include "src/lib/mem.h"
 #include "src/lib/mpack.h"
+#include "src/lib/rax_extras.h"
 #include "src/lib/sds_extras.h"
 #include "src/lib/utility.h"
 #include "src/mpd_client/tags.h"
@@ -25,6 +26,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
 
 /**
  * myMPD saves album information in the album cache as a mpd_song struct.
@@ -38,10 +40,72 @@
  *   prio: number of songs
  */
 
+/**
+ * The binary album cache format is read in one piece and needs no tokenizing,
+ * all fields have a fixed width and all offsets are 8 byte aligned.
+ * The reader creates the mpd_song structs of the albums from the records.
+ * Layout:
+ *   header
+ *   string pool offsets of the tag names (uint32 * tag_count)
+ *   padding to 8 bytes
+ *   album records (record_size * album_count)
+ *   tag value index: string pool offsets of the tag values (uint32 * value_count)
+ *   string pool: deduplicated, zero terminated strings
+ */
+
 /**
  * Private definitions
  */
 
+#define ALBUM_CACHE_BIN_MAGIC "myMPDac"
+#define ALBUM_CACHE_BIN_VERSION 2
+#define ALBUM_CACHE_BIN_BYTE_ORDER 0x01020304
+
+/**
+ * Header of the binary album cache format
+ */
+struct t_album_cache_bin_header {
+    char magic[8];            //!< ALBUM_CACHE_BIN_MAGIC
+    uint32_t version;         //!< ALBUM_CACHE_BIN_VERSION
+    uint32_t byte_order;      //!< ALBUM_CACHE_BIN_BYTE_ORDER, detects files written on other platforms
+    int32_t album_mode;       //!< album mode
+    int32_t group_tag;        //!< album group tag
+    uint32_t tag_count;       //!< number of tags per album
+    uint32_t album_count;     //!< number of album records
+    uint32_t record_size;     //!< size of one album record including the tags
+    uint32_t value_count;     //!< number of entries in the tag value index
+    uint64_t records_offset;  //!< offset of the first album record
+    uint64_t values_offset;   //!< offset of the tag value index
+    uint64_t pool_offset;     //!< offset of the string pool
+    uint64_t pool_size;       //!< size of the string pool
+};
+
+/**
+ * Fixed width album record, followed by tag_count t_album_cache_bin_tag structs
+ */
+struct t_album_cache_bin_record {
+    uint32_t key;             //!< string pool offset of the album key
+    uint32_t uri;             //!< string pool offset of the uri
+    uint32_t discs;           //!< number of discs
+    uint32_t songs;           //!< number of songs
+    uint32_t duration;        //!< total time in seconds
+    uint32_t duration_ms;     //!< total time in milliseconds
+    int64_t last_modified;    //!< last_modified from newest song
+    int64_t added;            //!< added from oldest song
+};
+
+/**
+ * Tag values of an album record
+ */
+struct t_album_cache_bin_tag {
+    uint32_t first;           //!< first entry in the tag value index
+    uint32_t count;           //!< number of values
+};
+
+static int album_cache_index_slot(enum sort_by_type sort_by, enum mpd_tag_type sort_tag);
+static bool album_cache_read_bin(struct t_cache *album_cache, const char *filepath, const struct t_albums_config *album_config);
+static bool album_cache_read_mpack(struct t_cache *album_cache, const char *filepath, const struct t_albums_config *album_config);
+static uint32_t album_cache_bin_add_string(sds *pool, rax *pool_index, const char *str);
 static struct mpd_song *album_from_mpack_node(mpack_node_t album_node, const struct t_tags *tags, sds *key);
 
 /**
@@ -78,21 +142,25 @@ const char *lookup_album_mode(enum album_modes mode) {
 }
 
 /**
- * Removes the album cache file
+ * Removes the album cache files
  * @param workdir myMPD working directory
  * @return bool true on success, else false
  */
 bool album_cache_remove(sds workdir) {
     sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE);
     int rc = try_rm_file(filepath);
+    sdsclear(filepath);
+    filepath = sdscatfmt(filepath, "%S/%s/%s", workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE_MPACK);
+    int rc_mpack = try_rm_file(filepath);
     FREE_SDS(filepath);
-    return rc == RM_FILE_ERROR
+    return rc == RM_FILE_ERROR || rc_mpack == RM_FILE_ERROR
         ? false
         : true;
 }
 
 /**
- * Reads the album cache from disc
+ * Reads the album cache from disc.
+ * Falls back to the mpack format of older myMPD versions.
  * @param album_cache pointer to t_cache struct
  * @param workdir myMPD working directory
  * @param album_config album configuration
@@ -103,90 +171,32 @@ bool album_cache_read(struct t_cache *album_cache, sds workdir, const struct t_a
         MEASURE_INIT
         MEASURE_START
     #endif
+    bool rc;
     sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE);
-    if (testfile_read(filepath) == false) {
-        FREE_SDS(filepath);
-        return false;
-    }
-    
-    mpack_tree_t tree;
-    mpack_tree_init_filename(&tree, filepath, 0);
-    mpack_tree_set_error_handler(&tree, log_mpack_node_error);
-    FREE_SDS(filepath);
-    mpack_tree_parse(&tree);
-    mpack_node_t root = mpack_tree_root(&tree);
-
-    // check for expected album_mode
-    enum album_modes album_mode = (enum album_modes)mpack_node_int(mpack_node_map_cstr(root, "albumMode"));
-    if (album_mode != album_config->mode) {
-        mpack_tree_destroy(&tree);
-        MYMPD_LOG_WARN(NULL, "Unexpected album mode, discarding cache");
-        album_cache_remove(workdir);
-        return NULL;
-    }
-
-    // check for expected album_group_tag
-    enum mpd_tag_type group_tag = (enum mpd_tag_type)mpack_node_int(mpack_node_map_cstr(root, "albumGroupTag"));
-    if (group_tag != album_config->group_tag) {
-        mpack_tree_destroy(&tree);
-        MYMPD_LOG_WARN(NULL, "Unexpected album group tag, discarding cache");
-        album_cache_remove(workdir);
-        return NULL;
-    }
-
-    // read tags array
-    struct t_tags *album_tags = malloc_assert(sizeof(struct t_tags));
-    tags_reset(album_tags);
-
-    mpack_node_t tags_node = mpack_node_map_cstr(root, "tags");
-    size_t len = mpack_node_array_length(tags_node);
-    for (size_t i = 0; i < len; i++) {
-        mpack_node_t value_node = mpack_node_array_at(tags_node, i);
-        char *value = mpack_node_cstr_alloc(value_node, JSONRPC_STR_MAX);
-        if (value == NULL) {
-            break;
-        }
-        enum mpd_tag_type tag = mpd_tag_name_parse(value);
-        if (tag != MPD_TAG_UNKNOWN) {
-            album_tags->tags[album_tags->len++] = tag;
-        }
-        else {
-            MYMPD_LOG_ERROR(NULL, "Unkown MPD tag type: \"%s\"", value);
-        }
-        MPACK_FREE(value);
-    }
-
-    // read albums array
-    mpack_node_t albums_node = mpack_node_map_cstr(root, "albums");
-    len = mpack_node_array_length(albums_node);
-    sds key = sdsempty();
     album_cache->building = true;
-    album_cache->cache = raxNew();
-
-    for (size_t i = 0; i < len; i++) {
-        mpack_node_t album_node = mpack_node_array_at(albums_node, i);
-        struct mpd_song *album = album_from_mpack_node(album_node, album_tags, &key);
-        if (album != NULL) {
-            if (raxTryInsert(album_cache->cache, (unsigned char *)key, sdslen(key), album, NULL) == 0) {
-                MYMPD_LOG_ERROR(NULL, "Duplicate key in album cache file found: %s", key);
-                mpd_song_free(album);
-            }
+    if (testfile_read(filepath) == true) {
+        rc = album_cache_read_bin(album_cache, filepath, album_config);
+    }
+    else {
+        sdsclear(filepath);
+        filepath = sdscatfmt(filepath, "%S/%s/%s", workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE_MPACK);
+        if (testfile_read(filepath) == false) {
+            FREE_SDS(filepath);
+            album_cache->building = false;
+            return false;
         }
+        rc = album_cache_read_mpack(album_cache, filepath, album_config);
     }
-    FREE_SDS(key);
-    // clean up and check for errors
-    bool rc = mpack_tree_destroy(&tree) != mpack_ok
-        ? false
-        : true;
+    FREE_SDS(filepath);
     if (rc == false) {
-        MYMPD_LOG_ERROR("default", "Reading album cache failed, discarding cache");
+        MYMPD_LOG_WARN(NULL, "Reading album cache failed, discarding cache");
         album_cache_remove(workdir);
         album_cache_free(album_cache);
     }
     else {
         MYMPD_LOG_INFO(NULL, "Read %" PRIu64 " album(s) from disc", album_cache->cache->numele);
+        album_cache_fold_tags(album_cache);
     }
-    FREE_PTR(album_tags);
     album_cache->building = false;
     #ifdef MYMPD_DEBUG
         MEASURE_END
@@ -196,7 +206,7 @@ bool album_cache_read(struct t_cache *album_cache, sds workdir, const struct t_a
 }
 
 /**
- * Saves the album cache to disc in mpack format
+ * Saves the album cache to disc in the binary album cache format
  * @param album_cache pointer to t_cache struct
  * @param workdir myMPD working directory
  * @param album_tags album tags to write
@@ -210,95 +220,112 @@ bool album_cache_write(struct t_cache *album_cache, sds workdir, const struct t_
         return true;
     }
     MYMPD_LOG_INFO(NULL, "Saving album cache to disc");
-    mpack_writer_t writer;
     sds tmp_file = sdscatfmt(sdsempty(), "%S/%s/%s.XXXXXX", workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE);
     FILE *fp = open_tmp_file(tmp_file);
     if (fp == NULL) {
         FREE_SDS(tmp_file);
         return false;
     }
-    // init mpack
-    mpack_writer_init_stdfile(&writer, fp, true);
-    mpack_writer_set_error_handler(&writer, log_mpack_write_error);
-    mpack_build_map(&writer);
-    mpack_write_kv(&writer, "albumMode", album_config->mode);
-    mpack_write_kv(&writer, "albumGroupTag", album_config->group_tag);
-    mpack_write_cstr(&writer, "tags");
-    mpack_start_array(&writer, (uint32_t)album_tags->len);
+    struct t_album_cache_bin_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ALBUM_CACHE_BIN_MAGIC, sizeof(header.magic));
+    header.version = ALBUM_CACHE_BIN_VERSION;
+    header.byte_order = ALBUM_CACHE_BIN_BYTE_ORDER;
+    header.album_mode = (int32_t)album_config->mode;
+    header.group_tag = (int32_t)album_config->group_tag;
+    header.tag_count = (uint32_t)album_tags->len;
+    header.album_count = (uint32_t)album_cache->cache->numele;
+    header.record_size = (uint32_t)(sizeof(struct t_album_cache_bin_record) +
+        album_tags->len * sizeof(struct t_album_cache_bin_tag));
+
+    // strings are deduplicated in the string pool
+    sds pool = sdsempty();
+    rax *pool_index = raxNew();
+    // tag value index: string pool offsets of all tag values
+    sds values = sdsempty();
+
+    // placeholder for the header, it is rewritten after all offsets are known
+    bool rc = fwrite(&header, sizeof(header), 1, fp) == 1;
+    // tag names
     for (unsigned tagnr = 0; tagnr < album_tags->len; ++tagnr) {
-        mpack_write_cstr(&writer, mpd_tag_name(album_tags->tags[tagnr]));
+        uint32_t name = album_cache_bin_add_string(&pool, pool_index, mpd_tag_name(album_tags->tags[tagnr]));
+        rc = rc && fwrite(&name, sizeof(name), 1, fp) == 1;
     }
-    mpack_finish_array(&writer);
-    mpack_write_cstr(&writer, "albums");
-    mpack_start_array(&writer, (uint32_t)album_cache->cache->numele);
+    // records are 8 byte aligned
+    size_t offset = sizeof(header) + album_tags->len * sizeof(uint32_t);
+    size_t padding = (8 - (offset % 8)) % 8;
+    const char zero[8] = { 0 };
+    rc = rc && fwrite(zero, 1, padding, fp) == padding;
+    header.records_offset = offset + padding;
+
+    // records
+    unsigned char *record_buf = malloc_assert(header.record_size);
     raxIterator iter;
     raxStart(&iter, album_cache->cache);
     raxSeek(&iter, "^", NULL, 0);
     while (raxNext(&iter)) {
         const struct mpd_song *album = (struct mpd_song *)iter.data;
-        mpack_build_map(&writer);
-        mpack_write_kv(&writer, "uri", mpd_song_get_uri(album));
-        mpack_write_kv(&writer, "Discs", album_get_discs(album));
-        mpack_write_kv(&writer, "Songs", album_get_song_count(album));
-        mpack_write_kv(&writer, "Duration", mpd_song_get_duration(album));
-        mpack_write_kv(&writer, "Last-Modified", (uint64_t)mpd_song_get_last_modified(album));
-        mpack_write_kv(&writer, "Added", (uint64_t)mpd_song_get_added(album));
-        mpack_write_cstr(&writer, "AlbumId");
-        mpack_write_str(&writer, (char *)iter.key, (uint32_t)iter.key_len);
+        struct t_album_cache_bin_record *record = (struct t_album_cache_bin_record *)record_buf;
+        memset(record_buf, 0, header.record_size);
+        sds key = sdsnewlen(iter.key, iter.key_len);
+        record->key = album_cache_bin_add_string(&pool, pool_index, key);
+        FREE_SDS(key);
+        record->uri = album_cache_bin_add_string(&pool, pool_index, mpd_song_get_uri(album));
+        record->discs = album_get_discs(album);
+        record->songs = album_get_song_count(album);
+        record->duration = mpd_song_get_duration(album);
+        record->duration_ms = mpd_song_get_duration_ms(album);
+        record->last_modified = (int64_t)mpd_song_get_last_modified(album);
+        record->added = (int64_t)mpd_song_get_added(album);
+        struct t_album_cache_bin_tag *tags = (struct t_album_cache_bin_tag *)(record_buf + sizeof(struct t_album_cache_bin_record));
         for (unsigned tagnr = 0; tagnr < album_tags->len; ++tagnr) {
-            enum mpd_tag_type tag = album_tags->tags[tagnr];
-            if (mpd_song_get_tag(album, tag, 0) == NULL) {
-                // do not write empty tags
-                continue;
-            }
-            if (is_multivalue_tag(tag) == true) {
-                const char *value;
-                unsigned count = 0;
-                mpack_write_cstr(&writer, mpd_tag_name(tag));
-                mpack_build_array(&writer);
-                while ((value = mpd_song_get_tag(album, tag, count)) != NULL) {
-                    mpack_write_cstr(&writer, value);
-                    count++;
-                }
-                mpack_complete_array(&writer);
-            }
-            else {
-                mpack_write_kv(&writer, mpd_tag_name(tag), mpd_song_get_tag(album, tag, 0));
+            const char *value;
+            tags[tagnr].first = (uint32_t)(sdslen(values) / sizeof(uint32_t));
+            while ((value = mpd_song_get_tag(album, album_tags->tags[tagnr], tags[tagnr].count)) != NULL) {
+                uint32_t value_offset = album_cache_bin_add_string(&pool, pool_index, value);
+                values = sdscatlen(values, &value_offset, sizeof(value_offset));
+                tags[tagnr].count++;
             }
         }
-        mpack_complete_map(&writer);
+        rc = rc && fwrite(record_buf, header.record_size, 1, fp) == 1;
         if (free_data == true) {
             mpd_song_free((struct mpd_song *)iter.data);
         }
     }
     raxStop(&iter);
-    mpack_finish_array(&writer);
-    mpack_complete_map(&writer);
+    FREE_PTR(record_buf);
     if (free_data == true) {
         raxFree(album_cache->cache);
         album_cache->cache = NULL;
+        album_cache->folded = false;
     }
-    // finish writing
-    bool rc = mpack_writer_destroy(&writer) != mpack_ok
-        ? false
-        : true;
+
+    // tag value index and string pool
+    header.values_offset = header.records_offset + (uint64_t)header.record_size * header.album_count;
+    header.value_count = (uint32_t)(sdslen(values) / sizeof(uint32_t));
+    header.pool_offset = header.values_offset + sdslen(values);
+    header.pool_size = sdslen(pool);
+    rc = rc &&
+        fwrite(values, 1, sdslen(values), fp) == sdslen(values) &&
+        fwrite(pool, 1, sdslen(pool), fp) == sdslen(pool);
+    // rewrite the header
+    rc = rc &&
+        fseek(fp, 0, SEEK_SET) == 0 &&
+        fwrite(&header, sizeof(header), 1, fp) == 1;
+    FREE_SDS(values);
+    FREE_SDS(pool);
+    raxFree(pool_index);
     if (rc == false) {
-        rm_file(tmp_file);
-        MYMPD_LOG_ERROR("default", "An error occurred encoding the data");
-        FREE_SDS(tmp_file);
-        return false;
+        MYMPD_LOG_ERROR("default", "An error occurred writing the album cache");
     }
-    // rename tmp file
-    sds filepath = sdscatlen(sdsempty(), tmp_file, sdslen(tmp_file) - 7);
-    errno = 0;
-    if (rename(tmp_file, filepath) == -1) {
-        MYMPD_LOG_ERROR(NULL, "Rename file from \"%s\" to \"%s\" failed", tmp_file, filepath);
-        MYMPD_LOG_ERRNO(NULL, errno);
-        rm_file(tmp_file);
-        rc = false;
-    }
-    FREE_SDS(filepath);
+    rc = rename_tmp_file(fp, tmp_file, rc);
     FREE_SDS(tmp_file);
+    if (rc == true) {
+        // remove the album cache of older myMPD versions
+        sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE_MPACK);
+        try_rm_file(filepath);
+        FREE_SDS(filepath);
+    }
     return rc;
 }
 
@@ -385,6 +412,7 @@ void album_cache_free(struct t_cache *album_cache) {
     }
     album_cache_free_rt(album_cache->cache);
     album_cache->cache = NULL;
+    album_cache->folded = false;
 }
 
 /**
@@ -403,6 +431,166 @@ void album_cache_free_rt(rax *album_cache_rt) {
     raxFree(album_cache_rt);
 }
 
+/**
+ * Appends a case folded twin to all tag values of the albums and
+ * marks the album cache as folded.
+ * @param album_cache pointer to t_cache struct
+ */
+void album_cache_fold_tags(struct t_cache *album_cache) {
+    if (album_cache->cache == NULL ||
+        album_cache->folded == true)
+    {
+        return;
+    }
+    album_cache_fold_tags_rt(album_cache->cache);
+    album_cache->folded = true;
+}
+
+/**
+ * Appends a case folded twin to all tag values of the albums.
+ * The twin is stored in the same allocation behind the terminating zero
+ * of the value: "Value\0value\0". The albums can be freed as usual.
+ * @param album_cache_rt album cache radix tree
+ */
+void album_cache_fold_tags_rt(rax *album_cache_rt) {
+    sds buffer = sdsempty();
+    raxIterator iter;
+    raxStart(&iter, album_cache_rt);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        struct mpd_song *album = (struct mpd_song *)iter.data;
+        for (unsigned tag = 0; tag < MPD_TAG_COUNT; tag++) {
+            for (struct mpd_tag_value *tag_value = &album->tags[tag];
+                tag_value != NULL && tag_value->value != NULL;
+                tag_value = tag_value->next)
+            {
+                size_t len = strlen(tag_value->value);
+                buffer = sdscpylen(buffer, tag_value->value, len);
+                sds_utf8_tolower(buffer);
+                tag_value->value = realloc_assert(tag_value->value, len + 1 + sdslen(buffer) + 1);
+                memcpy(tag_value->value + len + 1, buffer, sdslen(buffer) + 1);
+            }
+        }
+    }
+    raxStop(&iter);
+    FREE_SDS(buffer);
+}
+
+/**
+ * Gets the case folded twin of an album tag value
+ * @param album_cache pointer to t_cache struct
+ * @param value tag value of an album in the album cache
+ * @return case folded value or NULL if the album cache is not folded
+ */
+const char *album_cache_get_folded(const struct t_cache *album_cache, const char *value) {
+    return album_cache->folded == true
+        ? value + strlen(value) + 1
+        : NULL;
+}
+
+/**
+ * Initializes the album cache sort indexes
+ * @param album_index pointer to the sort indexes
+ */
+void album_cache_index_init(struct t_album_cache_index *album_index) {
+    for (unsigned i = 0; i < ALBUM_CACHE_INDEX_COUNT; i++) {
+        album_index->sorted[i] = NULL;
+    }
+}
+
+/**
+ * Frees all album cache sort indexes.
+ * Must be called before the album cache is freed or replaced.
+ * @param album_index pointer to the sort indexes
+ */
+void album_cache_index_clear(struct t_album_cache_index *album_index) {
+    for (unsigned i = 0; i < ALBUM_CACHE_INDEX_COUNT; i++) {
+        if (album_index->sorted[i] != NULL) {
+            FREE_PTR(album_index->sorted[i]->albums);
+            FREE_PTR(album_index->sorted[i]);
+        }
+    }
+}
+
+/**
+ * Creates the sort indexes that are used by the default album list views.
+ * Indexes for other sort tags are created on demand by album_cache_index_get.
+ * @param album_index pointer to the sort indexes
+ * @param album_cache pointer to the album cache
+ * @param available_tags available tags to resolve the sort tags
+ * @param album_config album configuration
+ */
+void album_cache_index_create(struct t_album_cache_index *album_index, struct t_cache *album_cache,
+        const struct t_tags *available_tags, const struct t_albums_config *album_config)
+{
+    album_cache_index_clear(album_index);
+    if (album_cache->cache == NULL) {
+        return;
+    }
+    MYMPD_LOG_DEBUG(NULL, "Creating album cache sort indexes");
+    album_cache_index_get(album_index, album_cache, SORT_BY_TAG, get_sort_tag(MPD_TAG_ALBUM, available_tags));
+    album_cache_index_get(album_index, album_cache, SORT_BY_TAG, get_sort_tag(MPD_TAG_ALBUM_ARTIST, available_tags));
+    if (album_config->group_tag != MPD_TAG_UNKNOWN) {
+        album_cache_index_get(album_index, album_cache, SORT_BY_TAG, album_config->group_tag);
+    }
+    if (album_config->mode == ALBUM_MODE_ADV) {
+        album_cache_index_get(album_index, album_cache, SORT_BY_TAG, MPD_TAG_DATE);
+        album_cache_index_get(album_index, album_cache, SORT_BY_ADDED, MPD_TAG_UNKNOWN);
+        album_cache_index_get(album_index, album_cache, SORT_BY_LAST_MODIFIED, MPD_TAG_UNKNOWN);
+    }
+}
+
+/**
+ * Gets the albums sorted by a tag, Added or Last-Modified.
+ * The sort index is created if it does not exist.
+ * @param album_index pointer to the sort indexes
+ * @param album_cache pointer to the album cache
+ * @param sort_by sort type
+ * @param sort_tag sort tag for SORT_BY_TAG, it must be already resolved with get_sort_tag
+ * @return sorted albums or NULL on error
+ */
+const struct t_album_cache_sorted *album_cache_index_get(struct t_album_cache_index *album_index, struct t_cache *album_cache,
+        enum sort_by_type sort_by, enum mpd_tag_type sort_tag)
+{
+    int slot = album_cache_index_slot(sort_by, sort_tag);
+    if (slot < 0 ||
+        album_cache->cache == NULL)
+    {
+        return NULL;
+    }
+    if (album_index->sorted[slot] != NULL) {
+        return album_index->sorted[slot];
+    }
+    // sort the albums with a temporary rax and flatten it to an array
+    rax *sorted_rax = raxNew();
+    sds key = sdsempty();
+    raxIterator iter;
+    raxStart(&iter, album_cache->cache);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        key = get_sort_key(key, sort_by, sort_tag, (struct mpd_song *)iter.data);
+        rax_insert_no_dup(sorted_rax, key, iter.data);
+        sdsclear(key);
+    }
+    raxStop(&iter);
+    FREE_SDS(key);
+
+    struct t_album_cache_sorted *sorted = malloc_assert(sizeof(struct t_album_cache_sorted));
+    sorted->len = 0;
+    sorted->albums = sorted_rax->numele > 0
+        ? malloc_assert(sorted_rax->numele * sizeof(struct mpd_song *))
+        : NULL;
+    raxStart(&iter, sorted_rax);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        sorted->albums[sorted->len++] = (struct mpd_song *)iter.data;
+    }
+    raxStop(&iter);
+    raxFree(sorted_rax);
+    album_index->sorted[slot] = sorted;
+    return sorted;
+}
+
 /**
  * Gets the number of songs
  * @param album mpd_song struct representing the album
@@ -572,13 +760,269 @@ void album_cache_set_uri(struct mpd_song *album, const char *uri) {
     free(album->uri);
     size_t len = strlen(uri);
     album->uri = malloc_assert(len + 1);
-    snprintf(album->uri, len, "%s", uri);
+    snprintf(album->uri, len + 1, "%s", uri);
 }
 
 /**
  * Private functions
  */
 
+/**
+ * Maps the sort type and tag to the sort index slot
+ * @param sort_by sort type
+ * @param sort_tag sort tag for SORT_BY_TAG
+ * @return slot number or -1 if there is no index for this sort type
+ */
+static int album_cache_index_slot(enum sort_by_type sort_by, enum mpd_tag_type sort_tag) {
+    switch(sort_by) {
+        case SORT_BY_TAG:
+            return sort_tag > MPD_TAG_UNKNOWN && sort_tag < MPD_TAG_COUNT
+                ? (int)sort_tag
+                : -1;
+        case SORT_BY_ADDED:
+            return MPD_TAG_COUNT;
+        case SORT_BY_LAST_MODIFIED:
+            return MPD_TAG_COUNT + 1;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * Reads the album cache in the binary album cache format.
+ * The file is read with one fread and the albums are created directly from the records.
+ * @param album_cache pointer to t_cache struct
+ * @param filepath album cache file
+ * @param album_config album configuration
+ * @return bool true on success, else false
+ */
+static bool album_cache_read_bin(struct t_cache *album_cache, const char *filepath, const struct t_albums_config *album_config) {
+    errno = 0;
+    FILE *fp = fopen(filepath, OPEN_FLAGS_READ_BIN);
+    if (fp == NULL) {
+        MYMPD_LOG_ERROR(NULL, "Can not open file \"%s\"", filepath);
+        MYMPD_LOG_ERRNO(NULL, errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fileno(fp), &st) != 0 ||
+        (size_t)st.st_size < sizeof(struct t_album_cache_bin_header))
+    {
+        MYMPD_LOG_ERROR(NULL, "Invalid album cache file \"%s\"", filepath);
+        (void) fclose(fp);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    // malloc returns a buffer that is aligned for the 8 byte aligned records
+    void *buf = malloc_assert(size);
+    if (fread(buf, 1, size, fp) != size) {
+        MYMPD_LOG_ERROR(NULL, "Can not read file \"%s\"", filepath);
+        (void) fclose(fp);
+        FREE_PTR(buf);
+        return false;
+    }
+    (void) fclose(fp);
+    const unsigned char *base = (const unsigned char *)buf;
+    const struct t_album_cache_bin_header *header = (const struct t_album_cache_bin_header *)base;
+
+    // check header
+    if (memcmp(header->magic, ALBUM_CACHE_BIN_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != ALBUM_CACHE_BIN_VERSION ||
+        header->byte_order != ALBUM_CACHE_BIN_BYTE_ORDER)
+    {
+        MYMPD_LOG_WARN(NULL, "Unexpected album cache format");
+        FREE_PTR(buf);
+        return false;
+    }
+    if (header->album_mode != (int32_t)album_config->mode) {
+        MYMPD_LOG_WARN(NULL, "Unexpected album mode");
+        FREE_PTR(buf);
+        return false;
+    }
+    if (header->group_tag != (int32_t)album_config->group_tag) {
+        MYMPD_LOG_WARN(NULL, "Unexpected album group tag");
+        FREE_PTR(buf);
+        return false;
+    }
+    // check bounds
+    if (header->tag_count > MPD_TAG_COUNT ||
+        header->record_size != sizeof(struct t_album_cache_bin_record) + header->tag_count * sizeof(struct t_album_cache_bin_tag) ||
+        header->records_offset % 8 != 0 ||
+        header->records_offset < sizeof(struct t_album_cache_bin_header) + header->tag_count * sizeof(uint32_t) ||
+        header->values_offset != header->records_offset + (uint64_t)header->record_size * header->album_count ||
+        header->pool_offset != header->values_offset + (uint64_t)header->value_count * sizeof(uint32_t) ||
+        header->pool_size == 0 ||
+        header->pool_offset + header->pool_size != size ||
+        base[size - 1] != '\0')
+    {
+        MYMPD_LOG_ERROR(NULL, "Corrupt album cache file \"%s\"", filepath);
+        FREE_PTR(buf);
+        return false;
+    }
+    const uint32_t *tag_names = (const uint32_t *)(base + sizeof(struct t_album_cache_bin_header));
+    const uint32_t *values = (const uint32_t *)(base + header->values_offset);
+    const char *pool = (const char *)(base + header->pool_offset);
+
+    // read tags
+    enum mpd_tag_type tags[MPD_TAG_COUNT];
+    for (uint32_t tagnr = 0; tagnr < header->tag_count; tagnr++) {
+        tags[tagnr] = tag_names[tagnr] < header->pool_size
+            ? mpd_tag_name_parse(pool + tag_names[tagnr])
+            : MPD_TAG_UNKNOWN;
+        if (tags[tagnr] == MPD_TAG_UNKNOWN) {
+            MYMPD_LOG_ERROR(NULL, "Unkown MPD tag type in album cache");
+        }
+    }
+
+    // read albums
+    bool rc = true;
+    album_cache->cache = raxNew();
+    for (uint32_t i = 0; i < header->album_count; i++) {
+        const unsigned char *record_buf = base + header->records_offset + (size_t)i * header->record_size;
+        const struct t_album_cache_bin_record *record = (const struct t_album_cache_bin_record *)record_buf;
+        if (record->key >= header->pool_size ||
+            record->uri >= header->pool_size)
+        {
+            rc = false;
+            break;
+        }
+        struct mpd_song *album = mpd_song_new(pool + record->uri);
+        album->pos = record->discs;
+        album->prio = record->songs;
+        album->duration = record->duration;
+        album->duration_ms = record->duration_ms;
+        album->last_modified = (time_t)record->last_modified;
+        album->added = (time_t)record->added;
+        const struct t_album_cache_bin_tag *record_tags = (const struct t_album_cache_bin_tag *)(record_buf + sizeof(struct t_album_cache_bin_record));
+        for (uint32_t tagnr = 0; tagnr < header->tag_count; tagnr++) {
+            if ((uint64_t)record_tags[tagnr].first + record_tags[tagnr].count > header->value_count) {
+                rc = false;
+                break;
+            }
+            if (tags[tagnr] == MPD_TAG_UNKNOWN) {
+                continue;
+            }
+            for (uint32_t j = 0; j < record_tags[tagnr].count; j++) {
+                uint32_t value = values[record_tags[tagnr].first + j];
+                if (value >= header->pool_size) {
+                    rc = false;
+                    break;
+                }
+                mympd_mpd_song_add_tag_dedup(album, tags[tagnr], pool + value);
+            }
+        }
+        if (rc == false) {
+            mpd_song_free(album);
+            break;
+        }
+        const char *key = pool + record->key;
+        if (raxTryInsert(album_cache->cache, (unsigned char *)key, strlen(key), album, NULL) == 0) {
+            MYMPD_LOG_ERROR(NULL, "Duplicate key in album cache file found: %s", key);
+            mpd_song_free(album);
+        }
+    }
+    FREE_PTR(buf);
+    if (rc == false) {
+        MYMPD_LOG_ERROR(NULL, "Corrupt album cache file \"%s\"", filepath);
+    }
+    return rc;
+}
+
+/**
+ * Reads the album cache in the mpack format of older myMPD versions
+ * @param album_cache pointer to t_cache struct
+ * @param filepath album cache file
+ * @param album_config album configuration
+ * @return bool true on success, else false
+ */
+static bool album_cache_read_mpack(struct t_cache *album_cache, const char *filepath, const struct t_albums_config *album_config) {
+    mpack_tree_t tree;
+    mpack_tree_init_filename(&tree, filepath, 0);
+    mpack_tree_set_error_handler(&tree, log_mpack_node_error);
+    mpack_tree_parse(&tree);
+    mpack_node_t root = mpack_tree_root(&tree);
+
+    // check for expected album_mode
+    enum album_modes album_mode = (enum album_modes)mpack_node_int(mpack_node_map_cstr(root, "albumMode"));
+    if (album_mode != album_config->mode) {
+        mpack_tree_destroy(&tree);
+        MYMPD_LOG_WARN(NULL, "Unexpected album mode");
+        return false;
+    }
+
+    // check for expected album_group_tag
+    enum mpd_tag_type group_tag = (enum mpd_tag_type)mpack_node_int(mpack_node_map_cstr(root, "albumGroupTag"));
+    if (group_tag != album_config->group_tag) {
+        mpack_tree_destroy(&tree);
+        MYMPD_LOG_WARN(NULL, "Unexpected album group tag");
+        return false;
+    }
+
+    // read tags array
+    struct t_tags *album_tags = malloc_assert(sizeof(struct t_tags));
+    tags_reset(album_tags);
+
+    mpack_node_t tags_node = mpack_node_map_cstr(root, "tags");
+    size_t len = mpack_node_array_length(tags_node);
+    for (size_t i = 0; i < len; i++) {
+        mpack_node_t value_node = mpack_node_array_at(tags_node, i);
+        char *value = mpack_node_cstr_alloc(value_node, JSONRPC_STR_MAX);
+        if (value == NULL) {
+            break;
+        }
+        enum mpd_tag_type tag = mpd_tag_name_parse(value);
+        if (tag != MPD_TAG_UNKNOWN) {
+            album_tags->tags[album_tags->len++] = tag;
+        }
+        else {
+            MYMPD_LOG_ERROR(NULL, "Unkown MPD tag type: \"%s\"", value);
+        }
+        MPACK_FREE(value);
+    }
+
+    // read albums array
+    mpack_node_t albums_node = mpack_node_map_cstr(root, "albums");
+    len = mpack_node_array_length(albums_node);
+    sds key = sdsempty();
+    album_cache->cache = raxNew();
+
+    for (size_t i = 0; i < len; i++) {
+        mpack_node_t album_node = mpack_node_array_at(albums_node, i);
+        struct mpd_song *album = album_from_mpack_node(album_node, album_tags, &key);
+        if (album != NULL) {
+            if (raxTryInsert(album_cache->cache, (unsigned char *)key, sdslen(key), album, NULL) == 0) {
+                MYMPD_LOG_ERROR(NULL, "Duplicate key in album cache file found: %s", key);
+                mpd_song_free(album);
+            }
+        }
+    }
+    FREE_SDS(key);
+    FREE_PTR(album_tags);
+    // clean up and check for errors
+    return mpack_tree_destroy(&tree) != mpack_ok
+        ? false
+        : true;
+}
+
+/**
+ * Adds a string to the string pool of the binary album cache format
+ * @param pool pointer to the string pool
+ * @param pool_index string -> offset index to deduplicate the strings
+ * @param str string to add
+ * @return offset of the string in the string pool
+ */
+static uint32_t album_cache_bin_add_string(sds *pool, rax *pool_index, const char *str) {
+    size_t len = strlen(str);
+    void *data = raxFind(pool_index, (unsigned char *)str, len);
+    if (data != raxNotFound) {
+        return (uint32_t)(uintptr_t)data;
+    }
+    uint32_t offset = (uint32_t)sdslen(*pool);
+    *pool = sdscatlen(*pool, str, len + 1);
+    raxInsert(pool_index, (unsigned char *)str, len, (void *)(uintptr_t)offset, NULL);
+    return offset;
+}
+
 /**
  * Creates a mpd_song struct from cache
  * @param album_node mpack node to parse
@@ -14,6 +14,27 @@
 
 #include <stdbool.h>
 
+/**
+ * Albums of the album cache sorted in ascending order
+ */
+struct t_album_cache_sorted {
+    struct mpd_song **albums;  //!< pointers to the albums in the album cache
+    size_t len;                //!< number of albums
+};
+
+/**
+ * Number of possible sort indexes: all tags, Added and Last-Modified
+ */
+#define ALBUM_CACHE_INDEX_COUNT (MPD_TAG_COUNT + 2)
+
+/**
+ * Persistent sort indexes for the album cache.
+ * The indexes reference the albums and must be cleared if the album cache is replaced.
+ */
+struct t_album_cache_index {
+    struct t_album_cache_sorted *sorted[ALBUM_CACHE_INDEX_COUNT];  //!< sorted albums by tag, Added and Last-Modified
+};
+
 enum album_modes parse_album_mode(const char *mode_str);
 const char *lookup_album_mode(enum album_modes mode);
 
@@ -25,6 +46,16 @@ sds album_cache_get_key(sds albumkey, const struct mpd_song *song, const struct
 struct mpd_song *album_cache_get_album(struct t_cache *album_cache, sds key);
 void album_cache_free(struct t_cache *album_cache);
 void album_cache_free_rt(rax *album_cache_rt);
+void album_cache_fold_tags(struct t_cache *album_cache);
+void album_cache_fold_tags_rt(rax *album_cache_rt);
+const char *album_cache_get_folded(const struct t_cache *album_cache, const char *value);
+
+void album_cache_index_init(struct t_album_cache_index *album_index);
+void album_cache_index_clear(struct t_album_cache_index *album_index);
+void album_cache_index_create(struct t_album_cache_index *album_index, struct t_cache *album_cache,
+        const struct t_tags *available_tags, const struct t_albums_config *album_config);
+const struct t_album_cache_sorted *album_cache_index_get(struct t_album_cache_index *album_index, struct t_cache *album_cache,
+        enum sort_by_type sort_by, enum mpd_tag_type sort_tag);
 
 unsigned album_get_discs(const struct mpd_song *album);
 unsigned album_get_total_time(const struct mpd_song *album);
@@ -40,6 +40,7 @@ struct t_config {
     bool http;                      //!< enable listening on plain http_port
     bool log_to_syslog;             //!< enable syslog logging
     bool save_caches;               //!< true = save caches between restart
+    bool save_sessions;             //!< true = save sessions between restart
     bool ssl;                       //!< enable listening on ssl_port
     bool stickers;                  //!< enable sticker support
     bool stickers_pad_int;          //!< enable the padding of integer sticker values
@@ -48,6 +49,7 @@ struct t_config {
     int cache_lyrics_keep_days;     //!< expiration time for lyrics cache files in days
     int cache_thumbs_keep_days;     //!< expiration time for thumbs cache files in days
     int cache_misc_keep_days;       //!< expiration time for misc cache files in days
+    int cache_cover_memory_kb;      //!< byte budget in KiB for the in-memory cover cache
     int http_port;                  //!< http port to listen
     int loglevel;                   //!< loglevel
     int ssl_port;                   //!< https port to listen
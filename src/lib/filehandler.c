@@ -176,6 +176,59 @@ sds sds_getfile(sds s, const char *file_path, size_t max, bool remove_newline, b
     return s;
 }
 
+/**
+ * Reads a whole binary file in the sds string s,
+ * the content is not modified
+ * @param s an already allocated sds string that should hold the file content
+ * @param file_path filename to read
+ * @param max maximum bytes to read
+ * @param nread Number of bytes read,
+ *              -1 error reading file,
+ *              -2 file is too big
+ * @return pointer to s
+ */
+sds sds_getfile_binary(sds s, const char *file_path, size_t max, int *nread) {
+    sdsclear(s);
+    errno = 0;
+    FILE *fp = fopen(file_path, OPEN_FLAGS_READ);
+    if (fp == NULL) {
+        MYMPD_LOG_ERROR(NULL, "Error opening file \"%s\"", file_path);
+        MYMPD_LOG_ERRNO(NULL, errno);
+        *nread = -1;
+        return s;
+    }
+    struct stat status;
+    if (fstat(fileno(fp), &status) != 0) {
+        MYMPD_LOG_ERROR(NULL, "Error getting size of \"%s\"", file_path);
+        MYMPD_LOG_ERRNO(NULL, errno);
+        (void) fclose(fp);
+        *nread = -1;
+        return s;
+    }
+    if (status.st_size < 0 ||
+        (size_t)status.st_size > max)
+    {
+        MYMPD_LOG_ERROR(NULL, "File \"%s\" is too big, max size is %lu", file_path, (unsigned long)max);
+        (void) fclose(fp);
+        *nread = -2;
+        return s;
+    }
+    size_t size = (size_t)status.st_size;
+    s = sdsMakeRoomFor(s, size);
+    size_t len = fread(s, 1, size, fp);
+    if (ferror(fp) != 0) {
+        MYMPD_LOG_ERROR(NULL, "Error reading file \"%s\"", file_path);
+        (void) fclose(fp);
+        *nread = -1;
+        return s;
+    }
+    (void) fclose(fp);
+    sdssetlen(s, len);
+    s[len] = '\0';
+    *nread = (int)len;
+    return s;
+}
+
 /**
  * Reads a whole file in the sds string s from *fp
  * Removes whitespace characters from start and end
@@ -31,6 +31,7 @@ time_t get_mtime(const char *filepath);
 
 sds sds_getline(sds s, FILE *fp, size_t max, int *nread);
 sds sds_getfile(sds s, const char *file_path, size_t max, bool remove_newline, bool warn, int *nread);
+sds sds_getfile_binary(sds s, const char *file_path, size_t max, int *nread);
 sds sds_getfile_from_fp(sds s, FILE *fp, size_t max, bool remove_newline, int *nread);
 
 FILE *open_tmp_file(sds filepath);
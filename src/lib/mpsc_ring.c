@@ -0,0 +1,128 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/lib/mpsc_ring.h"
+
+#include "src/lib/mem.h"
+
+#include <stdint.h>
+
+/*
+ Bounded multi-producer / single-consumer ring with preallocated slots.
+ Each slot carries a sequence number: a producer claims a position with a
+ compare and swap on the tail and publishes the slot by setting the sequence
+ to position + 1. The consumer reads the slot if the sequence matches and
+ releases it for the next round by setting the sequence to position + capacity.
+ No locks are taken and no memory is allocated after initialization.
+*/
+
+/**
+ * Initializes the ring
+ * @param ring pointer to the ring
+ * @param capacity number of slots, rounded up to the next power of two
+ */
+void mpsc_ring_init(struct t_mpsc_ring *ring, size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    ring->slots = malloc_assert(size * sizeof(struct t_mpsc_ring_slot));
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&ring->slots[i].seq, i);
+        ring->slots[i].data = NULL;
+        ring->slots[i].id = 0;
+        ring->slots[i].timestamp = 0;
+    }
+    ring->mask = size - 1;
+    atomic_init(&ring->tail, 0);
+    ring->head = 0;
+}
+
+/**
+ * Frees the slots, the ring must be empty
+ * @param ring pointer to the ring
+ */
+void mpsc_ring_clear(struct t_mpsc_ring *ring) {
+    FREE_PTR(ring->slots);
+    ring->mask = 0;
+}
+
+/**
+ * Appends data to the ring, can be called from any thread
+ * @param ring pointer to the ring
+ * @param data data to append
+ * @param id id of the entry
+ * @return true on success, false if the ring is full
+ */
+bool mpsc_ring_push(struct t_mpsc_ring *ring, void *data, unsigned id) {
+    size_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    struct t_mpsc_ring_slot *slot;
+    for (;;) {
+        slot = &ring->slots[pos & ring->mask];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            // slot is free, try to claim it
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed) == true)
+            {
+                break;
+            }
+            // pos was updated by the failed compare and swap
+        }
+        else if (diff < 0) {
+            // slot is not yet consumed
+            return false;
+        }
+        else {
+            // another producer claimed this position
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        }
+    }
+    slot->data = data;
+    slot->id = id;
+    slot->timestamp = time(NULL);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * Gets the first entry, must be called only from the consumer thread
+ * @param ring pointer to the ring
+ * @param id if not NULL, set to the id of the entry
+ * @param timestamp if not NULL, set to the timestamp of the entry
+ * @return the data or NULL if the ring is empty
+ */
+void *mpsc_ring_shift(struct t_mpsc_ring *ring, unsigned *id, time_t *timestamp) {
+    struct t_mpsc_ring_slot *slot = &ring->slots[ring->head & ring->mask];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq != ring->head + 1) {
+        // empty or the producer has not finished writing this slot
+        return NULL;
+    }
+    void *data = slot->data;
+    if (id != NULL) {
+        *id = slot->id;
+    }
+    if (timestamp != NULL) {
+        *timestamp = slot->timestamp;
+    }
+    slot->data = NULL;
+    atomic_store_explicit(&slot->seq, ring->head + ring->mask + 1, memory_order_release);
+    ring->head++;
+    return data;
+}
+
+/**
+ * Checks if the next entry is ready for the consumer
+ * @param ring pointer to the ring
+ * @return true if there is no published entry, else false
+ */
+bool mpsc_ring_is_empty(struct t_mpsc_ring *ring) {
+    struct t_mpsc_ring_slot *slot = &ring->slots[ring->head & ring->mask];
+    return atomic_load_explicit(&slot->seq, memory_order_acquire) != ring->head + 1;
+}
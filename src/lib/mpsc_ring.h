@@ -0,0 +1,48 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_MPSC_RING_H
+#define MYMPD_MPSC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * Size of a cache line, used to separate the producer and consumer positions
+ */
+#define MPSC_RING_CACHELINE 64
+
+/**
+ * A preallocated slot of the ring
+ */
+struct t_mpsc_ring_slot {
+    _Atomic size_t seq;  //!< sequence number, synchronizes the producer and the consumer
+    void *data;          //!< data t_work_request or t_work_response
+    unsigned id;         //!< id of the message
+    time_t timestamp;    //!< messages added timestamp
+};
+
+/**
+ * Bounded lock-free multi-producer / single-consumer ring
+ */
+struct t_mpsc_ring {
+    struct t_mpsc_ring_slot *slots;                 //!< preallocated slots
+    size_t mask;                                    //!< capacity - 1, capacity is a power of two
+    char pad0[MPSC_RING_CACHELINE];                 //!< keeps the tail away from the read-only fields
+    _Atomic size_t tail;                            //!< next position to claim for the producers
+    char pad1[MPSC_RING_CACHELINE];                 //!< keeps the head away from the tail
+    size_t head;                                    //!< next position to read for the consumer
+};
+
+void mpsc_ring_init(struct t_mpsc_ring *ring, size_t capacity);
+void mpsc_ring_clear(struct t_mpsc_ring *ring);
+bool mpsc_ring_push(struct t_mpsc_ring *ring, void *data, unsigned id);
+void *mpsc_ring_shift(struct t_mpsc_ring *ring, unsigned *id, time_t *timestamp);
+bool mpsc_ring_is_empty(struct t_mpsc_ring *ring);
+
+#endif
@@ -18,14 +18,30 @@
 #endif
 
 #include <errno.h>
+#include <poll.h>
 
 /*
- Message queue implementation to transfer messages between threads asynchronously
+ Message queue implementation to transfer messages between threads asynchronously.
+ Queues created with mympd_queue_create_mpsc have a single consumer and use a
+ lock-free ring. The linked list is only used for entries that do not fit into the ring.
+ Once an entry is in the linked list, all following entries are appended to it
+ until the consumer has drained it, this keeps the entries in order.
+ The consumer is woken up through the eventfd, the signaled flag ensures that
+ only the first push after the consumer has seen an empty queue writes to it.
 */
 
 //private definitions
+static bool msg_list_push(struct t_mympd_queue *queue, void *data, unsigned id);
+static void msg_list_append(struct t_mympd_queue *queue, void *data, unsigned id);
+static bool ring_push(struct t_mympd_queue *queue, void *data, unsigned id);
+static bool ring_overflow_push(struct t_mympd_queue *queue, void *data, unsigned id);
+static void *ring_shift(struct t_mympd_queue *queue, int timeout_ms);
+static void *ring_shift_any(struct t_mympd_queue *queue);
+static bool ring_is_empty(struct t_mympd_queue *queue);
+static void ring_rearm(struct t_mympd_queue *queue);
 static bool check_for_queue_id(struct t_mympd_queue *queue, unsigned id);
 static void free_queue_node(struct t_mympd_msg *n, enum mympd_queue_types type);
+static void free_queue_data(void *data, enum mympd_queue_types type);
 static void free_queue_node_extra(void *extra, enum mympd_cmd_ids cmd_id);
 static int unlock_mutex(pthread_mutex_t *mutex);
 static void set_wait_time(int timeout_ms, struct timespec *max_wait);
@@ -54,6 +70,27 @@ struct t_mympd_queue *mympd_queue_create(const char *name, enum mympd_queue_type
         : -1;
     queue->mg_mgr = NULL;
     queue->mg_conn_id = 0;
+    queue->ring = NULL;
+    queue->signaled = false;
+    queue->overflow = false;
+    return queue;
+}
+
+/**
+ * Creates a thread safe message queue for multiple producers and a single consumer.
+ * Entries are stored in a preallocated lock-free ring, the consumer is woken up by an eventfd.
+ * Entries can only be shifted in order (id 0).
+ * @param name description of the queue
+ * @param type type of the queue QUEUE_TYPE_REQUEST or QUEUE_TYPE_RESPONSE
+ * @param capacity number of slots of the ring
+ * @return pointer to allocated and initialized queue struct
+ */
+struct t_mympd_queue *mympd_queue_create_mpsc(const char *name, enum mympd_queue_types type,
+        size_t capacity)
+{
+    struct t_mympd_queue *queue = mympd_queue_create(name, type, true);
+    queue->ring = malloc_assert(sizeof(struct t_mpsc_ring));
+    mpsc_ring_init(queue->ring, capacity);
     return queue;
 }
 
@@ -64,6 +101,10 @@ struct t_mympd_queue *mympd_queue_create(const char *name, enum mympd_queue_type
 void *mympd_queue_free(struct t_mympd_queue *queue) {
     mympd_queue_expire_age(queue, 0);
     event_fd_close(queue->event_fd);
+    if (queue->ring != NULL) {
+        mpsc_ring_clear(queue->ring);
+        FREE_PTR(queue->ring);
+    }
     FREE_PTR(queue);
     return NULL;
 }
@@ -76,30 +117,13 @@ void *mympd_queue_free(struct t_mympd_queue *queue) {
  * @return true on success else false
  */
 bool mympd_queue_push(struct t_mympd_queue *queue, void *data, unsigned id) {
-    int rc = pthread_mutex_lock(&queue->mutex);
-    if (rc != 0) {
-        MYMPD_LOG_ERROR(NULL, "Error in pthread_mutex_lock: %d", rc);
-        return false;
-    }
-    struct t_mympd_msg* new_node = malloc_assert(sizeof(struct t_mympd_msg));
-    new_node->data = data;
-    new_node->id = id;
-    new_node->timestamp = time(NULL);
-    new_node->next = NULL;
-    queue->length++;
-    if (queue->head == NULL &&
-        queue->tail == NULL)
-    {
-        queue->head = queue->tail = new_node;
+    if (queue->ring != NULL) {
+        return ring_push(queue, data, id);
     }
-    else {
-        queue->tail->next = new_node;
-        queue->tail = new_node;
-    }
-    if (unlock_mutex(&queue->mutex) != 0) {
+    if (msg_list_push(queue, data, id) == false) {
         return false;
     }
-    rc = pthread_cond_signal(&queue->wakeup);
+    int rc = pthread_cond_signal(&queue->wakeup);
     if (rc != 0) {
         MYMPD_LOG_ERROR(NULL, "Error in pthread_cond_signal: %d", rc);
         return 0;
@@ -119,10 +143,13 @@ bool mympd_queue_push(struct t_mympd_queue *queue, void *data, unsigned id) {
  * @param timeout_ms timeout in ms to wait for a queue entry,
  *                   0 to wait infinite
  *                   -1 for no wait
- * @param id 0 for first entry or specific id
+ * @param id 0 for first entry or specific id, must be 0 for mpsc queues
  * @return t_work_request or t_work_response
  */
 void *mympd_queue_shift(struct t_mympd_queue *queue, int timeout_ms, unsigned id) {
+    if (queue->ring != NULL) {
+        return ring_shift(queue, timeout_ms);
+    }
     //lock the queue
     int rc = pthread_mutex_lock(&queue->mutex);
     if (rc != 0) {
@@ -189,18 +216,29 @@ void *mympd_queue_shift(struct t_mympd_queue *queue, int timeout_ms, unsigned id
 }
 
 /**
- * Expire entries from the queue by age
+ * Expire entries from the queue by age.
+ * Entries in the ring of mpsc queues are only removed if max_age_s is 0,
+ * this must be done by the consumer thread.
  * @param queue pointer to the queue
  * @param max_age_s max age of nodes in seconds
  * @return number of expired nodes
  */
 int mympd_queue_expire_age(struct t_mympd_queue *queue, time_t max_age_s) {
+    int expired_count = 0;
+    if (queue->ring != NULL &&
+        max_age_s == 0)
+    {
+        void *data;
+        while ((data = mpsc_ring_shift(queue->ring, NULL, NULL)) != NULL) {
+            free_queue_data(data, queue->type);
+            expired_count++;
+        }
+    }
     int rc = pthread_mutex_lock(&queue->mutex);
     if (rc != 0) {
         MYMPD_LOG_ERROR(NULL, "Error in pthread_mutex_lock: %d", rc);
-        return 0;
+        return expired_count;
     }
-    int expired_count = 0;
     if (queue->head != NULL) {
         //queue has entry
         struct t_mympd_msg *current = NULL;
@@ -247,6 +285,209 @@ int mympd_queue_expire_age(struct t_mympd_queue *queue, time_t max_age_s) {
 
 //privat functions
 
+/**
+ * Appends data to the linked list
+ * @param queue pointer to the queue
+ * @param data struct t_work_request or t_work_response
+ * @param id id of the queue entry
+ * @return true on success else false
+ */
+static bool msg_list_push(struct t_mympd_queue *queue, void *data, unsigned id) {
+    int rc = pthread_mutex_lock(&queue->mutex);
+    if (rc != 0) {
+        MYMPD_LOG_ERROR(NULL, "Error in pthread_mutex_lock: %d", rc);
+        return false;
+    }
+    msg_list_append(queue, data, id);
+    return unlock_mutex(&queue->mutex) == 0;
+}
+
+/**
+ * Appends data to the linked list, the caller must hold the mutex
+ * @param queue pointer to the queue
+ * @param data struct t_work_request or t_work_response
+ * @param id id of the queue entry
+ */
+static void msg_list_append(struct t_mympd_queue *queue, void *data, unsigned id) {
+    struct t_mympd_msg* new_node = malloc_assert(sizeof(struct t_mympd_msg));
+    new_node->data = data;
+    new_node->id = id;
+    new_node->timestamp = time(NULL);
+    new_node->next = NULL;
+    queue->length++;
+    if (queue->head == NULL &&
+        queue->tail == NULL)
+    {
+        queue->head = queue->tail = new_node;
+    }
+    else {
+        queue->tail->next = new_node;
+        queue->tail = new_node;
+    }
+}
+
+/**
+ * Appends data to the ring of a mpsc queue and wakes up the consumer.
+ * Falls back to the linked list if the ring is full.
+ * @param queue pointer to the queue
+ * @param data struct t_work_request or t_work_response
+ * @param id id of the queue entry
+ * @return true on success else false
+ */
+static bool ring_push(struct t_mympd_queue *queue, void *data, unsigned id) {
+    if (atomic_load(&queue->overflow) == true ||
+        mpsc_ring_push(queue->ring, data, id) == false)
+    {
+        if (ring_overflow_push(queue, data, id) == false) {
+            return false;
+        }
+    }
+    // pairs with the fence in ring_rearm and ring_shift
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_exchange(&queue->signaled, true) == false) {
+        return event_eventfd_write(queue->event_fd);
+    }
+    return true;
+}
+
+/**
+ * Appends data to the linked list of a mpsc queue.
+ * The ring is used again, if the consumer has drained the linked list.
+ * @param queue pointer to the queue
+ * @param data struct t_work_request or t_work_response
+ * @param id id of the queue entry
+ * @return true on success else false
+ */
+static bool ring_overflow_push(struct t_mympd_queue *queue, void *data, unsigned id) {
+    int rc = pthread_mutex_lock(&queue->mutex);
+    if (rc != 0) {
+        MYMPD_LOG_ERROR(NULL, "Error in pthread_mutex_lock: %d", rc);
+        return false;
+    }
+    if (queue->head == NULL) {
+        if (mpsc_ring_push(queue->ring, data, id) == true) {
+            atomic_store(&queue->overflow, false);
+            return unlock_mutex(&queue->mutex) == 0;
+        }
+        MYMPD_LOG_WARN(NULL, "Queue \"%s\" is full, using the overflow list", queue->name);
+        atomic_store(&queue->overflow, true);
+    }
+    msg_list_append(queue, data, id);
+    return unlock_mutex(&queue->mutex) == 0;
+}
+
+/**
+ * Gets the first entry from a mpsc queue, must be called only by the consumer.
+ * @param queue pointer to the queue
+ * @param timeout_ms timeout in ms to wait for a queue entry,
+ *                   0 to wait infinite
+ *                   -1 for no wait, the caller has already read the eventfd
+ * @return t_work_request or t_work_response
+ */
+static void *ring_shift(struct t_mympd_queue *queue, int timeout_ms) {
+    void *data = ring_shift_any(queue);
+    if (data != NULL) {
+        if (timeout_ms == -1) {
+            ring_rearm(queue);
+        }
+        return data;
+    }
+    // the queue was seen empty, the next push must write the eventfd
+    atomic_store(&queue->signaled, false);
+    atomic_thread_fence(memory_order_seq_cst);
+    data = ring_shift_any(queue);
+    if (data != NULL) {
+        if (timeout_ms == -1) {
+            ring_rearm(queue);
+        }
+        return data;
+    }
+    if (timeout_ms == -1) {
+        return NULL;
+    }
+    struct pollfd pfd = {
+        .fd = queue->event_fd,
+        .events = POLLIN,
+        .revents = 0
+    };
+    errno = 0;
+    int rc = poll(&pfd, 1, timeout_ms == 0 ? -1 : timeout_ms);
+    if (rc < 0) {
+        if (errno != EINTR) {
+            MYMPD_LOG_ERROR(NULL, "Error polling the eventfd of queue \"%s\"", queue->name);
+            MYMPD_LOG_ERRNO(NULL, errno);
+        }
+        return NULL;
+    }
+    if (rc == 0) {
+        // timeout
+        return NULL;
+    }
+    event_eventfd_read(queue->event_fd);
+    // can be NULL for a wakeup without a new entry, e.g. on shutdown
+    return ring_shift_any(queue);
+}
+
+/**
+ * Gets the first entry from the ring or the overflow list.
+ * Entries in the ring are older than the entries in the overflow list.
+ * @param queue pointer to the queue
+ * @return t_work_request or t_work_response
+ */
+static void *ring_shift_any(struct t_mympd_queue *queue) {
+    void *data = mpsc_ring_shift(queue->ring, NULL, NULL);
+    if (data != NULL) {
+        return data;
+    }
+    pthread_mutex_lock(&queue->mutex);
+    struct t_mympd_msg *current = queue->head;
+    if (current != NULL) {
+        data = current->data;
+        queue->head = current->next;
+        if (queue->tail == current) {
+            queue->tail = NULL;
+        }
+        FREE_PTR(current);
+        queue->length--;
+    }
+    unlock_mutex(&queue->mutex);
+    return data;
+}
+
+/**
+ * Checks if the ring and the overflow list are empty
+ * @param queue pointer to the queue
+ * @return true if empty, else false
+ */
+static bool ring_is_empty(struct t_mympd_queue *queue) {
+    if (mpsc_ring_is_empty(queue->ring) == false) {
+        return false;
+    }
+    pthread_mutex_lock(&queue->mutex);
+    bool empty = queue->head == NULL;
+    unlock_mutex(&queue->mutex);
+    return empty;
+}
+
+/**
+ * Keeps the eventfd readable while entries are left.
+ * The poll loop of the consumer processes only one entry per wakeup.
+ * @param queue pointer to the queue
+ */
+static void ring_rearm(struct t_mympd_queue *queue) {
+    if (ring_is_empty(queue) == true) {
+        atomic_store(&queue->signaled, false);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (ring_is_empty(queue) == true ||
+            atomic_exchange(&queue->signaled, true) == true)
+        {
+            // empty or a producer has written the eventfd
+            return;
+        }
+    }
+    event_eventfd_write(queue->event_fd);
+}
+
 /**
  * Checks if queue has a entry with requested id
  * @param queue Pointer to the queue
@@ -278,20 +519,28 @@ static bool check_for_queue_id(struct t_mympd_queue *queue, unsigned id) {
  * @param type type of the queue QUEUE_TYPE_REQUEST or QUEUE_TYPE_RESPONSE
  */
 static void free_queue_node(struct t_mympd_msg *node, enum mympd_queue_types type) {
-    //free data
+    free_queue_data(node->data, type);
+    //free the node itself
+    FREE_PTR(node);
+}
+
+/**
+ * Frees the data of a queue entry
+ * @param data struct t_work_request or t_work_response
+ * @param type type of the queue QUEUE_TYPE_REQUEST or QUEUE_TYPE_RESPONSE
+ */
+static void free_queue_data(void *data, enum mympd_queue_types type) {
     if (type == QUEUE_TYPE_REQUEST) {
-        struct t_work_request *request = node->data;
+        struct t_work_request *request = data;
         free_queue_node_extra(request->extra, request->cmd_id);
         free_request(request);
     }
     else {
         //QUEUE_TYPE_RESPONSE
-        struct t_work_response *response = node->data;
+        struct t_work_response *response = data;
         free_queue_node_extra(response->extra, response->cmd_id);
         free_response(response);
     }
-    //free the node itself
-    FREE_PTR(node);
 }
 
 /**
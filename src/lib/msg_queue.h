@@ -7,7 +7,10 @@
 #ifndef MYMPD_QUEUE_H
 #define MYMPD_QUEUE_H
 
+#include "src/lib/mpsc_ring.h"
+
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <time.h>
 
@@ -37,6 +40,10 @@ struct t_mympd_queue {
     pthread_cond_t wakeup;        //!< condition variable for the mutex
     const char *name;             //!< descriptive name
     enum mympd_queue_types type;  //!< the queue type (request or response)
+    // lock-free ring for queues with a single consumer, NULL for the linked list only queue
+    struct t_mpsc_ring *ring;     //!< lock-free ring, the linked list is used if the ring is full
+    _Atomic bool signaled;        //!< true if a wakeup is pending on the event fd of the ring
+    _Atomic bool overflow;        //!< true while the linked list has entries, new entries are appended to it
     // to wakeup the mympd_api event loop
     int event_fd;                 //!< event fd
     // to wakeup the mongoose event loop
@@ -46,6 +53,8 @@ struct t_mympd_queue {
 
 struct t_mympd_queue *mympd_queue_create(const char *name, enum mympd_queue_types type,
         bool event);
+struct t_mympd_queue *mympd_queue_create_mpsc(const char *name, enum mympd_queue_types type,
+        size_t capacity);
 void *mympd_queue_free(struct t_mympd_queue *queue);
 bool mympd_queue_push(struct t_mympd_queue *queue, void *data, unsigned id);
 void *mympd_queue_shift(struct t_mympd_queue *queue, int timeout_ms, unsigned id);
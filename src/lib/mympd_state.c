@@ -11,6 +11,7 @@
 #include "src/lib/event.h"
 #include "src/lib/last_played.h"
 #include "src/lib/mem.h"
+#include "src/lib/rax_extras.h"
 #include "src/lib/sds_extras.h"
 #include "src/lib/timer.h"
 #include "src/lib/utility.h"
@@ -18,6 +19,7 @@
 #include "src/mympd_api/home.h"
 #include "src/mympd_api/timer.h"
 #include "src/mympd_api/trigger.h"
+#include "src/mympd_api/webradios.h"
 
 #include <string.h>
 
@@ -32,6 +34,7 @@ void mympd_state_save(struct t_mympd_state *mympd_state, bool free_data) {
     if (mympd_state->config->save_caches == true &&
         mympd_state->config->albums.mode == ALBUM_MODE_SIMPLE)
     {
+        album_cache_index_clear(&mympd_state->album_cache_index);
         album_cache_write(&mympd_state->album_cache, mympd_state->config->workdir,
             &mympd_state->mpd_state->tags_album, &mympd_state->config->albums, true);
     }
@@ -107,6 +110,9 @@ void mympd_state_default(struct t_mympd_state *mympd_state, struct t_config *con
     //mpd partition state
     mympd_state->partition_state = malloc_assert(sizeof(struct t_partition_state));
     partition_state_default(mympd_state->partition_state, MPD_PARTITION_DEFAULT, mympd_state->mpd_state, config);
+    //webradio favorites index, shared across partitions
+    webradio_favorites_init(&mympd_state->webradio_favorites, config->workdir);
+    mympd_state->partition_state->webradio_favorites = &mympd_state->webradio_favorites;
     // stickerdb
     // use the partition struct to store the mpd connection for the stickerdb
     mympd_state->stickerdb = malloc_assert(sizeof(struct t_stickerdb_state));
@@ -114,6 +120,8 @@ void mympd_state_default(struct t_mympd_state *mympd_state, struct t_config *con
     // do not use the shared mpd_state - we can connect to another mpd server for stickers
     mympd_state->stickerdb->mpd_state = malloc_assert(sizeof(struct t_mpd_state));
     mpd_state_default(mympd_state->stickerdb->mpd_state, config);
+    // the stickers of the mympd_api thread are mirrored in memory
+    mympd_state->stickerdb->cache = raxNew();
     //triggers;
     list_init(&mympd_state->trigger_list);
     //home icons
@@ -122,6 +130,10 @@ void mympd_state_default(struct t_mympd_state *mympd_state, struct t_config *con
     mympd_api_timer_timerlist_init(&mympd_state->timer_list);
     //album cache
     cache_init(&mympd_state->album_cache);
+    album_cache_index_init(&mympd_state->album_cache_index);
+    list_init(&mympd_state->album_cache_update_paths);
+    //song index
+    song_index_init(&mympd_state->song_index);
     //init last played songs list
     mympd_state->last_played_count = MYMPD_LAST_PLAYED_COUNT;
     //poll fds
@@ -151,9 +163,14 @@ void mympd_state_free(struct t_mympd_state *mympd_state) {
     //stickerdb
     mpd_state_free(mympd_state->stickerdb->mpd_state);
     stickerdb_state_free(mympd_state->stickerdb);
+    //webradio favorites
+    webradio_favorites_clear(&mympd_state->webradio_favorites);
     //caches
+    album_cache_index_clear(&mympd_state->album_cache_index);
     album_cache_free(&mympd_state->album_cache);
     cache_free(&mympd_state->album_cache);
+    list_clear(&mympd_state->album_cache_update_paths);
+    song_index_free(&mympd_state->song_index);
     //sds
     FREE_SDS(mympd_state->tag_list_search);
     FREE_SDS(mympd_state->tag_list_browse);
@@ -335,6 +352,7 @@ void partition_state_default(struct t_partition_state *partition_state, const ch
     //add pointer to other states
     partition_state->config = config;
     partition_state->mpd_state = mpd_state;
+    partition_state->webradio_favorites = NULL;
     //mpd idle mask
     if (strcmp(name, MPD_PARTITION_DEFAULT) == 0) {
         partition_state->is_default = true;
@@ -402,6 +420,7 @@ void jukebox_state_default(struct t_jukebox_state *jukebox_state) {
     jukebox_state->last_played = MYMPD_JUKEBOX_LAST_PLAYED;
     jukebox_state->queue_length = MYMPD_JUKEBOX_QUEUE_LENGTH;
     jukebox_state->ignore_hated = MYMPD_JUKEBOX_IGNORE_HATED;
+    jukebox_state->weighting = JUKEBOX_WEIGHTING_OFF;
     jukebox_state->filter_include = sdsempty();
     jukebox_state->filter_exclude = sdsempty();
     jukebox_state->min_song_duration = MYMPD_JUKEBOX_MIN_SONG_DURATION;
@@ -435,6 +454,7 @@ void jukebox_state_copy(struct t_jukebox_state *src, struct t_jukebox_state *dst
     dst->uniq_tag.tags[0] = src->uniq_tag.tags[0];
     dst->last_played = src->last_played;
     dst->ignore_hated = src->ignore_hated;
+    dst->weighting = src->weighting;
     dst->min_song_duration = src->min_song_duration;
     dst->max_song_duration = src->max_song_duration;
     dst->filling = src->filling;
@@ -456,6 +476,11 @@ void stickerdb_state_default(struct t_stickerdb_state *stickerdb, struct t_confi
     stickerdb->conn_state = MPD_DISCONNECTED;
     stickerdb->conn = NULL;
     stickerdb->name = sdsnew("stickerdb");
+    stickerdb->cache = NULL;
+    stickerdb->cache_dirty = true;
+    stickerdb->cache_own_changes = 0;
+    stickerdb->batch_idle_exited = false;
+    stickerdb->batch_stickers = NULL;
 }
 
 /**
@@ -463,6 +488,12 @@ void stickerdb_state_default(struct t_stickerdb_state *stickerdb, struct t_confi
  * @param stickerdb pointer to struct
  */
 void stickerdb_state_free(struct t_stickerdb_state *stickerdb) {
+    if (stickerdb->cache != NULL) {
+        rax_free_data(stickerdb->cache, NULL);
+    }
+    if (stickerdb->batch_stickers != NULL) {
+        rax_free_data(stickerdb->batch_stickers, NULL);
+    }
     FREE_SDS(stickerdb->name);
     FREE_PTR(stickerdb);
 }
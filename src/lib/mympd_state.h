@@ -10,10 +10,12 @@
 #include "dist/libmympdclient/include/mpd/client.h"
 #include "dist/sds/sds.h"
 #include "src/lib/cache_rax.h"
+#include "src/lib/cache_rax_album.h"
 #include "src/lib/config_def.h"
 #include "src/lib/event.h"
 #include "src/lib/fields.h"
 #include "src/lib/list.h"
+#include "src/lib/song_index.h"
 
 #include <time.h>
 
@@ -28,6 +30,16 @@ enum jukebox_modes {
     JUKEBOX_UNKNOWN     //!< jukebox mode is unknown
 };
 
+/**
+ * Jukebox weighting of the random selection
+ */
+enum jukebox_weightings {
+    JUKEBOX_WEIGHTING_OFF,         //!< all songs / albums have the same chance
+    JUKEBOX_WEIGHTING_STICKERS,    //!< songs are weighted by rating, like, play and skip count
+    JUKEBOX_WEIGHTING_STRATIFIED,  //!< all values of the uniq tag have the same chance
+    JUKEBOX_WEIGHTING_UNKNOWN      //!< jukebox weighting is unknown
+};
+
 /**
  * MPD connection states
  */
@@ -104,6 +116,7 @@ struct t_jukebox_state {
     struct t_tags uniq_tag;      //!< single tag for the jukebox uniq constraint
     struct t_list *queue;          //!< the jukebox queue itself
     bool ignore_hated;             //!< ignores hated songs for the jukebox mode
+    enum jukebox_weightings weighting; //!< weighting of the random selection
     sds filter_include;            //!< mpd search filter to include songs / albums
     sds filter_exclude;            //!< mpd search filter to exclude songs / albums
     unsigned min_song_duration;    //!< minimum song duration
@@ -112,6 +125,17 @@ struct t_jukebox_state {
     sds last_error;                //!< last jukebox error message
 };
 
+/**
+ * In-memory index of the webradio favorites, reloaded after changes
+ */
+struct t_webradio_favorites {
+    sds dirname;                   //!< webradio favorites directory
+    rax *list;                     //!< folded m3u fields + filename -> entry, sort order of the list
+    rax *files;                    //!< m3u filename -> entry, the filename is the sanitized stream uri
+    int inotify_fd;                //!< inotify watch for the directory, -1 if not available
+    bool valid;                    //!< false if the index must be reloaded
+};
+
 /**
  * Holds partition specific states
  */
@@ -140,6 +164,7 @@ struct t_partition_state {
     bool auto_play;                        //!< start play if queue changes
     bool player_error;                     //!< signals mpd player error condition
     struct t_jukebox_state jukebox;        //!< jukebox
+    struct t_webradio_favorites *webradio_favorites; //!< pointer to the shared webradio favorites index, NULL if not available
     //partition
     sds name;                              //!< partition name
     sds highlight_color;                   //!< highlight color
@@ -173,6 +198,12 @@ struct t_stickerdb_state {
     struct mpd_connection *conn;           //!< mpd connection object from libmpdclient
     enum mpd_conn_states conn_state;       //!< mpd connection state
     sds name;                              //!< name for logging
+    //sticker cache
+    rax *cache;                            //!< uri -> int64_t[STICKER_COUNT], mirror of the myMPD stickers, NULL = disabled
+    bool cache_dirty;                      //!< cache must be rebuilt before the next lookup
+    unsigned cache_own_changes;            //!< sticker changes by myMPD since the last idle command
+    bool batch_idle_exited;                //!< stickerdb_batch_begin has left the idle mode
+    rax *batch_stickers;                   //!< uri -> int64_t[STICKER_COUNT], fetched by stickerdb_batch_prefetch
 };
 
 /**
@@ -220,6 +251,7 @@ struct t_mympd_state {
     struct t_mpd_state *mpd_state;                //!< mpd state shared across partitions
     struct t_partition_state *partition_state;    //!< list of partition states
     struct t_stickerdb_state *stickerdb;          //!< states for stickerdb connection
+    struct t_webradio_favorites webradio_favorites; //!< webradio favorites index
     struct mympd_pfds pfds;                       //!< fds to poll in the event loop
     struct t_timer_list timer_list;               //!< list of timers
     struct t_list home_list;                      //!< list of home icons
@@ -262,6 +294,9 @@ struct t_mympd_state {
     sds booklet_name;                             //!< name of the booklet files
     sds info_txt_name;                            //!< name of album info files
     struct t_cache album_cache;                   //!< the album cache created by the mpd_worker thread
+    struct t_album_cache_index album_cache_index; //!< sort indexes for the album cache
+    struct t_list album_cache_update_paths;       //!< database paths updated since the last album cache creation
+    struct t_song_index song_index;               //!< the song index created by the mpd_worker thread
     unsigned last_played_count;                   //!< number of songs to keep in the last played list (disk + memory)
 };
 
@@ -0,0 +1,217 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/lib/song_index.h"
+
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/sds_extras.h"
+#include "src/mpd_client/tags.h"
+
+/*
+ The song index holds only the song attributes that are needed for the random song selection.
+ The tag values are fetched with mpd_client_get_tag_value_string to get the same
+ values as the selection from the mpd database.
+*/
+
+// private definitions
+
+#define SONG_INDEX_SIZE_MIN 1024
+
+static int get_tag_idx(const struct t_song_index *song_index, enum mpd_tag_type tag);
+
+// public functions
+
+/**
+ * Initializes the song index
+ * @param song_index pointer to the song index
+ * @return true on success, else false
+ */
+bool song_index_init(struct t_song_index *song_index) {
+    song_index->songs = NULL;
+    song_index->len = 0;
+    song_index->size = 0;
+    song_index->tags.len = 0;
+    song_index->db_mtime = 0;
+    int rc = pthread_rwlock_init(&song_index->rwlock, NULL);
+    if (rc == 0) {
+        return true;
+    }
+    MYMPD_LOG_ERROR(NULL, "Can not init lock");
+    MYMPD_LOG_ERRNO(NULL, rc);
+    return false;
+}
+
+/**
+ * Frees all songs of the song index, the lock is not touched
+ * @param song_index pointer to the song index
+ */
+void song_index_clear(struct t_song_index *song_index) {
+    for (unsigned i = 0; i < song_index->len; i++) {
+        struct t_song_index_entry *entry = &song_index->songs[i];
+        FREE_SDS(entry->uri);
+        if (entry->values != NULL) {
+            for (size_t j = 0; j < song_index->tags.len; j++) {
+                FREE_SDS(entry->values[j]);
+            }
+            FREE_PTR(entry->values);
+        }
+    }
+    FREE_PTR(song_index->songs);
+    song_index->len = 0;
+    song_index->size = 0;
+}
+
+/**
+ * Frees all songs and destroys the lock
+ * @param song_index pointer to the song index
+ * @return true on success, else false
+ */
+bool song_index_free(struct t_song_index *song_index) {
+    song_index_clear(song_index);
+    int rc = pthread_rwlock_destroy(&song_index->rwlock);
+    if (rc == 0) {
+        return true;
+    }
+    MYMPD_LOG_ERROR(NULL, "Can not destroy lock");
+    MYMPD_LOG_ERRNO(NULL, rc);
+    return false;
+}
+
+/**
+ * Appends a song to the song index.
+ * The tags of the song index must be set before.
+ * @param song_index pointer to the song index
+ * @param song song to add
+ */
+void song_index_add(struct t_song_index *song_index, const struct mpd_song *song) {
+    if (song_index->len == song_index->size) {
+        song_index->size = song_index->size == 0
+            ? SONG_INDEX_SIZE_MIN
+            : song_index->size * 2;
+        song_index->songs = realloc_assert(song_index->songs, song_index->size * sizeof(struct t_song_index_entry));
+    }
+    struct t_song_index_entry *entry = &song_index->songs[song_index->len++];
+    entry->uri = sdsnew(mpd_song_get_uri(song));
+    entry->duration = mpd_song_get_duration(song);
+    entry->last_modified = mpd_song_get_last_modified(song);
+    if (song_index->tags.len > 0) {
+        entry->values = malloc_assert(song_index->tags.len * sizeof(sds));
+        for (size_t i = 0; i < song_index->tags.len; i++) {
+            entry->values[i] = mpd_client_get_tag_value_string(song, song_index->tags.tags[i], sdsempty());
+        }
+    }
+    else {
+        entry->values = NULL;
+    }
+}
+
+/**
+ * Replaces the songs of the song index with the songs of another song index.
+ * The caller must hold the write lock of dst, src is empty afterwards.
+ * @param dst song index to replace
+ * @param src song index with the new songs
+ */
+void song_index_replace(struct t_song_index *dst, struct t_song_index *src) {
+    song_index_clear(dst);
+    dst->songs = src->songs;
+    dst->len = src->len;
+    dst->size = src->size;
+    dst->tags = src->tags;
+    dst->db_mtime = src->db_mtime;
+    src->songs = NULL;
+    src->len = 0;
+    src->size = 0;
+}
+
+/**
+ * Checks if the values of the tag are in the song index
+ * @param song_index pointer to the song index
+ * @param tag mpd tag type
+ * @return true if the tag is indexed, else false
+ */
+bool song_index_has_tag(const struct t_song_index *song_index, enum mpd_tag_type tag) {
+    return get_tag_idx(song_index, tag) > -1;
+}
+
+/**
+ * Gets the indexed tag value of a song
+ * @param song_index pointer to the song index
+ * @param entry the song
+ * @param tag mpd tag type
+ * @return the tag value or NULL if the tag is not indexed
+ */
+const char *song_index_get_value(const struct t_song_index *song_index, const struct t_song_index_entry *entry,
+        enum mpd_tag_type tag)
+{
+    int idx = get_tag_idx(song_index, tag);
+    return idx > -1
+        ? entry->values[idx]
+        : NULL;
+}
+
+/**
+ * Acquires a read lock
+ * @param song_index pointer to the song index
+ * @return true on success, else false
+ */
+bool song_index_get_read_lock(struct t_song_index *song_index) {
+    int rc = pthread_rwlock_rdlock(&song_index->rwlock);
+    if (rc == 0) {
+        return true;
+    }
+    MYMPD_LOG_ERROR(NULL, "Can not get read lock");
+    MYMPD_LOG_ERRNO(NULL, rc);
+    return false;
+}
+
+/**
+ * Acquires a write lock
+ * @param song_index pointer to the song index
+ * @return true on success, else false
+ */
+bool song_index_get_write_lock(struct t_song_index *song_index) {
+    int rc = pthread_rwlock_wrlock(&song_index->rwlock);
+    if (rc == 0) {
+        return true;
+    }
+    MYMPD_LOG_ERROR(NULL, "Can not get write lock");
+    MYMPD_LOG_ERRNO(NULL, rc);
+    return false;
+}
+
+/**
+ * Frees the lock
+ * @param song_index pointer to the song index
+ * @return true on success, else false
+ */
+bool song_index_release_lock(struct t_song_index *song_index) {
+    int rc = pthread_rwlock_unlock(&song_index->rwlock);
+    if (rc == 0) {
+        return true;
+    }
+    MYMPD_LOG_ERROR(NULL, "Can not free the lock");
+    MYMPD_LOG_ERRNO(NULL, rc);
+    return false;
+}
+
+// private functions
+
+/**
+ * Gets the position of the tag in the values array
+ * @param song_index pointer to the song index
+ * @param tag mpd tag type
+ * @return position or -1 if the tag is not indexed
+ */
+static int get_tag_idx(const struct t_song_index *song_index, enum mpd_tag_type tag) {
+    for (size_t i = 0; i < song_index->tags.len; i++) {
+        if (song_index->tags.tags[i] == tag) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
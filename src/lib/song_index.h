@@ -0,0 +1,55 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_SONG_INDEX_H
+#define MYMPD_SONG_INDEX_H
+
+#include "dist/libmympdclient/include/mpd/client.h"
+#include "dist/sds/sds.h"
+#include "src/lib/fields.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * A song in the song index
+ */
+struct t_song_index_entry {
+    sds uri;                 //!< song uri
+    sds *values;             //!< values of the indexed tags, in the order of the index tags
+    unsigned duration;       //!< song duration in seconds
+    time_t last_modified;    //!< last modification time of the song
+};
+
+/**
+ * Compact resident index of all songs in the mpd database.
+ * It is created by the mpd_worker thread alongside the album cache
+ * and used for the random song selection.
+ */
+struct t_song_index {
+    struct t_song_index_entry *songs;  //!< array of songs, NULL if the index is not created
+    unsigned len;                      //!< number of songs
+    unsigned size;                     //!< allocated number of songs
+    struct t_tags tags;                //!< tags with values in the index
+    time_t db_mtime;                   //!< modification time of the mpd database the index was created from
+    pthread_rwlock_t rwlock;           //!< pthreads read-write lock object
+};
+
+bool song_index_init(struct t_song_index *song_index);
+void song_index_clear(struct t_song_index *song_index);
+bool song_index_free(struct t_song_index *song_index);
+void song_index_add(struct t_song_index *song_index, const struct mpd_song *song);
+void song_index_replace(struct t_song_index *dst, struct t_song_index *src);
+bool song_index_has_tag(const struct t_song_index *song_index, enum mpd_tag_type tag);
+const char *song_index_get_value(const struct t_song_index *song_index, const struct t_song_index_entry *entry,
+        enum mpd_tag_type tag);
+
+bool song_index_get_read_lock(struct t_song_index *song_index);
+bool song_index_get_write_lock(struct t_song_index *song_index);
+bool song_index_release_lock(struct t_song_index *song_index);
+
+#endif
@@ -0,0 +1,287 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/lib/thumbnail.h"
+
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/mimetype.h"
+#include "src/lib/sds_extras.h"
+
+#include <jpeglib.h>
+#include <png.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Private definitions
+ */
+
+/**
+ * Decoded image with 3 bytes per pixel
+ */
+struct t_rgb_image {
+    unsigned char *pixels;  //!< rgb pixels, row by row
+    unsigned width;         //!< width in pixels
+    unsigned height;        //!< height in pixels
+};
+
+/**
+ * libjpeg error manager that returns to the caller instead of exiting
+ */
+struct t_jpeg_error {
+    struct jpeg_error_mgr mgr;  //!< libjpeg error manager
+    jmp_buf jmp;                //!< return point
+};
+
+static void jpeg_error_exit(j_common_ptr cinfo);
+static bool decode_jpeg(sds image, unsigned max_size, struct t_rgb_image *rgb);
+static bool decode_png(sds image, struct t_rgb_image *rgb);
+static void downscale(struct t_rgb_image *src, struct t_rgb_image *dst);
+static bool encode_jpeg(struct t_rgb_image *rgb, sds *thumbnail);
+
+/**
+ * Public functions
+ */
+
+/**
+ * Creates a jpeg thumbnail that fits in a box of max_size x max_size pixels.
+ * Supported source formats are jpeg and png.
+ * @param image the source image
+ * @param max_size maximum width and height of the thumbnail
+ * @param thumbnail pointer to already allocated sds string to append the jpeg
+ * @return true on success, false if the format is not supported,
+ *         the image could not be decoded or is already small enough
+ */
+bool thumbnail_create(sds image, unsigned max_size, sds *thumbnail) {
+    const char *mime_type = get_mime_type_by_magic_stream(image);
+    struct t_rgb_image src = { NULL, 0, 0 };
+    bool rc = false;
+    if (strcmp(mime_type, "image/jpeg") == 0) {
+        rc = decode_jpeg(image, max_size, &src);
+    }
+    else if (strcmp(mime_type, "image/png") == 0) {
+        rc = decode_png(image, &src);
+    }
+    else {
+        MYMPD_LOG_DEBUG(NULL, "Thumbnails for %s images are not supported", mime_type);
+    }
+    if (rc == false) {
+        FREE_PTR(src.pixels);
+        return false;
+    }
+    if (src.width <= max_size &&
+        src.height <= max_size &&
+        sdslen(image) <= THUMBNAIL_PASSTHROUGH_BYTES)
+    {
+        //nothing to gain
+        FREE_PTR(src.pixels);
+        return false;
+    }
+    struct t_rgb_image dst;
+    if (src.width >= src.height) {
+        dst.width = src.width < max_size ? src.width : max_size;
+        dst.height = (unsigned)(((unsigned long)src.height * dst.width + src.width / 2) / src.width);
+    }
+    else {
+        dst.height = src.height < max_size ? src.height : max_size;
+        dst.width = (unsigned)(((unsigned long)src.width * dst.height + src.height / 2) / src.height);
+    }
+    if (dst.width == 0) {
+        dst.width = 1;
+    }
+    if (dst.height == 0) {
+        dst.height = 1;
+    }
+    dst.pixels = malloc_assert((size_t)dst.width * dst.height * 3);
+    downscale(&src, &dst);
+    FREE_PTR(src.pixels);
+    rc = encode_jpeg(&dst, thumbnail);
+    FREE_PTR(dst.pixels);
+    MYMPD_LOG_DEBUG(NULL, "Created thumbnail %ux%u: %lu bytes", dst.width, dst.height, (unsigned long)sdslen(*thumbnail));
+    return rc;
+}
+
+/**
+ * Private functions
+ */
+
+/**
+ * Error handler for libjpeg, jumps back to the caller
+ * @param cinfo libjpeg struct
+ */
+static void jpeg_error_exit(j_common_ptr cinfo) {
+    struct t_jpeg_error *err = (struct t_jpeg_error *)cinfo->err;
+    char msg[JMSG_LENGTH_MAX];
+    (*cinfo->err->format_message)(cinfo, msg);
+    MYMPD_LOG_WARN(NULL, "libjpeg: %s", msg);
+    longjmp(err->jmp, 1);
+}
+
+/**
+ * Decodes a jpeg image.
+ * libjpeg scales the image down by a power of two while decoding,
+ * as long as it stays larger than max_size.
+ * @param image the jpeg image
+ * @param max_size maximum width and height of the thumbnail
+ * @param rgb struct to populate, the pixels must be freed by the caller
+ * @return true on success, else false
+ */
+static bool decode_jpeg(sds image, unsigned max_size, struct t_rgb_image *rgb) {
+    struct jpeg_decompress_struct cinfo;
+    struct t_jpeg_error err;
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpeg_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, (const unsigned char *)image, (unsigned long)sdslen(image));
+    if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    unsigned denom = 1;
+    while (denom < 8 &&
+           cinfo.image_width / (denom * 2) >= max_size &&
+           cinfo.image_height / (denom * 2) >= max_size)
+    {
+        denom *= 2;
+    }
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = denom;
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_calc_output_dimensions(&cinfo);
+    if ((unsigned long)cinfo.output_width * cinfo.output_height > THUMBNAIL_PIXELS_MAX) {
+        MYMPD_LOG_WARN(NULL, "Image is too large for a thumbnail");
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_start_decompress(&cinfo);
+    rgb->width = cinfo.output_width;
+    rgb->height = cinfo.output_height;
+    size_t stride = (size_t)rgb->width * 3;
+    rgb->pixels = malloc_assert(stride * rgb->height);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        unsigned char *row = rgb->pixels + stride * cinfo.output_scanline;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+/**
+ * Decodes a png image, transparency is blended with white
+ * @param image the png image
+ * @param rgb struct to populate, the pixels must be freed by the caller
+ * @return true on success, else false
+ */
+static bool decode_png(sds image, struct t_rgb_image *rgb) {
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (png_image_begin_read_from_memory(&png, image, sdslen(image)) == 0) {
+        MYMPD_LOG_WARN(NULL, "libpng: %s", png.message);
+        return false;
+    }
+    if ((unsigned long)png.width * png.height > THUMBNAIL_PIXELS_MAX) {
+        MYMPD_LOG_WARN(NULL, "Image is too large for a thumbnail");
+        png_image_free(&png);
+        return false;
+    }
+    png.format = PNG_FORMAT_RGB;
+    rgb->width = png.width;
+    rgb->height = png.height;
+    rgb->pixels = malloc_assert(PNG_IMAGE_SIZE(png));
+    png_color background = { 255, 255, 255 };
+    if (png_image_finish_read(&png, &background, rgb->pixels, 0, NULL) == 0) {
+        MYMPD_LOG_WARN(NULL, "libpng: %s", png.message);
+        png_image_free(&png);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Downscales an image by averaging the source pixels covered by each destination pixel
+ * @param src source image
+ * @param dst destination image with allocated pixels, must not be larger than src
+ */
+static void downscale(struct t_rgb_image *src, struct t_rgb_image *dst) {
+    size_t src_stride = (size_t)src->width * 3;
+    for (unsigned y = 0; y < dst->height; y++) {
+        unsigned y0 = (unsigned)((unsigned long)y * src->height / dst->height);
+        unsigned y1 = (unsigned)((unsigned long)(y + 1) * src->height / dst->height);
+        if (y1 <= y0) {
+            y1 = y0 + 1;
+        }
+        for (unsigned x = 0; x < dst->width; x++) {
+            unsigned x0 = (unsigned)((unsigned long)x * src->width / dst->width);
+            unsigned x1 = (unsigned)((unsigned long)(x + 1) * src->width / dst->width);
+            if (x1 <= x0) {
+                x1 = x0 + 1;
+            }
+            unsigned long sum[3] = { 0, 0, 0 };
+            for (unsigned sy = y0; sy < y1; sy++) {
+                const unsigned char *p = src->pixels + src_stride * sy + (size_t)x0 * 3;
+                for (unsigned sx = x0; sx < x1; sx++) {
+                    sum[0] += p[0];
+                    sum[1] += p[1];
+                    sum[2] += p[2];
+                    p += 3;
+                }
+            }
+            unsigned long count = (unsigned long)(y1 - y0) * (x1 - x0);
+            unsigned char *d = dst->pixels + ((size_t)y * dst->width + x) * 3;
+            d[0] = (unsigned char)((sum[0] + count / 2) / count);
+            d[1] = (unsigned char)((sum[1] + count / 2) / count);
+            d[2] = (unsigned char)((sum[2] + count / 2) / count);
+        }
+    }
+}
+
+/**
+ * Encodes the image as jpeg
+ * @param rgb the image
+ * @param thumbnail pointer to already allocated sds string to append the jpeg
+ * @return true on success, else false
+ */
+static bool encode_jpeg(struct t_rgb_image *rgb, sds *thumbnail) {
+    struct jpeg_compress_struct cinfo;
+    struct t_jpeg_error err;
+    unsigned char *out = NULL;
+    unsigned long out_len = 0;
+    cinfo.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpeg_error_exit;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_compress(&cinfo);
+        free(out);
+        return false;
+    }
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &out, &out_len);
+    cinfo.image_width = rgb->width;
+    cinfo.image_height = rgb->height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, THUMBNAIL_JPEG_QUALITY, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    size_t stride = (size_t)rgb->width * 3;
+    while (cinfo.next_scanline < cinfo.image_height) {
+        unsigned char *row = rgb->pixels + stride * cinfo.next_scanline;
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    *thumbnail = sdscatlen(*thumbnail, out, out_len);
+    free(out);
+    return true;
+}
@@ -65,10 +65,6 @@ const char *__asan_default_options(void) {
 #endif
 
 //global variables
-_Atomic int mpd_worker_threads;
-#ifdef MYMPD_ENABLE_LUA
-    _Atomic int script_worker_threads;
-#endif
 //signal handler
 sig_atomic_t s_signal_received;
 //message queues
@@ -76,7 +72,6 @@ struct t_mympd_queue *web_server_queue;
 struct t_mympd_queue *mympd_api_queue;
 #ifdef MYMPD_ENABLE_LUA
     struct t_mympd_queue *script_queue;
-    struct t_mympd_queue *script_worker_queue;
 #endif
 
 /**
@@ -92,10 +87,8 @@ static void mympd_signal_handler(int sig_num) {
             //Set loop end condition for threads
             s_signal_received = sig_num;
             //Wakeup queue loops
-            pthread_cond_signal(&mympd_api_queue->wakeup);
             #ifdef MYMPD_ENABLE_LUA
-                pthread_cond_signal(&script_queue->wakeup);
-                pthread_cond_signal(&script_worker_queue->wakeup);
+                event_eventfd_write(script_queue->event_fd);
             #endif
             pthread_cond_signal(&web_server_queue->wakeup);
             event_eventfd_write(mympd_api_queue->event_fd);
@@ -372,10 +365,6 @@ int main(int argc, char **argv) {
     #endif
 
     //set initial states
-    mpd_worker_threads = 0;
-    #ifdef MYMPD_ENABLE_LUA
-        script_worker_threads = 0;
-    #endif
     s_signal_received = 0;
     struct t_config *config = NULL;
     struct t_mg_user_data *mg_user_data = NULL;
@@ -399,11 +388,10 @@ int main(int argc, char **argv) {
     //only owner should have rw access
     umask(0077);
 
-    mympd_api_queue = mympd_queue_create("mympd_api_queue", QUEUE_TYPE_REQUEST, true);
+    mympd_api_queue = mympd_queue_create_mpsc("mympd_api_queue", QUEUE_TYPE_REQUEST, MSG_QUEUE_RING_SIZE);
     web_server_queue = mympd_queue_create("web_server_queue", QUEUE_TYPE_RESPONSE, false);
     #ifdef MYMPD_ENABLE_LUA
-        script_queue = mympd_queue_create("script_queue", QUEUE_TYPE_REQUEST, false);
-        script_worker_queue = mympd_queue_create("script_worker_queue", QUEUE_TYPE_RESPONSE, false);
+        script_queue = mympd_queue_create_mpsc("script_queue", QUEUE_TYPE_REQUEST, MSG_QUEUE_RING_SIZE);
     #endif
 
     //mympd config defaults
@@ -638,7 +626,6 @@ int main(int argc, char **argv) {
     mympd_queue_free(mympd_api_queue);
     #ifdef MYMPD_ENABLE_LUA
         mympd_queue_free(script_queue);
-        mympd_queue_free(script_worker_queue);
     #endif
 
     //free config
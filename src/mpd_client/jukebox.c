@@ -77,6 +77,43 @@ const char *jukebox_mode_lookup(enum jukebox_modes mode) {
     return NULL;
 }
 
+/**
+ * Parses the string to the jukebox weighting
+ * @param str string to parse
+ * @return jukebox weighting
+ */
+enum jukebox_weightings jukebox_weighting_parse(const char *str) {
+    if (strcmp(str, "off") == 0) {
+        return JUKEBOX_WEIGHTING_OFF;
+    }
+    if (strcmp(str, "stickers") == 0) {
+        return JUKEBOX_WEIGHTING_STICKERS;
+    }
+    if (strcmp(str, "stratified") == 0) {
+        return JUKEBOX_WEIGHTING_STRATIFIED;
+    }
+    return JUKEBOX_WEIGHTING_UNKNOWN;
+}
+
+/**
+ * Returns the jukebox weighting as string
+ * @param weighting the jukebox weighting
+ * @return jukebox weighting as string
+ */
+const char *jukebox_weighting_lookup(enum jukebox_weightings weighting) {
+    switch (weighting) {
+        case JUKEBOX_WEIGHTING_OFF:
+            return "off";
+        case JUKEBOX_WEIGHTING_STICKERS:
+            return "stickers";
+        case JUKEBOX_WEIGHTING_STRATIFIED:
+            return "stratified";
+        case JUKEBOX_WEIGHTING_UNKNOWN:
+            return NULL;
+    }
+    return NULL;
+}
+
 /**
  * Clears the jukebox queue of all partitions.
  * @param mympd_state pointer to central myMPD state.
@@ -11,6 +11,8 @@
 
 enum jukebox_modes jukebox_mode_parse(const char *str);
 const char *jukebox_mode_lookup(enum jukebox_modes mode);
+enum jukebox_weightings jukebox_weighting_parse(const char *str);
+const char *jukebox_weighting_lookup(enum jukebox_weightings weighting);
 void jukebox_clear_all(struct t_mympd_state *mympd_state);
 void jukebox_disable(struct t_partition_state *partition_state);
 bool jukebox_run(struct t_mympd_state *mympd_state, struct t_partition_state *partition_state,
@@ -9,13 +9,17 @@
 
 #include "src/lib/convert.h"
 #include "src/lib/log.h"
+#include "src/lib/mem.h"
 #include "src/lib/random.h"
 #include "src/lib/sds_extras.h"
+#include "src/lib/sticker.h"
 #include "src/mpd_client/errorhandler.h"
 #include "src/mpd_client/search_local.h"
 #include "src/mpd_client/stickerdb.h"
 #include "src/mpd_client/tags.h"
 
+#include <limits.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -23,21 +27,69 @@
  * Private definitions
  */
 
-static bool check_min_duration(const struct mpd_song *song, unsigned min_duration);
-static bool check_max_duration(const struct mpd_song *song, unsigned max_duration);
-static bool check_expression(const struct mpd_song *song, struct t_tags *tags,
+static bool check_min_duration(unsigned duration, unsigned min_duration);
+static bool check_max_duration(unsigned duration, unsigned max_duration);
+static bool check_expression(const struct mpd_song *song, struct t_tags *tags, const struct t_cache *album_cache,
         struct t_list *include_expr_list, struct t_list *exclude_expr_list);
 static bool check_not_hated(rax *stickers_like, const char *uri, bool ignore_hated);
 static bool check_last_played_album(rax *stickers_last_played, const char *uri, time_t since, enum album_modes album_mode);
 static bool check_last_played(rax *stickers_last_played, const char *uri, time_t since);
-static long check_uniq_tag(const char *uri, const char *value, struct t_list *queue_list, struct t_list *add_list);
 static bool add_uri_constraint_or_expression(const char *include_expression, struct t_partition_state *partition_state);
 
-enum random_add_uniq_result {
-    RANDOM_ADD_UNIQ_IN_QUEUE = -2,
-    RANDOM_ADD_UNIQ_IS_UNIQ = -1
+/**
+ * A selected entry of the reservoir
+ */
+struct t_random_select_entry {
+    sds key;            //!< song uri or albumid
+    sds value;          //!< value of the uniq tag
+    unsigned lineno;    //!< number of the matching candidate
+    void *user_data;    //!< pointer to the album
+    double prio;        //!< sampling key for the weighted selection
+};
+
+/**
+ * State of a random selection with reservoir sampling.
+ * The keys and uniq tag values of the queue, the existing add_list entries and
+ * the reservoir are kept in radix trees to check the uniq constraint.
+ */
+struct t_random_select {
+    struct t_random_select_entry *reservoir;  //!< the selected entries
+    unsigned len;                             //!< number of selected entries
+    unsigned size;                            //!< number of entries to select
+    unsigned lineno;                          //!< number of matching candidates + 1
+    unsigned skipno;                          //!< number of skipped candidates
+    bool weighted;                            //!< weighted selection, the reservoir is a min-heap of prio
+    rax *keys;                                //!< taken keys, NULL if the uniq constraint is disabled
+    rax *values;                              //!< taken uniq tag values
+};
+
+/**
+ * Snapshot of the values for the weighted selection, fetched once per selection
+ */
+struct t_random_select_weights {
+    enum jukebox_weightings weighting;  //!< the weighting
+    rax *stickers_rating;               //!< rating stickers
+    rax *stickers_like;                 //!< like stickers, owned by the caller
+    rax *stickers_play_count;           //!< playCount stickers
+    rax *stickers_skip_count;           //!< skipCount stickers
+    rax *strata;                        //!< uniq tag value -> number of songs / albums
 };
 
+static void random_select_init(struct t_random_select *rs, unsigned size, struct t_list *queue_list, struct t_list *add_list,
+        bool weighted);
+static bool random_select_check_uniq(struct t_random_select *rs, const char *key, const char *value);
+static void random_select_add(struct t_random_select *rs, const char *key, const char *value, void *user_data, double weight);
+static void random_select_heap_fix(struct t_random_select *rs, unsigned pos);
+static void random_select_finish(struct t_random_select *rs, struct t_list *add_list);
+static bool random_select_from_index(struct t_partition_state *partition_state, struct t_song_index *song_index,
+        struct t_random_select *rs, struct t_random_select_weights *weights, struct t_list *queue_list,
+        struct t_random_add_constraints *constraints, rax *stickers_last_played, rax *stickers_like, time_t since);
+static void weights_init(struct t_random_select_weights *weights, enum jukebox_weightings weighting);
+static void weights_clear(struct t_random_select_weights *weights);
+static void weights_count_stratum(struct t_random_select_weights *weights, const char *value);
+static double weights_get(struct t_random_select_weights *weights, const char *uri, const char *value);
+static int64_t get_sticker_int(rax *stickers, const char *uri, int64_t default_value);
+
 /*
  * Public functions
  */
@@ -62,18 +114,19 @@ unsigned random_select_albums(struct t_partition_state *partition_state, struct
         return add_list->length;
     }
 
-    unsigned initial_length = add_list->length;
-    unsigned add_list_expected_len = add_albums;
     if (add_list->length >= add_albums) {
         return add_list->length;
     }
-    add_albums = add_albums - add_list->length;
-
-    MYMPD_LOG_DEBUG(partition_state->name, "Add list current length: %u", initial_length);
-    MYMPD_LOG_DEBUG(partition_state->name, "Add list expected length: %u", add_list_expected_len);
-
-    unsigned skipno = 0;
-    unsigned lineno = 1;
+    MYMPD_LOG_DEBUG(partition_state->name, "Add list current length: %u", add_list->length);
+    MYMPD_LOG_DEBUG(partition_state->name, "Add list expected length: %u", add_albums);
+
+    // song stickers can not be applied to albums
+    struct t_random_select_weights weights;
+    weights_init(&weights, constraints->weighting == JUKEBOX_WEIGHTING_STRATIFIED
+        ? JUKEBOX_WEIGHTING_STRATIFIED
+        : JUKEBOX_WEIGHTING_OFF);
+    struct t_random_select rs;
+    random_select_init(&rs, add_albums - add_list->length, queue_list, add_list, weights.weighting != JUKEBOX_WEIGHTING_OFF);
     time_t since = time(NULL);
     since = since - (time_t)(constraints->last_played * 3600);
     sds albumid = sdsempty();
@@ -95,6 +148,14 @@ unsigned random_select_albums(struct t_partition_state *partition_state, struct
     sds tag_value = sdsempty();
     raxIterator iter;
     raxStart(&iter, album_cache->cache);
+    if (weights.weighting == JUKEBOX_WEIGHTING_STRATIFIED) {
+        raxSeek(&iter, "^", NULL, 0);
+        while (raxNext(&iter)) {
+            sdsclear(tag_value);
+            tag_value = mpd_client_get_tag_value_string((struct mpd_song *)iter.data, constraints->uniq_tag, tag_value);
+            weights_count_stratum(&weights, tag_value);
+        }
+    }
     raxSeek(&iter, "^", NULL, 0);
     while (raxNext(&iter)) {
         struct mpd_song *album= (struct mpd_song *)iter.data;
@@ -106,31 +167,13 @@ unsigned random_select_albums(struct t_partition_state *partition_state, struct
         // we use the song uri in the album cache for enforcing last_played constraint,
         // because we do not know when an album was last played fully
         if (check_last_played_album(stickers_last_played, mpd_song_get_uri(album), since, partition_state->config->albums.mode) == true &&
-            check_expression(album, &partition_state->mpd_state->tags_mpd, include_expr_list, exclude_expr_list) == true &&
-            check_uniq_tag(albumid, tag_value, queue_list, add_list) == RANDOM_ADD_UNIQ_IS_UNIQ)
+            check_expression(album, &partition_state->mpd_state->tags_mpd, album_cache, include_expr_list, exclude_expr_list) == true &&
+            random_select_check_uniq(&rs, albumid, tag_value) == true)
         {
-            if (randrange(0, lineno) < add_albums) {
-                if (add_list->length < add_list_expected_len) {
-                    // append to fill the queue
-                    if (list_push(add_list, albumid, lineno, tag_value, album) == false) {
-                        MYMPD_LOG_ERROR(partition_state->name, "Can't push element to list");
-                    }
-                }
-                else {
-                    // replace at initial_length + random position
-                    // existing entries should not be touched
-                    unsigned pos = add_albums > 1
-                        ? initial_length + randrange(0, add_albums)
-                        : 0;
-                    if (list_replace(add_list, pos, albumid, lineno, tag_value, album) == false) {
-                        MYMPD_LOG_ERROR(partition_state->name, "Can't replace list element pos %u", pos);
-                    }
-                }
-            }
-            lineno++;
+            random_select_add(&rs, albumid, tag_value, album, weights_get(&weights, albumid, tag_value));
         }
         else {
-            skipno++;
+            rs.skipno++;
         }
     }
     FREE_SDS(albumid);
@@ -141,14 +184,19 @@ unsigned random_select_albums(struct t_partition_state *partition_state, struct
     if (stickers_last_played != NULL) {
         stickerdb_free_find_result(stickers_last_played);
     }
-    MYMPD_LOG_DEBUG(partition_state->name, "Iterated through %u albums, skipped %u", lineno, skipno);
+    weights_clear(&weights);
+    MYMPD_LOG_DEBUG(partition_state->name, "Iterated through %u albums, skipped %u", rs.lineno, rs.skipno);
+    random_select_finish(&rs, add_list);
     return add_list->length;
 }
 
 /**
- * Adds songs to the add_list
+ * Adds songs to the add_list.
+ * Songs from the database are selected from the song index, if it is available
+ * and no include or exclude expressions are set.
  * @param partition_state pointer to myMPD partition state
  * @param stickerdb pointer to stickerdb state
+ * @param song_index pointer to the song index or NULL
  * @param add_songs number of songs expected in add_list
  * @param playlist playlist from which songs are added
  * @param queue_list list of current songs in mpd queue and last played
@@ -157,23 +205,21 @@ unsigned random_select_albums(struct t_partition_state *partition_state, struct
  * @return new length of add_list
  */
 unsigned random_select_songs(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
-        unsigned add_songs, const char *playlist, struct t_list *queue_list, struct t_list *add_list,
+        struct t_song_index *song_index, unsigned add_songs, const char *playlist, struct t_list *queue_list, struct t_list *add_list,
         struct t_random_add_constraints *constraints)
 {
-    unsigned initial_length = add_list->length;
-    unsigned add_list_expected_len = add_songs;
     if (add_list->length >= add_songs) {
         return add_list->length;
     }
-    add_songs = add_list_expected_len - add_list->length;
-
-    MYMPD_LOG_DEBUG(partition_state->name, "Add list current length: %u", initial_length);
-    MYMPD_LOG_DEBUG(partition_state->name, "Add list expected length: %u", add_list_expected_len);
+    MYMPD_LOG_DEBUG(partition_state->name, "Add list current length: %u", add_list->length);
+    MYMPD_LOG_DEBUG(partition_state->name, "Add list expected length: %u", add_songs);
 
+    struct t_random_select_weights weights;
+    weights_init(&weights, constraints->weighting);
+    struct t_random_select rs;
+    random_select_init(&rs, add_songs - add_list->length, queue_list, add_list, weights.weighting != JUKEBOX_WEIGHTING_OFF);
     unsigned start = 0;
     unsigned end = start + MPD_RESULTS_MAX;
-    unsigned skipno = 0;
-    unsigned lineno = 1;
     time_t since = time(NULL) - (time_t)(constraints->last_played * 3600);
 
     bool from_database = strcmp(playlist, "Database") == 0
@@ -185,7 +231,16 @@ unsigned random_select_songs(struct t_partition_state *partition_state, struct t
     if (partition_state->mpd_state->feat.stickers == true) {
         MYMPD_LOG_DEBUG(partition_state->name, "Fetching lastPlayed stickers");
         stickers_last_played = stickerdb_find_stickers_by_name(stickerdb, "lastPlayed");
-        if (constraints->ignore_hated == true) {
+        if (weights.weighting == JUKEBOX_WEIGHTING_STICKERS) {
+            // all like values are needed for the weights, hated songs are filtered by value
+            MYMPD_LOG_DEBUG(partition_state->name, "Fetching stickers for the weighted selection");
+            stickers_like = stickerdb_find_stickers_by_name(stickerdb, "like");
+            weights.stickers_like = stickers_like;
+            weights.stickers_rating = stickerdb_find_stickers_by_name(stickerdb, "rating");
+            weights.stickers_play_count = stickerdb_find_stickers_by_name(stickerdb, "playCount");
+            weights.stickers_skip_count = stickerdb_find_stickers_by_name(stickerdb, "skipCount");
+        }
+        else if (constraints->ignore_hated == true) {
             MYMPD_LOG_DEBUG(partition_state->name, "Fetching stickers for hated songs");
             stickers_like = stickerdb_find_stickers_by_name_value(stickerdb, "like", MPD_STICKER_OP_EQ, "0");
         }
@@ -206,6 +261,26 @@ unsigned random_select_songs(struct t_partition_state *partition_state, struct t
         MYMPD_LOG_DEBUG(NULL, "Exclude expression is empty");
     }
 
+    if (from_database == true &&
+        include_expr_list == NULL &&
+        exclude_expr_list == NULL &&
+        random_select_from_index(partition_state, song_index, &rs, &weights, queue_list, constraints,
+            stickers_last_played, stickers_like, since) == true)
+    {
+        stickerdb_free_find_result(stickers_last_played);
+        stickerdb_free_find_result(stickers_like);
+        weights_clear(&weights);
+        FREE_SDS(tag_value);
+        random_select_finish(&rs, add_list);
+        return add_list->length;
+    }
+    if (weights.weighting == JUKEBOX_WEIGHTING_STRATIFIED) {
+        // the number of songs per stratum is only known for the song index
+        MYMPD_LOG_INFO(partition_state->name, "Stratified selection requires the song index, falling back to uniform selection");
+        weights.weighting = JUKEBOX_WEIGHTING_OFF;
+        rs.weighted = false;
+    }
+
     // Request results from mpd in chunks of MPD_RESULTS_MAX
     // Only MPD 0.24 supports this for playlists
     bool iterate = from_database || partition_state->mpd_state->feat.listplaylist_range;
@@ -240,35 +315,17 @@ unsigned random_select_songs(struct t_partition_state *partition_state, struct t
             tag_value = mpd_client_get_tag_value_string(song, constraints->uniq_tag, tag_value);
             const char *uri = mpd_song_get_uri(song);
 
-            if (check_min_duration(song, constraints->min_song_duration) == true &&
-                check_max_duration(song, constraints->max_song_duration) == true &&
+            if (check_min_duration(mpd_song_get_duration(song), constraints->min_song_duration) == true &&
+                check_max_duration(mpd_song_get_duration(song), constraints->max_song_duration) == true &&
                 check_last_played(stickers_last_played, uri, since) == true &&
                 check_not_hated(stickers_like, uri, constraints->ignore_hated) == true &&
-                check_expression(song, &partition_state->mpd_state->tags_mpd, include_expr_list, exclude_expr_list) == true &&
-                check_uniq_tag(uri, tag_value, queue_list, add_list) == RANDOM_ADD_UNIQ_IS_UNIQ)
+                check_expression(song, &partition_state->mpd_state->tags_mpd, NULL, include_expr_list, exclude_expr_list) == true &&
+                random_select_check_uniq(&rs, uri, tag_value) == true)
             {
-                if (randrange(0, lineno) < add_songs) {
-                    if (add_list->length < add_list_expected_len) {
-                        // append to fill the queue
-                        if (list_push(add_list, uri, lineno, tag_value, NULL) == false) {
-                            MYMPD_LOG_ERROR(partition_state->name, "Can't push element to list");
-                        }
-                    }
-                    else {
-                        // replace at initial_length + random position
-                        // existing entries should not be touched
-                        unsigned pos = add_songs > 1
-                            ? initial_length + randrange(0, add_songs)
-                            : 0;
-                        if (list_replace(add_list, pos, uri, lineno, tag_value, NULL) == false) {
-                            MYMPD_LOG_ERROR(partition_state->name, "Can't replace list element pos %u", pos);
-                        }
-                    }
-                }
-                lineno++;
+                random_select_add(&rs, uri, tag_value, NULL, weights_get(&weights, uri, tag_value));
             }
             else {
-                skipno++;
+                rs.skipno++;
             }
             mpd_song_free(song);
         }
@@ -278,13 +335,15 @@ unsigned random_select_songs(struct t_partition_state *partition_state, struct t
         }
         start = end;
         end = end + MPD_RESULTS_MAX;
-    } while (iterate == true && lineno + skipno > start);
+    } while (iterate == true && rs.lineno + rs.skipno > start);
     stickerdb_free_find_result(stickers_last_played);
     stickerdb_free_find_result(stickers_like);
+    weights_clear(&weights);
     free_search_expression_list(include_expr_list);
     free_search_expression_list(exclude_expr_list);
     FREE_SDS(tag_value);
-    MYMPD_LOG_DEBUG(partition_state->name, "Iterated through %u songs, skipped %u", lineno, skipno);
+    MYMPD_LOG_DEBUG(partition_state->name, "Iterated through %u songs, skipped %u", rs.lineno, rs.skipno);
+    random_select_finish(&rs, add_list);
     return add_list->length;
 }
 
@@ -293,90 +352,400 @@ unsigned random_select_songs(struct t_partition_state *partition_state, struct t
  */
 
 /**
- * Checks for minimum duration constraint for songs
- * @param song mpd song struct to check
- * @param min_duration the minimum duration, 0 for no limit
- * @return if song is longer then min_duration true, else false
+ * Selects songs from the song index, this does not touch mpd
+ * @param partition_state pointer to myMPD partition state
+ * @param song_index pointer to the song index or NULL
+ * @param rs the random selection state
+ * @param weights values for the weighted selection
+ * @param queue_list list of current songs in mpd queue and last played
+ * @param constraints constraints for song selection
+ * @param stickers_last_played last_played stickers or NULL
+ * @param stickers_like like stickers or NULL
+ * @param since timestamp for the last_played constraint
+ * @return true if the song index was used, false if the songs must be selected from mpd
  */
-static bool check_min_duration(const struct mpd_song *song, unsigned min_duration) {
-    return min_duration > 0
-        ? mpd_song_get_duration(song) > min_duration
-        : true;
+static bool random_select_from_index(struct t_partition_state *partition_state, struct t_song_index *song_index,
+        struct t_random_select *rs, struct t_random_select_weights *weights, struct t_list *queue_list,
+        struct t_random_add_constraints *constraints, rax *stickers_last_played, rax *stickers_like, time_t since)
+{
+    if (song_index == NULL ||
+        song_index_get_read_lock(song_index) == false)
+    {
+        return false;
+    }
+    if (song_index->songs == NULL ||
+        ((queue_list != NULL || weights->weighting == JUKEBOX_WEIGHTING_STRATIFIED) &&
+            song_index_has_tag(song_index, constraints->uniq_tag) == false))
+    {
+        MYMPD_LOG_DEBUG(partition_state->name, "Song index is not usable");
+        song_index_release_lock(song_index);
+        return false;
+    }
+    if (weights->weighting == JUKEBOX_WEIGHTING_STRATIFIED) {
+        for (unsigned i = 0; i < song_index->len; i++) {
+            weights_count_stratum(weights, song_index_get_value(song_index, &song_index->songs[i], constraints->uniq_tag));
+        }
+    }
+    for (unsigned i = 0; i < song_index->len; i++) {
+        const struct t_song_index_entry *entry = &song_index->songs[i];
+        const char *tag_value = song_index_get_value(song_index, entry, constraints->uniq_tag);
+        if (tag_value == NULL) {
+            tag_value = "";
+        }
+        if (check_min_duration(entry->duration, constraints->min_song_duration) == true &&
+            check_max_duration(entry->duration, constraints->max_song_duration) == true &&
+            check_last_played(stickers_last_played, entry->uri, since) == true &&
+            check_not_hated(stickers_like, entry->uri, constraints->ignore_hated) == true &&
+            random_select_check_uniq(rs, entry->uri, tag_value) == true)
+        {
+            random_select_add(rs, entry->uri, tag_value, NULL, weights_get(weights, entry->uri, tag_value));
+        }
+        else {
+            rs->skipno++;
+        }
+    }
+    song_index_release_lock(song_index);
+    MYMPD_LOG_DEBUG(partition_state->name, "Iterated through %u songs of the song index, skipped %u", rs->lineno, rs->skipno);
+    return true;
 }
 
 /**
- * Checks for maximum duration constraint for songs
- * @param song mpd song struct to check
- * @param max_duration the maximum duration, 0 for no limit
- * @return if song is shorter then min_duration true, else false
+ * Initializes the random selection state
+ * @param rs the random selection state
+ * @param size number of entries to select
+ * @param queue_list list of current songs in mpd queue and last played,
+ *                   NULL to disable the uniq constraint
+ * @param add_list list with the already selected entries
+ * @param weighted true for the weighted selection
  */
-static bool check_max_duration(const struct mpd_song *song, unsigned max_duration) {
-    return max_duration > 0
-        ? mpd_song_get_duration(song) < max_duration
-        : true;
+static void random_select_init(struct t_random_select *rs, unsigned size, struct t_list *queue_list, struct t_list *add_list,
+        bool weighted)
+{
+    rs->reservoir = malloc_assert(size * sizeof(struct t_random_select_entry));
+    rs->len = 0;
+    rs->size = size;
+    rs->lineno = 1;
+    rs->skipno = 0;
+    rs->weighted = weighted;
+    if (queue_list == NULL) {
+        rs->keys = NULL;
+        rs->values = NULL;
+        return;
+    }
+    rs->keys = raxNew();
+    rs->values = raxNew();
+    struct t_list *lists[2] = { queue_list, add_list };
+    for (unsigned i = 0; i < 2; i++) {
+        struct t_list_node *current = lists[i]->head;
+        while (current != NULL) {
+            raxInsert(rs->keys, (unsigned char *)current->key, sdslen(current->key), NULL, NULL);
+            if (current->value_p != NULL) {
+                raxInsert(rs->values, (unsigned char *)current->value_p, sdslen(current->value_p), NULL, NULL);
+            }
+            current = current->next;
+        }
+    }
 }
 
 /**
- * Checks for the uniq tag constraint for songs
- * @param uri song uri or albumid
- * @param value tag value to check
- * @param queue_list list of current songs in mpd queue and last played
- * @param add_list list to add the entries
- * @return value matches in the mpd queue: RANDOM_ADD_UNIQ_IN_QUEUE
- *         value matches in the add_list: position in the add_list
- *         value does not match, is uniq: RANDOM_ADD_UNIQ_IS_UNIQ
+ * Checks the uniq constraint
+ * @param rs the random selection state
+ * @param key song uri or albumid
+ * @param value value of the uniq tag
+ * @return true if neither the key nor the value are already taken, else false
  */
-static long check_uniq_tag(const char *uri, const char *value, struct t_list *queue_list, struct t_list *add_list)
-{
-    if (queue_list == NULL) {
-        return RANDOM_ADD_UNIQ_IS_UNIQ;
+static bool random_select_check_uniq(struct t_random_select *rs, const char *key, const char *value) {
+    if (rs->keys == NULL) {
+        return true;
     }
-    // check mpd queue and last_played
-    struct t_list_node *current = queue_list->head;
-    while(current != NULL) {
-        if (strcmp(current->key, uri) == 0) {
-            return RANDOM_ADD_UNIQ_IN_QUEUE;
-        }
-        if (value != NULL &&
-            strcmp(current->value_p, value) == 0)
+    return raxFind(rs->keys, (unsigned char *)key, strlen(key)) == raxNotFound &&
+        raxFind(rs->values, (unsigned char *)value, strlen(value)) == raxNotFound;
+}
+
+/**
+ * Adds a matching candidate to the reservoir.
+ * The uniform selection uses reservoir sampling, the weighted selection
+ * keeps the entries with the largest keys u^(1/weight) (A-Res).
+ * @param rs the random selection state
+ * @param key song uri or albumid
+ * @param value value of the uniq tag
+ * @param user_data pointer to the album or NULL
+ * @param weight weight of the candidate, must be greater than zero
+ */
+static void random_select_add(struct t_random_select *rs, const char *key, const char *value, void *user_data, double weight) {
+    unsigned lineno = rs->lineno++;
+    unsigned pos;
+    double prio = 0;
+    if (rs->weighted == true) {
+        // compare the logarithm of the key to preserve precision for small weights
+        double u = (randrange(0, UINT_MAX) + 1.0) / ((double)UINT_MAX + 1.0);
+        prio = log(u) / weight;
+        if (rs->len == rs->size &&
+            prio <= rs->reservoir[0].prio)
         {
-            return RANDOM_ADD_UNIQ_IN_QUEUE;
+            return;
+        }
+        // the root of the min-heap has the smallest key
+        pos = 0;
+    }
+    else {
+        if (randrange(0, lineno) >= rs->size) {
+            return;
+        }
+        pos = randrange(0, rs->size);
+    }
+    struct t_random_select_entry *entry;
+    if (rs->len < rs->size) {
+        // fill the reservoir
+        pos = rs->len++;
+        entry = &rs->reservoir[pos];
+        entry->key = sdsnew(key);
+        entry->value = sdsnew(value);
+    }
+    else {
+        // replace an entry
+        entry = &rs->reservoir[pos];
+        if (rs->keys != NULL) {
+            raxRemove(rs->keys, (unsigned char *)entry->key, sdslen(entry->key), NULL);
+            raxRemove(rs->values, (unsigned char *)entry->value, sdslen(entry->value), NULL);
         }
-        current = current->next;
+        entry->key = sds_replace(entry->key, key);
+        entry->value = sds_replace(entry->value, value);
+    }
+    entry->lineno = lineno;
+    entry->user_data = user_data;
+    entry->prio = prio;
+    if (rs->keys != NULL) {
+        raxInsert(rs->keys, (unsigned char *)entry->key, sdslen(entry->key), NULL, NULL);
+        raxInsert(rs->values, (unsigned char *)entry->value, sdslen(entry->value), NULL, NULL);
     }
+    if (rs->weighted == true) {
+        random_select_heap_fix(rs, pos);
+    }
+}
 
-    // check add_list
-    current = add_list->head;
-    long i = 0;
-    while (current != NULL) {
-        if (strcmp(current->key, uri) == 0) {
-            return i;
+/**
+ * Restores the min-heap order of the reservoir after an entry was changed
+ * @param rs the random selection state
+ * @param pos position of the changed entry
+ */
+static void random_select_heap_fix(struct t_random_select *rs, unsigned pos) {
+    struct t_random_select_entry *heap = rs->reservoir;
+    struct t_random_select_entry tmp;
+    while (pos > 0) {
+        unsigned parent = (pos - 1) / 2;
+        if (heap[parent].prio <= heap[pos].prio) {
+            break;
         }
-        if (value != NULL &&
-            strcmp(current->value_p, value) == 0)
+        tmp = heap[parent];
+        heap[parent] = heap[pos];
+        heap[pos] = tmp;
+        pos = parent;
+    }
+    while (true) {
+        unsigned smallest = pos;
+        unsigned left = 2 * pos + 1;
+        unsigned right = left + 1;
+        if (left < rs->len &&
+            heap[left].prio < heap[smallest].prio)
         {
-            return i;
+            smallest = left;
+        }
+        if (right < rs->len &&
+            heap[right].prio < heap[smallest].prio)
+        {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        tmp = heap[smallest];
+        heap[smallest] = heap[pos];
+        heap[pos] = tmp;
+        pos = smallest;
+    }
+}
+
+/**
+ * Appends the selected entries to the add_list and frees the random selection state
+ * @param rs the random selection state
+ * @param add_list list to add the entries
+ */
+static void random_select_finish(struct t_random_select *rs, struct t_list *add_list) {
+    for (unsigned i = 0; i < rs->len; i++) {
+        struct t_random_select_entry *entry = &rs->reservoir[i];
+        list_push(add_list, entry->key, entry->lineno, entry->value, entry->user_data);
+        FREE_SDS(entry->key);
+        FREE_SDS(entry->value);
+    }
+    FREE_PTR(rs->reservoir);
+    if (rs->keys != NULL) {
+        raxFree(rs->keys);
+        raxFree(rs->values);
+    }
+}
+
+/**
+ * Initializes the values for the weighted selection
+ * @param weights the values to initialize
+ * @param weighting the weighting
+ */
+static void weights_init(struct t_random_select_weights *weights, enum jukebox_weightings weighting) {
+    weights->weighting = weighting;
+    weights->stickers_rating = NULL;
+    weights->stickers_like = NULL;
+    weights->stickers_play_count = NULL;
+    weights->stickers_skip_count = NULL;
+    weights->strata = weighting == JUKEBOX_WEIGHTING_STRATIFIED
+        ? raxNew()
+        : NULL;
+}
+
+/**
+ * Frees the values for the weighted selection
+ * @param weights the values to free
+ */
+static void weights_clear(struct t_random_select_weights *weights) {
+    stickerdb_free_find_result(weights->stickers_rating);
+    stickerdb_free_find_result(weights->stickers_play_count);
+    stickerdb_free_find_result(weights->stickers_skip_count);
+    if (weights->strata != NULL) {
+        raxFree(weights->strata);
+        weights->strata = NULL;
+    }
+}
+
+/**
+ * Counts the songs / albums of a stratum
+ * @param weights values for the weighted selection
+ * @param value value of the uniq tag
+ */
+static void weights_count_stratum(struct t_random_select_weights *weights, const char *value) {
+    if (value == NULL) {
+        value = "";
+    }
+    size_t len = strlen(value);
+    void *data = raxFind(weights->strata, (unsigned char *)value, len);
+    uintptr_t count = data == raxNotFound
+        ? 1
+        : (uintptr_t)data + 1;
+    raxInsert(weights->strata, (unsigned char *)value, len, (void *)count, NULL);
+}
+
+/**
+ * Calculates the weight of a song / album
+ * @param weights values for the weighted selection
+ * @param uri song uri or albumid
+ * @param value value of the uniq tag
+ * @return the weight, always greater than zero
+ */
+static double weights_get(struct t_random_select_weights *weights, const char *uri, const char *value) {
+    switch (weights->weighting) {
+        case JUKEBOX_WEIGHTING_STICKERS: {
+            // unrated songs are treated as average rated
+            int64_t rating = get_sticker_int(weights->stickers_rating, uri, STICKER_RATING_MAX / 2);
+            if (rating < STICKER_RATING_MIN || rating > STICKER_RATING_MAX) {
+                rating = STICKER_RATING_MAX / 2;
+            }
+            double weight = (double)(rating + 1) / (STICKER_RATING_MAX / 2 + 1);
+            int64_t like = get_sticker_int(weights->stickers_like, uri, STICKER_LIKE_NEUTRAL);
+            if (like == STICKER_LIKE_LOVE) {
+                weight *= 2;
+            }
+            else if (like == STICKER_LIKE_HATE) {
+                weight /= 4;
+            }
+            // the chance of often played songs decays slowly
+            int64_t play_count = get_sticker_int(weights->stickers_play_count, uri, 0);
+            int64_t skip_count = get_sticker_int(weights->stickers_skip_count, uri, 0);
+            if (play_count < 0) {
+                play_count = 0;
+            }
+            if (skip_count < 0) {
+                skip_count = 0;
+            }
+            weight /= 1 + log1p((double)play_count);
+            // songs that are usually skipped get a quarter of the chance
+            if (play_count + skip_count > 0) {
+                weight *= 1 - 0.75 * (double)skip_count / (double)(play_count + skip_count);
+            }
+            return weight;
+        }
+        case JUKEBOX_WEIGHTING_STRATIFIED: {
+            // all values of the uniq tag have the same chance
+            void *data = raxFind(weights->strata, (unsigned char *)value, strlen(value));
+            return data == raxNotFound
+                ? 1
+                : 1.0 / (double)(uintptr_t)data;
         }
-        current = current->next;
-        i++;
+        case JUKEBOX_WEIGHTING_OFF:
+        case JUKEBOX_WEIGHTING_UNKNOWN:
+            break;
+    }
+    return 1;
+}
+
+/**
+ * Gets a numeric sticker value
+ * @param stickers stickers of one name
+ * @param uri song uri
+ * @param default_value value if the sticker is not set or invalid
+ * @return the sticker value
+ */
+static int64_t get_sticker_int(rax *stickers, const char *uri, int64_t default_value) {
+    if (stickers == NULL) {
+        return default_value;
+    }
+    void *sticker_value = raxFind(stickers, (unsigned char *)uri, strlen(uri));
+    if (sticker_value == raxNotFound) {
+        return default_value;
     }
-    return RANDOM_ADD_UNIQ_IS_UNIQ;
+    int64_t value;
+    enum str2int_errno rc = str2int64(&value, (sds)sticker_value);
+    return rc == STR2INT_SUCCESS
+        ? value
+        : default_value;
+}
+
+/**
+ * Checks for minimum duration constraint for songs
+ * @param duration song duration to check
+ * @param min_duration the minimum duration, 0 for no limit
+ * @return if song is longer then min_duration true, else false
+ */
+static bool check_min_duration(unsigned duration, unsigned min_duration) {
+    return min_duration > 0
+        ? duration > min_duration
+        : true;
+}
+
+/**
+ * Checks for maximum duration constraint for songs
+ * @param duration song duration to check
+ * @param max_duration the maximum duration, 0 for no limit
+ * @return if song is shorter then min_duration true, else false
+ */
+static bool check_max_duration(unsigned duration, unsigned max_duration) {
+    return max_duration > 0
+        ? duration < max_duration
+        : true;
 }
 
 /**
  * Checks if the song matches the expression lists
  * @param song song to apply the expressions
  * @param tags tags to search
+ * @param album_cache album cache with the case folded tag values, NULL for songs
  * @param include_expr_list include expression list
  * @param exclude_expr_list exclude expression list
  * @return true if song should be included, else false
  */
-static bool check_expression(const struct mpd_song *song, struct t_tags *tags,
+static bool check_expression(const struct mpd_song *song, struct t_tags *tags, const struct t_cache *album_cache,
         struct t_list *include_expr_list, struct t_list *exclude_expr_list)
 {
     // first check exclude expression
     if (exclude_expr_list != NULL &&
-        search_song_expression(song, exclude_expr_list, tags) == true)
+        search_album_expression(song, exclude_expr_list, tags, album_cache) == true)
     {
         // exclude expression matches
         return false;
@@ -384,7 +753,7 @@ static bool check_expression(const struct mpd_song *song, struct t_tags *tags,
     // exclude expression not matched, try include expression
     if (include_expr_list != NULL) {
         // exclude overwrites include
-        return search_song_expression(song, include_expr_list, tags);
+        return search_album_expression(song, include_expr_list, tags, album_cache);
     }
     // no include expression, include all
     return true;
@@ -8,6 +8,7 @@
 #define MYMPD_RANDOM_ADD_H
 
 #include "src/lib/mympd_state.h"
+#include "src/lib/song_index.h"
 
 /**
  * Jukebox constraints for song/album selection
@@ -18,6 +19,7 @@ struct t_random_add_constraints {
     enum mpd_tag_type uniq_tag;  //!< single tag for the jukebox uniq constraint
     unsigned last_played;        //!< only add songs with last_played state older than seconds from now
     bool ignore_hated;           //!< ignores hated songs for the jukebox mode
+    enum jukebox_weightings weighting;  //!< weighting of the random selection
     unsigned min_song_duration;  //!< minimum song duration
     unsigned max_song_duration;  //!< maximum song duration
 };
@@ -26,6 +28,6 @@ unsigned random_select_albums(struct t_partition_state *partition_state, struct
         struct t_cache *album_cache, unsigned add_albums, struct t_list *queue_list, struct t_list *add_list,
         struct t_random_add_constraints *constraints);
 unsigned random_select_songs(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
-        unsigned add_songs, const char *playlist, struct t_list *queue_list, struct t_list *add_list,
+        struct t_song_index *song_index, unsigned add_songs, const char *playlist, struct t_list *queue_list, struct t_list *add_list,
         struct t_random_add_constraints *constraints);
 #endif
@@ -8,6 +8,7 @@
 #include "src/mpd_client/search_local.h"
 
 #include "dist/utf8/utf8.h"
+#include "src/lib/cache_rax_album.h"
 #include "src/lib/datetime.h"
 #include "src/lib/log.h"
 #include "src/lib/mem.h"
@@ -51,17 +52,24 @@ enum search_filters {
  * Struct to hold a parsed search expression triple
  */
 struct t_search_expression {
-    int tag;                   //!< tag to search in
-    enum search_operators op;  //!< search operator
-    sds value;                 //!< value to match
-    time_t value_time;         //!< time value to match
-    pcre2_code *re_compiled;   //!< compiled regex if operator is a regex
+    int tag;                         //!< tag to search in
+    enum search_operators op;        //!< search operator
+    sds value;                       //!< value to match, case folded
+    time_t value_time;               //!< time value to match
+    pcre2_code *re_compiled;         //!< compiled regex if operator is a regex
+    pcre2_match_data *match_data;    //!< match data for the compiled regex
+    sds folded;                      //!< buffer for the case folded tag value
 };
 
+static void compile_search_expression(struct t_search_expression *expr);
+static int64_t get_search_expression_cost(const struct t_search_expression *expr);
+static bool search_expression(const struct mpd_song *song, struct t_list *expr_list, const struct t_tags *tag_types,
+        const struct t_cache *album_cache);
+static bool match_search_expression(struct t_search_expression *expr, const char *value, const char *folded);
 static void *free_search_expression(struct t_search_expression *expr);
 static void free_search_expression_node(struct t_list_node *current);
-static pcre2_code *compile_regex(char *regex_str);
-static bool cmp_regex(pcre2_code *re_compiled, const char *value);
+static pcre2_code *compile_regex(sds regex_str);
+static bool cmp_regex(pcre2_code *re_compiled, pcre2_match_data *match_data, const char *value, size_t len);
 
 /**
  * Public functions
@@ -104,7 +112,9 @@ bool search_mpd_song(const struct mpd_song *song, sds searchstr, const struct t_
 }
 
 /**
- * Parses a mpd search expression
+ * Parses and compiles a mpd search expression.
+ * Values are case folded, regexes are JIT compiled and the expressions
+ * are ordered by their evaluation costs, cheap and selective ones first.
  * @param expression mpd search expression
  * @return list of the expression
  */
@@ -121,6 +131,8 @@ struct t_list *parse_search_expression_to_list(const char *expression) {
         struct t_search_expression *expr = malloc_assert(sizeof(struct t_search_expression));
         expr->value = sdsempty();
         expr->re_compiled = NULL;
+        expr->match_data = NULL;
+        expr->folded = NULL;
         char *p = tokens[j];
         char *end = p + sdslen(tokens[j]) - 1; //ignore concluding apostrophe
         //tag
@@ -207,13 +219,7 @@ struct t_list *parse_search_expression_to_list(const char *expression) {
         }
         //push to list
         if (*end == '\'') {
-            if (expr->op == SEARCH_OP_REGEX ||
-                expr->op == SEARCH_OP_NOT_REGEX)
-            {
-                //is regex, compile
-                expr->re_compiled = compile_regex(expr->value);
-            }
-            else if (expr->op == SEARCH_OP_NEWER) {
+            if (expr->op == SEARCH_OP_NEWER) {
                 expr->value_time = parse_date(expr->value);
                 if (expr->value_time == 0) {
                     MYMPD_LOG_ERROR(NULL, "Can not parse search expression, invalid date");
@@ -221,7 +227,10 @@ struct t_list *parse_search_expression_to_list(const char *expression) {
                     break;
                 }
             }
-            list_push(expr_list, "", 0, NULL, expr);
+            else {
+                compile_search_expression(expr);
+            }
+            list_push(expr_list, "", get_search_expression_cost(expr), NULL, expr);
             MYMPD_LOG_DEBUG(NULL, "Parsed expression tag: \"%s\", op: \"%s\", value:\"%s\"", tag, op, expr->value);
         }
         else {
@@ -233,6 +242,8 @@ struct t_list *parse_search_expression_to_list(const char *expression) {
     FREE_SDS(tag);
     FREE_SDS(op);
     sdsfreesplitres(tokens, count);
+    //all expressions must match, evaluate the cheapest first
+    list_sort_by_value_i(expr_list, LIST_SORT_ASC);
     return expr_list;
 }
 
@@ -247,14 +258,51 @@ void *free_search_expression_list(struct t_list *expr_list) {
     return list_free_user_data(expr_list, free_search_expression_node);
 }
 
+/**
+ * Searches for a string in mpd tag values.
+ * The expressions hold the scratch buffers for case folding and regex matching,
+ * an expression list must be used only by the thread that has parsed it.
+ * @param song pointer to mpd song struct
+ * @param expr_list expression list returned by parse_search_expression
+ * @param tag_types tags for special "any" tag in expression
+ * @return expression result
+ */
+bool search_song_expression(const struct mpd_song *song, struct t_list *expr_list, const struct t_tags *tag_types) {
+    return search_expression(song, expr_list, tag_types, NULL);
+}
+
+/**
+ * Searches for a string in the tag values of an album from the album cache.
+ * Uses the case folded tag values of the album cache.
+ * The caller must hold the album cache lock if it is shared.
+ * An expression list must be used only by the thread that has parsed it.
+ * @param album pointer to an album from the album cache
+ * @param expr_list expression list returned by parse_search_expression
+ * @param tag_types tags for special "any" tag in expression
+ * @param album_cache pointer to the album cache, NULL to fold the values on the fly
+ * @return expression result
+ */
+bool search_album_expression(const struct mpd_song *album, struct t_list *expr_list, const struct t_tags *tag_types,
+        const struct t_cache *album_cache)
+{
+    return search_expression(album, expr_list, tag_types, album_cache);
+}
+
+/**
+ * Private functions
+ */
+
 /**
  * Searches for a string in mpd tag values
  * @param song pointer to mpd song struct
  * @param expr_list expression list returned by parse_search_expression
  * @param tag_types tags for special "any" tag in expression
+ * @param album_cache album cache with the case folded tag values or NULL to fold the values
  * @return expression result
  */
-bool search_song_expression(const struct mpd_song *song, const struct t_list *expr_list, const struct t_tags *tag_types) {
+static bool search_expression(const struct mpd_song *song, struct t_list *expr_list, const struct t_tags *tag_types,
+        const struct t_cache *album_cache)
+{
     struct t_tags one_tag;
     one_tag.len = 1;
     struct t_list_node *current = expr_list->head;
@@ -271,7 +319,7 @@ bool search_song_expression(const struct mpd_song *song, const struct t_list *ex
             }
         }
         else if (expr->tag == SEARCH_FILTER_FILE) {
-            if (utf8casestr(mpd_song_get_uri(song), expr->value) == NULL) {
+            if (match_search_expression(expr, mpd_song_get_uri(song), NULL) == false) {
                 return false;
             }
         }
@@ -288,20 +336,22 @@ bool search_song_expression(const struct mpd_song *song, const struct t_list *ex
                 const char *value = NULL;
                 while ((value = mpd_song_get_tag(song, tags->tags[i], j)) != NULL) {
                     j++;
-                    if ((expr->op == SEARCH_OP_CONTAINS && utf8casestr(value, expr->value) == NULL) ||
-                        (expr->op == SEARCH_OP_STARTS_WITH && utf8ncasecmp(expr->value, value, sdslen(expr->value)) != 0) ||
-                        (expr->op == SEARCH_OP_EQUAL && utf8casecmp(value, expr->value) != 0) ||
-                        (expr->op == SEARCH_OP_REGEX && cmp_regex(expr->re_compiled, value) == false))
+                    const char *folded = album_cache != NULL
+                        ? album_cache_get_folded(album_cache, value)
+                        : NULL;
+                    bool matched = match_search_expression(expr, value, folded);
+                    if (expr->op == SEARCH_OP_NOT_EQUAL ||
+                        expr->op == SEARCH_OP_NOT_REGEX)
                     {
-                        //expression does not match
-                        rc = false;
+                        if (matched == true) {
+                            //negated match operator - exit instantly
+                            rc = false;
+                            break;
+                        }
                     }
-                    else if ((expr->op == SEARCH_OP_NOT_EQUAL && utf8casecmp(value, expr->value) == 0) ||
-                            (expr->op == SEARCH_OP_NOT_REGEX && cmp_regex(expr->re_compiled, value) == true))
-                    {
-                        //negated match operator - exit instantly
+                    else if (matched == false) {
+                        //expression does not match
                         rc = false;
-                        break;
                     }
                     else {
                         //tag value matched
@@ -337,8 +387,81 @@ bool search_song_expression(const struct mpd_song *song, const struct t_list *ex
 }
 
 /**
- * Private functions
+ * Compiles the search expression value for fast matching.
+ * Case folds the value and JIT compiles regexes.
+ * @param expr pointer to t_search_expression struct
  */
+static void compile_search_expression(struct t_search_expression *expr) {
+    expr->folded = sdsempty();
+    if (expr->tag == SEARCH_FILTER_FILE) {
+        //file filter always matches as substring
+        expr->op = SEARCH_OP_CONTAINS;
+    }
+    else if (expr->op == SEARCH_OP_REGEX ||
+        expr->op == SEARCH_OP_NOT_REGEX)
+    {
+        expr->re_compiled = compile_regex(expr->value);
+        if (expr->re_compiled != NULL) {
+            expr->match_data = pcre2_match_data_create_from_pattern(expr->re_compiled, NULL);
+        }
+        return;
+    }
+    sds_utf8_tolower(expr->value);
+}
+
+/**
+ * Calculates the evaluation costs of a search expression.
+ * Time comparisons are cheapest, regexes and the any tag are most expensive.
+ * @param expr pointer to t_search_expression struct
+ * @return costs
+ */
+static int64_t get_search_expression_cost(const struct t_search_expression *expr) {
+    int64_t cost;
+    switch(expr->op) {
+        case SEARCH_OP_NEWER:       cost = 0; break;
+        case SEARCH_OP_EQUAL:       cost = 1; break;
+        case SEARCH_OP_STARTS_WITH: cost = 2; break;
+        case SEARCH_OP_NOT_EQUAL:   cost = 3; break;
+        case SEARCH_OP_CONTAINS:    cost = 4; break;
+        default:                    cost = 5; break;
+    }
+    if (expr->tag == SEARCH_FILTER_ANY_TAG) {
+        //checks all browse tags
+        cost += 10;
+    }
+    return cost;
+}
+
+/**
+ * Matches a value against the compiled search expression.
+ * Without a case folded twin the value is folded in the reusable buffer of the expression.
+ * Negated operators return true if the value matches the positive operator.
+ * @param expr pointer to t_search_expression struct
+ * @param value value to match
+ * @param folded case folded twin of value or NULL
+ * @return true on match, else false
+ */
+static bool match_search_expression(struct t_search_expression *expr, const char *value, const char *folded) {
+    if (folded == NULL) {
+        expr->folded = sdscpy(expr->folded, value);
+        sds_utf8_tolower(expr->folded);
+        folded = expr->folded;
+    }
+    switch(expr->op) {
+        case SEARCH_OP_CONTAINS:
+            return strstr(folded, expr->value) != NULL;
+        case SEARCH_OP_STARTS_WITH:
+            return strncmp(folded, expr->value, sdslen(expr->value)) == 0;
+        case SEARCH_OP_EQUAL:
+        case SEARCH_OP_NOT_EQUAL:
+            return strcmp(folded, expr->value) == 0;
+        case SEARCH_OP_REGEX:
+        case SEARCH_OP_NOT_REGEX:
+            return cmp_regex(expr->re_compiled, expr->match_data, folded, strlen(folded));
+        default:
+            return false;
+    }
+}
 
 /**
  * Frees the t_search_expression struct
@@ -346,7 +469,13 @@ bool search_song_expression(const struct mpd_song *song, const struct t_list *ex
  */
 void *free_search_expression(struct t_search_expression *expr) {
     FREE_SDS(expr->value);
-    FREE_PTR(expr->re_compiled);
+    FREE_SDS(expr->folded);
+    if (expr->match_data != NULL) {
+        pcre2_match_data_free(expr->match_data);
+    }
+    if (expr->re_compiled != NULL) {
+        pcre2_code_free(expr->re_compiled);
+    }
     FREE_PTR(expr);
     return NULL;
 }
@@ -365,9 +494,9 @@ static void free_search_expression_node(struct t_list_node *current) {
  * @param regex_str regex string
  * @return regex code
  */
-static pcre2_code *compile_regex(char *regex_str) {
+static pcre2_code *compile_regex(sds regex_str) {
     MYMPD_LOG_DEBUG(NULL, "Compiling regex: \"%s\"", regex_str);
-    utf8lwr(regex_str);
+    sds_utf8_tolower(regex_str);
     PCRE2_SIZE erroroffset;
     int rc;
     pcre2_code *re_compiled = pcre2_compile(
@@ -385,33 +514,37 @@ static pcre2_code *compile_regex(char *regex_str) {
         MYMPD_LOG_ERROR(NULL, "PCRE2 compilation failed at offset %lu: \"%s\"", (unsigned long)erroroffset, buffer);
         return NULL;
     }
+    //JIT compilation is optional, pcre2_match falls back to the interpreter
+    rc = pcre2_jit_compile(re_compiled, PCRE2_JIT_COMPLETE);
+    if (rc != 0) {
+        MYMPD_LOG_DEBUG(NULL, "PCRE2 JIT compilation not available: %d", rc);
+    }
     return re_compiled;
 }
 
 /**
  * Matches the regex against a string
  * @param re_compiled the compiled regex from compile_regex
- * @param value string to match against
+ * @param match_data match data created from the compiled regex
+ * @param value case folded string to match against
+ * @param len length of value
  * @return true if regex matches else false
  */
-static bool cmp_regex(pcre2_code *re_compiled, const char *value) {
-    if (re_compiled == NULL) {
+static bool cmp_regex(pcre2_code *re_compiled, pcre2_match_data *match_data, const char *value, size_t len) {
+    if (re_compiled == NULL ||
+        match_data == NULL)
+    {
         return false;
     }
-    char *lower = strdup(value);
-    utf8lwr(lower);
-    pcre2_match_data *match_data = pcre2_match_data_create_from_pattern(re_compiled, NULL);
     int rc = pcre2_match(
         re_compiled,          /* the compiled pattern */
-        (PCRE2_SPTR)lower,    /* the subject string */
-        strlen(value),        /* the length of the subject */
+        (PCRE2_SPTR)value,    /* the subject string */
+        len,                  /* the length of the subject */
         0,                    /* start at offset 0 in the subject */
         0,                    /* default options */
         match_data,           /* block for storing the result */
         NULL                  /* use default match context */
     );
-    pcre2_match_data_free(match_data);
-    FREE_PTR(lower);
     if (rc >= 0) {
         return true;
     }
@@ -12,5 +12,7 @@
 bool search_mpd_song(const struct mpd_song *song, sds searchstr, const struct t_tags *tags);
 struct t_list *parse_search_expression_to_list(const char *expression);
 void *free_search_expression_list(struct t_list *expr_list);
-bool search_song_expression(const struct mpd_song *song, const struct t_list *expr_list, const struct t_tags *browse_tag_types);
+bool search_song_expression(const struct mpd_song *song, struct t_list *expr_list, const struct t_tags *browse_tag_types);
+bool search_album_expression(const struct mpd_song *album, struct t_list *expr_list, const struct t_tags *browse_tag_types,
+        const struct t_cache *album_cache);
 #endif
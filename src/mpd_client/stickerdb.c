@@ -11,7 +11,9 @@
 #include "src/lib/convert.h"
 #include "src/lib/jsonrpc.h"
 #include "src/lib/log.h"
+#include "src/lib/mem.h"
 #include "src/lib/mympd_state.h"
+#include "src/lib/rax_extras.h"
 #include "src/lib/sds_extras.h"
 #include "src/lib/sticker.h"
 #include "src/lib/utility.h"
@@ -38,6 +40,10 @@ static bool inc_sticker(struct t_stickerdb_state *stickerdb, const char *uri, co
 static bool remove_sticker(struct t_stickerdb_state *stickerdb, const char *uri, const char *name);
 static bool stickerdb_connect_mpd(struct t_stickerdb_state *stickerdb);
 static bool check_sticker_support(struct t_stickerdb_state *stickerdb);
+static bool cache_is_valid(struct t_stickerdb_state *stickerdb);
+static struct t_sticker *cache_get(struct t_stickerdb_state *stickerdb, const char *uri, struct t_sticker *sticker);
+static struct t_sticker *batch_get(struct t_stickerdb_state *stickerdb, const char *uri, struct t_sticker *sticker);
+static void cache_set(struct t_stickerdb_state *stickerdb, const char *uri, const char *name, const char *value);
 
 // Public functions
 
@@ -138,6 +144,16 @@ bool stickerdb_idle(struct t_stickerdb_state *stickerdb) {
  */
 bool stickerdb_enter_idle(struct t_stickerdb_state *stickerdb) {
     MYMPD_LOG_DEBUG("stickerdb", "Entering idle mode");
+    if (stickerdb->cache_own_changes > 0) {
+        // MPD answers the idle command at once with the sticker event of our own writes,
+        // collect it before waiting for foreign events
+        enum mpd_idle idle_events = mpd_run_idle_mask(stickerdb->conn, MPD_IDLE_STICKER);
+        stickerdb_cache_idle_event(stickerdb, idle_events, true);
+        if (stickerdb_check_error_and_recover(stickerdb, "mpd_run_idle_mask") == false) {
+            stickerdb_disconnect(stickerdb);
+            return false;
+        }
+    }
     // the idle events are discarded in the mympd api loop
     if (mpd_send_idle_mask(stickerdb->conn, MPD_IDLE_STICKER) == false) {
         MYMPD_LOG_ERROR("stickerdb", "Error entering idle mode");
@@ -157,6 +173,10 @@ bool stickerdb_exit_idle(struct t_stickerdb_state *stickerdb) {
     if (mpd_send_noidle(stickerdb->conn) == false) {
         MYMPD_LOG_ERROR("stickerdb", "Error exiting idle mode");
     }
+    else {
+        // events received while idling are caused by other clients
+        stickerdb_cache_idle_event(stickerdb, mpd_recv_idle(stickerdb->conn, false), false);
+    }
     mpd_response_finish(stickerdb->conn);
     return stickerdb_check_error_and_recover(stickerdb, "mpd_run_noidle");
 }
@@ -196,6 +216,226 @@ bool stickerdb_check_error_and_recover(struct t_stickerdb_state *stickerdb, cons
     return false;
 }
 
+/**
+ * Updates the sticker cache state for received idle events.
+ * MPD merges all sticker changes between two idle commands into one event,
+ * the event is only caused by myMPD if it was collected right after own writes.
+ * Foreign changes while myMPD is writing stickers can not be told apart from own changes.
+ * @param stickerdb pointer to the stickerdb state
+ * @param idle_events received idle events
+ * @param own_window true if the events were collected right after own writes
+ */
+void stickerdb_cache_idle_event(struct t_stickerdb_state *stickerdb, enum mpd_idle idle_events, bool own_window) {
+    unsigned own_changes = stickerdb->cache_own_changes;
+    stickerdb->cache_own_changes = 0;
+    if (own_window == true) {
+        if (own_changes > 0 &&
+            (idle_events & MPD_IDLE_STICKER) == MPD_IDLE_STICKER)
+        {
+            // the cache is already updated
+            MYMPD_LOG_DEBUG("stickerdb", "Received sticker event for %u own changes", own_changes);
+            return;
+        }
+        // the own changes were not acknowledged
+        MYMPD_LOG_DEBUG("stickerdb", "Missing sticker event for own changes, invalidating the sticker cache");
+        stickerdb->cache_dirty = true;
+        return;
+    }
+    if ((idle_events & MPD_IDLE_STICKER) == MPD_IDLE_STICKER) {
+        MYMPD_LOG_DEBUG("stickerdb", "Stickers changed, invalidating the sticker cache");
+        stickerdb->cache_dirty = true;
+    }
+}
+
+/**
+ * Mirrors a sticker change made by myMPD in the sticker cache
+ * and counts it as own change.
+ * @param stickerdb pointer to the stickerdb state
+ * @param uri song uri
+ * @param name sticker name
+ * @param value sticker value or NULL if the sticker was removed
+ */
+void stickerdb_cache_own_change(struct t_stickerdb_state *stickerdb, const char *uri, const char *name, const char *value) {
+    if (stickerdb->cache == NULL) {
+        return;
+    }
+    // also user defined stickers cause a sticker event
+    stickerdb->cache_own_changes++;
+    cache_set(stickerdb, uri, name, value);
+}
+
+/**
+ * Rebuilds the sticker cache with one sticker search per myMPD sticker.
+ * You must manage the idle state manually.
+ * @param stickerdb pointer to the stickerdb state
+ * @return true on success, else false
+ */
+bool stickerdb_cache_update(struct t_stickerdb_state *stickerdb) {
+    if (stickerdb->cache == NULL ||
+        stickerdb->cache_dirty == false)
+    {
+        return true;
+    }
+    MYMPD_LOG_INFO(stickerdb->name, "Updating the sticker cache");
+    rax_free_data(stickerdb->cache, NULL);
+    stickerdb->cache = raxNew();
+    sds file = sdsempty();
+    bool rc = true;
+    for (int i = 0; i < STICKER_COUNT; i++) {
+        const char *name = sticker_name_lookup((enum mympd_sticker_types)i);
+        struct mpd_pair *pair;
+        if (mpd_sticker_search_begin(stickerdb->conn, "song", NULL, name) == false) {
+            mpd_sticker_search_cancel(stickerdb->conn);
+            rc = false;
+            break;
+        }
+        if (mpd_sticker_search_commit(stickerdb->conn) == true) {
+            while ((pair = mpd_recv_pair(stickerdb->conn)) != NULL) {
+                if (strcmp(pair->name, "file") == 0) {
+                    file = sds_replace(file, pair->value);
+                }
+                else if (strcmp(pair->name, "sticker") == 0) {
+                    // sticker value has the format name=value
+                    const char *value = strchr(pair->value, '=');
+                    if (value != NULL) {
+                        cache_set(stickerdb, file, name, value + 1);
+                    }
+                }
+                mpd_return_sticker(stickerdb->conn, pair);
+            }
+        }
+        mpd_response_finish(stickerdb->conn);
+        if (stickerdb_check_error_and_recover(stickerdb, "mpd_sticker_search_commit") == false) {
+            rc = false;
+            break;
+        }
+    }
+    FREE_SDS(file);
+    if (rc == false) {
+        MYMPD_LOG_ERROR(stickerdb->name, "Updating the sticker cache failed");
+        return false;
+    }
+    stickerdb->cache_dirty = false;
+    MYMPD_LOG_INFO(stickerdb->name, "Cached stickers for %" PRIu64 " songs", stickerdb->cache->numele);
+    return true;
+}
+
+/**
+ * Prepares the stickerdb for a batch of sticker lookups.
+ * Leaves the idle mode only if the sticker cache can not be used.
+ * Must be followed by stickerdb_batch_end.
+ * @param stickerdb pointer to the stickerdb state
+ * @return true on success, else false
+ */
+bool stickerdb_batch_begin(struct t_stickerdb_state *stickerdb) {
+    stickerdb->batch_idle_exited = false;
+    if (stickerdb->cache != NULL &&
+        stickerdb->cache_dirty == false)
+    {
+        // served from the cache, no round-trips required
+        return true;
+    }
+    if (stickerdb_connect(stickerdb) == false) {
+        return false;
+    }
+    stickerdb->batch_idle_exited = true;
+    stickerdb_cache_update(stickerdb);
+    return true;
+}
+
+/**
+ * Fetches the myMPD stickers for a page of songs in one command list,
+ * if they can not be served from the sticker cache.
+ * Call it between stickerdb_batch_begin and stickerdb_batch_end,
+ * stickerdb_get_all_batch uses the result.
+ * @param stickerdb pointer to the stickerdb state
+ * @param uris list of song uris
+ */
+void stickerdb_batch_prefetch(struct t_stickerdb_state *stickerdb, struct t_list *uris) {
+    if (stickerdb->batch_idle_exited == false ||
+        cache_is_valid(stickerdb) == true ||
+        uris->length == 0)
+    {
+        return;
+    }
+    if (stickerdb->batch_stickers != NULL) {
+        rax_free_data(stickerdb->batch_stickers, NULL);
+    }
+    stickerdb->batch_stickers = raxNew();
+    if (mpd_command_list_begin(stickerdb->conn, true) == false) {
+        stickerdb_check_error_and_recover(stickerdb, "mpd_command_list_begin");
+        return;
+    }
+    struct t_list_node *current = uris->head;
+    while (current != NULL) {
+        if (is_streamuri(current->key) == false &&
+            mpd_send_sticker_list(stickerdb->conn, "song", current->key) == false)
+        {
+            break;
+        }
+        current = current->next;
+    }
+    if (mpd_command_list_end(stickerdb->conn) == false) {
+        mpd_response_finish(stickerdb->conn);
+        stickerdb_check_error_and_recover(stickerdb, "mpd_command_list_end");
+        return;
+    }
+    // responses are in the order of the commands
+    struct t_sticker sticker;
+    current = uris->head;
+    while (current != NULL) {
+        if (is_streamuri(current->key) == true) {
+            current = current->next;
+            continue;
+        }
+        // user defined stickers are not fetched, sticker.user is not used
+        sticker_struct_init(&sticker);
+        struct mpd_pair *pair;
+        while ((pair = mpd_recv_sticker(stickerdb->conn)) != NULL) {
+            enum mympd_sticker_types sticker_type = sticker_name_parse(pair->name);
+            if (sticker_type != STICKER_UNKNOWN) {
+                int64_t num;
+                sticker.mympd[sticker_type] = str2int64(&num, pair->value) == STR2INT_SUCCESS
+                    ? num
+                    : 0;
+            }
+            mpd_return_sticker(stickerdb->conn, pair);
+        }
+        if (mpd_connection_get_error(stickerdb->conn) != MPD_ERROR_SUCCESS) {
+            // command list was aborted, remaining songs are fetched one by one
+            break;
+        }
+        int64_t *values = malloc_assert(sizeof(sticker.mympd));
+        memcpy(values, sticker.mympd, sizeof(sticker.mympd));
+        if (raxTryInsert(stickerdb->batch_stickers, (unsigned char *)current->key, sdslen(current->key), values, NULL) == 0) {
+            // duplicate uri in the page
+            FREE_PTR(values);
+        }
+        if (mpd_response_next(stickerdb->conn) == false) {
+            break;
+        }
+        current = current->next;
+    }
+    mpd_response_finish(stickerdb->conn);
+    stickerdb_check_error_and_recover(stickerdb, "mpd_send_sticker_list");
+    MYMPD_LOG_DEBUG("stickerdb", "Prefetched stickers for %" PRIu64 " songs", stickerdb->batch_stickers->numele);
+}
+
+/**
+ * Enters the idle mode, if it was left by stickerdb_batch_begin
+ * @param stickerdb pointer to the stickerdb state
+ */
+void stickerdb_batch_end(struct t_stickerdb_state *stickerdb) {
+    if (stickerdb->batch_stickers != NULL) {
+        rax_free_data(stickerdb->batch_stickers, NULL);
+        stickerdb->batch_stickers = NULL;
+    }
+    if (stickerdb->batch_idle_exited == true) {
+        stickerdb_enter_idle(stickerdb);
+        stickerdb->batch_idle_exited = false;
+    }
+}
+
 /**
  * Gets a sticker for a song.
  * * You must manage the idle state manually.
@@ -281,6 +521,14 @@ struct t_sticker *stickerdb_get_all_batch(struct t_stickerdb_state *stickerdb, c
     if (is_streamuri(uri) == true) {
         return NULL;
     }
+    if (user_defined == false) {
+        if (cache_is_valid(stickerdb) == true) {
+            return cache_get(stickerdb, uri, sticker);
+        }
+        if (batch_get(stickerdb, uri, sticker) != NULL) {
+            return sticker;
+        }
+    }
     return get_sticker_all(stickerdb, uri, sticker, user_defined);
 }
 
@@ -296,6 +544,11 @@ struct t_sticker *stickerdb_get_all(struct t_stickerdb_state *stickerdb, const c
     if (is_streamuri(uri) == true) {
         return NULL;
     }
+    if (user_defined == false &&
+        cache_is_valid(stickerdb) == true)
+    {
+        return cache_get(stickerdb, uri, sticker);
+    }
     if (stickerdb_connect(stickerdb) == false) {
         return NULL;
     }
@@ -742,7 +995,11 @@ int64_t get_sticker_int64(struct t_stickerdb_state *stickerdb, const char *uri,
 static bool set_sticker_value(struct t_stickerdb_state *stickerdb, const char *uri, const char *name, const char *value) {
     MYMPD_LOG_INFO(stickerdb->name, "Setting sticker: \"%s\" -> %s: %s", uri, name, value);
     mpd_run_sticker_set(stickerdb->conn, "song", uri, name, value);
-    return stickerdb_check_error_and_recover(stickerdb, "mpd_run_sticker_set");
+    if (stickerdb_check_error_and_recover(stickerdb, "mpd_run_sticker_set") == false) {
+        return false;
+    }
+    stickerdb_cache_own_change(stickerdb, uri, name, value);
+    return true;
 }
 
 /**
@@ -799,7 +1056,97 @@ static bool inc_sticker(struct t_stickerdb_state *stickerdb, const char *uri, co
 static bool remove_sticker(struct t_stickerdb_state *stickerdb, const char *uri, const char *name) {
     MYMPD_LOG_INFO(stickerdb->name, "Removing sticker: \"%s\" -> %s", uri, name);
     mpd_run_sticker_delete(stickerdb->conn, "song", uri, name);
-    return stickerdb_check_error_and_recover(stickerdb, "mpd_run_sticker_delete");
+    if (stickerdb_check_error_and_recover(stickerdb, "mpd_run_sticker_delete") == false) {
+        return false;
+    }
+    stickerdb_cache_own_change(stickerdb, uri, name, NULL);
+    return true;
+}
+
+/**
+ * Checks if the sticker cache can be used for lookups
+ * @param stickerdb pointer to the stickerdb state
+ * @return true if the cache is enabled and up to date, else false
+ */
+static bool cache_is_valid(struct t_stickerdb_state *stickerdb) {
+    return stickerdb->cache != NULL &&
+        stickerdb->cache_dirty == false;
+}
+
+/**
+ * Initializes the sticker struct and populates it from the sticker cache
+ * @param stickerdb pointer to the stickerdb state
+ * @param uri song uri
+ * @param sticker pointer to t_sticker struct to populate
+ * @return the initialized and populated sticker struct
+ */
+static struct t_sticker *cache_get(struct t_stickerdb_state *stickerdb, const char *uri, struct t_sticker *sticker) {
+    sticker_struct_init(sticker);
+    void *data = raxFind(stickerdb->cache, (unsigned char *)uri, strlen(uri));
+    if (data != raxNotFound) {
+        memcpy(sticker->mympd, data, sizeof(sticker->mympd));
+    }
+    return sticker;
+}
+
+/**
+ * Initializes the sticker struct and populates it from the prefetched stickers
+ * @param stickerdb pointer to the stickerdb state
+ * @param uri song uri
+ * @param sticker pointer to t_sticker struct to populate
+ * @return the initialized and populated sticker struct or NULL if the song was not prefetched
+ */
+static struct t_sticker *batch_get(struct t_stickerdb_state *stickerdb, const char *uri, struct t_sticker *sticker) {
+    if (stickerdb->batch_stickers == NULL) {
+        return NULL;
+    }
+    void *data = raxFind(stickerdb->batch_stickers, (unsigned char *)uri, strlen(uri));
+    if (data == raxNotFound) {
+        return NULL;
+    }
+    sticker_struct_init(sticker);
+    memcpy(sticker->mympd, data, sizeof(sticker->mympd));
+    return sticker;
+}
+
+/**
+ * Mirrors a changed myMPD sticker in the sticker cache
+ * @param stickerdb pointer to the stickerdb state
+ * @param uri song uri
+ * @param name sticker name
+ * @param value sticker value or NULL if the sticker was removed
+ */
+static void cache_set(struct t_stickerdb_state *stickerdb, const char *uri, const char *name, const char *value) {
+    if (stickerdb->cache == NULL) {
+        return;
+    }
+    enum mympd_sticker_types sticker_type = sticker_name_parse(name);
+    if (sticker_type == STICKER_UNKNOWN) {
+        return;
+    }
+    size_t uri_len = strlen(uri);
+    int64_t *values = raxFind(stickerdb->cache, (unsigned char *)uri, uri_len);
+    if (values == raxNotFound) {
+        if (value == NULL) {
+            return;
+        }
+        struct t_sticker sticker;
+        sticker_struct_init(&sticker);
+        values = malloc_assert(sizeof(sticker.mympd));
+        memcpy(values, sticker.mympd, sizeof(sticker.mympd));
+        raxInsert(stickerdb->cache, (unsigned char *)uri, uri_len, values, NULL);
+    }
+    if (value == NULL) {
+        // default value of a removed sticker
+        values[sticker_type] = sticker_type == STICKER_LIKE
+            ? STICKER_LIKE_NEUTRAL
+            : 0;
+        return;
+    }
+    int64_t num;
+    values[sticker_type] = str2int64(&num, value) == STR2INT_SUCCESS
+        ? num
+        : 0;
 }
 
 /**
@@ -855,6 +1202,9 @@ static bool stickerdb_connect_mpd(struct t_stickerdb_state *stickerdb) {
 
     MYMPD_LOG_NOTICE(stickerdb->name, "Connected to MPD");
     stickerdb->conn_state = MPD_CONNECTED;
+    // sticker changes could have been missed
+    stickerdb->cache_dirty = true;
+    stickerdb->cache_own_changes = 0;
     return true;
 }
 
@@ -16,6 +16,13 @@ bool stickerdb_enter_idle(struct t_stickerdb_state *stickerdb);
 bool stickerdb_exit_idle(struct t_stickerdb_state *stickerdb);
 bool stickerdb_check_error_and_recover(struct t_stickerdb_state *stickerdb, const char *command);
 
+bool stickerdb_cache_update(struct t_stickerdb_state *stickerdb);
+void stickerdb_cache_idle_event(struct t_stickerdb_state *stickerdb, enum mpd_idle idle_events, bool own_window);
+void stickerdb_cache_own_change(struct t_stickerdb_state *stickerdb, const char *uri, const char *name, const char *value);
+bool stickerdb_batch_begin(struct t_stickerdb_state *stickerdb);
+void stickerdb_batch_prefetch(struct t_stickerdb_state *stickerdb, struct t_list *uris);
+void stickerdb_batch_end(struct t_stickerdb_state *stickerdb);
+
 sds stickerdb_get(struct t_stickerdb_state *stickerdb, const char *uri, const char *name);
 int64_t stickerdb_get_int64(struct t_stickerdb_state *stickerdb, const char *uri, const char *name);
 struct t_sticker *stickerdb_get_all(struct t_stickerdb_state *stickerdb, const char *uri, struct t_sticker *sticker, bool user_defined);
@@ -511,6 +511,14 @@ bool mpd_client_tag_exists(const struct t_tags *tagtypes, enum mpd_tag_type tag)
     return false;
 }
 
+/**
+ * Callback function for list_clear_user_data that frees the mpd_song user data
+ * @param current list node
+ */
+void list_free_cb_song_user_data(struct t_list_node *current) {
+    mpd_song_free((struct mpd_song *)current->user_data);
+}
+
 /**
  * Private functions
  */
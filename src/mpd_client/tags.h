@@ -34,5 +34,6 @@ sds mpd_client_get_tag_value_padded(const struct mpd_song *song, enum mpd_tag_ty
 int mpd_client_get_tag_value_int(const struct mpd_song *song, enum mpd_tag_type tag);
 sds mpd_client_get_value_padded(int64_t value, sds tag_values);
 sds get_sort_key(sds key, enum sort_by_type sort_by, enum mpd_tag_type sort_tag, const struct mpd_song *song);
+void list_free_cb_song_user_data(struct t_list_node *current);
 
 #endif
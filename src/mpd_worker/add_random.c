@@ -36,6 +36,7 @@ bool mpd_worker_add_random_to_queue(struct t_mpd_worker_state *mpd_worker_state,
         .uniq_tag = MPD_TAG_UNKNOWN,
         .last_played = 0,
         .ignore_hated = false,
+        .weighting = JUKEBOX_WEIGHTING_OFF,
         .min_song_duration = 0,
         .max_song_duration = UINT_MAX
     };
@@ -58,7 +59,7 @@ bool mpd_worker_add_random_to_queue(struct t_mpd_worker_state *mpd_worker_state,
     }
     else if  (mode == JUKEBOX_ADD_SONG){
         new_length = random_select_songs(mpd_worker_state->partition_state, mpd_worker_state->stickerdb,
-            add, plist, NULL, &add_list, &constraints);
+            mpd_worker_state->song_index, add, plist, NULL, &add_list, &constraints);
         if (new_length > 0) {
             mpd_client_add_uris_to_queue(mpd_worker_state->partition_state, &add_list, UINT_MAX, MPD_POSITION_ABSOLUTE, &error);
         }
@@ -10,9 +10,11 @@
 #include "dist/libmympdclient/include/mpd/client.h"
 #include "dist/libmympdclient/src/isong.h"
 #include "src/lib/cache_rax_album.h"
+#include "src/lib/convert.h"
 #include "src/lib/datetime.h"
 #include "src/lib/filehandler.h"
 #include "src/lib/jsonrpc.h"
+#include "src/lib/list.h"
 #include "src/lib/log.h"
 #include "src/lib/msg_queue.h"
 #include "src/lib/sds_extras.h"
@@ -28,20 +30,32 @@
 /**
  * Private definitions
  */
+static void album_cache_enable_tags(struct t_mpd_worker_state *mpd_worker_state);
 static bool album_cache_create(struct t_mpd_worker_state *mpd_worker_state, rax *album_cache);
 static bool album_cache_create_simple(struct t_mpd_worker_state *mpd_worker_state, rax *album_cache);
+static bool album_cache_add_song(struct t_mpd_worker_state *mpd_worker_state, rax *album_cache, struct mpd_song *song, sds key);
+static rax *album_cache_update(struct t_mpd_worker_state *mpd_worker_state, time_t since, struct t_list *update_paths);
+static bool album_cache_get_changed_by_path(struct t_mpd_worker_state *mpd_worker_state, struct t_list *update_paths, rax *changed);
+static bool album_cache_get_changed_by_mtime(struct t_mpd_worker_state *mpd_worker_state, time_t since, rax *changed);
+static bool album_cache_fetch_album(struct t_mpd_worker_state *mpd_worker_state, struct mpd_song *album, sds key, struct mpd_song **result);
+static rax *album_cache_merge(struct t_mpd_worker_state *mpd_worker_state, rax *patch, unsigned *song_count);
+static bool album_cache_count_songs(struct t_mpd_worker_state *mpd_worker_state, unsigned *song_count);
+static void album_cache_free_patch(rax *patch);
 
 /**
  * Public functions
  */
 
 /**
- * Creates the album cache and returns it to mympd_api thread
+ * Creates the album cache and returns it to mympd_api thread.
+ * In advanced album mode only the changed albums are fetched from MPD,
+ * if a saved album cache exists and the update is not forced.
  * @param mpd_worker_state pointer to mpd_worker_state struct
  * @param force true=force update, false=update only if mpd database is newer then the caches
+ * @param update_paths list of database paths updated since the last album cache creation or NULL
  * @return true on success else false
  */
-bool mpd_worker_album_cache_create(struct t_mpd_worker_state *mpd_worker_state, bool force) {
+bool mpd_worker_album_cache_create(struct t_mpd_worker_state *mpd_worker_state, bool force, struct t_list *update_paths) {
     time_t db_mtime = mpd_client_get_db_mtime(mpd_worker_state->partition_state);
     sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", mpd_worker_state->config->workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE);
     time_t album_cache_mtime = get_mtime(filepath);
@@ -72,11 +86,24 @@ bool mpd_worker_album_cache_create(struct t_mpd_worker_state *mpd_worker_state,
     bool rc = true;
     if (mpd_worker_state->partition_state->mpd_state->feat.tags == true) {
         struct t_cache album_cache;
-        album_cache.cache = raxNew();
-        rc = mpd_worker_state->config->albums.mode == ALBUM_MODE_ADV
-            ? album_cache_create(mpd_worker_state, album_cache.cache)
-            : album_cache_create_simple(mpd_worker_state, album_cache.cache);
+        album_cache.cache = NULL;
+        album_cache.folded = false;
+        if (mpd_worker_state->config->albums.mode == ALBUM_MODE_ADV &&
+            force == false &&
+            album_cache_mtime > 0)
+        {
+            // patch only the albums that have changed since the last run
+            album_cache.cache = album_cache_update(mpd_worker_state, album_cache_mtime, update_paths);
+        }
+        if (album_cache.cache == NULL) {
+            album_cache.cache = raxNew();
+            rc = mpd_worker_state->config->albums.mode == ALBUM_MODE_ADV
+                ? album_cache_create(mpd_worker_state, album_cache.cache)
+                : album_cache_create_simple(mpd_worker_state, album_cache.cache);
+        }
         if (rc == true) {
+            // the album cache is read-only after this point, case fold the tag values for local searches
+            album_cache_fold_tags(&album_cache);
             struct t_work_request *request = create_request(REQUEST_TYPE_DISCARD, 0, 0, INTERNAL_API_ALBUMCACHE_CREATED, NULL, mpd_worker_state->partition_state->name);
             request->data = jsonrpc_end(request->data);
             request->extra = (void *) album_cache.cache;
@@ -111,26 +138,10 @@ bool mpd_worker_album_cache_create(struct t_mpd_worker_state *mpd_worker_state,
  */
 
 /**
- * Initializes the album cache
+ * Sets the tags that are fetched for the album cache
  * @param mpd_worker_state pointer to mpd_worker_state struct
- * @param album_cache pointer to empty album_cache
- * @return true on success, else false
  */
-static bool album_cache_create(struct t_mpd_worker_state *mpd_worker_state, rax *album_cache) {
-    MYMPD_LOG_INFO("default", "Creating album cache");
-    if (mpd_worker_state->config->albums.group_tag != MPD_TAG_UNKNOWN) {
-        MYMPD_LOG_DEBUG("default", "Additional group tag: %s", mpd_tag_name(mpd_worker_state->config->albums.group_tag));
-    }
-    else {
-        MYMPD_LOG_DEBUG("default", "Additional group tag: None");
-    }
-
-    unsigned start = 0;
-    unsigned end = start + MPD_RESULTS_MAX;
-    unsigned i = 0;
-    int album_count = 0;
-    int skip_count = 0;
-
+static void album_cache_enable_tags(struct t_mpd_worker_state *mpd_worker_state) {
     //set interesting tags
     if (mpd_client_tag_exists(&mpd_worker_state->mpd_state->tags_mympd, MPD_TAG_DISC) == true) {
         if (mpd_client_tag_exists(&mpd_worker_state->mpd_state->tags_album, MPD_TAG_DISC) == false) {
@@ -151,6 +162,387 @@ static bool album_cache_create(struct t_mpd_worker_state *mpd_worker_state, rax
         }
     }
     enable_mpd_tags(mpd_worker_state->partition_state, &mpd_worker_state->mpd_state->tags_album);
+}
+
+/**
+ * Adds a song to the album cache, the song is consumed.
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param album_cache album cache radix tree to add the song
+ * @param song song to add
+ * @param key the album key of the song
+ * @return true if a new album was created, false if the song was appended to an existing album
+ */
+static bool album_cache_add_song(struct t_mpd_worker_state *mpd_worker_state, rax *album_cache, struct mpd_song *song, sds key) {
+    // set initial song and disc count to 1
+    album_cache_set_song_count(song, 1);
+    if (mpd_worker_state->tag_disc_empty_is_first == true) {
+        // handle empty disc tag as disc one
+        album_cache_set_disc_count(song, 1);
+    }
+    if (mpd_worker_state->partition_state->mpd_state->tag_albumartist == MPD_TAG_ALBUM_ARTIST &&
+        mpd_song_get_tag(song, MPD_TAG_ALBUM_ARTIST, 0) == NULL)
+    {
+        // Copy Artist tag to AlbumArtist tag
+        // for filters mpd falls back from AlbumArtist to Artist if AlbumArtist does not exist
+        album_cache_copy_tags(song, MPD_TAG_ARTIST, MPD_TAG_ALBUM_ARTIST);
+    }
+    void *old_data;
+    if (raxTryInsert(album_cache, (unsigned char *)key, sdslen(key), (void *)song, &old_data) == 0) {
+        // existing album: append song data
+        struct mpd_song *album = (struct mpd_song *) old_data;
+        // append tags
+        album_cache_append_tags(album, song, &mpd_worker_state->partition_state->mpd_state->tags_mympd);
+        // set album data
+        album_cache_set_last_modified(album, song); // use latest last_modified
+        album_cache_inc_total_time(album, song);    // sum duration
+        album_cache_set_discs(album, song);         // use max disc value
+        album_cache_inc_song_count(album);          // inc song count by one
+        // free song data
+        mpd_song_free(song);
+        return false;
+    }
+    // new album: use song data as initial album data
+    return true;
+}
+
+/**
+ * Creates a new album cache from the current album cache and refetches only the changed albums.
+ * Changed albums are albums with songs modified since the last album cache creation
+ * and albums in updated database paths.
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param since modification time of the saved album cache
+ * @param update_paths list of database paths updated since the last album cache creation or NULL
+ * @return the new album cache or NULL if a full album cache creation is required
+ */
+static rax *album_cache_update(struct t_mpd_worker_state *mpd_worker_state, time_t since, struct t_list *update_paths) {
+    MYMPD_LOG_INFO("default", "Updating album cache");
+    #ifdef MYMPD_DEBUG
+        MEASURE_INIT
+        MEASURE_START
+    #endif
+    album_cache_enable_tags(mpd_worker_state);
+
+    // changed albums: album key -> song to construct the search expression
+    rax *changed = raxNew();
+    if (album_cache_get_changed_by_path(mpd_worker_state, update_paths, changed) == false ||
+        album_cache_get_changed_by_mtime(mpd_worker_state, since, changed) == false)
+    {
+        album_cache_free_rt(changed);
+        return NULL;
+    }
+    MYMPD_LOG_INFO("default", "Found %" PRIu64 " changed album(s)", changed->numele);
+
+    // refetch the changed albums: album key -> new album or NULL if the album was removed
+    rax *patch = raxNew();
+    raxIterator iter;
+    raxStart(&iter, changed);
+    raxSeek(&iter, "^", NULL, 0);
+    sds key = sdsempty();
+    bool rc = true;
+    while (raxNext(&iter)) {
+        key = sds_replacelen(key, (char *)iter.key, iter.key_len);
+        struct mpd_song *album = NULL;
+        if (mpd_worker_canceled(mpd_worker_state) == true ||
+            album_cache_fetch_album(mpd_worker_state, (struct mpd_song *)iter.data, key, &album) == false)
+        {
+            rc = false;
+            break;
+        }
+        raxInsert(patch, iter.key, iter.key_len, album, NULL);
+    }
+    raxStop(&iter);
+    FREE_SDS(key);
+    album_cache_free_rt(changed);
+    if (rc == false) {
+        album_cache_free_patch(patch);
+        return NULL;
+    }
+
+    // apply the patch to a copy of the current album cache
+    unsigned cache_song_count = 0;
+    rax *album_cache = album_cache_merge(mpd_worker_state, patch, &cache_song_count);
+    if (album_cache == NULL) {
+        return NULL;
+    }
+
+    // deleted songs and songs moved to another album are only detected through the updated paths,
+    // a mismatch of the song count requires a full album cache creation
+    unsigned db_song_count = 0;
+    if (album_cache_count_songs(mpd_worker_state, &db_song_count) == false ||
+        db_song_count != cache_song_count)
+    {
+        MYMPD_LOG_INFO("default", "Song count mismatch: %u songs in database, %u songs in album cache", db_song_count, cache_song_count);
+        album_cache_free_rt(album_cache);
+        return NULL;
+    }
+    #ifdef MYMPD_DEBUG
+        MEASURE_END
+        MEASURE_PRINT("default", "Update album cache")
+    #endif
+    MYMPD_LOG_INFO("default", "Cache updated successfully");
+    return album_cache;
+}
+
+/**
+ * Adds all albums from the current album cache located in the updated paths
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param update_paths list of database paths updated since the last album cache creation or NULL
+ * @param changed radix tree to add the changed albums
+ * @return true on success, else false
+ */
+static bool album_cache_get_changed_by_path(struct t_mpd_worker_state *mpd_worker_state, struct t_list *update_paths, rax *changed) {
+    if (update_paths == NULL ||
+        update_paths->length == 0)
+    {
+        return true;
+    }
+    if (cache_get_read_lock(mpd_worker_state->album_cache) == false) {
+        return false;
+    }
+    if (mpd_worker_state->album_cache->cache == NULL) {
+        cache_release_lock(mpd_worker_state->album_cache);
+        return false;
+    }
+    raxIterator iter;
+    raxStart(&iter, mpd_worker_state->album_cache->cache);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        const char *uri = mpd_song_get_uri((struct mpd_song *)iter.data);
+        struct t_list_node *current = update_paths->head;
+        while (current != NULL) {
+            size_t len = sdslen(current->key);
+            if (strncmp(uri, current->key, len) == 0 &&
+                (uri[len] == '/' || uri[len] == '\0'))
+            {
+                raxTryInsert(changed, iter.key, iter.key_len, mpd_song_dup((struct mpd_song *)iter.data), NULL);
+                break;
+            }
+            current = current->next;
+        }
+    }
+    raxStop(&iter);
+    cache_release_lock(mpd_worker_state->album_cache);
+    return true;
+}
+
+/**
+ * Adds all albums with songs modified since the last album cache creation
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param since modification time of the saved album cache
+ * @param changed radix tree to add the changed albums
+ * @return true on success, else false
+ */
+static bool album_cache_get_changed_by_mtime(struct t_mpd_worker_state *mpd_worker_state, time_t since, rax *changed) {
+    unsigned start = 0;
+    unsigned end = start + MPD_RESULTS_MAX;
+    unsigned i = 0;
+    sds expression = sdscatfmt(sdsempty(), "((Album != '') AND (AlbumArtist != '') AND (modified-since '%I'))", (int64_t)since);
+    sds key = sdsempty();
+    bool rc = true;
+    do {
+        if (mpd_search_db_songs(mpd_worker_state->partition_state->conn, false) == false ||
+            mpd_search_add_expression(mpd_worker_state->partition_state->conn, expression) == false ||
+            mpd_search_add_window(mpd_worker_state->partition_state->conn, start, end) == false)
+        {
+            mpd_search_cancel(mpd_worker_state->partition_state->conn);
+            rc = false;
+            break;
+        }
+        if (mpd_search_commit(mpd_worker_state->partition_state->conn)) {
+            struct mpd_song *song;
+            while ((song = mpd_recv_song(mpd_worker_state->partition_state->conn)) != NULL) {
+                key = album_cache_get_key(key, song, &mpd_worker_state->config->albums);
+                if (mpd_worker_state->partition_state->mpd_state->tag_albumartist == MPD_TAG_ALBUM_ARTIST &&
+                    mpd_song_get_tag(song, MPD_TAG_ALBUM_ARTIST, 0) == NULL)
+                {
+                    // the album search expression is constructed with the AlbumArtist tag
+                    album_cache_copy_tags(song, MPD_TAG_ARTIST, MPD_TAG_ALBUM_ARTIST);
+                }
+                if (sdslen(key) == 0 ||
+                    raxTryInsert(changed, (unsigned char *)key, sdslen(key), song, NULL) == 0)
+                {
+                    mpd_song_free(song);
+                }
+                i++;
+            }
+        }
+        mpd_response_finish(mpd_worker_state->partition_state->conn);
+        if (mympd_check_error_and_recover(mpd_worker_state->partition_state, NULL, "mpd_search_commit") == false) {
+            rc = false;
+            break;
+        }
+        start = end;
+        end = end + MPD_RESULTS_MAX;
+    } while (i >= start);
+    FREE_SDS(expression);
+    FREE_SDS(key);
+    if (rc == false) {
+        MYMPD_LOG_ERROR("default", "Fetching modified songs failed");
+    }
+    return rc;
+}
+
+/**
+ * Fetches all songs of an album and creates the album entry
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param album song to construct the search expression
+ * @param key the album key
+ * @param result pointer to set to the new album or NULL if the album has no songs
+ * @return true on success, else false
+ */
+static bool album_cache_fetch_album(struct t_mpd_worker_state *mpd_worker_state, struct mpd_song *album, sds key, struct mpd_song **result) {
+    sds expression = sdslen(key) == MBID_LENGTH
+        ? escape_mpd_search_expression(sdsempty(), "MUSICBRAINZ_ALBUMID", "==", key)
+        : get_search_expression_album(mpd_worker_state->partition_state->mpd_state->tag_albumartist, album, &mpd_worker_state->config->albums);
+    if (mpd_search_db_songs(mpd_worker_state->partition_state->conn, true) == false ||
+        mpd_search_add_expression(mpd_worker_state->partition_state->conn, expression) == false ||
+        mpd_search_add_window(mpd_worker_state->partition_state->conn, 0, MPD_RESULTS_MAX) == false)
+    {
+        MYMPD_LOG_ERROR("default", "Fetching album failed");
+        mpd_search_cancel(mpd_worker_state->partition_state->conn);
+        FREE_SDS(expression);
+        return false;
+    }
+    FREE_SDS(expression);
+    // the search expression can match songs of other albums, e.g. albums with a MusicBrainz album id
+    rax *album_songs = raxNew();
+    sds song_key = sdsempty();
+    if (mpd_search_commit(mpd_worker_state->partition_state->conn)) {
+        struct mpd_song *song;
+        while ((song = mpd_recv_song(mpd_worker_state->partition_state->conn)) != NULL) {
+            song_key = album_cache_get_key(song_key, song, &mpd_worker_state->config->albums);
+            if (sdscmp(song_key, key) == 0) {
+                album_cache_add_song(mpd_worker_state, album_songs, song, song_key);
+            }
+            else {
+                mpd_song_free(song);
+            }
+        }
+    }
+    mpd_response_finish(mpd_worker_state->partition_state->conn);
+    FREE_SDS(song_key);
+    if (mympd_check_error_and_recover(mpd_worker_state->partition_state, NULL, "mpd_search_commit") == false) {
+        album_cache_free_rt(album_songs);
+        return false;
+    }
+    void *data = raxFind(album_songs, (unsigned char *)key, sdslen(key));
+    *result = data == raxNotFound
+        ? NULL
+        : (struct mpd_song *)data;
+    raxFree(album_songs);
+    return true;
+}
+
+/**
+ * Copies the current album cache and applies the patch.
+ * The patch is consumed.
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param patch album key -> new album or NULL to remove the album
+ * @param song_count pointer to set the total song count of the new album cache
+ * @return the new album cache or NULL on error
+ */
+static rax *album_cache_merge(struct t_mpd_worker_state *mpd_worker_state, rax *patch, unsigned *song_count) {
+    if (cache_get_read_lock(mpd_worker_state->album_cache) == false) {
+        album_cache_free_patch(patch);
+        return NULL;
+    }
+    if (mpd_worker_state->album_cache->cache == NULL) {
+        cache_release_lock(mpd_worker_state->album_cache);
+        album_cache_free_patch(patch);
+        return NULL;
+    }
+    rax *album_cache = raxNew();
+    raxIterator iter;
+    raxStart(&iter, mpd_worker_state->album_cache->cache);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        if (raxFind(patch, iter.key, iter.key_len) != raxNotFound) {
+            // replaced or removed album
+            continue;
+        }
+        struct mpd_song *album = mpd_song_dup((struct mpd_song *)iter.data);
+        *song_count += album_get_song_count(album);
+        raxInsert(album_cache, iter.key, iter.key_len, album, NULL);
+    }
+    raxStop(&iter);
+    cache_release_lock(mpd_worker_state->album_cache);
+
+    raxStart(&iter, patch);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        if (iter.data != NULL) {
+            *song_count += album_get_song_count((struct mpd_song *)iter.data);
+            raxInsert(album_cache, iter.key, iter.key_len, iter.data, NULL);
+        }
+    }
+    raxStop(&iter);
+    raxFree(patch);
+    return album_cache;
+}
+
+/**
+ * Counts the songs in the mpd database that are relevant for the album cache
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param song_count pointer to set the song count
+ * @return true on success, else false
+ */
+static bool album_cache_count_songs(struct t_mpd_worker_state *mpd_worker_state, unsigned *song_count) {
+    if (mpd_count_db_songs(mpd_worker_state->partition_state->conn) == false ||
+        mpd_search_add_expression(mpd_worker_state->partition_state->conn, "((Album != '') AND (AlbumArtist !=''))") == false)
+    {
+        mpd_search_cancel(mpd_worker_state->partition_state->conn);
+        return false;
+    }
+    if (mpd_search_commit(mpd_worker_state->partition_state->conn)) {
+        struct mpd_pair *pair = mpd_recv_pair_named(mpd_worker_state->partition_state->conn, "songs");
+        if (pair != NULL) {
+            str2uint(song_count, pair->value);
+            mpd_return_pair(mpd_worker_state->partition_state->conn, pair);
+        }
+    }
+    mpd_response_finish(mpd_worker_state->partition_state->conn);
+    return mympd_check_error_and_recover(mpd_worker_state->partition_state, NULL, "mpd_count_db_songs");
+}
+
+/**
+ * Frees an album cache patch
+ * @param patch album key -> new album or NULL
+ */
+static void album_cache_free_patch(rax *patch) {
+    raxIterator iter;
+    raxStart(&iter, patch);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        if (iter.data != NULL) {
+            mpd_song_free((struct mpd_song *)iter.data);
+        }
+    }
+    raxStop(&iter);
+    raxFree(patch);
+}
+
+/**
+ * Initializes the album cache
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param album_cache pointer to empty album_cache
+ * @return true on success, else false
+ */
+static bool album_cache_create(struct t_mpd_worker_state *mpd_worker_state, rax *album_cache) {
+    MYMPD_LOG_INFO("default", "Creating album cache");
+    if (mpd_worker_state->config->albums.group_tag != MPD_TAG_UNKNOWN) {
+        MYMPD_LOG_DEBUG("default", "Additional group tag: %s", mpd_tag_name(mpd_worker_state->config->albums.group_tag));
+    }
+    else {
+        MYMPD_LOG_DEBUG("default", "Additional group tag: None");
+    }
+
+    unsigned start = 0;
+    unsigned end = start + MPD_RESULTS_MAX;
+    unsigned i = 0;
+    int album_count = 0;
+    int skip_count = 0;
+
+    album_cache_enable_tags(mpd_worker_state);
 
     //get all songs and set albums
     #ifdef MYMPD_DEBUG
@@ -159,6 +551,10 @@ static bool album_cache_create(struct t_mpd_worker_state *mpd_worker_state, rax
     #endif
     sds key = sdsempty();
     do {
+        if (mpd_worker_canceled(mpd_worker_state) == true) {
+            FREE_SDS(key);
+            return false;
+        }
         if (mpd_search_db_songs(mpd_worker_state->partition_state->conn, false) == false ||
             mpd_search_add_expression(mpd_worker_state->partition_state->conn, "((Album != '') AND (AlbumArtist !=''))") == false ||
             mpd_search_add_window(mpd_worker_state->partition_state->conn, start, end) == false)
@@ -170,38 +566,10 @@ static bool album_cache_create(struct t_mpd_worker_state *mpd_worker_state, rax
         if (mpd_search_commit(mpd_worker_state->partition_state->conn)) {
             struct mpd_song *song;
             while ((song = mpd_recv_song(mpd_worker_state->partition_state->conn)) != NULL) {
-                // set initial song and disc count to 1
-                album_cache_set_song_count(song, 1);
-                if (mpd_worker_state->tag_disc_empty_is_first == true) {
-                    // handle empty disc tag as disc one
-                    album_cache_set_disc_count(song, 1);
-                }
                 // construct the key
                 key = album_cache_get_key(key, song, &mpd_worker_state->config->albums);
                 if (sdslen(key) > 0) {
-                    if (mpd_worker_state->partition_state->mpd_state->tag_albumartist == MPD_TAG_ALBUM_ARTIST &&
-                        mpd_song_get_tag(song, MPD_TAG_ALBUM_ARTIST, 0) == NULL)
-                    {
-                        // Copy Artist tag to AlbumArtist tag
-                        // for filters mpd falls back from AlbumArtist to Artist if AlbumArtist does not exist
-                        album_cache_copy_tags(song, MPD_TAG_ARTIST, MPD_TAG_ALBUM_ARTIST);
-                    }
-                    void *old_data;
-                    if (raxTryInsert(album_cache, (unsigned char *)key, sdslen(key), (void *)song, &old_data) == 0) {
-                        // existing album: append song data
-                        struct mpd_song *album = (struct mpd_song *) old_data;
-                        // append tags
-                        album_cache_append_tags(album, song, &mpd_worker_state->partition_state->mpd_state->tags_mympd);
-                        // set album data
-                        album_cache_set_last_modified(album, song); // use latest last_modified
-                        album_cache_inc_total_time(album, song);    // sum duration
-                        album_cache_set_discs(album, song);         // use max disc value
-                        album_cache_inc_song_count(album);          // inc song count by one
-                        // free song data
-                        mpd_song_free(song);
-                    }
-                    else {
-                        // new album: use song data as initial album data
+                    if (album_cache_add_song(mpd_worker_state, album_cache, song, key) == true) {
                         album_count++;
                     }
                 }
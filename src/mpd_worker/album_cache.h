@@ -7,7 +7,8 @@
 #ifndef MYMPD_MPD_WORKER_ALBUM_CACHE_H
 #define MYMPD_MPD_WORKER_ALBUM_CACHE_H
 
+#include "src/lib/list.h"
 #include "src/mpd_worker/state.h"
 
-bool mpd_worker_album_cache_create(struct t_mpd_worker_state *mpd_worker_state, bool force);
+bool mpd_worker_album_cache_create(struct t_mpd_worker_state *mpd_worker_state, bool force, struct t_list *update_paths);
 #endif
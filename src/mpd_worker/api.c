@@ -9,6 +9,7 @@
 
 #include "src/lib/cache_disk.h"
 #include "src/lib/jsonrpc.h"
+#include "src/lib/list.h"
 #include "src/lib/log.h"
 #include "src/lib/sds_extras.h"
 #include "src/mpd_client/playlists.h"
@@ -18,6 +19,9 @@
 #include "src/mpd_worker/playlists.h"
 #include "src/mpd_worker/smartpls.h"
 #include "src/mpd_worker/song.h"
+#include "src/mpd_worker/song_index.h"
+#include "src/mympd_api/playlists.h"
+#include "src/mympd_api/search.h"
 
 /**
  * Handler for mpd worker api requests
@@ -42,6 +46,8 @@ void mpd_worker_api(struct t_mpd_worker_state *mpd_worker_state) {
     MYMPD_LOG_INFO(NULL, "MPD WORKER API request (%lu)(%u) %s: %s", request->conn_id, request->id, method, request->data);
     //create response struct
     struct t_work_response *response = create_response(request);
+    //streamed responses may wait for the client in the worker threads
+    response->stream_wait = true;
     //some shortcuts
     struct t_partition_state *partition_state = mpd_worker_state->partition_state;
 
@@ -109,19 +115,27 @@ void mpd_worker_api(struct t_mpd_worker_state *mpd_worker_state) {
                 response->data = mpd_worker_song_fingerprint(partition_state, response->data, request->id, sds_buf1);
             }
             break;
-        case MYMPD_API_CACHES_CREATE:
+        case MYMPD_API_CACHES_CREATE: {
+            struct t_list *update_paths = (struct t_list *)request->extra;
             if (json_get_bool(request->data, "$.params.force", &bool_buf1, &parse_error) == true) {
                 response->data = jsonrpc_respond_ok(response->data, request->cmd_id, request->id, JSONRPC_FACILITY_DATABASE);
                 push_response(response);
-                mpd_worker_album_cache_create(mpd_worker_state, bool_buf1);
+                mpd_worker_album_cache_create(mpd_worker_state, bool_buf1, update_paths);
+                mpd_worker_song_index_create(mpd_worker_state, bool_buf1);
                 async = true;
             }
+            list_free(update_paths);
+            request->extra = NULL;
             break;
+        }
         case MYMPD_API_PLAYLIST_CONTENT_ENUMERATE:
             if (json_get_string(request->data, "$.params.plist", 1, FILENAME_LEN_MAX, &sds_buf1, vcb_isfilename, &parse_error) == true) {
                 response->data = mpd_worker_playlist_content_enumerate(partition_state, response->data, request->id, sds_buf1);
             }
             break;
+        case MYMPD_API_PLAYLIST_CONTENT_LIST:
+            response->data = mympd_api_playlist_content_list_request(partition_state, mpd_worker_state->stickerdb, request, response, &parse_error);
+            break;
         case MYMPD_API_PLAYLIST_CONTENT_SHUFFLE:
             if (json_get_string(request->data, "$.params.plist", 1, FILENAME_LEN_MAX, &sds_buf1, vcb_isfilename, &parse_error) == true) {
                 rc = mpd_client_playlist_shuffle(partition_state, sds_buf1, &error);
@@ -334,6 +348,9 @@ void mpd_worker_api(struct t_mpd_worker_state *mpd_worker_state) {
                 async = true;
             }
             break;
+        case MYMPD_API_DATABASE_SEARCH:
+            response->data = mympd_api_search_songs_request(partition_state, mpd_worker_state->stickerdb, request, response, &parse_error);
+            break;
         case MYMPD_API_SMARTPLS_UPDATE:
             if (mpd_worker_state->smartpls == false) {
                 response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
@@ -393,7 +410,9 @@ void mpd_worker_api(struct t_mpd_worker_state *mpd_worker_state) {
     }
 
     //sync request handling
-    if (sdslen(response->data) == 0) {
+    if (sdslen(response->data) == 0 &&
+        response->chunks == 0)
+    {
         // error handling
         if (parse_error.message != NULL) {
             // jsonrpc parsing error
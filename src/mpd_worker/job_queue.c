@@ -0,0 +1,354 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/mpd_worker/job_queue.h"
+
+#include "src/lib/jsonrpc.h"
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/sds_extras.h"
+#include "src/mpd_worker/state.h"
+
+#include <limits.h>
+
+/*
+ Priority queue for the mpd_worker thread pool.
+ Pending jobs are kept in one fifo list per priority,
+ the list node value_i is the job id and user_data the job itself.
+ Low priority jobs can not occupy all worker threads, one thread is kept
+ free for interactive requests.
+*/
+
+// private definitions
+
+static unsigned get_job_idx(struct t_list *l, unsigned id);
+static unsigned get_pending_length(struct t_mpd_worker_queue *queue);
+static sds print_job(sds buffer, struct t_mpd_worker_job *job);
+
+// public functions
+
+/**
+ * Creates a new mpd_worker job
+ * @param cmd_id api method of the job
+ * @param partition mpd partition
+ * @param prio job priority
+ * @param key key to detect identical pending jobs, empty string or NULL to disable deduplication
+ * @param mpd_worker_state job data, the job takes ownership
+ * @return newly allocated job
+ */
+struct t_mpd_worker_job *mpd_worker_job_new(enum mympd_cmd_ids cmd_id, const char *partition,
+        enum mpd_worker_job_prio prio, const char *key, struct t_mpd_worker_state *mpd_worker_state)
+{
+    struct t_mpd_worker_job *job = malloc_assert(sizeof(struct t_mpd_worker_job));
+    job->id = 0;
+    job->prio = prio;
+    job->cmd_id = cmd_id;
+    job->partition = sdsnew(partition);
+    job->key = key != NULL
+        ? sdsnew(key)
+        : sdsempty();
+    job->queued = 0;
+    job->started = 0;
+    job->canceled = false;
+    job->mpd_worker_state = mpd_worker_state;
+    if (mpd_worker_state != NULL) {
+        mpd_worker_state->job = job;
+    }
+    return job;
+}
+
+/**
+ * Frees the job and the attached job data
+ * @param job the job to free
+ */
+void mpd_worker_job_free(struct t_mpd_worker_job *job) {
+    FREE_SDS(job->partition);
+    FREE_SDS(job->key);
+    if (job->mpd_worker_state != NULL) {
+        mpd_worker_state_free(job->mpd_worker_state);
+    }
+    FREE_PTR(job);
+}
+
+/**
+ * Initializes the job queue
+ * @param queue pointer to the queue
+ * @param max_pending maximum number of pending jobs
+ */
+void mpd_worker_queue_init(struct t_mpd_worker_queue *queue, unsigned max_pending) {
+    for (unsigned i = 0; i < MPD_WORKER_PRIO_COUNT; i++) {
+        list_init(&queue->pending[i]);
+    }
+    list_init(&queue->running);
+    queue->low_running = 0;
+    queue->low_running_max = MPD_WORKER_THREADS > 1
+        ? MPD_WORKER_THREADS - 1
+        : 1;
+    queue->max_pending = max_pending;
+    queue->next_id = 1;
+    queue->stop = false;
+    queue->mutex = (pthread_mutex_t)PTHREAD_MUTEX_INITIALIZER;
+    queue->wakeup = (pthread_cond_t)PTHREAD_COND_INITIALIZER;
+}
+
+/**
+ * Frees all pending jobs.
+ * All worker threads must be finished.
+ * @param queue pointer to the queue
+ */
+void mpd_worker_queue_clear(struct t_mpd_worker_queue *queue) {
+    for (unsigned i = 0; i < MPD_WORKER_PRIO_COUNT; i++) {
+        struct t_list_node *current;
+        while ((current = list_shift_first(&queue->pending[i])) != NULL) {
+            mpd_worker_job_free((struct t_mpd_worker_job *)current->user_data);
+            current->user_data = NULL;
+            list_node_free(current);
+        }
+    }
+    if (queue->running.length > 0) {
+        MYMPD_LOG_WARN(NULL, "%u mpd_worker jobs are still running", queue->running.length);
+    }
+    list_clear(&queue->running);
+    pthread_mutex_destroy(&queue->mutex);
+    pthread_cond_destroy(&queue->wakeup);
+}
+
+/**
+ * Appends a job to the queue and wakes up a worker thread.
+ * The queue takes the ownership of the job only if MPD_WORKER_QUEUE_ADDED is returned.
+ * @param queue pointer to the queue
+ * @param job the job to add
+ * @return enum mpd_worker_queue_rc
+ */
+enum mpd_worker_queue_rc mpd_worker_queue_push(struct t_mpd_worker_queue *queue, struct t_mpd_worker_job *job) {
+    enum mpd_worker_queue_rc rc = MPD_WORKER_QUEUE_ADDED;
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->stop == true) {
+        rc = MPD_WORKER_QUEUE_STOPPED;
+    }
+    else if (sdslen(job->key) > 0 &&
+        list_get_node(&queue->pending[job->prio], job->key) != NULL)
+    {
+        rc = MPD_WORKER_QUEUE_DUPLICATE;
+    }
+    else if (get_pending_length(queue) >= queue->max_pending) {
+        rc = MPD_WORKER_QUEUE_FULL;
+    }
+    else {
+        job->id = queue->next_id++;
+        job->queued = time(NULL);
+        list_push(&queue->pending[job->prio], job->key, (int64_t)job->id, NULL, job);
+        pthread_cond_signal(&queue->wakeup);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return rc;
+}
+
+/**
+ * Waits for the next job with the highest priority and marks it as running.
+ * Low priority jobs are skipped while low_running_max of them are running.
+ * @param queue pointer to the queue
+ * @return the job or NULL if the queue is shutting down
+ */
+struct t_mpd_worker_job *mpd_worker_queue_shift(struct t_mpd_worker_queue *queue) {
+    struct t_mpd_worker_job *job = NULL;
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->stop == false) {
+        for (unsigned i = 0; i < MPD_WORKER_PRIO_COUNT; i++) {
+            if (i == MPD_WORKER_PRIO_LOW &&
+                queue->low_running >= queue->low_running_max)
+            {
+                break;
+            }
+            struct t_list_node *node = list_shift_first(&queue->pending[i]);
+            if (node != NULL) {
+                job = (struct t_mpd_worker_job *)node->user_data;
+                node->user_data = NULL;
+                list_node_free(node);
+                break;
+            }
+        }
+        if (job != NULL) {
+            job->started = time(NULL);
+            if (job->prio == MPD_WORKER_PRIO_LOW) {
+                queue->low_running++;
+            }
+            list_push(&queue->running, job->key, (int64_t)job->id, NULL, job);
+            break;
+        }
+        pthread_cond_wait(&queue->wakeup, &queue->mutex);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return job;
+}
+
+/**
+ * Removes a finished job from the running list.
+ * The caller keeps the ownership of the job.
+ * @param queue pointer to the queue
+ * @param job the finished job
+ */
+void mpd_worker_queue_done(struct t_mpd_worker_queue *queue, struct t_mpd_worker_job *job) {
+    pthread_mutex_lock(&queue->mutex);
+    unsigned idx = get_job_idx(&queue->running, job->id);
+    if (idx < UINT_MAX) {
+        struct t_list_node *node = list_node_extract(&queue->running, idx);
+        node->user_data = NULL;
+        list_node_free(node);
+    }
+    if (job->prio == MPD_WORKER_PRIO_LOW &&
+        queue->low_running > 0)
+    {
+        queue->low_running--;
+        //a waiting low priority job can be started now
+        pthread_cond_broadcast(&queue->wakeup);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+/**
+ * Cancels a job.
+ * Pending jobs are removed from the queue and returned, running jobs are flagged.
+ * @param queue pointer to the queue
+ * @param id the job id
+ * @param job set to the removed pending job, the caller takes the ownership
+ * @return enum mpd_worker_cancel_rc
+ */
+enum mpd_worker_cancel_rc mpd_worker_queue_cancel(struct t_mpd_worker_queue *queue, unsigned id,
+        struct t_mpd_worker_job **job)
+{
+    enum mpd_worker_cancel_rc rc = MPD_WORKER_CANCEL_NOT_FOUND;
+    *job = NULL;
+    pthread_mutex_lock(&queue->mutex);
+    for (unsigned i = 0; i < MPD_WORKER_PRIO_COUNT; i++) {
+        unsigned idx = get_job_idx(&queue->pending[i], id);
+        if (idx < UINT_MAX) {
+            struct t_list_node *node = list_node_extract(&queue->pending[i], idx);
+            *job = (struct t_mpd_worker_job *)node->user_data;
+            node->user_data = NULL;
+            list_node_free(node);
+            rc = MPD_WORKER_CANCEL_PENDING;
+            break;
+        }
+    }
+    if (rc == MPD_WORKER_CANCEL_NOT_FOUND) {
+        unsigned idx = get_job_idx(&queue->running, id);
+        if (idx < UINT_MAX) {
+            struct t_list_node *node = list_node_at(&queue->running, idx);
+            ((struct t_mpd_worker_job *)node->user_data)->canceled = true;
+            rc = MPD_WORKER_CANCEL_RUNNING;
+        }
+    }
+    pthread_mutex_unlock(&queue->mutex);
+    return rc;
+}
+
+/**
+ * Stops the queue, flags all running jobs for cancellation
+ * and wakes up all waiting worker threads.
+ * @param queue pointer to the queue
+ */
+void mpd_worker_queue_stop(struct t_mpd_worker_queue *queue) {
+    pthread_mutex_lock(&queue->mutex);
+    queue->stop = true;
+    struct t_list_node *current = queue->running.head;
+    while (current != NULL) {
+        ((struct t_mpd_worker_job *)current->user_data)->canceled = true;
+        current = current->next;
+    }
+    pthread_cond_broadcast(&queue->wakeup);
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+/**
+ * Prints the queue depth, the running and the pending jobs as json
+ * @param queue pointer to the queue
+ * @param buffer already allocated sds string to append the json
+ * @return pointer to buffer
+ */
+sds mpd_worker_queue_print(struct t_mpd_worker_queue *queue, sds buffer) {
+    pthread_mutex_lock(&queue->mutex);
+    buffer = tojson_uint(buffer, "queueDepth", get_pending_length(queue), true);
+    buffer = sdscat(buffer, "\"running\":[");
+    struct t_list_node *current = queue->running.head;
+    while (current != NULL) {
+        buffer = print_job(buffer, (struct t_mpd_worker_job *)current->user_data);
+        current = current->next;
+        if (current != NULL) {
+            buffer = sdscatlen(buffer, ",", 1);
+        }
+    }
+    buffer = sdscat(buffer, "],\"pending\":[");
+    bool first = true;
+    for (unsigned i = 0; i < MPD_WORKER_PRIO_COUNT; i++) {
+        current = queue->pending[i].head;
+        while (current != NULL) {
+            if (first == false) {
+                buffer = sdscatlen(buffer, ",", 1);
+            }
+            buffer = print_job(buffer, (struct t_mpd_worker_job *)current->user_data);
+            first = false;
+            current = current->next;
+        }
+    }
+    buffer = sdscatlen(buffer, "]", 1);
+    pthread_mutex_unlock(&queue->mutex);
+    return buffer;
+}
+
+// private functions
+
+/**
+ * Gets the list index of a job
+ * @param l list to search
+ * @param id job id
+ * @return the list index or UINT_MAX if not found
+ */
+static unsigned get_job_idx(struct t_list *l, unsigned id) {
+    unsigned idx = 0;
+    struct t_list_node *current = l->head;
+    while (current != NULL) {
+        if (current->value_i == (int64_t)id) {
+            return idx;
+        }
+        idx++;
+        current = current->next;
+    }
+    return UINT_MAX;
+}
+
+/**
+ * Returns the number of pending jobs, the caller must hold the mutex
+ * @param queue pointer to the queue
+ * @return number of pending jobs
+ */
+static unsigned get_pending_length(struct t_mpd_worker_queue *queue) {
+    unsigned len = 0;
+    for (unsigned i = 0; i < MPD_WORKER_PRIO_COUNT; i++) {
+        len += queue->pending[i].length;
+    }
+    return len;
+}
+
+/**
+ * Prints a job as json object
+ * @param buffer already allocated sds string to append the json
+ * @param job the job to print
+ * @return pointer to buffer
+ */
+static sds print_job(sds buffer, struct t_mpd_worker_job *job) {
+    buffer = sdscatlen(buffer, "{", 1);
+    buffer = tojson_uint(buffer, "id", job->id, true);
+    buffer = tojson_char(buffer, "method", get_cmd_id_method_name(job->cmd_id), true);
+    buffer = tojson_sds(buffer, "partition", job->partition, true);
+    buffer = tojson_uint(buffer, "priority", (unsigned)job->prio, true);
+    buffer = tojson_time(buffer, "queued", job->queued, true);
+    buffer = tojson_time(buffer, "started", job->started, true);
+    buffer = tojson_bool(buffer, "canceled", job->canceled, false);
+    buffer = sdscatlen(buffer, "}", 1);
+    return buffer;
+}
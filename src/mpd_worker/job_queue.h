@@ -0,0 +1,93 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_MPD_WORKER_JOB_QUEUE_H
+#define MYMPD_MPD_WORKER_JOB_QUEUE_H
+
+#include "dist/sds/sds.h"
+#include "src/lib/api.h"
+#include "src/lib/list.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+struct t_mpd_worker_state;
+
+/**
+ * Priorities of the mpd_worker jobs, lower values are served first
+ */
+enum mpd_worker_job_prio {
+    MPD_WORKER_PRIO_HIGH = 0,  //!< jobs that are required for playback, e.g. jukebox
+    MPD_WORKER_PRIO_NORMAL,    //!< interactive user requests
+    MPD_WORKER_PRIO_LOW,       //!< bulk jobs, e.g. cache creation
+    MPD_WORKER_PRIO_COUNT
+};
+
+/**
+ * Return codes of mpd_worker_queue_push
+ */
+enum mpd_worker_queue_rc {
+    MPD_WORKER_QUEUE_ADDED = 0,  //!< job was added
+    MPD_WORKER_QUEUE_DUPLICATE,  //!< an identical job is already pending
+    MPD_WORKER_QUEUE_FULL,       //!< too many pending jobs
+    MPD_WORKER_QUEUE_STOPPED     //!< the queue is shutting down
+};
+
+/**
+ * Return codes of mpd_worker_queue_cancel
+ */
+enum mpd_worker_cancel_rc {
+    MPD_WORKER_CANCEL_NOT_FOUND = 0,  //!< unknown job id
+    MPD_WORKER_CANCEL_PENDING,        //!< pending job was removed from the queue
+    MPD_WORKER_CANCEL_RUNNING         //!< running job was flagged for cancellation
+};
+
+/**
+ * A job for the mpd_worker thread pool
+ */
+struct t_mpd_worker_job {
+    unsigned id;                                   //!< job id, assigned by mpd_worker_queue_push
+    enum mpd_worker_job_prio prio;                 //!< job priority
+    enum mympd_cmd_ids cmd_id;                     //!< api method of the job
+    sds partition;                                 //!< mpd partition of the job
+    sds key;                                       //!< key to detect identical pending jobs, empty = no deduplication
+    time_t queued;                                 //!< time the job was queued
+    time_t started;                                //!< time the job was started, 0 = pending
+    _Atomic bool canceled;                         //!< cancellation flag, checked by long running jobs
+    struct t_mpd_worker_state *mpd_worker_state;   //!< job data
+};
+
+/**
+ * Thread safe priority queue for the mpd_worker thread pool
+ */
+struct t_mpd_worker_queue {
+    struct t_list pending[MPD_WORKER_PRIO_COUNT];  //!< pending jobs per priority
+    struct t_list running;                         //!< jobs processed by the worker threads
+    unsigned low_running;                          //!< number of running low priority jobs
+    unsigned low_running_max;                      //!< maximum number of concurrently running low priority jobs
+    unsigned max_pending;                          //!< maximum number of pending jobs
+    unsigned next_id;                              //!< id for the next job
+    bool stop;                                     //!< true if the queue is shutting down
+    pthread_mutex_t mutex;                         //!< the mutex
+    pthread_cond_t wakeup;                         //!< condition variable for the mutex
+};
+
+struct t_mpd_worker_job *mpd_worker_job_new(enum mympd_cmd_ids cmd_id, const char *partition,
+        enum mpd_worker_job_prio prio, const char *key, struct t_mpd_worker_state *mpd_worker_state);
+void mpd_worker_job_free(struct t_mpd_worker_job *job);
+
+void mpd_worker_queue_init(struct t_mpd_worker_queue *queue, unsigned max_pending);
+void mpd_worker_queue_clear(struct t_mpd_worker_queue *queue);
+enum mpd_worker_queue_rc mpd_worker_queue_push(struct t_mpd_worker_queue *queue, struct t_mpd_worker_job *job);
+struct t_mpd_worker_job *mpd_worker_queue_shift(struct t_mpd_worker_queue *queue);
+void mpd_worker_queue_done(struct t_mpd_worker_queue *queue, struct t_mpd_worker_job *job);
+enum mpd_worker_cancel_rc mpd_worker_queue_cancel(struct t_mpd_worker_queue *queue, unsigned id,
+        struct t_mpd_worker_job **job);
+void mpd_worker_queue_stop(struct t_mpd_worker_queue *queue);
+sds mpd_worker_queue_print(struct t_mpd_worker_queue *queue, sds buffer);
+
+#endif
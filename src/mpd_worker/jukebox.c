@@ -62,6 +62,7 @@ bool mpd_worker_jukebox_queue_fill(struct t_mpd_worker_state *mpd_worker_state,
         .uniq_tag = mpd_worker_state->partition_state->jukebox.uniq_tag.tags[0],
         .last_played = mpd_worker_state->partition_state->jukebox.last_played,
         .ignore_hated = mpd_worker_state->partition_state->jukebox.ignore_hated,
+        .weighting = mpd_worker_state->partition_state->jukebox.weighting,
         .min_song_duration = mpd_worker_state->partition_state->jukebox.min_song_duration,
         .max_song_duration = mpd_worker_state->partition_state->jukebox.max_song_duration
     };
@@ -82,7 +83,7 @@ bool mpd_worker_jukebox_queue_fill(struct t_mpd_worker_state *mpd_worker_state,
     }
     else if (mpd_worker_state->partition_state->jukebox.mode == JUKEBOX_ADD_SONG) {
         expected_length = JUKEBOX_INTERNAL_SONG_QUEUE_LENGTH + add_songs;
-        new_length = random_select_songs(mpd_worker_state->partition_state, mpd_worker_state->stickerdb, expected_length,
+        new_length = random_select_songs(mpd_worker_state->partition_state, mpd_worker_state->stickerdb, mpd_worker_state->song_index, expected_length,
             mpd_worker_state->partition_state->jukebox.playlist, queue_list, mpd_worker_state->partition_state->jukebox.queue, &constraints);
     }
     else {
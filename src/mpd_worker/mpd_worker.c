@@ -7,15 +7,20 @@
 #include "compile_time.h"
 #include "src/mpd_worker/mpd_worker.h"
 
+#include "dist/mjson/mjson.h"
 #include "dist/sds/sds.h"
+#include "src/lib/jsonrpc.h"
 #include "src/lib/log.h"
 #include "src/lib/mem.h"
 #include "src/lib/mympd_state.h"
 #include "src/lib/sds_extras.h"
 #include "src/lib/thread.h"
 #include "src/mpd_client/connection.h"
+#include "src/mpd_client/partitions.h"
 #include "src/mpd_client/stickerdb.h"
+#include "src/mpd_client/tags.h"
 #include "src/mpd_worker/api.h"
+#include "src/mympd_api/database.h"
 
 #include <pthread.h>
 #include <string.h>
@@ -24,38 +29,96 @@
  * Private definitions
  */
 
+/**
+ * A thread of the mpd_worker thread pool with its long-lived mpd connections
+ */
+struct t_mpd_worker_thread {
+    pthread_t thread;                           //!< thread id
+    unsigned idx;                               //!< index in the thread pool
+    struct t_partition_state *partition_state;  //!< holds the mpd connection, created on first use
+    struct t_stickerdb_state *stickerdb;        //!< holds the stickerdb connection, created on first use
+    sds conn_key;                               //!< connection settings of the mpd connection
+    sds stickerdb_conn_key;                     //!< connection settings of the stickerdb connection
+};
+
+static struct t_mpd_worker_queue mpd_worker_queue;
+static struct t_mpd_worker_thread mpd_worker_pool[MPD_WORKER_THREADS];
+
 static void *mpd_worker_run(void *arg);
+static void mpd_worker_job_run(struct t_mpd_worker_thread *thread, struct t_mpd_worker_job *job);
+static bool mpd_worker_job_attach(struct t_mpd_worker_thread *thread, struct t_mpd_worker_state *mpd_worker_state);
+static void mpd_worker_job_detach(struct t_mpd_worker_thread *thread, struct t_mpd_worker_state *mpd_worker_state);
+static void mpd_worker_thread_free(struct t_mpd_worker_thread *thread);
+static sds get_conn_key(sds buffer, struct t_mpd_state *mpd_state);
+static sds get_job_key(sds buffer, struct t_work_request *request);
+static enum mpd_worker_job_prio get_job_prio(enum mympd_cmd_ids cmd_id);
+static void swap_jukebox_state(struct t_jukebox_state *a, struct t_jukebox_state *b);
+static void get_song_index_tags(struct t_mympd_state *mympd_state, struct t_tags *tags);
 
 /**
  * Public functions
  */
 
 /**
- * Starts the worker thread in detached state.
+ * Starts the mpd_worker thread pool.
+ * The threads connect to mpd on first use and keep the connections open.
+ * @return true on success, else false
+ */
+bool mpd_worker_pool_start(void) {
+    mpd_worker_queue_init(&mpd_worker_queue, MPD_WORKER_QUEUE_MAX);
+    MYMPD_LOG_NOTICE(NULL, "Starting %d mpd_worker threads", MPD_WORKER_THREADS);
+    bool rc = true;
+    for (unsigned i = 0; i < MPD_WORKER_THREADS; i++) {
+        struct t_mpd_worker_thread *thread = &mpd_worker_pool[i];
+        thread->idx = i;
+        thread->partition_state = NULL;
+        thread->stickerdb = NULL;
+        thread->conn_key = sdsempty();
+        thread->stickerdb_conn_key = sdsempty();
+        if (pthread_create(&thread->thread, NULL, mpd_worker_run, thread) != 0) {
+            MYMPD_LOG_ERROR(NULL, "Can not create mpd_worker thread %u", i);
+            thread->thread = 0;
+            rc = false;
+        }
+    }
+    return rc;
+}
+
+/**
+ * Stops the mpd_worker thread pool.
+ * Running jobs are canceled and pending jobs are discarded.
+ */
+void mpd_worker_pool_stop(void) {
+    MYMPD_LOG_NOTICE(NULL, "Stopping mpd_worker threads");
+    mpd_worker_queue_stop(&mpd_worker_queue);
+    for (unsigned i = 0; i < MPD_WORKER_THREADS; i++) {
+        struct t_mpd_worker_thread *thread = &mpd_worker_pool[i];
+        if (thread->thread > (pthread_t)0) {
+            pthread_join(thread->thread, NULL);
+        }
+        FREE_SDS(thread->conn_key);
+        FREE_SDS(thread->stickerdb_conn_key);
+    }
+    mpd_worker_queue_clear(&mpd_worker_queue);
+}
+
+/**
+ * Creates a snapshot of the states for the request and queues it for the mpd_worker thread pool.
+ * The job takes the ownership of the request only if MPD_WORKER_QUEUE_ADDED is returned.
  * @param mympd_state pointer to mympd_state struct
  * @param partition_state pointer to partition_state struct
  * @param request the work request
- * @return true on success, else false
+ * @return enum mpd_worker_queue_rc
  */
-bool mpd_worker_start(struct t_mympd_state *mympd_state, struct t_partition_state *partition_state,
+enum mpd_worker_queue_rc mpd_worker_start(struct t_mympd_state *mympd_state, struct t_partition_state *partition_state,
         struct t_work_request *request)
 {
-    MYMPD_LOG_NOTICE(NULL, "Starting mpd_worker thread for %s", get_cmd_id_method_name(request->cmd_id));
-    pthread_t mpd_worker_thread;
-    pthread_attr_t attr;
-    if (pthread_attr_init(&attr) != 0) {
-        MYMPD_LOG_ERROR(NULL, "Can not init mpd_worker thread attribute");
-        return false;
-    }
-    if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0) {
-        MYMPD_LOG_ERROR(NULL, "Can not set mpd_worker thread to detached");
-        return false;
-    }
     //create mpd worker state from mympd_state
     struct t_mpd_worker_state *mpd_worker_state = malloc_assert(sizeof(struct t_mpd_worker_state));
     mpd_worker_state->mympd_only = is_mympd_only_api_method(request->cmd_id);
     mpd_worker_state->request = request;
     mpd_worker_state->config = mympd_state->config;
+    mpd_worker_state->job = NULL;
 
     mpd_worker_state->smartpls = mympd_state->smartpls == true ?
         mympd_state->mpd_state->feat.playlists
@@ -65,44 +128,96 @@ bool mpd_worker_start(struct t_mympd_state *mympd_state, struct t_partition_stat
     mpd_worker_state->tag_disc_empty_is_first = mympd_state->tag_disc_empty_is_first;
     tags_clone(&mympd_state->smartpls_generate_tag_types, &mpd_worker_state->smartpls_generate_tag_types);
     mpd_worker_state->album_cache = &mympd_state->album_cache;
+    mpd_worker_state->song_index = &mympd_state->song_index;
+    get_song_index_tags(mympd_state, &mpd_worker_state->song_index_tags);
+    //the connections are set by the worker thread
+    mpd_worker_state->partition_state = NULL;
+    mpd_worker_state->stickerdb = NULL;
+    jukebox_state_default(&mpd_worker_state->jukebox);
 
     if (mpd_worker_state->mympd_only == true) {
         mpd_worker_state->mpd_state = NULL;
-        mpd_worker_state->partition_state = NULL;
-        mpd_worker_state->stickerdb = NULL;
+        mpd_worker_state->stickerdb_mpd_state = NULL;
     }
     else {
         //mpd state
         mpd_worker_state->mpd_state = malloc_assert(sizeof(struct t_mpd_state));
         mpd_state_copy(mympd_state->mpd_state, mpd_worker_state->mpd_state);
-
-        //partition state
-        mpd_worker_state->partition_state = malloc_assert(sizeof(struct t_partition_state));
-        //set defaults
-        partition_state_default(mpd_worker_state->partition_state, partition_state->name,
-                mpd_worker_state->mpd_state, mpd_worker_state->config);
         //copy jukebox settings
-        jukebox_state_copy(&partition_state->jukebox, &mpd_worker_state->partition_state->jukebox);
-        //use mpd state from worker
-        mpd_worker_state->partition_state->mpd_state = mpd_worker_state->mpd_state;
-
-        //stickerdb
-        mpd_worker_state->stickerdb = malloc_assert(sizeof(struct t_partition_state));
-        //worker runs always in default partition
-        stickerdb_state_default(mpd_worker_state->stickerdb, mpd_worker_state->config);
+        jukebox_state_copy(&partition_state->jukebox, &mpd_worker_state->jukebox);
         // do not use the shared mpd_state - we can connect to another mpd server for stickers
-        mpd_worker_state->stickerdb->mpd_state = malloc_assert(sizeof(struct t_mpd_state));
-        mpd_state_copy(mympd_state->stickerdb->mpd_state, mpd_worker_state->stickerdb->mpd_state);
+        mpd_worker_state->stickerdb_mpd_state = malloc_assert(sizeof(struct t_mpd_state));
+        mpd_state_copy(mympd_state->stickerdb->mpd_state, mpd_worker_state->stickerdb_mpd_state);
     }
 
-    //create the worker thread
-    if (pthread_create(&mpd_worker_thread, &attr, mpd_worker_run, mpd_worker_state) != 0) {
-        MYMPD_LOG_ERROR(NULL, "Can not create mpd_worker thread");
-        mpd_worker_state_free(mpd_worker_state);
-        return false;
+    sds key = get_job_key(sdsempty(), request);
+    struct t_mpd_worker_job *job = mpd_worker_job_new(request->cmd_id, request->partition,
+        get_job_prio(request->cmd_id), key, mpd_worker_state);
+    FREE_SDS(key);
+
+    enum mpd_worker_queue_rc rc = mpd_worker_queue_push(&mpd_worker_queue, job);
+    if (rc == MPD_WORKER_QUEUE_ADDED) {
+        MYMPD_LOG_INFO(partition_state->name, "Queued mpd_worker job %u: %s", job->id, get_cmd_id_method_name(request->cmd_id));
     }
-    mpd_worker_threads++;
-    return true;
+    else {
+        //the caller keeps the ownership of the request
+        mpd_worker_state->request = NULL;
+        mpd_worker_job_free(job);
+    }
+    return rc;
+}
+
+/**
+ * Cancels a mpd_worker job.
+ * Pending jobs are removed and the requester gets a response,
+ * running jobs are notified and stop at the next check.
+ * @param mympd_state pointer to mympd_state struct
+ * @param job_id the job id
+ * @return enum mpd_worker_cancel_rc
+ */
+enum mpd_worker_cancel_rc mpd_worker_cancel(struct t_mympd_state *mympd_state, unsigned job_id) {
+    struct t_mpd_worker_job *job;
+    enum mpd_worker_cancel_rc rc = mpd_worker_queue_cancel(&mpd_worker_queue, job_id, &job);
+    if (rc != MPD_WORKER_CANCEL_PENDING) {
+        return rc;
+    }
+    struct t_work_request *request = job->mpd_worker_state->request;
+    MYMPD_LOG_NOTICE(request->partition, "Removed pending mpd_worker job %u: %s", job_id, get_cmd_id_method_name(request->cmd_id));
+    //reset the state flags the mympd_api thread has set for this job
+    if (request->cmd_id == MYMPD_API_CACHES_CREATE) {
+        mympd_state->album_cache.building = false;
+        //keep the updated paths for the next album cache creation
+        mympd_api_database_update_paths_restore(&mympd_state->album_cache_update_paths, request->extra);
+    }
+    else if (request->cmd_id == INTERNAL_API_JUKEBOX_REFILL ||
+        request->cmd_id == INTERNAL_API_JUKEBOX_REFILL_ADD)
+    {
+        struct t_partition_state *partition_state = partitions_get_by_name(mympd_state, request->partition);
+        if (partition_state != NULL) {
+            partition_state->jukebox.filling = false;
+        }
+    }
+    struct t_work_response *response = create_response(request);
+    response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
+        JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_WARN, "Job was canceled");
+    push_response(response);
+    mpd_worker_job_free(job);
+    return rc;
+}
+
+/**
+ * Prints the status of the mpd_worker thread pool
+ * @param buffer already allocated sds string to append the response
+ * @param cmd_id jsonrpc method
+ * @param request_id jsonrpc request id
+ * @return pointer to buffer
+ */
+sds mpd_worker_status(sds buffer, enum mympd_cmd_ids cmd_id, unsigned request_id) {
+    buffer = jsonrpc_respond_start(buffer, cmd_id, request_id);
+    buffer = tojson_uint(buffer, "threads", MPD_WORKER_THREADS, true);
+    buffer = mpd_worker_queue_print(&mpd_worker_queue, buffer);
+    buffer = jsonrpc_end(buffer);
+    return buffer;
 }
 
 /**
@@ -110,41 +225,254 @@ bool mpd_worker_start(struct t_mympd_state *mympd_state, struct t_partition_stat
  */
 
 /**
- * This is the main function of the worker thread.
- * @param arg void pointer to the mpd_worker_state
+ * This is the main function of the worker threads.
+ * @param arg void pointer to the t_mpd_worker_thread struct
  */
 static void *mpd_worker_run(void *arg) {
+    struct t_mpd_worker_thread *thread = (struct t_mpd_worker_thread *) arg;
     thread_logname = sds_replace(thread_logname, "mpdworker");
+    thread_logname = sdscatfmt(thread_logname, "%u", thread->idx);
     set_threadname(thread_logname);
-    struct t_mpd_worker_state *mpd_worker_state = (struct t_mpd_worker_state *) arg;
+    struct t_mpd_worker_job *job;
+    while ((job = mpd_worker_queue_shift(&mpd_worker_queue)) != NULL) {
+        mpd_worker_job_run(thread, job);
+        mpd_worker_queue_done(&mpd_worker_queue, job);
+        mpd_worker_job_free(job);
+    }
+    mpd_worker_thread_free(thread);
+    FREE_SDS(thread_logname);
+    return NULL;
+}
+
+/**
+ * Runs a job
+ * @param thread the worker thread
+ * @param job the job to run
+ */
+static void mpd_worker_job_run(struct t_mpd_worker_thread *thread, struct t_mpd_worker_job *job) {
+    struct t_mpd_worker_state *mpd_worker_state = job->mpd_worker_state;
+    MYMPD_LOG_NOTICE(job->partition, "Starting mpd_worker job %u: %s", job->id, get_cmd_id_method_name(job->cmd_id));
     if (mpd_worker_state->mympd_only == true) {
-        //call api handler
+        //call api handler, it frees the request
         mpd_worker_api(mpd_worker_state);
+        mpd_worker_state->request = NULL;
     }
-    else if (mpd_client_connect(mpd_worker_state->partition_state) == true) {
-        bool rc = true;
-        if (strcmp(mpd_worker_state->partition_state->name, MPD_PARTITION_DEFAULT) != 0) {
-            if (mpd_run_switch_partition(mpd_worker_state->partition_state->conn, mpd_worker_state->partition_state->name) == false) {
-                MYMPD_LOG_ERROR(MPD_PARTITION_DEFAULT, "Could not switch to partition \"%s\"", mpd_worker_state->partition_state->name);
-                rc = false;
-            }
-        }
-        if (rc == true) {
-            //call api handler
+    else {
+        if (mpd_worker_job_attach(thread, mpd_worker_state) == true) {
             mpd_worker_api(mpd_worker_state);
-            //disconnect
-            mpd_client_disconnect_silent(mpd_worker_state->partition_state);
+            mpd_worker_state->request = NULL;
         }
-        if (mpd_worker_state->stickerdb->conn != NULL) {
-            stickerdb_disconnect(mpd_worker_state->stickerdb);
+        else {
+            MYMPD_LOG_ERROR(job->partition, "Running mpd_worker job %u failed", job->id);
         }
+        mpd_worker_job_detach(thread, mpd_worker_state);
     }
-    else {
-        MYMPD_LOG_ERROR(NULL, "Running mpd_worker failed");
+    MYMPD_LOG_NOTICE(job->partition, "Finished mpd_worker job %u", job->id);
+}
+
+/**
+ * Attaches the job to the connections of the worker thread.
+ * Reuses the open connections if the connection settings are unchanged.
+ * @param thread the worker thread
+ * @param mpd_worker_state the job state
+ * @return true on success, else false
+ */
+static bool mpd_worker_job_attach(struct t_mpd_worker_thread *thread, struct t_mpd_worker_state *mpd_worker_state) {
+    if (thread->partition_state == NULL) {
+        thread->partition_state = malloc_assert(sizeof(struct t_partition_state));
+        partition_state_default(thread->partition_state, MPD_PARTITION_DEFAULT,
+            mpd_worker_state->mpd_state, mpd_worker_state->config);
+        thread->stickerdb = malloc_assert(sizeof(struct t_stickerdb_state));
+        stickerdb_state_default(thread->stickerdb, mpd_worker_state->config);
+    }
+    struct t_partition_state *partition_state = thread->partition_state;
+    partition_state->mpd_state = mpd_worker_state->mpd_state;
+    thread->stickerdb->mpd_state = mpd_worker_state->stickerdb_mpd_state;
+    swap_jukebox_state(&partition_state->jukebox, &mpd_worker_state->jukebox);
+    mpd_worker_state->partition_state = partition_state;
+    mpd_worker_state->stickerdb = thread->stickerdb;
+
+    //drop the connections if the connection settings have changed
+    sds key = get_conn_key(sdsempty(), mpd_worker_state->mpd_state);
+    if (strcmp(key, thread->conn_key) != 0) {
+        mpd_client_disconnect_silent(partition_state);
+        thread->conn_key = sds_replace(thread->conn_key, key);
+    }
+    sdsclear(key);
+    key = get_conn_key(key, mpd_worker_state->stickerdb_mpd_state);
+    if (strcmp(key, thread->stickerdb_conn_key) != 0) {
+        stickerdb_disconnect(thread->stickerdb);
+        thread->stickerdb_conn_key = sds_replace(thread->stickerdb_conn_key, key);
+    }
+    FREE_SDS(key);
+
+    if (partition_state->conn != NULL) {
+        //leave idle mode, this fails if mpd has closed the connection
+        if (mpd_send_noidle(partition_state->conn) == true &&
+            mpd_response_finish(partition_state->conn) == true)
+        {
+            //reset the tags, the previous job could have changed them
+            enable_mpd_tags(partition_state, &partition_state->mpd_state->tags_mympd);
+        }
+        else {
+            MYMPD_LOG_INFO(partition_state->name, "Reconnecting to MPD");
+            mpd_client_disconnect_silent(partition_state);
+        }
+    }
+    if (partition_state->conn == NULL) {
+        partition_state->name = sds_replace(partition_state->name, MPD_PARTITION_DEFAULT);
+        if (mpd_client_connect(partition_state) == false) {
+            mpd_client_disconnect_silent(partition_state);
+            return false;
+        }
+    }
+    const char *partition = mpd_worker_state->request->partition;
+    if (strcmp(partition_state->name, partition) != 0) {
+        if (mpd_run_switch_partition(partition_state->conn, partition) == false) {
+            MYMPD_LOG_ERROR(partition_state->name, "Could not switch to partition \"%s\"", partition);
+            mpd_client_disconnect_silent(partition_state);
+            return false;
+        }
+        partition_state->name = sds_replace(partition_state->name, partition);
+    }
+    return true;
+}
+
+/**
+ * Detaches the job from the connections of the worker thread.
+ * The mpd connection enters the idle mode to prevent the connection timeout.
+ * @param thread the worker thread
+ * @param mpd_worker_state the job state
+ */
+static void mpd_worker_job_detach(struct t_mpd_worker_thread *thread, struct t_mpd_worker_state *mpd_worker_state) {
+    struct t_partition_state *partition_state = thread->partition_state;
+    if (partition_state->conn != NULL) {
+        if (partition_state->conn_state != MPD_CONNECTED ||
+            mpd_send_idle_mask(partition_state->conn, MPD_IDLE_PARTITION) == false)
+        {
+            mpd_client_disconnect_silent(partition_state);
+        }
+    }
+    swap_jukebox_state(&partition_state->jukebox, &mpd_worker_state->jukebox);
+    //the mpd states are owned by the job
+    partition_state->mpd_state = NULL;
+    thread->stickerdb->mpd_state = NULL;
+    mpd_worker_state->partition_state = NULL;
+    mpd_worker_state->stickerdb = NULL;
+}
+
+/**
+ * Closes the connections of a worker thread and frees the states
+ * @param thread the worker thread
+ */
+static void mpd_worker_thread_free(struct t_mpd_worker_thread *thread) {
+    if (thread->partition_state != NULL) {
+        mpd_client_disconnect_silent(thread->partition_state);
+        partition_state_free(thread->partition_state);
+        thread->partition_state = NULL;
+    }
+    if (thread->stickerdb != NULL) {
+        stickerdb_disconnect(thread->stickerdb);
+        stickerdb_state_free(thread->stickerdb);
+        thread->stickerdb = NULL;
+    }
+}
+
+/**
+ * Creates a key from the connection settings of a mpd state
+ * @param buffer already allocated sds string to append the key
+ * @param mpd_state the mpd state
+ * @return pointer to buffer
+ */
+static sds get_conn_key(sds buffer, struct t_mpd_state *mpd_state) {
+    return sdscatfmt(buffer, "%S:%u:%S:%u:%u:%u", mpd_state->mpd_host, mpd_state->mpd_port, mpd_state->mpd_pass,
+        mpd_state->mpd_binarylimit, mpd_state->mpd_timeout, (unsigned)mpd_state->mpd_keepalive);
+}
+
+/**
+ * Creates the key to detect identical pending jobs.
+ * Jobs that return data or should run each time they are requested are not deduplicated.
+ * @param buffer already allocated sds string to append the key
+ * @param request the work request
+ * @return pointer to buffer
+ */
+static sds get_job_key(sds buffer, struct t_work_request *request) {
+    switch(request->cmd_id) {
+        case INTERNAL_API_JUKEBOX_REFILL:
+        case MYMPD_API_CACHES_CREATE:
+        case MYMPD_API_CACHE_DISK_CLEAR:
+        case MYMPD_API_CACHE_DISK_CROP:
+        case MYMPD_API_PLAYLIST_CONTENT_DEDUP:
+        case MYMPD_API_PLAYLIST_CONTENT_DEDUP_ALL:
+        case MYMPD_API_PLAYLIST_CONTENT_SORT:
+        case MYMPD_API_PLAYLIST_CONTENT_VALIDATE:
+        case MYMPD_API_PLAYLIST_CONTENT_VALIDATE_ALL:
+        case MYMPD_API_PLAYLIST_CONTENT_VALIDATE_DEDUP:
+        case MYMPD_API_PLAYLIST_CONTENT_VALIDATE_DEDUP_ALL:
+        case MYMPD_API_SMARTPLS_UPDATE:
+        case MYMPD_API_SMARTPLS_UPDATE_ALL: {
+            buffer = sdscatfmt(buffer, "%s:%S:", get_cmd_id_method_name(request->cmd_id), request->partition);
+            const char *p;
+            int n;
+            if (mjson_find(request->data, (int)sdslen(request->data), "$.params", &p, &n) == MJSON_TOK_OBJECT) {
+                buffer = sdscatlen(buffer, p, (size_t)n);
+            }
+            return buffer;
+        }
+        default:
+            return buffer;
+    }
+}
+
+/**
+ * Gets the priority for a job
+ * @param cmd_id api method of the job
+ * @return the priority
+ */
+static enum mpd_worker_job_prio get_job_prio(enum mympd_cmd_ids cmd_id) {
+    switch(cmd_id) {
+        case INTERNAL_API_JUKEBOX_REFILL:
+        case INTERNAL_API_JUKEBOX_REFILL_ADD:
+            return MPD_WORKER_PRIO_HIGH;
+        case MYMPD_API_CACHES_CREATE:
+        case MYMPD_API_CACHE_DISK_CLEAR:
+        case MYMPD_API_CACHE_DISK_CROP:
+        case MYMPD_API_PLAYLIST_CONTENT_DEDUP_ALL:
+        case MYMPD_API_PLAYLIST_CONTENT_VALIDATE_ALL:
+        case MYMPD_API_PLAYLIST_CONTENT_VALIDATE_DEDUP_ALL:
+        case MYMPD_API_SMARTPLS_UPDATE_ALL:
+            return MPD_WORKER_PRIO_LOW;
+        default:
+            return MPD_WORKER_PRIO_NORMAL;
+    }
+}
+
+/**
+ * Swaps two jukebox states
+ * @param a first jukebox state
+ * @param b second jukebox state
+ */
+static void swap_jukebox_state(struct t_jukebox_state *a, struct t_jukebox_state *b) {
+    struct t_jukebox_state tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+/**
+ * Gets the tags for the song index: the jukebox uniq tags of all partitions
+ * @param mympd_state pointer to mympd_state struct
+ * @param tags pointer to the tags struct to populate
+ */
+static void get_song_index_tags(struct t_mympd_state *mympd_state, struct t_tags *tags) {
+    tags->len = 0;
+    struct t_partition_state *partition_state = mympd_state->partition_state;
+    while (partition_state != NULL) {
+        enum mpd_tag_type tag = partition_state->jukebox.uniq_tag.tags[0];
+        if (tag != MPD_TAG_UNKNOWN &&
+            mpd_client_tag_exists(tags, tag) == false)
+        {
+            tags->tags[tags->len++] = tag;
+        }
+        partition_state = partition_state->next;
     }
-    MYMPD_LOG_NOTICE(NULL, "Stopping mpd_worker thread");
-    mpd_worker_state_free(mpd_worker_state);
-    mpd_worker_threads--;
-    FREE_SDS(thread_logname);
-    return NULL;
 }
@@ -9,8 +9,13 @@
 
 #include "src/lib/api.h"
 #include "src/lib/mympd_state.h"
+#include "src/mpd_worker/job_queue.h"
 
-bool mpd_worker_start(struct t_mympd_state *mympd_state, struct t_partition_state *partition_state,
+bool mpd_worker_pool_start(void);
+void mpd_worker_pool_stop(void);
+enum mpd_worker_queue_rc mpd_worker_start(struct t_mympd_state *mympd_state, struct t_partition_state *partition_state,
         struct t_work_request *request);
+enum mpd_worker_cancel_rc mpd_worker_cancel(struct t_mympd_state *mympd_state, unsigned job_id);
+sds mpd_worker_status(sds buffer, enum mympd_cmd_ids cmd_id, unsigned request_id);
 
 #endif
@@ -81,6 +81,9 @@ bool mpd_worker_smartpls_update_all(struct t_mpd_worker_state *mpd_worker_state,
     int updated = 0;
     int skipped = 0;
     while ((next_file = readdir(dir)) != NULL) {
+        if (mpd_worker_canceled(mpd_worker_state) == true) {
+            break;
+        }
         if (next_file->d_type != DT_REG) {
             continue;
         }
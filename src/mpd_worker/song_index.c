@@ -0,0 +1,160 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/mpd_worker/song_index.h"
+
+#include "src/lib/jsonrpc.h"
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/msg_queue.h"
+#include "src/lib/song_index.h"
+#include "src/lib/utility.h"
+#include "src/mpd_client/errorhandler.h"
+#include "src/mpd_client/tags.h"
+
+/**
+ * Private definitions
+ */
+
+static bool song_index_is_current(struct t_mpd_worker_state *mpd_worker_state, time_t db_mtime);
+static bool song_index_populate(struct t_mpd_worker_state *mpd_worker_state, struct t_song_index *song_index);
+
+/**
+ * Public functions
+ */
+
+/**
+ * Creates the song index and returns it to the mympd_api thread.
+ * Only the uri, duration, last-modified and the jukebox uniq tags are fetched.
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param force true=force update, false=update only if the mpd database or the indexed tags have changed
+ * @return true on success else false
+ */
+bool mpd_worker_song_index_create(struct t_mpd_worker_state *mpd_worker_state, bool force) {
+    time_t db_mtime = mpd_client_get_db_mtime(mpd_worker_state->partition_state);
+    if (force == false &&
+        song_index_is_current(mpd_worker_state, db_mtime) == true)
+    {
+        MYMPD_LOG_INFO("default", "Song index is up-to-date");
+        return true;
+    }
+    MYMPD_LOG_INFO("default", "Creating song index");
+    #ifdef MYMPD_DEBUG
+        MEASURE_INIT
+        MEASURE_START
+    #endif
+    struct t_song_index *song_index = malloc_assert(sizeof(struct t_song_index));
+    song_index->songs = NULL;
+    song_index->len = 0;
+    song_index->size = 0;
+    song_index->db_mtime = db_mtime;
+    song_index->tags.len = 0;
+    // index only tags that are enabled in myMPD
+    for (size_t i = 0; i < mpd_worker_state->song_index_tags.len; i++) {
+        enum mpd_tag_type tag = mpd_worker_state->song_index_tags.tags[i];
+        if (mpd_client_tag_exists(&mpd_worker_state->mpd_state->tags_mympd, tag) == true) {
+            song_index->tags.tags[song_index->tags.len++] = tag;
+        }
+    }
+
+    if (song_index_populate(mpd_worker_state, song_index) == false) {
+        MYMPD_LOG_ERROR("default", "Creating song index failed");
+        song_index_clear(song_index);
+        FREE_PTR(song_index);
+        return false;
+    }
+    #ifdef MYMPD_DEBUG
+        MEASURE_END
+        MEASURE_PRINT("default", "Populate song index")
+    #endif
+    MYMPD_LOG_INFO("default", "Added %u songs to the song index", song_index->len);
+    struct t_work_request *request = create_request(REQUEST_TYPE_DISCARD, 0, 0, INTERNAL_API_SONG_INDEX_CREATED, NULL, mpd_worker_state->partition_state->name);
+    request->data = jsonrpc_end(request->data);
+    request->extra = (void *) song_index;
+    mympd_queue_push(mympd_api_queue, request, 0);
+    return true;
+}
+
+/**
+ * Private functions
+ */
+
+/**
+ * Checks if the current song index was created from the current database with all required tags
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param db_mtime modification time of the mpd database
+ * @return true if the song index is up-to-date, else false
+ */
+static bool song_index_is_current(struct t_mpd_worker_state *mpd_worker_state, time_t db_mtime) {
+    if (song_index_get_read_lock(mpd_worker_state->song_index) == false) {
+        return false;
+    }
+    bool rc = mpd_worker_state->song_index->songs != NULL &&
+        mpd_worker_state->song_index->db_mtime == db_mtime;
+    for (size_t i = 0; rc == true && i < mpd_worker_state->song_index_tags.len; i++) {
+        enum mpd_tag_type tag = mpd_worker_state->song_index_tags.tags[i];
+        if (mpd_client_tag_exists(&mpd_worker_state->mpd_state->tags_mympd, tag) == true &&
+            song_index_has_tag(mpd_worker_state->song_index, tag) == false)
+        {
+            rc = false;
+        }
+    }
+    song_index_release_lock(mpd_worker_state->song_index);
+    return rc;
+}
+
+/**
+ * Fetches all songs from the mpd database with the minimal set of tags
+ * @param mpd_worker_state pointer to mpd_worker_state struct
+ * @param song_index the song index to populate
+ * @return true on success, else false
+ */
+static bool song_index_populate(struct t_mpd_worker_state *mpd_worker_state, struct t_song_index *song_index) {
+    struct t_partition_state *partition_state = mpd_worker_state->partition_state;
+    struct t_tags enable_tags = song_index->tags;
+    if (mpd_client_tag_exists(&song_index->tags, MPD_TAG_TITLE) == true &&
+        mpd_client_tag_exists(&mpd_worker_state->mpd_state->tags_mympd, MPD_TAG_NAME) == true)
+    {
+        // the title falls back to the name tag
+        enable_tags.tags[enable_tags.len++] = MPD_TAG_NAME;
+    }
+    if (enable_tags.len > 0) {
+        enable_mpd_tags(partition_state, &enable_tags);
+    }
+    else {
+        disable_all_mpd_tags(partition_state);
+    }
+
+    unsigned start = 0;
+    unsigned end = start + MPD_RESULTS_MAX;
+    do {
+        if (mpd_worker_canceled(mpd_worker_state) == true) {
+            return false;
+        }
+        if (mpd_search_db_songs(partition_state->conn, false) == false ||
+            mpd_search_add_uri_constraint(partition_state->conn, MPD_OPERATOR_DEFAULT, "") == false ||
+            mpd_search_add_window(partition_state->conn, start, end) == false)
+        {
+            mpd_search_cancel(partition_state->conn);
+            return false;
+        }
+        if (mpd_search_commit(partition_state->conn)) {
+            struct mpd_song *song;
+            while ((song = mpd_recv_song(partition_state->conn)) != NULL) {
+                song_index_add(song_index, song);
+                mpd_song_free(song);
+            }
+        }
+        mpd_response_finish(partition_state->conn);
+        if (mympd_check_error_and_recover(partition_state, NULL, "mpd_search_db_songs") == false) {
+            return false;
+        }
+        start = end;
+        end = end + MPD_RESULTS_MAX;
+    } while (song_index->len >= start);
+    return true;
+}
@@ -0,0 +1,13 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_MPD_WORKER_SONG_INDEX_H
+#define MYMPD_MPD_WORKER_SONG_INDEX_H
+
+#include "src/mpd_worker/state.h"
+
+bool mpd_worker_song_index_create(struct t_mpd_worker_state *mpd_worker_state, bool force);
+#endif
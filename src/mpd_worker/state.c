@@ -7,11 +7,14 @@
 #include "compile_time.h"
 #include "src/mpd_worker/state.h"
 
+#include "src/lib/log.h"
 #include "src/lib/mem.h"
 #include "src/lib/sds_extras.h"
+#include "src/mpd_worker/job_queue.h"
 
 /**
- * Frees the mpd_worker_state struct
+ * Frees the mpd_worker_state struct, the connections are owned by the worker thread.
+ * A request that was not consumed by the api handler is also freed.
  * @param mpd_worker_state pointer to the t_mpd_worker_state struct
  */
 void mpd_worker_state_free(struct t_mpd_worker_state *mpd_worker_state) {
@@ -20,12 +23,29 @@ void mpd_worker_state_free(struct t_mpd_worker_state *mpd_worker_state) {
     if (mpd_worker_state->mpd_state != NULL) {
         mpd_state_free(mpd_worker_state->mpd_state);
     }
-    if (mpd_worker_state->partition_state != NULL) {
-        partition_state_free(mpd_worker_state->partition_state);
+    if (mpd_worker_state->stickerdb_mpd_state != NULL) {
+        mpd_state_free(mpd_worker_state->stickerdb_mpd_state);
     }
-    if (mpd_worker_state->stickerdb != NULL) {
-        mpd_state_free(mpd_worker_state->stickerdb->mpd_state);
-        stickerdb_state_free(mpd_worker_state->stickerdb);
+    jukebox_state_free(&mpd_worker_state->jukebox);
+    if (mpd_worker_state->request != NULL) {
+        // the extra data of all mpd_worker requests is a list
+        list_free((struct t_list *)mpd_worker_state->request->extra);
+        free_request(mpd_worker_state->request);
     }
     FREE_PTR(mpd_worker_state);
 }
+
+/**
+ * Checks if the job was canceled, long running jobs should check it periodically
+ * @param mpd_worker_state pointer to the t_mpd_worker_state struct
+ * @return true if the job was canceled, else false
+ */
+bool mpd_worker_canceled(struct t_mpd_worker_state *mpd_worker_state) {
+    if (mpd_worker_state->job != NULL &&
+        mpd_worker_state->job->canceled == true)
+    {
+        MYMPD_LOG_NOTICE(NULL, "Job %u was canceled", mpd_worker_state->job->id);
+        return true;
+    }
+    return false;
+}
@@ -10,23 +10,31 @@
 #include "src/lib/api.h"
 #include "src/lib/mympd_state.h"
 
+struct t_mpd_worker_job;
+
 /**
- * State struct for the mpd_worker thread
+ * State struct for a mpd_worker job
  */
 struct t_mpd_worker_state {
     bool smartpls;                                //!< smart playlists enabled
     sds smartpls_sort;                            //!< smart playlists sort tag
     sds smartpls_prefix;                          //!< prefix for smart playlist names
     struct t_tags smartpls_generate_tag_types;  //!< generate smart playlists for each value for this tag
-    struct t_partition_state *partition_state;    //!< pointer to the partition state to work (default partition for worker threads)
-    struct t_mpd_state *mpd_state;                //!< pointer to mpd shared state
+    struct t_partition_state *partition_state;    //!< pointer to the partition state of the worker thread, it holds the mpd connection
+    struct t_mpd_state *mpd_state;                //!< snapshot of the mpd shared state
+    struct t_jukebox_state jukebox;               //!< snapshot of the jukebox settings, swapped into the partition state while the job is running
     struct t_config *config;                      //!< pointer to myMPD config
     struct t_work_request *request;               //!< work request from msg queue
     bool tag_disc_empty_is_first;                 //!< handle empty disc tag as disc one for albums
-    struct t_stickerdb_state *stickerdb;          //!< pointer to the stickerdb state
+    struct t_stickerdb_state *stickerdb;          //!< pointer to the stickerdb state of the worker thread
+    struct t_mpd_state *stickerdb_mpd_state;      //!< snapshot of the stickerdb mpd state
     bool mympd_only;                              //!< true = no mpd connection required
     struct t_cache *album_cache;                  //!< the album cache, use it only with a read lock
+    struct t_song_index *song_index;              //!< the song index, use it only with a read lock
+    struct t_tags song_index_tags;                //!< tags to add to the song index: the jukebox uniq tags of all partitions
+    struct t_mpd_worker_job *job;                 //!< the job this state belongs to
 };
 
 void mpd_worker_state_free(struct t_mpd_worker_state *mpd_worker_state);
+bool mpd_worker_canceled(struct t_mpd_worker_state *mpd_worker_state);
 #endif
@@ -95,9 +95,22 @@ sds mympd_api_browse_album_detail(struct t_mympd_state *mympd_state, struct t_pa
         if (partition_state->mpd_state->feat.stickers == true &&
             tagcols->stickers.len > 0)
         {
-            stickerdb_exit_idle(mympd_state->stickerdb);
+            stickerdb_batch_begin(mympd_state->stickerdb);
         }
+        // receive all songs first to fetch the stickers in one command list
+        struct t_list songs;
+        list_init(&songs);
         while ((song = mpd_recv_song(partition_state->conn)) != NULL) {
+            list_push(&songs, mpd_song_get_uri(song), 0, NULL, song);
+        }
+        if (partition_state->mpd_state->feat.stickers == true &&
+            tagcols->stickers.len > 0)
+        {
+            stickerdb_batch_prefetch(mympd_state->stickerdb, &songs);
+        }
+        struct t_list_node *current = songs.head;
+        while (current != NULL) {
+            song = (struct mpd_song *)current->user_data;
             if (entities_returned++) {
                 buffer = sdscatlen(buffer, ",", 1);
             }
@@ -126,14 +139,15 @@ sds mympd_api_browse_album_detail(struct t_mympd_state *mympd_state, struct t_pa
                 album_cache_set_discs(mpd_album, song);
                 album_cache_inc_song_count(mpd_album);
             }
-            mpd_song_free(song);
+            current = current->next;
         }
+        list_clear_user_data(&songs, list_free_cb_song_user_data);
     }
     mpd_response_finish(partition_state->conn);
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_enter_idle(mympd_state->stickerdb);
+        stickerdb_batch_end(mympd_state->stickerdb);
     }
     if (mympd_check_error_and_recover_respond(partition_state, &buffer, cmd_id, request_id, "mpd_search_commit") == false) {
         FREE_SDS(first_song_uri);
@@ -162,7 +176,9 @@ sds mympd_api_browse_album_detail(struct t_mympd_state *mympd_state, struct t_pa
  * Lists albums from the album_cache
  * @param partition_state pointer to partition specific states
  * @param album_cache pointer to album cache
+ * @param album_index pointer to the album cache sort indexes
  * @param buffer sds string to append response
+ * @param stream response to stream long lists in parts or NULL
  * @param request_id jsonrpc request id
  * @param expression mpd search expression
  * @param sort tag to sort the result
@@ -172,7 +188,8 @@ sds mympd_api_browse_album_detail(struct t_mympd_state *mympd_state, struct t_pa
  * @param tagcols tags to print
  * @return pointer to buffer
  */
-sds mympd_api_browse_album_list(struct t_partition_state *partition_state, struct t_cache *album_cache, sds buffer, unsigned request_id,
+sds mympd_api_browse_album_list(struct t_partition_state *partition_state, struct t_cache *album_cache,
+        struct t_album_cache_index *album_index, sds buffer, struct t_work_response *stream, unsigned request_id,
         sds expression, sds sort, bool sortdesc, unsigned offset, unsigned limit, const struct t_fields *tagcols)
 {
     if (album_cache->cache == NULL) {
@@ -219,64 +236,64 @@ sds mympd_api_browse_album_list(struct t_partition_state *partition_state, struc
         return buffer;
     }
 
+    //get the pre-sorted album list
+    const struct t_album_cache_sorted *sorted = album_cache_index_get(album_index, album_cache, sort_by, sort_tag);
+    if (sorted == NULL) {
+        buffer = jsonrpc_respond_message(buffer, MYMPD_API_DATABASE_ALBUM_LIST, request_id,
+            JSONRPC_FACILITY_DATABASE, JSONRPC_SEVERITY_WARN, "Invalid sort tag");
+        return buffer;
+    }
+
     //parse mpd search expression
     struct t_list *expr_list = parse_search_expression_to_list(expression);
-    
-    //search and sort albumlist
-    unsigned real_limit = offset + limit;
-    rax *albums = raxNew();
-    raxIterator iter;
-    raxStart(&iter, album_cache->cache);
-    raxSeek(&iter, "^", NULL, 0);
-    sds key = sdsempty();
-    while (raxNext(&iter)) {
-        struct mpd_song *album = (struct mpd_song *)iter.data;
-        if (expr_list->length == 0 ||
-            search_song_expression(album, expr_list, &partition_state->mpd_state->tags_browse) == true)
-        {
-            key = get_sort_key(key, sort_by, sort_tag, album);
-            rax_insert_no_dup(albums, key, iter.data);
-            sdsclear(key);
-        }
-    }
-    raxStop(&iter);
-    free_search_expression_list(expr_list);
-    FREE_SDS(key);
 
     //print album list
+    unsigned real_limit = offset + limit;
     unsigned entity_count = 0;
     unsigned entities_returned = 0;
-    raxStart(&iter, albums);
-    int (*iterator)(struct raxIterator *iter);
-    if (sortdesc == false) {
-        raxSeek(&iter, "^", NULL, 0);
-        iterator = &raxNext;
-    }
-    else {
-        raxSeek(&iter, "$", NULL, 0);
-        iterator = &raxPrev;
+    size_t start = 0;
+    if (expr_list->length == 0) {
+        //unfiltered list: slice the sorted albums
+        entity_count = offset < sorted->len
+            ? offset
+            : (unsigned)sorted->len;
+        start = entity_count;
     }
-    while (iterator(&iter)) {
-        if (entity_count >= offset) {
+    for (size_t i = start; i < sorted->len; i++) {
+        struct mpd_song *album = sortdesc == false
+            ? sorted->albums[i]
+            : sorted->albums[sorted->len - i - 1];
+        if (expr_list->length > 0 &&
+            search_album_expression(album, expr_list, &partition_state->mpd_state->tags_browse, album_cache) == false)
+        {
+            continue;
+        }
+        if (entity_count >= offset &&
+            entity_count < real_limit)
+        {
             if (entities_returned++) {
                 buffer = sdscatlen(buffer, ",", 1);
             }
-            struct mpd_song *album = (struct mpd_song *)iter.data;
             buffer = sdscat(buffer, "{\"Type\": \"album\",");
             buffer = print_album_tags(buffer, partition_state->mpd_state, &tagcols->tags, album);
             buffer = sdscatlen(buffer, ",", 1);
             buffer = tojson_char(buffer, "FirstSongUri", mpd_song_get_uri(album), false);
             buffer = sdscatlen(buffer, "}", 1);
+            buffer = response_stream_flush(stream, buffer);
         }
         entity_count++;
-        if (entity_count == real_limit) {
+        if (expr_list->length == 0 &&
+            entity_count == real_limit)
+        {
+            //unfiltered list: the total is known
+            entity_count = (unsigned)sorted->len;
             break;
         }
     }
-    raxStop(&iter);
+    free_search_expression_list(expr_list);
 
     buffer = sdscatlen(buffer, "],", 2);
-    buffer = tojson_uint64(buffer, "totalEntities", albums->numele, true);
+    buffer = tojson_uint(buffer, "totalEntities", entity_count, true);
     buffer = tojson_uint(buffer, "returnedEntities", entities_returned, true);
     buffer = tojson_uint(buffer, "offset", offset, true);
     buffer = tojson_sds(buffer, "expression", expression, true);
@@ -284,7 +301,6 @@ sds mympd_api_browse_album_list(struct t_partition_state *partition_state, struc
     buffer = tojson_bool(buffer, "sortdesc", sortdesc, true);
     buffer = tojson_char(buffer, "tag", "Album", false);
     buffer = jsonrpc_end(buffer);
-    raxFree(albums);
     return buffer;
 }
 
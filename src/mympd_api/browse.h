@@ -7,12 +7,13 @@
 #ifndef MYMPD_API_BROWSE_H
 #define MYMPD_API_BROWSE_H
 
+#include "src/lib/api.h"
 #include "src/lib/mympd_state.h"
 
 sds mympd_api_browse_album_detail(struct t_mympd_state *mympd_state, struct t_partition_state *partition_state,
         sds buffer, unsigned request_id, sds albumid, const struct t_fields *tagcols);
 sds mympd_api_browse_album_list(struct t_partition_state *partition_state, struct t_cache *album_cache,
-        sds buffer, unsigned request_id, sds expression, sds sort, bool sortdesc, unsigned offset, unsigned limit,
+        struct t_album_cache_index *album_index, sds buffer, struct t_work_response *stream, unsigned request_id, sds expression, sds sort, bool sortdesc, unsigned offset, unsigned limit,
         const struct t_fields *tagcols);
 sds mympd_api_browse_tag_list(struct t_partition_state *partition_state, sds buffer,
         unsigned request_id, sds searchstr, sds tag, unsigned offset, unsigned limit, bool sortdesc);
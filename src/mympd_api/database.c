@@ -9,20 +9,23 @@
 
 #include "dist/libmympdclient/include/mpd/client.h"
 #include "src/lib/jsonrpc.h"
+#include "src/lib/list.h"
 #include "src/mpd_client/errorhandler.h"
 #include "src/mympd_api/status.h"
 
 /**
  * Starts mpd database update or rescan.
  * It checks if a database update is already running.
+ * Successfully started updates for a path are remembered for the incremental album cache update.
  * @param partition_state pointer to partition state
+ * @param update_paths list of updated paths since the last album cache creation
  * @param buffer pointer to sds string to append the jsonrpc result
  * @param cmd_id jsonrpc method
  * @param request_id mongoose request id
  * @param path path to update
  * @return pointer to buffer
  */
-sds mympd_api_database_update(struct t_partition_state *partition_state, sds buffer, enum mympd_cmd_ids cmd_id, unsigned request_id, sds path) {
+sds mympd_api_database_update(struct t_partition_state *partition_state, struct t_list *update_paths, sds buffer, enum mympd_cmd_ids cmd_id, unsigned request_id, sds path) {
     unsigned update_id = mympd_api_status_updatedb_id(partition_state);
 
     if (update_id == UINT_MAX) {
@@ -41,8 +44,36 @@ sds mympd_api_database_update(struct t_partition_state *partition_state, sds buf
     bool rc;
     if (cmd_id == MYMPD_API_DATABASE_UPDATE) {
         mpd_run_update(partition_state->conn, real_path);
-        return mympd_respond_with_error_or_ok(partition_state, buffer, cmd_id, request_id, "mpd_run_update", &rc);
+        buffer = mympd_respond_with_error_or_ok(partition_state, buffer, cmd_id, request_id, "mpd_run_update", &rc);
+    }
+    else {
+        mpd_run_rescan(partition_state->conn, real_path);
+        buffer = mympd_respond_with_error_or_ok(partition_state, buffer, cmd_id, request_id, "mpd_run_rescan", &rc);
+    }
+    if (rc == true &&
+        real_path != NULL &&
+        list_get_node(update_paths, path) == NULL)
+    {
+        list_push(update_paths, path, 0, NULL, NULL);
+    }
+    return buffer;
+}
+
+/**
+ * Merges the updated paths of an album cache creation that was not started
+ * back into the list of the mympd_api thread.
+ * @param update_paths list of updated paths since the last album cache creation
+ * @param paths paths handed over to the album cache creation or NULL
+ */
+void mympd_api_database_update_paths_restore(struct t_list *update_paths, struct t_list *paths) {
+    if (paths == NULL) {
+        return;
+    }
+    struct t_list_node *current = paths->head;
+    while (current != NULL) {
+        if (list_get_node(update_paths, current->key) == NULL) {
+            list_push(update_paths, current->key, 0, NULL, NULL);
+        }
+        current = current->next;
     }
-    mpd_run_rescan(partition_state->conn, real_path);
-    return mympd_respond_with_error_or_ok(partition_state, buffer, cmd_id, request_id, "mpd_run_rescan", &rc);
 }
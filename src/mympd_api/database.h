@@ -13,6 +13,7 @@
 
 #include <stdbool.h>
 
-sds mympd_api_database_update(struct t_partition_state *partition_state, sds buffer, enum mympd_cmd_ids cmd_id, unsigned request_id, sds path);
+sds mympd_api_database_update(struct t_partition_state *partition_state, struct t_list *update_paths, sds buffer, enum mympd_cmd_ids cmd_id, unsigned request_id, sds path);
+void mympd_api_database_update_paths_restore(struct t_list *update_paths, struct t_list *paths);
 
 #endif
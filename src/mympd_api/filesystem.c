@@ -130,7 +130,7 @@ sds mympd_api_browse_filesystem(struct t_mympd_state *mympd_state, struct t_part
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_exit_idle(mympd_state->stickerdb);
+        stickerdb_batch_begin(mympd_state->stickerdb);
     }
     while (raxNext(&iter)) {
         struct t_dir_entry *entry_data = (struct t_dir_entry *)iter.data;
@@ -190,7 +190,7 @@ sds mympd_api_browse_filesystem(struct t_mympd_state *mympd_state, struct t_part
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_enter_idle(mympd_state->stickerdb);
+        stickerdb_batch_end(mympd_state->stickerdb);
     }
     buffer = sdscatlen(buffer, "],", 2);
     buffer = mympd_api_get_extra_media(buffer, partition_state->mpd_state, mympd_state->booklet_name, mympd_state->info_txt_name, path, true);
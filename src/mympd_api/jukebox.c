@@ -126,7 +126,7 @@ sds mympd_api_jukebox_list(struct t_partition_state *partition_state, struct t_s
         if (partition_state->mpd_state->feat.stickers == true &&
             tagcols->stickers.len > 0)
         {
-            stickerdb_exit_idle(stickerdb);
+            stickerdb_batch_begin(stickerdb);
         }
         while (current != NULL) {
             if (mpd_send_list_meta(partition_state->conn, current->key)) {
@@ -162,7 +162,7 @@ sds mympd_api_jukebox_list(struct t_partition_state *partition_state, struct t_s
         if (partition_state->mpd_state->feat.stickers == true &&
             tagcols->stickers.len > 0)
         {
-            stickerdb_enter_idle(stickerdb);
+            stickerdb_batch_end(stickerdb);
         }
     }
     else if (partition_state->jukebox.mode == JUKEBOX_ADD_ALBUM) {
@@ -81,7 +81,7 @@ sds mympd_api_last_played_list(struct t_partition_state *partition_state, struct
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_exit_idle(stickerdb);
+        stickerdb_batch_begin(stickerdb);
     }
 
     struct t_list_node *current = partition_state->last_played.head;
@@ -108,7 +108,7 @@ sds mympd_api_last_played_list(struct t_partition_state *partition_state, struct
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_enter_idle(stickerdb);
+        stickerdb_batch_end(stickerdb);
     }
     free_search_expression_list(expr_list);
     buffer = sdscatlen(buffer, "],", 2);
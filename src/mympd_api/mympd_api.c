@@ -23,6 +23,7 @@
 #include "src/mpd_client/idle.h"
 #include "src/mpd_client/partitions.h"
 #include "src/mpd_client/stickerdb.h"
+#include "src/mpd_worker/mpd_worker.h"
 #include "src/mympd_api/home.h"
 #include "src/mympd_api/settings.h"
 #include "src/mympd_api/timer.h"
@@ -80,6 +81,9 @@ void *mympd_api_loop(void *arg_config) {
     mympd_api_timer_add(&mympd_state->timer_list, TIMER_DISK_CACHE_CLEANUP_OFFSET, TIMER_DISK_CACHE_CLEANUP_INTERVAL,
         timer_handler_by_id, TIMER_ID_DISK_CACHE_CROP, NULL);
 
+    // start the mpd_worker thread pool
+    mpd_worker_pool_start();
+
     // start trigger
     mympd_api_trigger_execute(&mympd_state->trigger_list, TRIGGER_MYMPD_START, MPD_PARTITION_ALL, NULL);
 
@@ -90,6 +94,7 @@ void *mympd_api_loop(void *arg_config) {
     // connect to stickerdb
     if (mympd_state->config->stickers == true) {
         if (stickerdb_connect(mympd_state->stickerdb) == true) {
+            stickerdb_cache_update(mympd_state->stickerdb);
             stickerdb_enter_idle(mympd_state->stickerdb);
         }
     }
@@ -127,6 +132,9 @@ void *mympd_api_loop(void *arg_config) {
     // stop trigger
     mympd_api_trigger_execute(&mympd_state->trigger_list, TRIGGER_MYMPD_STOP, MPD_PARTITION_ALL, NULL);
 
+    // stop the mpd_worker thread pool, the jobs are referencing the mympd_state
+    mpd_worker_pool_stop();
+
     // disconnect from mpd
     mpd_client_disconnect_all(mympd_state);
     if (mympd_state->stickerdb->conn != NULL) {
@@ -117,6 +117,19 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
     struct t_work_response *response = create_response(request);
 
     switch(request->cmd_id) {
+    // interactive methods that are delegated to a worker thread,
+    // they are handled in this thread if the worker can not take them
+        case MYMPD_API_PLAYLIST_CONTENT_LIST:
+        case MYMPD_API_DATABASE_SEARCH:
+            if (mpd_worker_start(mympd_state, partition_state, request) == MPD_WORKER_QUEUE_ADDED) {
+                async = true;
+                break;
+            }
+            MYMPD_LOG_DEBUG(partition_state->name, "Handling %s in the mympd_api thread", get_cmd_id_method_name(request->cmd_id));
+            response->data = request->cmd_id == MYMPD_API_PLAYLIST_CONTENT_LIST
+                ? mympd_api_playlist_content_list_request(partition_state, mympd_state->stickerdb, request, response, &parse_error)
+                : mympd_api_search_songs_request(partition_state, mympd_state->stickerdb, request, response, &parse_error);
+            break;
     // methods that are delegated to a new worker thread
         case INTERNAL_API_JUKEBOX_REFILL:
         case INTERNAL_API_JUKEBOX_REFILL_ADD:
@@ -136,12 +149,6 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
         case MYMPD_API_CACHE_DISK_CROP:
         case MYMPD_API_CACHE_DISK_CLEAR:
         case MYMPD_API_QUEUE_ADD_RANDOM:
-            if (mpd_worker_threads > MAX_MPD_WORKER_THREADS) {
-                response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
-                    JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_ERROR, "Too many worker threads are already running");
-                MYMPD_LOG_ERROR(partition_state->name, "Too many worker threads are already running");
-                break;
-            }
             if (request->cmd_id == MYMPD_API_CACHES_CREATE ||
                 request->cmd_id == MYMPD_API_SMARTPLS_UPDATE_ALL)
             {
@@ -158,12 +165,62 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                     break;
                 }
                 mympd_state->album_cache.building = mympd_state->mpd_state->feat.tags;
+                //hand over the updated database paths for the incremental album cache update
+                request->extra = list_dup(&mympd_state->album_cache_update_paths);
+                list_clear(&mympd_state->album_cache_update_paths);
             }
-            async = mpd_worker_start(mympd_state, partition_state, request);
-            if (async == false) {
-                response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
+            switch(mpd_worker_start(mympd_state, partition_state, request)) {
+                case MPD_WORKER_QUEUE_ADDED:
+                    async = true;
+                    break;
+                case MPD_WORKER_QUEUE_DUPLICATE:
+                    response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
+                        JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_WARN, "Same job is already queued");
+                    break;
+                case MPD_WORKER_QUEUE_FULL:
+                    response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
+                        JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_ERROR, "Too many jobs are already queued");
+                    MYMPD_LOG_ERROR(partition_state->name, "Too many mpd_worker jobs are already queued");
+                    break;
+                case MPD_WORKER_QUEUE_STOPPED:
+                    response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
                         JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_ERROR, "Error starting worker thread");
-                mympd_state->album_cache.building = false;
+                    break;
+            }
+            if (async == false) {
+                if (request->cmd_id == MYMPD_API_CACHES_CREATE) {
+                    mympd_state->album_cache.building = false;
+                    //keep the updated paths for the next album cache creation
+                    mympd_api_database_update_paths_restore(&mympd_state->album_cache_update_paths, request->extra);
+                }
+                else if (request->cmd_id == INTERNAL_API_JUKEBOX_REFILL ||
+                    request->cmd_id == INTERNAL_API_JUKEBOX_REFILL_ADD)
+                {
+                    partition_state->jukebox.filling = false;
+                }
+                list_free(request->extra);
+                request->extra = NULL;
+            }
+            break;
+        case MYMPD_API_WORKER_STATUS:
+            response->data = mpd_worker_status(response->data, request->cmd_id, request->id);
+            break;
+        case MYMPD_API_WORKER_CANCEL:
+            if (json_get_uint_max(request->data, "$.params.jobId", &uint_buf1, &parse_error) == true) {
+                switch(mpd_worker_cancel(mympd_state, uint_buf1)) {
+                    case MPD_WORKER_CANCEL_PENDING:
+                        response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
+                            JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_INFO, "Job was canceled");
+                        break;
+                    case MPD_WORKER_CANCEL_RUNNING:
+                        response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
+                            JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_INFO, "Cancellation of running job requested");
+                        break;
+                    case MPD_WORKER_CANCEL_NOT_FOUND:
+                        response->data = jsonrpc_respond_message(response->data, request->cmd_id, request->id,
+                            JSONRPC_FACILITY_GENERAL, JSONRPC_SEVERITY_ERROR, "Job not found");
+                        break;
+                }
             }
             break;
     // Album cache
@@ -183,15 +240,38 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                     send_jsonrpc_notify(JSONRPC_FACILITY_DATABASE, JSONRPC_SEVERITY_ERROR, MPD_PARTITION_ALL, "Album cache could not be replaced");
                     break;
                 }
+                album_cache_index_clear(&mympd_state->album_cache_index);
                 album_cache_free(&mympd_state->album_cache);
                 mympd_state->album_cache.cache = (rax *) request->extra;
+                //the mpd_worker thread has already folded the tag values
+                mympd_state->album_cache.folded = true;
                 cache_release_lock(&mympd_state->album_cache);
+                //create the sort indexes for the album list
+                album_cache_index_create(&mympd_state->album_cache_index, &mympd_state->album_cache,
+                    &mympd_state->mpd_state->tags_mympd, &mympd_state->config->albums);
                 MYMPD_LOG_INFO(partition_state->name, "Album cache was replaced");
             }
             else {
                 MYMPD_LOG_ERROR(partition_state->name, "Album cache is NULL");
             }
             break;
+        case INTERNAL_API_SONG_INDEX_CREATED:
+            if (request->extra != NULL) {
+                struct t_song_index *song_index = (struct t_song_index *)request->extra;
+                //replace the song index with the freshly generated one
+                if (song_index_get_write_lock(&mympd_state->song_index) == true) {
+                    song_index_replace(&mympd_state->song_index, song_index);
+                    song_index_release_lock(&mympd_state->song_index);
+                    MYMPD_LOG_INFO(partition_state->name, "Song index was replaced");
+                }
+                song_index_clear(song_index);
+                FREE_PTR(song_index);
+                request->extra = NULL;
+            }
+            else {
+                MYMPD_LOG_ERROR(partition_state->name, "Song index is NULL");
+            }
+            break;
     // Misc
         case MYMPD_API_LOGLEVEL:
             if (json_get_int(request->data, "$.params.loglevel", 0, 7, &int_buf1, &parse_error) == true) {
@@ -456,6 +536,7 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                         stickerdb_disconnect(mympd_state->stickerdb);
                         // connect to stickerdb
                         if (stickerdb_connect(mympd_state->stickerdb) == true) {
+                            stickerdb_cache_update(mympd_state->stickerdb);
                             stickerdb_enter_idle(mympd_state->stickerdb);
                         }
                     }
@@ -1088,10 +1169,10 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                 if (sdslen(sds_buf1) == 0 &&            // no search expression
                     strcmp(sds_buf2, "Priority") == 0)  // sort by priority
                 {
-                    response->data = mympd_api_queue_list(partition_state, mympd_state->stickerdb, response->data, request->id, uint_buf1, uint_buf2, &tagcols);
+                    response->data = mympd_api_queue_list(partition_state, mympd_state->stickerdb, response->data, response, request->id, uint_buf1, uint_buf2, &tagcols);
                 }
                 else {
-                    response->data = mympd_api_queue_search(partition_state, mympd_state->stickerdb, response->data, request->id,
+                    response->data = mympd_api_queue_search(partition_state, mympd_state->stickerdb, response->data, response, request->id,
                         sds_buf1, sds_buf2, bool_buf1, uint_buf1, uint_buf2, &tagcols);
                 }
             }
@@ -1160,20 +1241,6 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                     uint_buf1, uint_buf2, sds_buf1, uint_buf3);
             }
             break;
-        case MYMPD_API_PLAYLIST_CONTENT_LIST: {
-            struct t_fields tagcols;
-            fields_reset(&tagcols);
-            if (json_get_string(request->data, "$.params.plist", 1, FILENAME_LEN_MAX, &sds_buf1, vcb_isfilename, &parse_error) == true &&
-                json_get_uint(request->data, "$.params.offset", 0, MPD_PLAYLIST_LENGTH_MAX, &uint_buf1, &parse_error) == true &&
-                json_get_uint(request->data, "$.params.limit", MPD_RESULTS_MIN, MPD_RESULTS_MAX, &uint_buf2, &parse_error) == true &&
-                json_get_string(request->data, "$.params.expression", 0, NAME_LEN_MAX, &sds_buf2, vcb_issearchexpression, &parse_error) == true &&
-                json_get_fields(request->data, "$.params.fields", &tagcols, FIELDS_MAX, &parse_error) == true)
-            {
-                response->data = mympd_api_playlist_content_search(partition_state, mympd_state->stickerdb, response->data, request->id,
-                    sds_buf1, uint_buf1, uint_buf2, sds_buf2, &tagcols);
-            }
-            break;
-        }
         case MYMPD_API_PLAYLIST_CONTENT_APPEND_URIS: {
             struct t_list uris;
             list_init(&uris);
@@ -1441,7 +1508,7 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
         case MYMPD_API_DATABASE_UPDATE:
         case MYMPD_API_DATABASE_RESCAN:
             if (json_get_string(request->data, "$.params.uri", 0, FILEPATH_LEN_MAX, &sds_buf1, vcb_isfilepath, &parse_error) == true) {
-                response->data = mympd_api_database_update(partition_state, response->data, request->cmd_id, request->id, sds_buf1);
+                response->data = mympd_api_database_update(partition_state, &mympd_state->album_cache_update_paths, response->data, request->cmd_id, request->id, sds_buf1);
             }
             break;
         case MYMPD_API_DATABASE_FILESYSTEM_LIST: {
@@ -1458,7 +1525,7 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                     sds expr = sdslen(sds_buf1) > 0
                         ? escape_mpd_search_expression(sdsempty(), "file", "contains", sds_buf1)
                         : sdsempty();
-                    response->data = mympd_api_playlist_content_search(partition_state, mympd_state->stickerdb, response->data, request->id,
+                    response->data = mympd_api_playlist_content_search(partition_state, mympd_state->stickerdb, response->data, response, request->id,
                         sds_buf2, uint_buf1, uint_buf2, expr, &tagcols);
                     FREE_SDS(expr);
                 }
@@ -1469,21 +1536,6 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
             }
             break;
         }
-        case MYMPD_API_DATABASE_SEARCH: {
-            struct t_fields tagcols;
-            fields_reset(&tagcols);
-            if (json_get_string(request->data, "$.params.expression", 0, EXPRESSION_LEN_MAX, &sds_buf1, vcb_issearchexpression, &parse_error) == true &&
-                json_get_string(request->data, "$.params.sort", 0, NAME_LEN_MAX, &sds_buf2, vcb_ismpdsort, &parse_error) == true &&
-                json_get_bool(request->data, "$.params.sortdesc", &bool_buf1, &parse_error) == true &&
-                json_get_uint(request->data, "$.params.offset", 0, MPD_PLAYLIST_LENGTH_MAX, &uint_buf1, &parse_error) == true &&
-                json_get_uint(request->data, "$.params.limit", 0, MPD_RESULTS_MAX, &uint_buf2, &parse_error) == true &&
-                json_get_fields(request->data, "$.params.fields", &tagcols, FIELDS_MAX, &parse_error) == true)
-            {
-                response->data = mympd_api_search_songs(partition_state, mympd_state->stickerdb, response->data, request->id,
-                        sds_buf1, sds_buf2, bool_buf1, uint_buf1, uint_buf2, &tagcols, &rc);
-            }
-            break;
-        }
         case MYMPD_API_DATABASE_TAG_LIST:
             if (json_get_uint(request->data, "$.params.offset", 0, MPD_PLAYLIST_LENGTH_MAX, &uint_buf1, &parse_error) == true &&
                 json_get_uint(request->data, "$.params.limit", MPD_RESULTS_MIN, MPD_RESULTS_MAX, &uint_buf2, &parse_error) == true &&
@@ -1505,7 +1557,7 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                 json_get_bool(request->data, "$.params.sortdesc", &bool_buf1, &parse_error) == true &&
                 json_get_fields(request->data, "$.params.fields", &tagcols, FIELDS_MAX, &parse_error) == true)
             {
-                response->data = mympd_api_browse_album_list(partition_state, &mympd_state->album_cache, response->data, request->id,
+                response->data = mympd_api_browse_album_list(partition_state, &mympd_state->album_cache, &mympd_state->album_cache_index, response->data, response, request->id,
                         sds_buf1, sds_buf2, bool_buf1, uint_buf1, uint_buf2, &tagcols);
             }
             break;
@@ -1583,12 +1635,12 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                 json_get_uint(request->data, "$.params.limit", MPD_RESULTS_MIN, MPD_RESULTS_MAX, &uint_buf2, &parse_error) == true &&
                 json_get_string(request->data, "$.params.searchstr", 0, NAME_LEN_MAX, &sds_buf1, vcb_isname, &parse_error) == true)
             {
-                response->data = mympd_api_webradio_list(config->workdir, response->data, request->cmd_id, sds_buf1, uint_buf1, uint_buf2);
+                response->data = mympd_api_webradio_list(&mympd_state->webradio_favorites, response->data, request->cmd_id, sds_buf1, uint_buf1, uint_buf2);
             }
             break;
         case MYMPD_API_WEBRADIO_FAVORITE_GET:
             if (json_get_string(request->data, "$.params.filename", 1, FILENAME_LEN_MAX, &sds_buf1, vcb_isfilename, &parse_error) == true) {
-                response->data = mympd_api_webradio_get(config->workdir, response->data, request->cmd_id, sds_buf1);
+                response->data = mympd_api_webradio_get(&mympd_state->webradio_favorites, response->data, request->cmd_id, sds_buf1);
             }
             break;
         case MYMPD_API_WEBRADIO_FAVORITE_SAVE:
@@ -1607,6 +1659,7 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
             {
                 rc = mympd_api_webradio_save(config->workdir, sds_buf1, sds_buf2, sds_buf3, sds_buf4, sds_buf5, sds_buf6, sds_buf7,
                     sds_buf8, sds_buf9, int_buf1, sds_buf0, sds_buf10);
+                webradio_favorites_invalidate(&mympd_state->webradio_favorites);
                 response->data = jsonrpc_respond_with_message_or_error(response->data, request->cmd_id, request->id, rc,
                         JSONRPC_FACILITY_DATABASE, "Webradio favorite successfully saved", "Could not save webradio favorite");
             }
@@ -1620,6 +1673,7 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
                         JSONRPC_FACILITY_QUEUE, JSONRPC_SEVERITY_ERROR, "No webradios provided");
                 }
                 rc = mympd_api_webradio_delete(config->workdir, &filenames);
+                webradio_favorites_invalidate(&mympd_state->webradio_favorites);
                 response->data = jsonrpc_respond_with_ok_or_error(response->data, request->cmd_id, request->id, rc,
                         JSONRPC_FACILITY_DATABASE, "Could not delete webradio favorite");
             }
@@ -1660,7 +1714,9 @@ void mympd_api_handler(struct t_mympd_state *mympd_state, struct t_partition_sta
     }
 
     //sync request handling
-    if (sdslen(response->data) == 0) {
+    if (sdslen(response->data) == 0 &&
+        response->chunks == 0)
+    {
         // error handling
         if (parse_error.message != NULL) {
             // jsonrpc parsing error
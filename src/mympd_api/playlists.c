@@ -19,6 +19,7 @@
 #include "src/lib/sds_extras.h"
 #include "src/lib/smartpls.h"
 #include "src/lib/utility.h"
+#include "src/lib/validate.h"
 #include "src/mpd_client/errorhandler.h"
 #include "src/mpd_client/playlists.h"
 #include "src/mpd_client/search.h"
@@ -694,11 +695,45 @@ static sds print_plist_entry(sds buffer, struct mpd_song *song, unsigned pos, bo
     return buffer;
 }
 
+/**
+ * Parses the params of MYMPD_API_PLAYLIST_CONTENT_LIST and lists the content of the playlist.
+ * Shared by the mympd_api and the mpd_worker threads.
+ * @param partition_state pointer to partition state
+ * @param stickerdb pointer to stickerdb state
+ * @param request the jsonrpc request
+ * @param response response to stream long lists in parts
+ * @param parse_error pointer to jsonrpc parse error struct
+ * @return pointer to response->data
+ */
+sds mympd_api_playlist_content_list_request(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
+        struct t_work_request *request, struct t_work_response *response, struct t_jsonrpc_parse_error *parse_error)
+{
+    sds plist = NULL;
+    sds expression = NULL;
+    unsigned offset;
+    unsigned limit;
+    struct t_fields tagcols;
+    fields_reset(&tagcols);
+    if (json_get_string(request->data, "$.params.plist", 1, FILENAME_LEN_MAX, &plist, vcb_isfilename, parse_error) == true &&
+        json_get_uint(request->data, "$.params.offset", 0, MPD_PLAYLIST_LENGTH_MAX, &offset, parse_error) == true &&
+        json_get_uint(request->data, "$.params.limit", MPD_RESULTS_MIN, MPD_RESULTS_MAX, &limit, parse_error) == true &&
+        json_get_string(request->data, "$.params.expression", 0, NAME_LEN_MAX, &expression, vcb_issearchexpression, parse_error) == true &&
+        json_get_fields(request->data, "$.params.fields", &tagcols, FIELDS_MAX, parse_error) == true)
+    {
+        response->data = mympd_api_playlist_content_search(partition_state, stickerdb, response->data, response, request->id,
+            plist, offset, limit, expression, &tagcols);
+    }
+    FREE_SDS(plist);
+    FREE_SDS(expression);
+    return response->data;
+}
+
 /**
  * Lists the content of a mpd playlist
  * @param partition_state pointer to partition state
  * @param stickerdb pointer to stickerdb state
  * @param buffer already allocated sds string to append the response
+ * @param stream response to stream long lists in parts or NULL
  * @param request_id jsonrpc request id
  * @param plist playlist name to list contents
  * @param offset list offset
@@ -708,7 +743,7 @@ static sds print_plist_entry(sds buffer, struct mpd_song *song, unsigned pos, bo
  * @return pointer to buffer
  */
 sds mympd_api_playlist_content_search(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
-        sds buffer, unsigned request_id, sds plist, unsigned offset, unsigned limit, sds expression, const struct t_fields *tagcols)
+        sds buffer, struct t_work_response *stream, unsigned request_id, sds plist, unsigned offset, unsigned limit, sds expression, const struct t_fields *tagcols)
 {
     enum mympd_cmd_ids cmd_id = MYMPD_API_PLAYLIST_CONTENT_LIST;
     unsigned entities_returned = 0;
@@ -721,8 +756,12 @@ sds mympd_api_playlist_content_search(struct t_partition_state *partition_state,
     sds last_played_song_uri = sdsempty();
     bool print_stickers = partition_state->mpd_state->feat.stickers == true && tagcols->stickers.len > 0;
     if (print_stickers == true) {
-        stickerdb_exit_idle(stickerdb);
+        stickerdb_batch_begin(stickerdb);
     }
+    // the page is received first to fetch the stickers in one command list,
+    // value_i is the position in the playlist
+    struct t_list songs;
+    list_init(&songs);
     if (sdslen(expression) == 0 &&
         partition_state->mpd_state->feat.listplaylist_range == true)
     {
@@ -732,12 +771,7 @@ sds mympd_api_playlist_content_search(struct t_partition_state *partition_state,
             buffer = sdscat(buffer,"\"data\":[");
             while ((song = mpd_recv_song(partition_state->conn)) != NULL) {
                 total_time += mpd_song_get_duration(song);
-                if (entities_returned++) {
-                    buffer= sdscatlen(buffer, ",", 1);
-                }
-                buffer = print_plist_entry(buffer, song, entity_count, print_stickers, partition_state, stickerdb, tagcols,
-                    &last_played_max, &last_played_song_uri);
-                mpd_song_free(song);
+                list_push(&songs, mpd_song_get_uri(song), entity_count, NULL, song);
                 entity_count++;
             }
         }
@@ -752,30 +786,46 @@ sds mympd_api_playlist_content_search(struct t_partition_state *partition_state,
                 if (search_song_expression(song, expr_list, &tagcols->tags) == true) {
                     total_time += mpd_song_get_duration(song);
                     if (entities_found >= offset) {
-                        if (entities_returned++) {
-                            buffer= sdscatlen(buffer, ",", 1);
-                        }
-                        buffer = print_plist_entry(buffer, song, entity_count, print_stickers, partition_state, stickerdb, tagcols,
-                            &last_played_max, &last_played_song_uri);
+                        list_push(&songs, mpd_song_get_uri(song), entity_count, NULL, song);
+                        song = NULL;
                     }
                     entities_found++;
                     if (entities_found == real_limit) {
-                        mpd_song_free(song);
+                        if (song != NULL) {
+                            mpd_song_free(song);
+                        }
                         break;
                     }
                 }
                 entity_count++;
-                mpd_song_free(song);
+                if (song != NULL) {
+                    mpd_song_free(song);
+                }
             }
             free_search_expression_list(expr_list);
         }
     }
     mpd_response_finish(partition_state->conn);
     if (print_stickers == true) {
-        stickerdb_enter_idle(stickerdb);
+        stickerdb_batch_prefetch(stickerdb, &songs);
+    }
+    struct t_list_node *current = songs.head;
+    while (current != NULL) {
+        if (entities_returned++) {
+            buffer= sdscatlen(buffer, ",", 1);
+        }
+        buffer = print_plist_entry(buffer, (struct mpd_song *)current->user_data, (unsigned)current->value_i,
+            print_stickers, partition_state, stickerdb, tagcols, &last_played_max, &last_played_song_uri);
+        buffer = response_stream_flush(stream, buffer);
+        current = current->next;
+    }
+    list_clear_user_data(&songs, list_free_cb_song_user_data);
+    if (print_stickers == true) {
+        stickerdb_batch_end(stickerdb);
     }
 
     if (mympd_check_error_and_recover_respond(partition_state, &buffer, cmd_id, request_id, "mpd_send_list_playlist_meta") == false) {
+        buffer = response_stream_abort(stream, buffer);
         FREE_SDS(last_played_song_uri);
         return buffer;
     }
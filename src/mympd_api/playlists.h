@@ -7,6 +7,8 @@
 #ifndef MYMPD_API_PLAYLISTS_H
 #define MYMPD_API_PLAYLISTS_H
 
+#include "src/lib/api.h"
+#include "src/lib/jsonrpc.h"
 #include "src/lib/list.h"
 #include "src/lib/mympd_state.h"
 #include "src/mpd_client/playlists.h"
@@ -30,8 +32,10 @@ enum plist_delete_criterias parse_plist_delete_criteria(const char *str);
 
 sds mympd_api_playlist_list(struct t_partition_state *partition_state, sds buffer, unsigned request_id,
         unsigned offset, unsigned limit, sds searchstr, enum playlist_types type);
+sds mympd_api_playlist_content_list_request(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
+        struct t_work_request *request, struct t_work_response *response, struct t_jsonrpc_parse_error *parse_error);
 sds mympd_api_playlist_content_search(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
-        sds buffer, unsigned request_id, sds plist, unsigned offset, unsigned limit, sds expression, const struct t_fields *tagcols);
+        sds buffer, struct t_work_response *stream, unsigned request_id, sds plist, unsigned offset, unsigned limit, sds expression, const struct t_fields *tagcols);
 sds mympd_api_playlist_rename(struct t_partition_state *partition_state, sds buffer,
         unsigned request_id, const char *old_playlist, const char *new_playlist);
 sds mympd_api_playlist_delete_all(struct t_partition_state *partition_state, sds buffer,
@@ -598,6 +598,7 @@ sds mympd_api_queue_crop(struct t_partition_state *partition_state, sds buffer,
  * @param partition_state pointer to partition state
  * @param stickerdb pointer to stickerdb state
  * @param buffer already allocated sds string to append the response
+ * @param stream response to stream long lists in parts or NULL
  * @param request_id jsonrpc id
  * @param offset offset for the list
  * @param limit maximum entries to print
@@ -605,7 +606,7 @@ sds mympd_api_queue_crop(struct t_partition_state *partition_state, sds buffer,
  * @return pointer to buffer
  */
 sds mympd_api_queue_list(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
-        sds buffer, unsigned request_id, unsigned offset, unsigned limit, const struct t_fields *tagcols)
+        sds buffer, struct t_work_response *stream, unsigned request_id, unsigned offset, unsigned limit, const struct t_fields *tagcols)
 {
     enum mympd_cmd_ids cmd_id = MYMPD_API_QUEUE_SEARCH;
     //update the queue status
@@ -618,7 +619,7 @@ sds mympd_api_queue_list(struct t_partition_state *partition_state, struct t_sti
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_exit_idle(stickerdb);
+        stickerdb_batch_begin(stickerdb);
     }
     unsigned real_limit = offset + limit;
     if (mpd_send_list_queue_range_meta(partition_state->conn, offset, real_limit) == true) {
@@ -627,14 +628,29 @@ sds mympd_api_queue_list(struct t_partition_state *partition_state, struct t_sti
         unsigned total_time = 0;
         unsigned entities_returned = 0;
         struct mpd_song *song;
+        // receive the page first to fetch the stickers in one command list
+        struct t_list songs;
+        list_init(&songs);
         while ((song = mpd_recv_song(partition_state->conn)) != NULL) {
+            list_push(&songs, mpd_song_get_uri(song), 0, NULL, song);
+        }
+        if (partition_state->mpd_state->feat.stickers == true &&
+            tagcols->stickers.len > 0)
+        {
+            stickerdb_batch_prefetch(stickerdb, &songs);
+        }
+        struct t_list_node *current = songs.head;
+        while (current != NULL) {
+            song = (struct mpd_song *)current->user_data;
             if (entities_returned++) {
                 buffer = sdscatlen(buffer, ",", 1);
             }
             buffer = print_queue_entry(partition_state, stickerdb, buffer, tagcols, song);
+            buffer = response_stream_flush(stream, buffer);
             total_time += mpd_song_get_duration(song);
-            mpd_song_free(song);
+            current = current->next;
         }
+        list_clear_user_data(&songs, list_free_cb_song_user_data);
 
         buffer = sdscatlen(buffer, "],", 2);
         buffer = tojson_uint(buffer, "totalTime", total_time, true);
@@ -647,9 +663,11 @@ sds mympd_api_queue_list(struct t_partition_state *partition_state, struct t_sti
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_enter_idle(stickerdb);
+        stickerdb_batch_end(stickerdb);
+    }
+    if (mympd_check_error_and_recover_respond(partition_state, &buffer, cmd_id, request_id, "mpd_send_list_queue_range_meta") == false) {
+        buffer = response_stream_abort(stream, buffer);
     }
-    mympd_check_error_and_recover_respond(partition_state, &buffer, cmd_id, request_id, "mpd_send_list_queue_range_meta");
     return buffer;
 }
 
@@ -658,6 +676,7 @@ sds mympd_api_queue_list(struct t_partition_state *partition_state, struct t_sti
  * @param partition_state pointer to partition state
  * @param stickerdb pointer to stickerdb state
  * @param buffer already allocated sds string to append the response
+ * @param stream response to stream long lists in parts or NULL
  * @param request_id jsonrpc id
  * @param expression mpd filter expression
  * @param sort tag to sort - only relevant for feat_advqueue
@@ -668,7 +687,7 @@ sds mympd_api_queue_list(struct t_partition_state *partition_state, struct t_sti
  * @return pointer to buffer
  */
 sds mympd_api_queue_search(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
-        sds buffer, unsigned request_id, sds expression, sds sort, bool sortdesc, unsigned offset, unsigned limit,
+        sds buffer, struct t_work_response *stream, unsigned request_id, sds expression, sds sort, bool sortdesc, unsigned offset, unsigned limit,
         const struct t_fields *tagcols)
 {
     enum mympd_cmd_ids cmd_id = MYMPD_API_QUEUE_SEARCH;
@@ -692,7 +711,7 @@ sds mympd_api_queue_search(struct t_partition_state *partition_state, struct t_s
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_exit_idle(stickerdb);
+        stickerdb_batch_begin(stickerdb);
     }
     if (mpd_search_commit(partition_state->conn)) {
         buffer = jsonrpc_respond_start(buffer, cmd_id, request_id);
@@ -710,6 +729,7 @@ sds mympd_api_queue_search(struct t_partition_state *partition_state, struct t_s
                     buffer= sdscatlen(buffer, ",", 1);
                 }
                 buffer = print_queue_entry(partition_state, stickerdb, buffer, tagcols, song);
+                buffer = response_stream_flush(stream, buffer);
                 total_time += mpd_song_get_duration(song);
             }
             mpd_song_free(song);
@@ -739,10 +759,10 @@ sds mympd_api_queue_search(struct t_partition_state *partition_state, struct t_s
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_enter_idle(stickerdb);
+        stickerdb_batch_end(stickerdb);
     }
     if (mympd_check_error_and_recover_respond(partition_state, &buffer, cmd_id, request_id, "mpd_search_queue_songs") == false) {
-        return buffer;
+        buffer = response_stream_abort(stream, buffer);
     }
     return buffer;
 }
@@ -829,7 +849,7 @@ sds print_queue_entry(struct t_partition_state *partition_state, struct t_sticke
     const char *uri = mpd_song_get_uri(song);
     buffer = sdscatlen(buffer, ",", 1);
     if (is_streamuri(uri) == true) {
-        sds webradio = get_webradio_from_uri(partition_state->config->workdir, uri);
+        sds webradio = get_webradio_from_uri(partition_state->webradio_favorites, uri);
         if (sdslen(webradio) > 0) {
             buffer = sdscat(buffer, "\"webradio\":{");
             buffer = sdscatsds(buffer, webradio);
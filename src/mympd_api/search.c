@@ -9,12 +9,50 @@
 
 #include "src/lib/api.h"
 #include "src/lib/jsonrpc.h"
+#include "src/lib/sds_extras.h"
+#include "src/lib/validate.h"
 #include "src/mpd_client/errorhandler.h"
 #include "src/mpd_client/search.h"
 #include "src/mpd_client/stickerdb.h"
 #include "src/mpd_client/tags.h"
 #include "src/mympd_api/sticker.h"
 
+/**
+ * Parses the params of MYMPD_API_DATABASE_SEARCH and searches the mpd database.
+ * Shared by the mympd_api and the mpd_worker threads.
+ * @param partition_state pointer to partition specific states
+ * @param stickerdb pointer to stickerdb state
+ * @param request the jsonrpc request
+ * @param response response to fill
+ * @param parse_error pointer to jsonrpc parse error struct
+ * @return pointer to response->data
+ */
+sds mympd_api_search_songs_request(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
+        struct t_work_request *request, struct t_work_response *response, struct t_jsonrpc_parse_error *parse_error)
+{
+    sds expression = NULL;
+    sds sort = NULL;
+    bool sortdesc;
+    unsigned offset;
+    unsigned limit;
+    bool rc;
+    struct t_fields tagcols;
+    fields_reset(&tagcols);
+    if (json_get_string(request->data, "$.params.expression", 0, EXPRESSION_LEN_MAX, &expression, vcb_issearchexpression, parse_error) == true &&
+        json_get_string(request->data, "$.params.sort", 0, NAME_LEN_MAX, &sort, vcb_ismpdsort, parse_error) == true &&
+        json_get_bool(request->data, "$.params.sortdesc", &sortdesc, parse_error) == true &&
+        json_get_uint(request->data, "$.params.offset", 0, MPD_PLAYLIST_LENGTH_MAX, &offset, parse_error) == true &&
+        json_get_uint(request->data, "$.params.limit", 0, MPD_RESULTS_MAX, &limit, parse_error) == true &&
+        json_get_fields(request->data, "$.params.fields", &tagcols, FIELDS_MAX, parse_error) == true)
+    {
+        response->data = mympd_api_search_songs(partition_state, stickerdb, response->data, request->id,
+                expression, sort, sortdesc, offset, limit, &tagcols, &rc);
+    }
+    FREE_SDS(expression);
+    FREE_SDS(sort);
+    return response->data;
+}
+
 /**
  * Searches the mpd database for songs by expression and returns an jsonrpc result
  * @param partition_state pointer to partition specific states
@@ -54,7 +92,7 @@ sds mympd_api_search_songs(struct t_partition_state *partition_state, struct t_s
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_exit_idle(stickerdb);
+        stickerdb_batch_begin(stickerdb);
     }
     if (mpd_search_commit(partition_state->conn) == true) {
         struct mpd_song *song;
@@ -77,7 +115,7 @@ sds mympd_api_search_songs(struct t_partition_state *partition_state, struct t_s
     if (partition_state->mpd_state->feat.stickers == true &&
         tagcols->stickers.len > 0)
     {
-        stickerdb_enter_idle(stickerdb);
+        stickerdb_batch_end(stickerdb);
     }
     *result = mympd_check_error_and_recover_respond(partition_state, &buffer, cmd_id, request_id, "mpd_search_db_songs");
     if (*result == false) {
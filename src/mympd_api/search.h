@@ -7,8 +7,12 @@
 #ifndef MYMPD_API_SEARCH_H
 #define MYMPD_API_SEARCH_H
 
+#include "src/lib/api.h"
+#include "src/lib/jsonrpc.h"
 #include "src/lib/mympd_state.h"
 
+sds mympd_api_search_songs_request(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb,
+        struct t_work_request *request, struct t_work_response *response, struct t_jsonrpc_parse_error *parse_error);
 sds mympd_api_search_songs(struct t_partition_state *partition_state, struct t_stickerdb_state *stickerdb, 
         sds buffer, unsigned request_id, const char *expression, const char *sort, bool sortdesc,
         unsigned offset, unsigned limit, const struct t_fields *tagcols, bool *result);
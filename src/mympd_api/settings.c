@@ -679,6 +679,19 @@ bool mympd_api_settings_mpd_options_set(const char *path, sds key, sds value, in
             jukebox_changed = true;
         }
     }
+    else if (strcmp(key, "jukeboxWeighting") == 0 && vtype == MJSON_TOK_STRING) {
+        enum jukebox_weightings weighting = jukebox_weighting_parse(value);
+        if (weighting == JUKEBOX_WEIGHTING_UNKNOWN) {
+            set_invalid_value(error, path, key, value, "Invalid jukebox weighting");
+            return false;
+        }
+        if (partition_state->jukebox.weighting != weighting) {
+            partition_state->jukebox.weighting = weighting;
+            jukebox_changed = true;
+        }
+        sdsclear(value);
+        value = sdscatfmt(value, "%i", weighting);
+    }
     else if (strcmp(key, "jukeboxFilterInclude") == 0 && vtype == MJSON_TOK_STRING) {
         if (vcb_issearchexpression(value) == false) {
             set_invalid_value(error, path, key, value, "Invalid MPD search expression");
@@ -910,6 +923,7 @@ void mympd_api_settings_statefiles_partition_read(struct t_partition_state *part
     partition_state->jukebox.last_played = state_file_rw_uint(workdir, partition_state->state_dir, "jukebox_last_played", partition_state->jukebox.last_played, JUKEBOX_LAST_PLAYED_MIN, JUKEBOX_LAST_PLAYED_MAX, true);
     partition_state->jukebox.uniq_tag.tags[0] = state_file_rw_tag(workdir, partition_state->state_dir, "jukebox_uniq_tag", partition_state->jukebox.uniq_tag.tags[0], true);
     partition_state->jukebox.ignore_hated = state_file_rw_bool(workdir, partition_state->state_dir, "jukebox_ignore_hated", MYMPD_JUKEBOX_IGNORE_HATED, true);
+    partition_state->jukebox.weighting = state_file_rw_uint(workdir, partition_state->state_dir, "jukebox_weighting", partition_state->jukebox.weighting, JUKEBOX_WEIGHTING_MIN, JUKEBOX_WEIGHTING_MAX, true);
     partition_state->jukebox.filter_include = state_file_rw_string_sds(workdir, partition_state->state_dir, "jukebox_filter_include", partition_state->jukebox.filter_include, vcb_issearchexpression, true);
     partition_state->jukebox.filter_exclude = state_file_rw_string_sds(workdir, partition_state->state_dir, "jukebox_filter_exclude", partition_state->jukebox.filter_exclude, vcb_issearchexpression, true);
     partition_state->jukebox.min_song_duration= state_file_rw_uint(workdir, partition_state->state_dir, "jukebox_min_song_duration", partition_state->jukebox.min_song_duration, 0, JUKEBOX_MIN_SONG_DURATION_MAX, true);
@@ -1003,6 +1017,7 @@ sds mympd_api_settings_get(struct t_mympd_state *mympd_state, struct t_partition
     buffer = tojson_char(buffer, "jukeboxUniqTag", mpd_tag_name(partition_state->jukebox.uniq_tag.tags[0]), true);
     buffer = tojson_uint(buffer, "jukeboxLastPlayed", partition_state->jukebox.last_played, true);
     buffer = tojson_bool(buffer, "jukeboxIgnoreHated", partition_state->jukebox.ignore_hated, true);
+    buffer = tojson_char(buffer, "jukeboxWeighting", jukebox_weighting_lookup(partition_state->jukebox.weighting), true);
     buffer = tojson_char(buffer, "jukeboxFilterInclude", partition_state->jukebox.filter_include, true);
     buffer = tojson_char(buffer, "jukeboxFilterExclude", partition_state->jukebox.filter_exclude, true);
     buffer = tojson_uint(buffer, "jukeboxMinSongDuration", partition_state->jukebox.min_song_duration, true);
@@ -8,7 +8,6 @@
 #include "src/mympd_api/webradios.h"
 
 #include "dist/rax/rax.h"
-#include "dist/utf8/utf8.h"
 #include "src/lib/api.h"
 #include "src/lib/filehandler.h"
 #include "src/lib/jsonrpc.h"
@@ -21,80 +20,137 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 
 /**
  * Private definitions
  */
 
 /**
- * Struct to hold a webradio entry in the rax tree
+ * Struct to hold a webradio entry in the index
  */
 struct t_webradio_entry {
-    sds entry;     //!< json representation of the webradio m3u
     sds filename;  //!< filename of the webradio m3u
+    sds json;      //!< pre-rendered json members: filename and the m3u fields
+    sds search;    //!< m3u fields values in lower case for the search
 };
 
+static bool webradio_favorites_update(struct t_webradio_favorites *favorites);
+static void webradio_favorites_free_index(struct t_webradio_favorites *favorites);
+static struct t_webradio_entry *webradio_favorites_lookup(struct t_webradio_favorites *favorites, const char *filename);
+
 /**
  * Public functions
  */
 
+/**
+ * Initializes the webradio favorites index and watches the webradios directory.
+ * The index itself is loaded on first access.
+ * @param favorites pointer to the webradio favorites index
+ * @param workdir working directory
+ */
+void webradio_favorites_init(struct t_webradio_favorites *favorites, sds workdir) {
+    favorites->dirname = sdscatfmt(sdsempty(), "%S/%s", workdir, DIR_WORK_WEBRADIOS);
+    favorites->list = raxNew();
+    favorites->files = raxNew();
+    favorites->valid = false;
+    errno = 0;
+    favorites->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (favorites->inotify_fd == -1) {
+        MYMPD_LOG_WARN(NULL, "Can not watch the webradios directory, external changes are not detected");
+        MYMPD_LOG_ERRNO(NULL, errno);
+        return;
+    }
+    errno = 0;
+    if (inotify_add_watch(favorites->inotify_fd, favorites->dirname,
+            IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) == -1)
+    {
+        MYMPD_LOG_WARN(NULL, "Can not watch directory \"%s\"", favorites->dirname);
+        MYMPD_LOG_ERRNO(NULL, errno);
+        close(favorites->inotify_fd);
+        favorites->inotify_fd = -1;
+    }
+}
+
+/**
+ * Frees the webradio favorites index
+ * @param favorites pointer to the webradio favorites index
+ */
+void webradio_favorites_clear(struct t_webradio_favorites *favorites) {
+    webradio_favorites_free_index(favorites);
+    raxFree(favorites->list);
+    raxFree(favorites->files);
+    favorites->list = NULL;
+    favorites->files = NULL;
+    if (favorites->inotify_fd > -1) {
+        close(favorites->inotify_fd);
+        favorites->inotify_fd = -1;
+    }
+    FREE_SDS(favorites->dirname);
+}
+
+/**
+ * Marks the webradio favorites index for reload on next access
+ * @param favorites pointer to the webradio favorites index
+ */
+void webradio_favorites_invalidate(struct t_webradio_favorites *favorites) {
+    favorites->valid = false;
+}
+
 /**
  * Gets the webradio m3u as json object string.
  * This function calculates the real filename for the m3u from the uri
- * @param workdir working directory
+ * @param favorites pointer to the webradio favorites index, can be NULL
  * @param uri webradio stream uri
  * @return new sds string with the json object string
  */
-sds get_webradio_from_uri(sds workdir, const char *uri) {
+sds get_webradio_from_uri(struct t_webradio_favorites *favorites, const char *uri) {
+    if (favorites == NULL ||
+        webradio_favorites_update(favorites) == false)
+    {
+        return sdsempty();
+    }
     sds filename = sdsnew(uri);
     sanitize_filename(filename);
     filename = sdscatlen(filename, ".m3u", 4);
-    sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", workdir, DIR_WORK_WEBRADIOS, filename);
-    sds entry = sdsempty();
-    if (testfile_read(filepath) == true) {
-        entry = tojson_sds(entry, "filename", filename, true);
-        entry = m3u_to_json(entry, filepath, NULL);
-        FREE_SDS(filepath);
-        FREE_SDS(filename);
-        return entry;
-    }
-    FREE_SDS(filepath);
+    struct t_webradio_entry *webradio = webradio_favorites_lookup(favorites, filename);
     FREE_SDS(filename);
-    return entry;
+    return webradio != NULL
+        ? sdsdup(webradio->json)
+        : sdsempty();
 }
 
 /**
  * Prints a webradio m3u as jsonrpc response
- * @param workdir working directory
+ * @param favorites pointer to the webradio favorites index
  * @param buffer already allocated sds string to append the response
  * @param request_id jsonrpc request id
  * @param filename webradio m3u filename
  * @return pointer to buffer
  */
-sds mympd_api_webradio_get(sds workdir, sds buffer, unsigned request_id, sds filename) {
+sds mympd_api_webradio_get(struct t_webradio_favorites *favorites, sds buffer, unsigned request_id, sds filename) {
     enum mympd_cmd_ids cmd_id = MYMPD_API_WEBRADIO_FAVORITE_GET;
-    sds filepath = sdscatfmt(sdsempty(), "%S/%s/%S", workdir, DIR_WORK_WEBRADIOS, filename);
-    sds entry = sdsempty();
-    entry = m3u_to_json(entry, filepath, NULL);
-    if (sdslen(entry) == 0) {
+    struct t_webradio_entry *webradio = webradio_favorites_update(favorites) == true
+        ? webradio_favorites_lookup(favorites, filename)
+        : NULL;
+    if (webradio == NULL) {
         buffer = jsonrpc_respond_message(buffer, cmd_id, request_id,
             JSONRPC_FACILITY_DATABASE, JSONRPC_SEVERITY_ERROR, "Can not parse webradio favorite file");
     }
     else {
         buffer = jsonrpc_respond_start(buffer, cmd_id, request_id);
-        buffer = tojson_sds(buffer, "filename", filename, true);
-        buffer = sdscatsds(buffer, entry);
+        buffer = sdscatsds(buffer, webradio->json);
         buffer = jsonrpc_end(buffer);
     }
-    FREE_SDS(entry);
-    FREE_SDS(filepath);
     return buffer;
 }
 
 /**
  * Prints the webradio list as a jsonrpc response
- * @param workdir working directory 
+ * @param favorites pointer to the webradio favorites index
  * @param buffer already allocated sds string to append the response
  * @param request_id jsonrpc request id
  * @param searchstr string to search
@@ -102,72 +158,34 @@ sds mympd_api_webradio_get(sds workdir, sds buffer, unsigned request_id, sds fil
  * @param limit maximum entries to print
  * @return pointer to buffer
  */
-sds mympd_api_webradio_list(sds workdir, sds buffer, unsigned request_id, sds searchstr, unsigned offset, unsigned limit) {
+sds mympd_api_webradio_list(struct t_webradio_favorites *favorites, sds buffer, unsigned request_id,
+        sds searchstr, unsigned offset, unsigned limit)
+{
     enum mympd_cmd_ids cmd_id = MYMPD_API_WEBRADIO_FAVORITE_GET;
-    buffer = jsonrpc_respond_start(buffer, cmd_id, request_id);
-    buffer = sdscat(buffer, "\"data\":[");
-    sds webradios_dirname = sdscatfmt(sdsempty(), "%S/%s", workdir, DIR_WORK_WEBRADIOS);
-    errno = 0;
-    DIR *webradios_dir = opendir(webradios_dirname);
-    if (webradios_dir == NULL) {
-        MYMPD_LOG_ERROR(NULL, "Can not open directory \"%s\"", webradios_dirname);
-        MYMPD_LOG_ERRNO(NULL, errno);
-        FREE_SDS(webradios_dirname);
+    if (webradio_favorites_update(favorites) == false) {
         buffer = jsonrpc_respond_message(buffer, cmd_id, request_id,
             JSONRPC_FACILITY_DATABASE, JSONRPC_SEVERITY_ERROR, "Can not open webradios directory");
         return buffer;
     }
-
-    size_t search_len = sdslen(searchstr);
-    struct dirent *next_file;
-    rax *webradios = raxNew();
-    sds key = sdsempty();
+    buffer = jsonrpc_respond_start(buffer, cmd_id, request_id);
+    buffer = sdscat(buffer, "\"data\":[");
+    //fold the search string once, the index holds the folded m3u fields
+    sds search = sdsdup(searchstr);
+    sds_utf8_tolower(search);
+    size_t search_len = sdslen(search);
     unsigned real_limit = offset + limit;
-    //read dir
-    sds filepath = sdsempty();
-    while ((next_file = readdir(webradios_dir)) != NULL ) {
-        const char *ext = get_extension_from_filename(next_file->d_name);
-        if (ext == NULL ||
-            strcasecmp(ext, "m3u") != 0)
-        {
-            continue;
-        }
-
-        sdsclear(key);
-        sdsclear(filepath);
-        filepath = sdscatfmt(filepath, "%S/%s", webradios_dirname, next_file->d_name);
-        sds entry = m3u_to_json(sdsempty(), filepath, &key);
-        if (sdslen(entry) == 0) {
-            //skip on parsing error
-            FREE_SDS(entry);
-            continue;
-        }
-        if (search_len == 0 ||
-            utf8casestr(key, searchstr) != NULL)
-        {
-            struct t_webradio_entry *webradio = malloc_assert(sizeof(struct t_webradio_entry));
-            webradio->filename = sdsnew(next_file->d_name);
-            webradio->entry = entry;
-            key = sdscatsds(key, next_file->d_name); //append filename to keep it unique
-            sds_utf8_tolower(key);
-            rax_insert_no_dup(webradios, key, webradio);
-        }
-        else {
-            FREE_SDS(entry);
-        }
-    }
-    closedir(webradios_dir);
-    FREE_SDS(filepath);
-    FREE_SDS(webradios_dirname);
-    FREE_SDS(key);
-    //print result
     unsigned entity_count = 0;
     unsigned entities_returned = 0;
     raxIterator iter;
-    raxStart(&iter, webradios);
+    raxStart(&iter, favorites->list);
     raxSeek(&iter, "^", NULL, 0);
     while (raxNext(&iter)) {
         struct t_webradio_entry *webradio = (struct t_webradio_entry *)iter.data;
+        if (search_len > 0 &&
+            strstr(webradio->search, search) == NULL)
+        {
+            continue;
+        }
         if (entity_count >= offset &&
             entity_count < real_limit)
         {
@@ -175,21 +193,17 @@ sds mympd_api_webradio_list(sds workdir, sds buffer, unsigned request_id, sds se
                 buffer = sdscatlen(buffer, ",", 1);
             }
             buffer = sdscatlen(buffer, "{", 1);
-            buffer = tojson_sds(buffer, "filename", webradio->filename, true);
-            buffer = sdscatsds(buffer, webradio->entry);
+            buffer = sdscatsds(buffer, webradio->json);
             buffer = sdscatlen(buffer, "}", 1);
         }
         entity_count++;
-        FREE_SDS(webradio->entry);
-        FREE_SDS(webradio->filename);
-        FREE_PTR(webradio);
     }
     raxStop(&iter);
+    FREE_SDS(search);
     buffer = sdscatlen(buffer, "],", 2);
-    buffer = tojson_uint64(buffer, "totalEntities", webradios->numele, true);
+    buffer = tojson_uint(buffer, "totalEntities", entity_count, true);
     buffer = tojson_uint(buffer, "returnedEntities", entities_returned, false);
     buffer = jsonrpc_end(buffer);
-    raxFree(webradios);
     return buffer;
 }
 
@@ -275,3 +289,111 @@ bool mympd_api_webradio_delete(sds workdir, struct t_list *filenames) {
     FREE_SDS(filepath);
     return rc;
 }
+
+/**
+ * Private functions
+ */
+
+/**
+ * Drains the inotify events and reloads the index if required
+ * @param favorites pointer to the webradio favorites index
+ * @return true if the index is usable, else false
+ */
+static bool webradio_favorites_update(struct t_webradio_favorites *favorites) {
+    if (favorites->inotify_fd > -1) {
+        //the events itself are not evaluated, any change reloads the whole index
+        char events[4096];
+        while (read(favorites->inotify_fd, events, sizeof(events)) > 0) {
+            favorites->valid = false;
+        }
+    }
+    if (favorites->valid == true) {
+        return true;
+    }
+    webradio_favorites_free_index(favorites);
+    errno = 0;
+    DIR *webradios_dir = opendir(favorites->dirname);
+    if (webradios_dir == NULL) {
+        MYMPD_LOG_ERROR(NULL, "Can not open directory \"%s\"", favorites->dirname);
+        MYMPD_LOG_ERRNO(NULL, errno);
+        return false;
+    }
+    struct dirent *next_file;
+    sds key = sdsempty();
+    sds filepath = sdsempty();
+    while ((next_file = readdir(webradios_dir)) != NULL ) {
+        const char *ext = get_extension_from_filename(next_file->d_name);
+        if (ext == NULL ||
+            strcasecmp(ext, "m3u") != 0)
+        {
+            continue;
+        }
+        sdsclear(key);
+        sdsclear(filepath);
+        filepath = sdscatfmt(filepath, "%S/%s", favorites->dirname, next_file->d_name);
+        sds json = tojson_char(sdsempty(), "filename", next_file->d_name, true);
+        size_t prefix_len = sdslen(json);
+        json = m3u_to_json(json, filepath, &key);
+        if (sdslen(json) <= prefix_len) {
+            //skip on parsing error
+            FREE_SDS(json);
+            continue;
+        }
+        struct t_webradio_entry *webradio = malloc_assert(sizeof(struct t_webradio_entry));
+        webradio->filename = sdsnew(next_file->d_name);
+        webradio->json = json;
+        webradio->search = sdsdup(key);
+        if (raxTryInsert(favorites->files, (unsigned char *)webradio->filename, sdslen(webradio->filename), webradio, NULL) == 0) {
+            FREE_SDS(webradio->filename);
+            FREE_SDS(webradio->json);
+            FREE_SDS(webradio->search);
+            FREE_PTR(webradio);
+            continue;
+        }
+        key = sdscat(key, next_file->d_name); //append filename to keep it unique
+        sds_utf8_tolower(key);
+        raxInsert(favorites->list, (unsigned char *)key, sdslen(key), webradio, NULL);
+    }
+    closedir(webradios_dir);
+    FREE_SDS(filepath);
+    FREE_SDS(key);
+    favorites->valid = true;
+    MYMPD_LOG_DEBUG(NULL, "Indexed %" PRIu64 " webradio favorites", favorites->files->numele);
+    return true;
+}
+
+/**
+ * Frees all entries of the index
+ * @param favorites pointer to the webradio favorites index
+ */
+static void webradio_favorites_free_index(struct t_webradio_favorites *favorites) {
+    raxIterator iter;
+    raxStart(&iter, favorites->files);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        struct t_webradio_entry *webradio = (struct t_webradio_entry *)iter.data;
+        FREE_SDS(webradio->filename);
+        FREE_SDS(webradio->json);
+        FREE_SDS(webradio->search);
+        FREE_PTR(webradio);
+    }
+    raxStop(&iter);
+    raxFree(favorites->files);
+    raxFree(favorites->list);
+    favorites->files = raxNew();
+    favorites->list = raxNew();
+    favorites->valid = false;
+}
+
+/**
+ * Looks up a webradio by its m3u filename
+ * @param favorites pointer to the webradio favorites index
+ * @param filename m3u filename
+ * @return the webradio entry or NULL if not found
+ */
+static struct t_webradio_entry *webradio_favorites_lookup(struct t_webradio_favorites *favorites, const char *filename) {
+    void *data = raxFind(favorites->files, (unsigned char *)filename, strlen(filename));
+    return data == raxNotFound
+        ? NULL
+        : (struct t_webradio_entry *)data;
+}
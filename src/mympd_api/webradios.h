@@ -9,16 +9,20 @@
 
 #include "dist/sds/sds.h"
 #include "src/lib/list.h"
+#include "src/lib/mympd_state.h"
 
 #include <stdbool.h>
 
-sds get_webradio_from_uri(sds workdir, const char *uri);
+void webradio_favorites_init(struct t_webradio_favorites *favorites, sds workdir);
+void webradio_favorites_clear(struct t_webradio_favorites *favorites);
+void webradio_favorites_invalidate(struct t_webradio_favorites *favorites);
+sds get_webradio_from_uri(struct t_webradio_favorites *favorites, const char *uri);
 bool mympd_api_webradio_save(sds workdir, sds name, sds uri, sds uri_old,
         sds genre, sds picture, sds homepage, sds country, sds language,
         sds codec, int bitrate, sds description, sds state);
 bool mympd_api_webradio_delete(sds workdir, struct t_list *filenames);
-sds mympd_api_webradio_get(sds workdir, sds buffer, unsigned request_id, sds filename);
-sds mympd_api_webradio_list(sds workdir, sds buffer, unsigned request_id, sds searchstr,
+sds mympd_api_webradio_get(struct t_webradio_favorites *favorites, sds buffer, unsigned request_id, sds filename);
+sds mympd_api_webradio_list(struct t_webradio_favorites *favorites, sds buffer, unsigned request_id, sds searchstr,
         unsigned offset, unsigned limit);
 
 #endif
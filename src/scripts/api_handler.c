@@ -28,9 +28,6 @@ void scripts_api_handler(struct t_scripts_state *scripts_state, struct t_work_re
     MYMPD_LOG_DEBUG(request->partition, "MYMPD API request (%lu)(%u) %s: %s",
         request->conn_id, request->id, method, request->data);
 
-    //shortcuts
-    struct t_config *config = scripts_state->config;
-
     //some buffer variables
     bool rc;
     sds error = sdsempty();
@@ -55,7 +52,7 @@ void scripts_api_handler(struct t_scripts_state *scripts_state, struct t_work_re
             if (json_get_string(request->data, "$.params.script", 1, FILENAME_LEN_MAX, &sds_buf1, vcb_isfilename, &parse_error) == true &&
                 json_get_string(request->data, "$.params.content", 0, CONTENT_LEN_MAX, &sds_buf2, vcb_istext, &parse_error) == true)
             {
-                rc = script_validate(config, sds_buf1, sds_buf2, &error);
+                rc = script_validate(sds_buf1, sds_buf2, &error);
                 response->data = jsonrpc_respond_with_ok_or_error(response->data, request->cmd_id, request->id, rc,
                         JSONRPC_FACILITY_SCRIPT, error);
             }
@@ -71,7 +68,7 @@ void scripts_api_handler(struct t_scripts_state *scripts_state, struct t_work_re
                 json_get_string(request->data, "$.params.content", 0, CONTENT_LEN_MAX, &sds_buf4, vcb_istext, &parse_error) == true &&
                 json_get_array_string(request->data, "$.params.arguments", &arguments, vcb_isname, SCRIPT_ARGUMENTS_MAX, &parse_error) == true)
             {
-                rc = script_validate(config, sds_buf1, sds_buf4, &error) &&
+                rc = script_validate(sds_buf1, sds_buf4, &error) &&
                     script_save(scripts_state, sds_buf1, sds_buf2, sds_buf3, int_buf1, int_buf2, sds_buf4, &arguments, &error);
                 response->data = jsonrpc_respond_with_ok_or_error(response->data, request->cmd_id, request->id, rc,
                         JSONRPC_FACILITY_SCRIPT, error);
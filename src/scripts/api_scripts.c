@@ -83,6 +83,7 @@ bool scripts_file_read(struct t_scripts_state *scripts_state) {
         if (rc == true) {
             struct t_script_list_data *user_data = malloc_assert(sizeof(struct t_script_list_data));
             user_data->bytecode = NULL;
+            user_data->bytecode_id = 0;
             user_data->script = content;
             list_push(&scripts_state->script_list, scriptname, order, metadata, user_data);
         }
@@ -194,6 +195,7 @@ bool script_save(struct t_scripts_state *scripts_state, sds scriptname, sds olds
     if (rc == true) {
         struct t_script_list_data *user_data = malloc_assert(sizeof(struct t_script_list_data));
         user_data->bytecode = NULL;
+        user_data->bytecode_id = 0;
         user_data->script = sdsdup(content);
         list_push(&scripts_state->script_list, scriptname, order, metadata, user_data);
         list_sort_by_key(&scripts_state->script_list, LIST_SORT_ASC);
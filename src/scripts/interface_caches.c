@@ -85,7 +85,7 @@ int lua_caches_images_write(lua_State *lua_vm) {
         lua_pushstring(lua_vm, "Unknown filetype");
         return 2;
     }
-    sds dst = cache_disk_images_get_basename(config->cachedir, type, uri, 0);
+    sds dst = cache_disk_images_get_basename(config->cachedir, type, uri, 0, false);
     dst = sdscatfmt(dst, ".%s", ext);
     lua_pop(lua_vm, n);
     if (is_image(dst) == false) {
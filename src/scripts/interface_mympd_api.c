@@ -11,56 +11,165 @@
 #include "src/lib/jsonrpc.h"
 #include "src/lib/log.h"
 #include "src/lib/msg_queue.h"
-#include "src/lib/random.h"
 #include "src/mympd_api/lua_mympd_state.h"
 #include "src/scripts/interface.h"
 
+#include <time.h>
+
+// Private definitions
+
+#define MAILBOX_REGISTRY_KEY "mympd_mailbox"
+#define API_RESPONSE_TIMEOUT 60
+
+static struct t_script_mailbox *get_mailbox(lua_State *lua_vm);
+static unsigned send_api_request(lua_State *lua_vm, struct t_script_mailbox *mailbox);
+static int push_api_response(lua_State *lua_vm, struct t_work_response *response);
+
+// Public functions
+
+/**
+ * Sets the mailbox for the myMPD API responses of the script
+ * @param lua_vm lua instance
+ * @param mailbox the mailbox of the script worker thread
+ */
+void lua_mympd_api_set_mailbox(lua_State *lua_vm, struct t_script_mailbox *mailbox) {
+    lua_pushlightuserdata(lua_vm, mailbox);
+    lua_setfield(lua_vm, LUA_REGISTRYINDEX, MAILBOX_REGISTRY_KEY);
+}
+
 /**
  * Function that implements mympd_api lua function
  * @param lua_vm lua instance
  * @return return code
  */
 int lua_mympd_api(lua_State *lua_vm) {
+    struct t_script_mailbox *mailbox = get_mailbox(lua_vm);
+    unsigned request_id = send_api_request(lua_vm, mailbox);
+    struct t_work_response *response = script_mailbox_wait(mailbox, request_id, time(NULL) + API_RESPONSE_TIMEOUT);
+    if (response == NULL) {
+        return luaL_error(lua_vm, "No API response, timeout after 60s");
+    }
+    return push_api_response(lua_vm, response);
+}
+
+/**
+ * Function that implements mympd_api_async lua function.
+ * Sends the request without waiting for the response.
+ * @param lua_vm lua instance
+ * @return return code
+ */
+int lua_mympd_api_async(lua_State *lua_vm) {
+    struct t_script_mailbox *mailbox = get_mailbox(lua_vm);
+    unsigned request_id = send_api_request(lua_vm, mailbox);
+    lua_pushinteger(lua_vm, request_id);
+    return 1;
+}
+
+/**
+ * Function that implements mympd_api_wait lua function.
+ * Waits for the responses of requests sent with mympd_api_async.
+ * Returns return code and jsonrpc response for each request id in the order of the arguments.
+ * @param lua_vm lua instance
+ * @return return code
+ */
+int lua_mympd_api_wait(lua_State *lua_vm) {
+    struct t_script_mailbox *mailbox = get_mailbox(lua_vm);
+    int n = lua_gettop(lua_vm);
+    if (n == 0) {
+        MYMPD_LOG_ERROR(NULL, "Lua - mympd_api_wait: Invalid number of arguments");
+        return luaL_error(lua_vm, "Invalid number of arguments");
+    }
+    luaL_checkstack(lua_vm, n * 2, "Too many request ids");
+    time_t deadline = time(NULL) + API_RESPONSE_TIMEOUT;
+    for (int i = 1; i <= n; i++) {
+        unsigned request_id = (unsigned)luaL_checkinteger(lua_vm, i);
+        struct t_work_response *response = script_mailbox_wait(mailbox, request_id, deadline);
+        if (response == NULL) {
+            return luaL_error(lua_vm, "No API response for request %I", (lua_Integer)request_id);
+        }
+        push_api_response(lua_vm, response);
+    }
+    //return response count
+    return n * 2;
+}
+
+// Private functions
+
+/**
+ * Gets the mailbox of the script worker thread
+ * @param lua_vm lua instance
+ * @return the mailbox, raises a lua error if no mailbox is set
+ */
+static struct t_script_mailbox *get_mailbox(lua_State *lua_vm) {
+    lua_getfield(lua_vm, LUA_REGISTRYINDEX, MAILBOX_REGISTRY_KEY);
+    struct t_script_mailbox *mailbox = (struct t_script_mailbox *)lua_touserdata(lua_vm, -1);
+    lua_pop(lua_vm, 1);
+    if (mailbox == NULL) {
+        MYMPD_LOG_ERROR(NULL, "Lua - mympd_api: No mailbox for the API responses");
+        luaL_error(lua_vm, "No mailbox for the API responses");
+    }
+    return mailbox;
+}
+
+/**
+ * Validates the arguments partition, method and params and sends the api request
+ * @param lua_vm lua instance
+ * @param mailbox mailbox for the response
+ * @return the request id, raises a lua error on invalid arguments
+ */
+static unsigned send_api_request(lua_State *lua_vm, struct t_script_mailbox *mailbox) {
     //check arguments
     int n = lua_gettop(lua_vm);
     if (n != 3) {
         MYMPD_LOG_ERROR(NULL, "Lua - mympd_api: Invalid number of arguments");
         lua_pop(lua_vm, n);
-        return luaL_error(lua_vm, "Invalid number of arguments");
+        luaL_error(lua_vm, "Invalid number of arguments");
+        return 0;
     }
     //get partition
     const char *partition = lua_tostring(lua_vm, 1);
     if (partition == NULL) {
         MYMPD_LOG_ERROR(NULL, "Lua - mympd_api: partition is NULL");
         lua_pop(lua_vm, n);
-        return luaL_error(lua_vm, "partition is NULL");
+        luaL_error(lua_vm, "partition is NULL");
+        return 0;
     }
     //get method
     const char *method = lua_tostring(lua_vm, 2);
     if (method == NULL) {
         MYMPD_LOG_ERROR(partition, "Lua - mympd_api: method is NULL");
         lua_pop(lua_vm, n);
-        return luaL_error(lua_vm, "method is NULL");
+        luaL_error(lua_vm, "method is NULL");
+        return 0;
     }
     enum mympd_cmd_ids cmd_id = get_cmd_id(method);
     if (cmd_id == GENERAL_API_UNKNOWN) {
         MYMPD_LOG_ERROR(partition, "Lua - mympd_api: Invalid method \"%s\"", method);
         lua_pop(lua_vm, n);
-        return luaL_error(lua_vm, "Invalid method");
+        luaL_error(lua_vm, "Invalid method");
+        return 0;
     }
     if (is_script_api_method(cmd_id) == false) {
         MYMPD_LOG_ERROR(partition, "Lua - mympd_api: API method %s is for internal use only ", method);
         lua_pop(lua_vm, n);
-        return luaL_error(lua_vm, "API method is for internal use only");
+        luaL_error(lua_vm, "API method is for internal use only");
+        return 0;
     }
     const char *params = lua_tostring(lua_vm, 3);
     if (params == NULL) {
         MYMPD_LOG_ERROR(partition, "Lua - mympd_api: params is NULL");
         lua_pop(lua_vm, n);
-        return luaL_error(lua_vm, "params is NULL");
+        luaL_error(lua_vm, "params is NULL");
+        return 0;
+    }
+    //the request id addresses the mailbox of this thread
+    unsigned request_id = script_mailbox_request_id(mailbox);
+    if (request_id == 0) {
+        MYMPD_LOG_ERROR(partition, "Lua - mympd_api: Too many pending API requests");
+        lua_pop(lua_vm, n);
+        luaL_error(lua_vm, "Too many pending API requests");
+        return 0;
     }
-    //generate a request id
-    unsigned request_id = randrange(0, UINT_MAX);
     MYMPD_LOG_DEBUG(NULL, "Creating API request with id %u", request_id);
     //create the request
     struct t_work_request *request = create_request(REQUEST_TYPE_SCRIPT, 0, request_id, cmd_id, NULL, partition);
@@ -75,31 +184,30 @@ int lua_mympd_api(lua_State *lua_vm) {
     request->data = sdscatlen(request->data, "}", 1);
     push_request(request, request_id);
     lua_pop(lua_vm, n);
-    int i = 0;
-    while (s_signal_received == 0 && i < 60) {
-        i++;
-        struct t_work_response *response = mympd_queue_shift(script_worker_queue, 1000, request_id);
-        if (response != NULL) {
-            MYMPD_LOG_DEBUG(NULL, "Got response: %s", response->data);
-            if (response->cmd_id == INTERNAL_API_SCRIPT_INIT) {
-                //this populates a lua table with some MPD and myMPD states
-                MYMPD_LOG_DEBUG(partition, "Populating global lua table mympd_state");
-                if (response->extra != NULL) {
-                    struct t_list *lua_mympd_state = (struct t_list *)response->extra;
-                    lua_newtable(lua_vm);
-                    populate_lua_table(lua_vm, lua_mympd_state);
-                    lua_setglobal(lua_vm, "mympd_state");
-                    lua_mympd_state_free(lua_mympd_state);
-                }
-            }
-            //push return code and jsonrpc response
-            int rc = json_find_key(response->data, "$.error.message") == true ? 1 : 0;
-            lua_pushinteger(lua_vm, rc);
-            lua_pushlstring(lua_vm, response->data, sdslen(response->data));
-            free_response(response);
-            //return response count
-            return 2;
-        }
+    return request_id;
+}
+
+/**
+ * Pushes the return code and the jsonrpc response onto the lua stack and frees the response
+ * @param lua_vm lua instance
+ * @param response the response
+ * @return number of pushed values
+ */
+static int push_api_response(lua_State *lua_vm, struct t_work_response *response) {
+    MYMPD_LOG_DEBUG(NULL, "Got response: %s", response->data);
+    if (response->cmd_id == INTERNAL_API_SCRIPT_INIT &&
+        response->extra != NULL)
+    {
+        //this populates a lua table with some MPD and myMPD states
+        MYMPD_LOG_DEBUG(response->partition, "Populating global lua table mympd_state");
+        lua_newtable(lua_vm);
+        populate_lua_table(lua_vm, (struct t_list *)response->extra);
+        lua_setglobal(lua_vm, "mympd_state");
     }
-    return luaL_error(lua_vm, "No API response, timeout after 60s");
+    //push return code and jsonrpc response
+    int rc = json_find_key(response->data, "$.error.message") == true ? 1 : 0;
+    lua_pushinteger(lua_vm, rc);
+    lua_pushlstring(lua_vm, response->data, sdslen(response->data));
+    script_response_free(response);
+    return 2;
 }
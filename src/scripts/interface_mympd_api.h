@@ -7,10 +7,15 @@
 #ifndef MYMPD_API_SCRIPTS_INTERFACE_MYMPD_API_H
 #define MYMPD_API_SCRIPTS_INTERFACE_MYMPD_API_H
 
+#include "src/scripts/mailbox.h"
+
 #include <lauxlib.h>
 #include <lua.h>
 #include <lualib.h>
 
+void lua_mympd_api_set_mailbox(lua_State *lua_vm, struct t_script_mailbox *mailbox);
 int lua_mympd_api(lua_State *lua_vm);
+int lua_mympd_api_async(lua_State *lua_vm);
+int lua_mympd_api_wait(lua_State *lua_vm);
 
 #endif
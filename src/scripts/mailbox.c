@@ -0,0 +1,209 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/scripts/mailbox.h"
+
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/mympd_api/lua_mympd_state.h"
+
+/*
+ Request ids of the myMPD API requests from scripts:
+ bits 24-31: slot of the mailbox + 1
+ bits 0-23: sequence number of the mailbox
+*/
+
+// Private definitions
+
+#define SCRIPT_MAILBOX_SLOTS 255
+#define SCRIPT_MAILBOX_SEQ_MASK 0xffffffU
+
+static struct t_script_mailbox *script_mailboxes[SCRIPT_MAILBOX_SLOTS];
+static pthread_rwlock_t script_mailboxes_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static struct t_list_node *get_pending(struct t_script_mailbox *mailbox, unsigned request_id, unsigned *idx);
+static void free_pending_cb(struct t_list_node *current);
+
+// Public functions
+
+/**
+ * Creates a mailbox and registers it in a free slot
+ * @return the mailbox or NULL if all slots are in use
+ */
+struct t_script_mailbox *script_mailbox_new(void) {
+    struct t_script_mailbox *mailbox = NULL;
+    pthread_rwlock_wrlock(&script_mailboxes_lock);
+    for (unsigned i = 0; i < SCRIPT_MAILBOX_SLOTS; i++) {
+        if (script_mailboxes[i] == NULL) {
+            mailbox = malloc_assert(sizeof(struct t_script_mailbox));
+            mailbox->slot = i;
+            mailbox->seq = 0;
+            list_init(&mailbox->pending);
+            pthread_mutex_init(&mailbox->mutex, NULL);
+            pthread_cond_init(&mailbox->wakeup, NULL);
+            script_mailboxes[i] = mailbox;
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&script_mailboxes_lock);
+    if (mailbox == NULL) {
+        MYMPD_LOG_ERROR(NULL, "No free script mailbox slot");
+    }
+    return mailbox;
+}
+
+/**
+ * Unregisters and frees the mailbox, undelivered responses are discarded
+ * @param mailbox the mailbox
+ */
+void script_mailbox_free(struct t_script_mailbox *mailbox) {
+    pthread_rwlock_wrlock(&script_mailboxes_lock);
+    script_mailboxes[mailbox->slot] = NULL;
+    pthread_rwlock_unlock(&script_mailboxes_lock);
+    list_clear_user_data(&mailbox->pending, free_pending_cb);
+    pthread_mutex_destroy(&mailbox->mutex);
+    pthread_cond_destroy(&mailbox->wakeup);
+    FREE_PTR(mailbox);
+}
+
+/**
+ * Creates a request id and adds it to the pending requests of the mailbox
+ * @param mailbox the mailbox
+ * @return the request id or 0 if SCRIPT_API_PENDING_MAX requests are pending
+ */
+unsigned script_mailbox_request_id(struct t_script_mailbox *mailbox) {
+    unsigned request_id = 0;
+    pthread_mutex_lock(&mailbox->mutex);
+    if (mailbox->pending.length < SCRIPT_API_PENDING_MAX) {
+        mailbox->seq = (mailbox->seq + 1) & SCRIPT_MAILBOX_SEQ_MASK;
+        request_id = ((mailbox->slot + 1) << 24) | mailbox->seq;
+        list_push(&mailbox->pending, "", (int64_t)request_id, NULL, NULL);
+    }
+    pthread_mutex_unlock(&mailbox->mutex);
+    return request_id;
+}
+
+/**
+ * Delivers a response to the mailbox of the script that has sent the request.
+ * Responses without waiting mailbox are freed.
+ * @param response the response
+ * @return true if the response was delivered, else false
+ */
+bool script_mailbox_deliver(struct t_work_response *response) {
+    bool delivered = false;
+    unsigned slot = response->id >> 24;
+    pthread_rwlock_rdlock(&script_mailboxes_lock);
+    if (slot > 0 &&
+        script_mailboxes[slot - 1] != NULL)
+    {
+        struct t_script_mailbox *mailbox = script_mailboxes[slot - 1];
+        pthread_mutex_lock(&mailbox->mutex);
+        struct t_list_node *node = get_pending(mailbox, response->id, NULL);
+        if (node != NULL &&
+            node->user_data == NULL)
+        {
+            node->user_data = response;
+            delivered = true;
+            pthread_cond_signal(&mailbox->wakeup);
+        }
+        pthread_mutex_unlock(&mailbox->mutex);
+    }
+    pthread_rwlock_unlock(&script_mailboxes_lock);
+    if (delivered == false) {
+        MYMPD_LOG_WARN(NULL, "Discarding response for script request %u", response->id);
+        script_response_free(response);
+    }
+    return delivered;
+}
+
+/**
+ * Waits for the response of a request.
+ * The wait is interrupted each second to check for the exit signal.
+ * @param mailbox the mailbox
+ * @param request_id the request id
+ * @param deadline give up at this time
+ * @return the response or NULL on timeout or for unknown request ids
+ */
+struct t_work_response *script_mailbox_wait(struct t_script_mailbox *mailbox, unsigned request_id, time_t deadline) {
+    struct t_work_response *response = NULL;
+    pthread_mutex_lock(&mailbox->mutex);
+    unsigned idx;
+    struct t_list_node *node = get_pending(mailbox, request_id, &idx);
+    if (node != NULL) {
+        while (node->user_data == NULL &&
+            s_signal_received == 0 &&
+            time(NULL) < deadline)
+        {
+            struct timespec max_wait;
+            clock_gettime(CLOCK_REALTIME, &max_wait);
+            max_wait.tv_sec += 1;
+            pthread_cond_timedwait(&mailbox->wakeup, &mailbox->mutex, &max_wait);
+        }
+        // a late response is discarded by script_mailbox_deliver
+        response = (struct t_work_response *)node->user_data;
+        node->user_data = NULL;
+        list_remove_node(&mailbox->pending, idx);
+    }
+    pthread_mutex_unlock(&mailbox->mutex);
+    return response;
+}
+
+/**
+ * Discards the pending requests and not fetched responses of a script run
+ * @param mailbox the mailbox
+ */
+void script_mailbox_clear(struct t_script_mailbox *mailbox) {
+    pthread_mutex_lock(&mailbox->mutex);
+    list_clear_user_data(&mailbox->pending, free_pending_cb);
+    pthread_mutex_unlock(&mailbox->mutex);
+}
+
+/**
+ * Frees a response for a script including the myMPD state of INTERNAL_API_SCRIPT_INIT
+ * @param response the response
+ */
+void script_response_free(struct t_work_response *response) {
+    if (response->cmd_id == INTERNAL_API_SCRIPT_INIT &&
+        response->extra != NULL)
+    {
+        lua_mympd_state_free((struct t_list *)response->extra);
+    }
+    free_response(response);
+}
+
+// Private functions
+
+/**
+ * Gets the pending request, the caller must hold the mutex of the mailbox
+ * @param mailbox the mailbox
+ * @param request_id the request id
+ * @param idx set to the position in the list if not NULL
+ * @return the list node or NULL if not found
+ */
+static struct t_list_node *get_pending(struct t_script_mailbox *mailbox, unsigned request_id, unsigned *idx) {
+    unsigned i = 0;
+    struct t_list_node *current = mailbox->pending.head;
+    while (current != NULL) {
+        if (current->value_i == (int64_t)request_id) {
+            if (idx != NULL) {
+                *idx = i;
+            }
+            return current;
+        }
+        i++;
+        current = current->next;
+    }
+    return NULL;
+}
+
+/**
+ * Callback function to free a delivered response
+ * @param current list node
+ */
+static void free_pending_cb(struct t_list_node *current) {
+    script_response_free((struct t_work_response *)current->user_data);
+}
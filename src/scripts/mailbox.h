@@ -0,0 +1,38 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_SCRIPTS_MAILBOX_H
+#define MYMPD_SCRIPTS_MAILBOX_H
+
+#include "src/lib/api.h"
+#include "src/lib/list.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * Mailbox for the myMPD API responses of a script worker thread.
+ * The slot of the mailbox is encoded in the request ids, the threads answering
+ * the requests deliver the responses directly to the mailbox.
+ */
+struct t_script_mailbox {
+    unsigned slot;           //!< slot in the mailbox table
+    unsigned seq;            //!< sequence number for the request ids
+    struct t_list pending;   //!< value_i is the request id, user_data is the response or NULL
+    pthread_mutex_t mutex;   //!< the mutex
+    pthread_cond_t wakeup;   //!< signals a delivered response
+};
+
+struct t_script_mailbox *script_mailbox_new(void);
+void script_mailbox_free(struct t_script_mailbox *mailbox);
+unsigned script_mailbox_request_id(struct t_script_mailbox *mailbox);
+bool script_mailbox_deliver(struct t_work_response *response);
+struct t_work_response *script_mailbox_wait(struct t_script_mailbox *mailbox, unsigned request_id, time_t deadline);
+void script_mailbox_clear(struct t_script_mailbox *mailbox);
+void script_response_free(struct t_work_response *response);
+
+#endif
@@ -0,0 +1,291 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/scripts/sandbox.h"
+
+/*
+ The script workers reuse their lua instances. Each run gets its own environment
+ table and the loaded script functions are cached in the registry of the lua instance.
+ Scripts can still change the shared state through _G or the library tables.
+ A snapshot of this tables is taken after the lua instance is created and
+ compared after each run, a changed lua instance must not be reused.
+*/
+
+// Private definitions
+
+#define SANDBOX_CACHE_KEY "mympd_functions"
+#define SANDBOX_SNAPSHOT_KEY "mympd_snapshot"
+#define SANDBOX_RUN_GLOBALS_KEY "mympd_run_globals"
+#define SANDBOX_STRING_MT_KEY "mympd_string_mt"
+#define SANDBOX_SNAPSHOT_DEPTH 2
+
+static void snapshot_table(lua_State *lua_vm, int snapshot, int depth);
+static bool check_table(lua_State *lua_vm, int table, int entry);
+static bool is_global_table(lua_State *lua_vm, int table);
+static bool is_run_global(lua_State *lua_vm, int key);
+
+// Public functions
+
+/**
+ * Pushes the function of a script onto the stack.
+ * Functions with an id are cached in the registry of the lua instance,
+ * the chunk is only loaded again if the id has changed.
+ * @param lua_vm lua instance
+ * @param name name of the script
+ * @param id id of the chunk, 0 = do not cache the function
+ * @param chunk script source or byte code
+ * @param len length of the chunk
+ * @return LUA_OK on success, else the lua error code and the error message is pushed onto the stack
+ */
+int lua_sandbox_load(lua_State *lua_vm, const char *name, unsigned id, const char *chunk, size_t len) {
+    if (id == 0) {
+        return luaL_loadbuffer(lua_vm, chunk, len, name);
+    }
+    // registry[SANDBOX_CACHE_KEY][name] = { id, function }
+    if (lua_getfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_CACHE_KEY) != LUA_TTABLE) {
+        lua_pop(lua_vm, 1);
+        lua_newtable(lua_vm);
+        lua_pushvalue(lua_vm, -1);
+        lua_setfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_CACHE_KEY);
+    }
+    if (lua_getfield(lua_vm, -1, name) == LUA_TTABLE) {
+        lua_rawgeti(lua_vm, -1, 1);
+        lua_Integer cached_id = lua_tointeger(lua_vm, -1);
+        lua_pop(lua_vm, 1);
+        if (cached_id == (lua_Integer)id) {
+            lua_rawgeti(lua_vm, -1, 2);
+            // remove the cache entry and the cache table, the function remains
+            lua_remove(lua_vm, -2);
+            lua_remove(lua_vm, -2);
+            return LUA_OK;
+        }
+    }
+    lua_pop(lua_vm, 1);
+    int rc = luaL_loadbuffer(lua_vm, chunk, len, name);
+    if (rc != LUA_OK) {
+        // remove the cache table, the error message remains
+        lua_remove(lua_vm, -2);
+        return rc;
+    }
+    lua_createtable(lua_vm, 2, 0);
+    lua_pushinteger(lua_vm, (lua_Integer)id);
+    lua_rawseti(lua_vm, -2, 1);
+    lua_pushvalue(lua_vm, -2);
+    lua_rawseti(lua_vm, -2, 2);
+    lua_setfield(lua_vm, -3, name);
+    lua_remove(lua_vm, -2);
+    return LUA_OK;
+}
+
+/**
+ * Sets a new environment for the script function on top of the stack.
+ * Global variables defined by the script are written to this table and are
+ * discarded after the run, reads fall back to the global table of the lua instance.
+ * @param lua_vm lua instance
+ */
+void lua_sandbox_env(lua_State *lua_vm) {
+    lua_newtable(lua_vm);
+    lua_createtable(lua_vm, 0, 1);
+    lua_pushglobaltable(lua_vm);
+    lua_setfield(lua_vm, -2, "__index");
+    lua_setmetatable(lua_vm, -2);
+    // the first upvalue of a main chunk is _ENV
+    if (lua_setupvalue(lua_vm, -2, 1) == NULL) {
+        lua_pop(lua_vm, 1);
+    }
+}
+
+/**
+ * Takes a snapshot of the global table, the tables it references up to
+ * SANDBOX_SNAPSHOT_DEPTH levels (the libraries, package.loaded) and the string metatable.
+ * Call it after all libraries and functions are registered.
+ * @param lua_vm lua instance
+ * @param run_globals NULL terminated list of global variables that are set for each run
+ */
+void lua_sandbox_seal(lua_State *lua_vm, const char * const *run_globals) {
+    lua_newtable(lua_vm);
+    for (const char * const *name = run_globals; *name != NULL; name++) {
+        lua_pushboolean(lua_vm, 1);
+        lua_setfield(lua_vm, -2, *name);
+    }
+    lua_setfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_RUN_GLOBALS_KEY);
+    // watched table -> { copy, metatable or false, number of entries }
+    lua_newtable(lua_vm);
+    int snapshot = lua_gettop(lua_vm);
+    lua_pushglobaltable(lua_vm);
+    snapshot_table(lua_vm, snapshot, SANDBOX_SNAPSHOT_DEPTH);
+    lua_pop(lua_vm, 1);
+    // all strings share one metatable, its __index is the string library
+    lua_pushliteral(lua_vm, "");
+    if (lua_getmetatable(lua_vm, -1) == 0) {
+        lua_pushboolean(lua_vm, 0);
+    }
+    else {
+        snapshot_table(lua_vm, snapshot, 0);
+    }
+    lua_setfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_STRING_MT_KEY);
+    lua_pop(lua_vm, 1);
+    lua_setfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_SNAPSHOT_KEY);
+}
+
+/**
+ * Compares the shared state with the snapshot from lua_sandbox_seal.
+ * @param lua_vm lua instance
+ * @return true if the shared state is unchanged, false if it was changed
+ *         by a script or the lua instance was not sealed
+ */
+bool lua_sandbox_check(lua_State *lua_vm) {
+    int top = lua_gettop(lua_vm);
+    if (lua_getfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_SNAPSHOT_KEY) != LUA_TTABLE) {
+        lua_settop(lua_vm, top);
+        return false;
+    }
+    int snapshot = lua_gettop(lua_vm);
+    lua_pushliteral(lua_vm, "");
+    if (lua_getmetatable(lua_vm, -1) == 0) {
+        lua_pushboolean(lua_vm, 0);
+    }
+    lua_getfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_STRING_MT_KEY);
+    bool rc = lua_rawequal(lua_vm, -1, -2) == 1;
+    lua_settop(lua_vm, snapshot);
+    lua_pushnil(lua_vm);
+    while (rc == true &&
+        lua_next(lua_vm, snapshot) != 0)
+    {
+        // watched table at -2, snapshot entry at -1
+        rc = check_table(lua_vm, lua_absindex(lua_vm, -2), lua_absindex(lua_vm, -1));
+        lua_pop(lua_vm, 1);
+    }
+    lua_settop(lua_vm, top);
+    return rc;
+}
+
+// Private functions
+
+/**
+ * Adds the table on top of the stack and its nested tables to the snapshot
+ * @param lua_vm lua instance
+ * @param snapshot stack index of the snapshot table
+ * @param depth levels of nested tables to add
+ */
+static void snapshot_table(lua_State *lua_vm, int snapshot, int depth) {
+    int table = lua_gettop(lua_vm);
+    lua_pushvalue(lua_vm, table);
+    if (lua_rawget(lua_vm, snapshot) != LUA_TNIL) {
+        // already watched
+        lua_pop(lua_vm, 1);
+        return;
+    }
+    lua_pop(lua_vm, 1);
+    bool is_global = is_global_table(lua_vm, table);
+    lua_createtable(lua_vm, 3, 0);
+    lua_newtable(lua_vm);
+    int copy = lua_gettop(lua_vm);
+    lua_Integer count = 0;
+    lua_pushnil(lua_vm);
+    while (lua_next(lua_vm, table) != 0) {
+        if (is_global == false ||
+            is_run_global(lua_vm, -2) == false)
+        {
+            lua_pushvalue(lua_vm, -2);
+            lua_pushvalue(lua_vm, -2);
+            lua_rawset(lua_vm, copy);
+            count++;
+        }
+        lua_pop(lua_vm, 1);
+    }
+    lua_rawseti(lua_vm, -2, 1);
+    if (lua_getmetatable(lua_vm, table) == 0) {
+        lua_pushboolean(lua_vm, 0);
+    }
+    lua_rawseti(lua_vm, -2, 2);
+    lua_pushinteger(lua_vm, count);
+    lua_rawseti(lua_vm, -2, 3);
+    lua_pushvalue(lua_vm, table);
+    lua_insert(lua_vm, -2);
+    lua_rawset(lua_vm, snapshot);
+    if (depth == 0) {
+        return;
+    }
+    lua_pushnil(lua_vm);
+    while (lua_next(lua_vm, table) != 0) {
+        if (lua_type(lua_vm, -1) == LUA_TTABLE &&
+            (is_global == false || is_run_global(lua_vm, -2) == false))
+        {
+            snapshot_table(lua_vm, snapshot, depth - 1);
+        }
+        lua_pop(lua_vm, 1);
+    }
+}
+
+/**
+ * Compares a watched table with its snapshot entry
+ * @param lua_vm lua instance
+ * @param table stack index of the watched table
+ * @param entry stack index of the snapshot entry
+ * @return true if the table is unchanged, else false
+ */
+static bool check_table(lua_State *lua_vm, int table, int entry) {
+    int top = lua_gettop(lua_vm);
+    bool is_global = is_global_table(lua_vm, table);
+    lua_rawgeti(lua_vm, entry, 2);
+    if (lua_getmetatable(lua_vm, table) == 0) {
+        lua_pushboolean(lua_vm, 0);
+    }
+    bool rc = lua_rawequal(lua_vm, -1, -2) == 1;
+    lua_rawgeti(lua_vm, entry, 3);
+    lua_Integer count = lua_tointeger(lua_vm, -1);
+    lua_rawgeti(lua_vm, entry, 1);
+    int copy = lua_gettop(lua_vm);
+    lua_pushnil(lua_vm);
+    while (rc == true &&
+        lua_next(lua_vm, table) != 0)
+    {
+        if (is_global == false ||
+            is_run_global(lua_vm, -2) == false)
+        {
+            lua_pushvalue(lua_vm, -2);
+            lua_rawget(lua_vm, copy);
+            rc = lua_rawequal(lua_vm, -1, -2) == 1;
+            lua_pop(lua_vm, 1);
+            count--;
+        }
+        lua_pop(lua_vm, 1);
+    }
+    lua_settop(lua_vm, top);
+    // removed entries are detected by the count
+    return rc == true &&
+        count == 0;
+}
+
+/**
+ * Checks if the table is the global table
+ * @param lua_vm lua instance
+ * @param table stack index of the table
+ * @return true if it is the global table, else false
+ */
+static bool is_global_table(lua_State *lua_vm, int table) {
+    lua_pushglobaltable(lua_vm);
+    bool rc = lua_rawequal(lua_vm, table, -1) == 1;
+    lua_pop(lua_vm, 1);
+    return rc;
+}
+
+/**
+ * Checks if the key is the name of a global variable that is set for each run
+ * @param lua_vm lua instance
+ * @param key stack index of the key
+ * @return true if it is a per run global variable, else false
+ */
+static bool is_run_global(lua_State *lua_vm, int key) {
+    key = lua_absindex(lua_vm, key);
+    lua_getfield(lua_vm, LUA_REGISTRYINDEX, SANDBOX_RUN_GLOBALS_KEY);
+    lua_pushvalue(lua_vm, key);
+    bool rc = lua_rawget(lua_vm, -2) != LUA_TNIL;
+    lua_pop(lua_vm, 2);
+    return rc;
+}
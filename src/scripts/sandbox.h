@@ -0,0 +1,20 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_SCRIPTS_SANDBOX_H
+#define MYMPD_SCRIPTS_SANDBOX_H
+
+#include <lauxlib.h>
+#include <lua.h>
+#include <lualib.h>
+#include <stdbool.h>
+
+int lua_sandbox_load(lua_State *lua_vm, const char *name, unsigned id, const char *chunk, size_t len);
+void lua_sandbox_env(lua_State *lua_vm);
+void lua_sandbox_seal(lua_State *lua_vm, const char * const *run_globals);
+bool lua_sandbox_check(lua_State *lua_vm);
+
+#endif
@@ -16,6 +16,7 @@
 #include "src/scripts/api_handler.h"
 #include "src/scripts/api_scripts.h"
 #include "src/scripts/api_vars.h"
+#include "src/scripts/scripts_worker.h"
 #include "src/scripts/util.h"
 
 /**
@@ -31,6 +32,7 @@ void *scripts_loop(void *arg_config) {
     scripts_state_default(scripts_state, (struct t_config *)arg_config);
     scripts_vars_file_read(&scripts_state->var_list, scripts_state->config->workdir);
     scripts_file_read(scripts_state);
+    script_worker_pool_start();
 
     // thread loop
     while (s_signal_received == 0) {
@@ -40,6 +42,7 @@ void *scripts_loop(void *arg_config) {
         }
     }
     MYMPD_LOG_DEBUG(NULL, "Stopping scripts thread");
+    script_worker_pool_stop();
 
     // save and free states
     scripts_state_save(scripts_state, true);
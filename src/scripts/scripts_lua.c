@@ -10,7 +10,6 @@
 #include "src/lib/config_def.h"
 #include "src/lib/log.h"
 #include "src/lib/mem.h"
-#include "src/lib/msg_queue.h"
 #include "src/lib/sds_extras.h"
 
 #include "src/lib/utility.h"
@@ -22,6 +21,7 @@
 #endif
 #include "src/scripts/interface_mympd_api.h"
 #include "src/scripts/interface_util.h"
+#include "src/scripts/sandbox.h"
 #include "src/scripts/scripts_worker.h"
 
 #include <string.h>
@@ -33,128 +33,126 @@
 
 // Private definitions
 
-static bool create_lua_vm(struct t_script_thread_arg *script_arg);
-static bool script_load(struct t_script_thread_arg *script_arg, const char *script);
-static bool script_load_bytecode(struct t_script_thread_arg *script_arg, sds bytecode);
-static int save_bytecode(lua_State *lua_vm, struct t_script_list_data *data);
-static void populate_lua_global_vars(struct t_scripts_state *scripts_state,
-        struct t_script_thread_arg *script_arg, struct t_list *arguments);
+static unsigned bytecode_id_last;  // last assigned byte code id, only used by the scripts thread
+
+/**
+ * Global variables that are set by populate_lua_global_vars and mympd.init for each run
+ */
+static const char * const run_globals[] = {
+    "mympd_arguments",
+    "mympd_config",
+    "mympd_env",
+    "mympd_state",
+    NULL
+};
+
+static bool script_compile(const char *scriptname, const char *script, sds *bytecode, sds *error);
+static void script_start_error(enum script_start_events start_event, unsigned long conn_id,
+        const char *partition, const char *message, sds *error);
+static int dump_cb(lua_State *lua_vm, const void* p, size_t sz, void* ud);
+static void populate_lua_global_vars(lua_State *lua_vm, struct t_script_thread_arg *script_arg);
 static void register_lua_functions(lua_State *lua_vm);
 static int mympd_luaopen(lua_State *lua_vm, const char *lualib);
 
 // Public functions
 
 /**
- * Executes the script in a new thread.
- * @param script_thread_arg pointer to t_script_thread_arg struct
+ * Queues the script for the script worker threads.
+ * The script is compiled on first execution and the byte code is cached.
+ * @param scripts_state pointer to scripts_state
+ * @param scriptname name of the script or the script itself if localscript is false
+ * @param arguments list of arguments, the list is copied
+ * @param partition execute the script in this partition
+ * @param localscript true = scriptname is the name of a saved script, false = scriptname is the script
+ * @param start_event script start event
+ * @param request_id jsonrpc request id
+ * @param conn_id mongoose connection id
+ * @param error already allocated sds string to hold the error message
+ * @return true on success, else false
  */
 bool script_start(struct t_scripts_state *scripts_state, sds scriptname, struct t_list *arguments,
         const char *partition, bool localscript, enum script_start_events start_event,
         unsigned request_id, unsigned long conn_id, sds *error)
 {
-    if (script_worker_threads > MAX_SCRIPT_WORKER_THREADS) {
-        if (start_event == SCRIPT_START_HTTP) {
-            send_script_raw_error(conn_id, partition, "Too many script worker threads already running.");
-        }
-        else {
-            *error = sdscat(*error, "Too many script worker threads already running.");
-        }
-        return false;
-    }
-
-    struct t_script_thread_arg *script_arg = malloc_assert(sizeof(struct t_script_thread_arg));
-    script_arg->partition = sdsnew(partition);
-    script_arg->start_event = start_event;
-    script_arg->conn_id = start_event == SCRIPT_START_HTTP ? conn_id : 0;
-    script_arg->request_id = request_id;
-    script_arg->config = scripts_state->config;
-    script_arg->lua_vm = NULL;
+    sds bytecode = NULL;
+    unsigned bytecode_id = 0;
+    sds result = sdsempty();
     bool rc;
-
     if (localscript == true) {
-        script_arg->script_name = sdsdup(scriptname);
-        // Load script from list
         struct t_list_node *script = list_get_node(&scripts_state->script_list, scriptname);
         if (script != NULL) {
-            #ifdef MYMPD_DEBUG
-                MEASURE_INIT
-                MEASURE_START
-            #endif
             struct t_script_list_data *data = (struct t_script_list_data *)script->user_data;
+            rc = true;
             if (data->bytecode == NULL) {
+                #ifdef MYMPD_DEBUG
+                    MEASURE_INIT
+                    MEASURE_START
+                #endif
                 MYMPD_LOG_DEBUG(partition, "Compiling lua script");
-                rc = script_load(script_arg, data->script);
+                data->bytecode = sdsempty();
+                rc = script_compile(scriptname, data->script, &data->bytecode, &result);
                 if (rc == true) {
-                    if (save_bytecode(script_arg->lua_vm, data) == 0) {
-                        MYMPD_LOG_DEBUG(partition, "Lua byte code cached successfully");
-                    }
-                    else {
-                        MYMPD_LOG_ERROR(partition, "Error caching lua bytecode");
+                    bytecode_id_last++;
+                    if (bytecode_id_last == 0) {
+                        bytecode_id_last++;
                     }
+                    data->bytecode_id = bytecode_id_last;
+                    MYMPD_LOG_DEBUG(partition, "Lua byte code cached successfully");
                 }
+                else {
+                    FREE_SDS(data->bytecode);
+                }
+                #ifdef MYMPD_DEBUG
+                    MEASURE_END
+                    MEASURE_PRINT(partition, "SCRIPT_COMPILE")
+                #endif
             }
-            else {
-                MYMPD_LOG_DEBUG(partition, "Loading cached lua bytecode");
-                rc = script_load_bytecode(script_arg, data->bytecode);
+            if (rc == true) {
+                bytecode = sdsdup(data->bytecode);
+                bytecode_id = data->bytecode_id;
             }
-            #ifdef MYMPD_DEBUG
-                MEASURE_END
-                MEASURE_PRINT(partition, "SCRIPT_START")
-            #endif
         }
         else {
+            result = sdscat(result, "Script not found");
             rc = false;
         }
     }
     else {
-        script_arg->script_name = sdsnew("user_defined");
-        rc = script_load(script_arg, scriptname);
-    }
-
-    if (script_arg->lua_vm == NULL) {
-        if (start_event == SCRIPT_START_HTTP) {
-            send_script_raw_error(conn_id, partition, "Error creating Lua instance.");
-        }
-        else {
-            *error = sdscat(*error, "Error creating Lua instance.");
-        }
-        free_t_script_thread_arg(script_arg);
-        return false;
+        // user defined scripts are not cached
+        bytecode = sdsempty();
+        rc = script_compile("user_defined", scriptname, &bytecode, &result);
     }
     if (rc == false) {
-        sds result = script_get_result(script_arg->lua_vm, rc);
-        if (start_event == SCRIPT_START_HTTP) {
-            send_script_raw_error(conn_id, partition, result);
-        }
-        else {
-            *error = sdscat(*error, result);
-        }
-        MYMPD_LOG_ERROR(script_arg->partition, "Error executing script %s: %s", script_arg->script_name, result);
+        script_start_error(start_event, conn_id, partition, result, error);
+        MYMPD_LOG_ERROR(partition, "Error executing script %s: %s",
+            (localscript == true ? scriptname : "user_defined"), result);
+        FREE_SDS(bytecode);
         FREE_SDS(result);
-        free_t_script_thread_arg(script_arg);
         return false;
     }
+    FREE_SDS(result);
 
-    populate_lua_global_vars(scripts_state, script_arg, arguments);
+    struct t_script_thread_arg *script_arg = malloc_assert(sizeof(struct t_script_thread_arg));
+    script_arg->script_name = localscript == true
+        ? sdsdup(scriptname)
+        : sdsnew("user_defined");
+    script_arg->bytecode = bytecode;
+    script_arg->bytecode_id = bytecode_id;
+    script_arg->partition = sdsnew(partition);
+    script_arg->start_event = start_event;
+    script_arg->conn_id = start_event == SCRIPT_START_HTTP ? conn_id : 0;
+    script_arg->request_id = request_id;
+    script_arg->config = scripts_state->config;
+    list_init(&script_arg->arguments);
+    list_append(&script_arg->arguments, arguments);
+    list_init(&script_arg->vars);
+    list_append(&script_arg->vars, &scripts_state->var_list);
 
-    //execute script
-    pthread_t scripts_worker_thread;
-    pthread_attr_t attr;
-    if (pthread_attr_init(&attr) != 0 ||
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0 ||
-        pthread_create(&scripts_worker_thread, &attr, script_run, script_arg) != 0)
-    {
-        MYMPD_LOG_ERROR(NULL, "Can not create script worker thread");
-        if (start_event == SCRIPT_START_HTTP) {
-            send_script_raw_error(conn_id, partition, "Can not create script worker thread");
-        }
-        else {
-            *error = sdscat(*error, "Can not create script worker thread");
-        }
+    if (script_worker_push(script_arg) == false) {
+        script_start_error(start_event, conn_id, partition, "Too many scripts already running.", error);
         free_t_script_thread_arg(script_arg);
         return false;
     }
-    mympd_queue_expire_age(script_worker_queue, 120);
     return true;
 }
 
@@ -162,81 +160,112 @@ bool script_start(struct t_scripts_state *scripts_state, sds scriptname, struct
  * Validates (compiles) a lua script
  * @param scriptname name of the script
  * @param script the script itself
- * @param lualibs lua libraries to load
  * @param error already allocated sds string to hold the error message
  * @return true on success, else false
  */
-bool script_validate(struct t_config *config, sds scriptname, sds script, sds *error) {
-    struct t_script_thread_arg script_arg;
-    script_arg.script_name = scriptname;
-    script_arg.partition = NULL;
-    script_arg.config = config;
-    script_arg.request_id = 0;
-
-    bool rc = script_load(&script_arg, script);
-    if (script_arg.lua_vm == NULL) {
-        *error = sdscat(*error, "Error creating Lua instance.");
-        return false;
-    }
-    sds result = script_get_result(script_arg.lua_vm, rc);
-    lua_close(script_arg.lua_vm);
-    if (rc == true) {
-        FREE_SDS(result);
+bool script_validate(sds scriptname, sds script, sds *error) {
+    if (script_compile(scriptname, script, NULL, error) == true) {
         return true;
     }
-    //compilation error
-    MYMPD_LOG_ERROR(NULL, "Error validating script %s: %s", script_arg.script_name, result);
-    *error = sdscatsds(*error, result);
-    FREE_SDS(result);
+    MYMPD_LOG_ERROR(NULL, "Error validating script %s: %s", scriptname, *error);
     return false;
 }
 
-// Private functions
-
 /**
- * Creates the lua instance and opens the standard and myMPD libraries
- * @param script_arg 
- * @return true on success, else false
+ * Creates the lua instance for a script worker thread,
+ * opens the standard and myMPD libraries and seals the shared state
+ * @return the lua instance or NULL on error
  */
-static bool create_lua_vm(struct t_script_thread_arg *script_arg) {
-    script_arg->lua_vm = luaL_newstate();
-    if (script_arg->lua_vm == NULL) {
-        MYMPD_LOG_ERROR(script_arg->partition, "Memory allocation error in luaL_newstate");
-        return false;
+lua_State *script_vm_new(void) {
+    lua_State *lua_vm = luaL_newstate();
+    if (lua_vm == NULL) {
+        MYMPD_LOG_ERROR(NULL, "Memory allocation error in luaL_newstate");
+        return NULL;
     }
-    luaL_openlibs(script_arg->lua_vm);
-    if (mympd_luaopen(script_arg->lua_vm, "json") == 1 ||
-        mympd_luaopen(script_arg->lua_vm, "mympd") == 1)
+    luaL_openlibs(lua_vm);
+    if (mympd_luaopen(lua_vm, "json") != 0 ||
+        mympd_luaopen(lua_vm, "mympd") != 0)
     {
-        lua_close(script_arg->lua_vm);
-        script_arg->lua_vm = NULL;
-        return false;
+        lua_close(lua_vm);
+        return NULL;
     }
-    register_lua_functions(script_arg->lua_vm);
-    return true;
+    register_lua_functions(lua_vm);
+    lua_sandbox_seal(lua_vm, run_globals);
+    return lua_vm;
 }
 
 /**
- * Loads the script from a string
+ * Prepares a reused lua instance for the script run.
+ * Sets the global variables and pushes the script function
+ * with a fresh environment onto the stack.
+ * @param lua_vm lua instance
  * @param script_arg pointer to t_script_thread_arg struct
- * @param script script to load
- * @return 0 on success, else 1
+ * @param mailbox mailbox for the myMPD API responses of the script
+ * @return LUA_OK on success, else the lua error code
  */
-static bool script_load(struct t_script_thread_arg *script_arg, const char *script) {
-    return create_lua_vm(script_arg) &&
-        luaL_loadstring(script_arg->lua_vm, script) == 0;
+int script_vm_prepare(lua_State *lua_vm, struct t_script_thread_arg *script_arg, struct t_script_mailbox *mailbox) {
+    lua_settop(lua_vm, 0);
+    lua_mympd_api_set_mailbox(lua_vm, mailbox);
+    populate_lua_global_vars(lua_vm, script_arg);
+    int rc = lua_sandbox_load(lua_vm, script_arg->script_name, script_arg->bytecode_id,
+        script_arg->bytecode, sdslen(script_arg->bytecode));
+    if (rc == LUA_OK) {
+        lua_sandbox_env(lua_vm);
+    }
+    return rc;
 }
 
+// Private functions
+
 /**
- * Loads the cached bytecode
- * This should be faster than compiling the script on each execution.
- * @param script_arg pointer to t_script_thread_arg struct
- * @param bytecode compiled lua script
- * @return 0 on success, else 1
+ * Compiles a lua script in a bare lua instance
+ * @param scriptname name of the script
+ * @param script the script itself
+ * @param bytecode already allocated sds string to append the byte code or NULL to only validate the script
+ * @param error already allocated sds string to hold the error message
+ * @return true on success, else false
  */
-static bool script_load_bytecode(struct t_script_thread_arg *script_arg, sds bytecode) {
-    return create_lua_vm(script_arg) &&
-        luaL_loadbuffer(script_arg->lua_vm, bytecode, sdslen(bytecode), script_arg->script_name) == 0;
+static bool script_compile(const char *scriptname, const char *script, sds *bytecode, sds *error) {
+    lua_State *lua_vm = luaL_newstate();
+    if (lua_vm == NULL) {
+        *error = sdscat(*error, "Error creating Lua instance.");
+        return false;
+    }
+    int rc = luaL_loadbuffer(lua_vm, script, strlen(script), scriptname);
+    if (rc == LUA_OK) {
+        if (bytecode != NULL &&
+            lua_dump(lua_vm, dump_cb, bytecode, false) != 0)
+        {
+            *error = sdscat(*error, "Error caching lua bytecode");
+            rc = LUA_ERRMEM;
+        }
+    }
+    else {
+        sds result = script_get_result(lua_vm, rc);
+        *error = sdscatsds(*error, result);
+        FREE_SDS(result);
+    }
+    lua_close(lua_vm);
+    return rc == LUA_OK;
+}
+
+/**
+ * Sends the error for a script that could not be started
+ * @param start_event script start event
+ * @param conn_id mongoose connection id
+ * @param partition MPD partition
+ * @param message the error message
+ * @param error already allocated sds string to append the error message for non http scripts
+ */
+static void script_start_error(enum script_start_events start_event, unsigned long conn_id,
+        const char *partition, const char *message, sds *error)
+{
+    if (start_event == SCRIPT_START_HTTP) {
+        send_script_raw_error(conn_id, partition, message);
+    }
+    else {
+        *error = sdscat(*error, message);
+    }
 }
 
 /**
@@ -244,81 +273,68 @@ static bool script_load_bytecode(struct t_script_thread_arg *script_arg, sds byt
  * @param lua_vm lua state
  * @param p chunk to write
  * @param sz chunk size
- * @param ud user data
+ * @param ud pointer to the sds string for the byte code
  * @return 0 on success
  */
 static int dump_cb(lua_State *lua_vm, const void* p, size_t sz, void* ud) {
     (void)lua_vm;
-    struct t_script_list_data *data = (struct t_script_list_data *)ud;
-    data->bytecode = sdscatlen(data->bytecode, p, sz);
+    sds *bytecode = (sds *)ud;
+    *bytecode = sdscatlen(*bytecode, p, sz);
     return 0;
 }
 
 /**
- * Saves the lua bytecode
- * @param lua_vm lua state
- * @param data pointer to script_list data
- * @return 0 on success
- */
-static int save_bytecode(lua_State *lua_vm, struct t_script_list_data *data) {
-    FREE_SDS(data->bytecode);
-    data->bytecode = sdsempty();
-    return lua_dump(lua_vm, dump_cb, data, false);
-}
-
-/**
- * Populate the global vars for script execution
- * @param scripts_state pointer to scripts_state
+ * Populate the global vars for script execution.
+ * The globals of the previous run are overwritten.
+ * @param lua_vm lua instance
  * @param script_arg pointer to t_script_thread_arg struct
- * @param arguments list of arguments
  */
-static void populate_lua_global_vars(struct t_scripts_state *scripts_state,
-        struct t_script_thread_arg *script_arg, struct t_list *arguments)
-{
+static void populate_lua_global_vars(lua_State *lua_vm, struct t_script_thread_arg *script_arg) {
     // Set myMPD config as a global
-    lua_pushlightuserdata(script_arg->lua_vm, script_arg->config);
-    lua_setglobal(script_arg->lua_vm, "mympd_config");
+    lua_pushlightuserdata(lua_vm, script_arg->config);
+    lua_setglobal(lua_vm, "mympd_config");
+    // mympd_state is populated by mympd.init()
+    lua_pushnil(lua_vm);
+    lua_setglobal(lua_vm, "mympd_state");
     // Set global mympd_env lua table
-    lua_newtable(script_arg->lua_vm);
-    populate_lua_table_field_p(script_arg->lua_vm, "partition", script_arg->partition);
-    populate_lua_table_field_i(script_arg->lua_vm, "requestid", script_arg->request_id);
-    populate_lua_table_field_p(script_arg->lua_vm, "scriptevent", script_start_event_name(script_arg->start_event));
-    populate_lua_table_field_p(script_arg->lua_vm, "scriptname", script_arg->script_name);
+    lua_newtable(lua_vm);
+    populate_lua_table_field_p(lua_vm, "partition", script_arg->partition);
+    populate_lua_table_field_i(lua_vm, "requestid", script_arg->request_id);
+    populate_lua_table_field_p(lua_vm, "scriptevent", script_start_event_name(script_arg->start_event));
+    populate_lua_table_field_p(lua_vm, "scriptname", script_arg->script_name);
     sds cachedir = sdscatfmt(sdsempty(), "%s/%s", script_arg->config->cachedir,  DIR_CACHE_COVER);
-    populate_lua_table_field_p(script_arg->lua_vm, "cachedir_cover", cachedir);
+    populate_lua_table_field_p(lua_vm, "cachedir_cover", cachedir);
     sdsclear(cachedir);
     cachedir = sdscatfmt(cachedir, "%s/%s", script_arg->config->cachedir,  DIR_CACHE_LYRICS);
-    populate_lua_table_field_p(script_arg->lua_vm, "cachedir_lyrics", cachedir);
+    populate_lua_table_field_p(lua_vm, "cachedir_lyrics", cachedir);
     sdsclear(cachedir);
     cachedir = sdscatfmt(cachedir, "%s/%s", script_arg->config->cachedir,  DIR_CACHE_MISC);
-    populate_lua_table_field_p(script_arg->lua_vm, "cachedir_misc", cachedir);
+    populate_lua_table_field_p(lua_vm, "cachedir_misc", cachedir);
     sdsclear(cachedir);
     cachedir = sdscatfmt(cachedir, "%s/%s", script_arg->config->cachedir,  DIR_CACHE_THUMBS);
-    populate_lua_table_field_p(script_arg->lua_vm, "cachedir_thumbs", cachedir);
+    populate_lua_table_field_p(lua_vm, "cachedir_thumbs", cachedir);
     FREE_SDS(cachedir);
-    populate_lua_table_field_p(script_arg->lua_vm, "workdir", script_arg->config->workdir);
+    populate_lua_table_field_p(lua_vm, "workdir", script_arg->config->workdir);
     // User defined variables
-    struct t_list_node *current = scripts_state->var_list.head;
+    struct t_list_node *current = script_arg->vars.head;
     sds key = sdsempty();
     while (current != NULL) {
         key = sdscatfmt(key, "var_%S", current->key);
-        populate_lua_table_field_p(script_arg->lua_vm, key, current->value_p);
+        populate_lua_table_field_p(lua_vm, key, current->value_p);
         sdsclear(key);
         current = current->next;
     }
     FREE_SDS(key);
-    lua_setglobal(script_arg->lua_vm, "mympd_env");
+    lua_setglobal(lua_vm, "mympd_env");
 
     // Set global arguments lua table
-    lua_newtable(script_arg->lua_vm);
-    if (arguments->length > 0) {
-        current = arguments->head;
-        while (current != NULL) {
-            populate_lua_table_field_p(script_arg->lua_vm, current->key, current->value_p);
-            current = current->next;
-        }
+    lua_newtable(lua_vm);
+    current = script_arg->arguments.head;
+    while (current != NULL) {
+        populate_lua_table_field_p(lua_vm, current->key, current->value_p);
+        current = current->next;
     }
-    lua_setglobal(script_arg->lua_vm, "mympd_arguments");
+    lua_setglobal(lua_vm, "mympd_arguments");
 }
 
 /**
@@ -367,6 +383,8 @@ static int mympd_luaopen(lua_State *lua_vm, const char *lualib) {
  */
 static void register_lua_functions(lua_State *lua_vm) {
     lua_register(lua_vm, "mympd_api", lua_mympd_api);
+    lua_register(lua_vm, "mympd_api_async", lua_mympd_api_async);
+    lua_register(lua_vm, "mympd_api_wait", lua_mympd_api_wait);
     lua_register(lua_vm, "mympd_http_client", lua_http_client);
     lua_register(lua_vm, "mympd_http_download", lua_http_download);
     lua_register(lua_vm, "mympd_http_serve_file", lua_http_serve_file);
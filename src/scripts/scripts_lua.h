@@ -7,6 +7,7 @@
 #ifndef MYMPD_SCRIPTS_LUA_H
 #define MYMPD_SCRIPTS_LUA_H
 
+#include "src/scripts/mailbox.h"
 #include "src/scripts/util.h"
 
 #include <lauxlib.h>
@@ -16,6 +17,8 @@
 bool script_start(struct t_scripts_state *scripts_state, sds scriptname, struct t_list *arguments,
         const char *partition, bool localscript, enum script_start_events start_event,
         unsigned request_id, unsigned long conn_id, sds *error);
-bool script_validate(struct t_config *config, sds scriptname, sds script, sds *error);
+bool script_validate(sds scriptname, sds script, sds *error);
+lua_State *script_vm_new(void);
+int script_vm_prepare(lua_State *lua_vm, struct t_script_thread_arg *script_arg, struct t_script_mailbox *mailbox);
 
 #endif
@@ -9,27 +9,288 @@
 
 #include "src/lib/api.h"
 #include "src/lib/jsonrpc.h"
+#include "src/lib/list.h"
 #include "src/lib/log.h"
+#include "src/lib/mem.h"
 #include "src/lib/sds_extras.h"
 #include "src/lib/thread.h"
-#include "src/scripts/util.h"
+#include "src/scripts/mailbox.h"
+#include "src/scripts/sandbox.h"
+#include "src/scripts/scripts_lua.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * Private definitions
+ */
+
+/**
+ * A thread of the script worker thread pool with its reused lua instance
+ * and the mailbox for the responses of its myMPD API requests
+ */
+struct t_script_worker_thread {
+    pthread_t thread;                   //!< thread id
+    unsigned idx;                       //!< number of the thread, used for the thread name
+    lua_State *lua_vm;                  //!< lua instance, created on thread start and after it was closed
+    unsigned runs;                      //!< number of scripts executed in lua_vm
+    struct t_script_mailbox *mailbox;   //!< mailbox for the myMPD API responses
+};
+
+/**
+ * The script worker thread pool.
+ * SCRIPT_WORKER_THREADS threads are started with the scripts thread,
+ * additional threads are started on demand and exit after SCRIPT_WORKER_IDLE_TIMEOUT.
+ */
+struct t_script_worker_pool {
+    struct t_list jobs;      //!< pending scripts, user_data is a struct t_script_thread_arg
+    unsigned threads;        //!< number of running threads
+    unsigned idle;           //!< number of threads waiting for a script
+    unsigned idx;            //!< number of started threads
+    bool stop;               //!< true if the pool is stopping
+    pthread_mutex_t mutex;   //!< the mutex
+    pthread_cond_t wakeup;   //!< signals new scripts and stop
+};
+
+static struct t_script_worker_pool script_worker_pool;
+
+static bool script_worker_thread_start(void);
+static void *script_worker_run(void *arg);
+static struct t_script_thread_arg *script_worker_shift(void);
+static void script_worker_job_run(struct t_script_worker_thread *thread, struct t_script_thread_arg *script_arg);
+static void script_worker_respond(struct t_script_thread_arg *script_arg, int rc, sds result);
+static void free_job_cb(struct t_list_node *current);
+
+/**
+ * Public functions
+ */
 
 /**
- * Main function for the scripts_worker thread.
- * @param script_thread_arg pointer to t_script_thread_arg struct
+ * Starts the script worker thread pool.
+ * The threads create their lua instances on start.
+ * @return true on success, else false
  */
-void *script_run(void *script_thread_arg) {
-    script_worker_threads++;
-    thread_logname = sds_replace(thread_logname, "scripts_worker");
+bool script_worker_pool_start(void) {
+    list_init(&script_worker_pool.jobs);
+    script_worker_pool.threads = 0;
+    script_worker_pool.idle = 0;
+    script_worker_pool.idx = 0;
+    script_worker_pool.stop = false;
+    pthread_mutex_init(&script_worker_pool.mutex, NULL);
+    pthread_cond_init(&script_worker_pool.wakeup, NULL);
+    MYMPD_LOG_NOTICE(NULL, "Starting %d script worker threads", SCRIPT_WORKER_THREADS);
+    bool rc = true;
+    pthread_mutex_lock(&script_worker_pool.mutex);
+    for (unsigned i = 0; i < SCRIPT_WORKER_THREADS; i++) {
+        if (script_worker_thread_start() == false) {
+            rc = false;
+        }
+    }
+    pthread_mutex_unlock(&script_worker_pool.mutex);
+    return rc;
+}
+
+/**
+ * Stops the script worker thread pool.
+ * Pending scripts are discarded. Like the formerly detached script threads,
+ * running scripts are not waited for, the threads exit after the script has finished.
+ */
+void script_worker_pool_stop(void) {
+    MYMPD_LOG_NOTICE(NULL, "Stopping script worker threads");
+    pthread_mutex_lock(&script_worker_pool.mutex);
+    script_worker_pool.stop = true;
+    list_clear_user_data(&script_worker_pool.jobs, free_job_cb);
+    pthread_cond_broadcast(&script_worker_pool.wakeup);
+    pthread_mutex_unlock(&script_worker_pool.mutex);
+}
+
+/**
+ * Queues a script for the script worker threads.
+ * A new thread is started if no thread is idle.
+ * The pool takes the ownership of script_arg only if true is returned.
+ * @param script_arg pointer to t_script_thread_arg struct
+ * @return true on success, else false
+ */
+bool script_worker_push(struct t_script_thread_arg *script_arg) {
+    pthread_mutex_lock(&script_worker_pool.mutex);
+    if (script_worker_pool.stop == true ||
+        script_worker_pool.jobs.length >= SCRIPT_WORKER_QUEUE_MAX)
+    {
+        pthread_mutex_unlock(&script_worker_pool.mutex);
+        return false;
+    }
+    if (script_worker_pool.idle <= script_worker_pool.jobs.length &&
+        script_worker_pool.threads < MAX_SCRIPT_WORKER_THREADS)
+    {
+        // the script waits for a running thread if this fails
+        script_worker_thread_start();
+    }
+    if (script_worker_pool.threads == 0) {
+        pthread_mutex_unlock(&script_worker_pool.mutex);
+        return false;
+    }
+    list_push(&script_worker_pool.jobs, script_arg->script_name, 0, NULL, script_arg);
+    pthread_cond_signal(&script_worker_pool.wakeup);
+    pthread_mutex_unlock(&script_worker_pool.mutex);
+    return true;
+}
+
+/**
+ * Private functions
+ */
+
+/**
+ * Starts a script worker thread, the caller must hold the mutex
+ * @return true on success, else false
+ */
+static bool script_worker_thread_start(void) {
+    struct t_script_worker_thread *thread = malloc_assert(sizeof(struct t_script_worker_thread));
+    thread->idx = script_worker_pool.idx++;
+    thread->lua_vm = NULL;
+    thread->runs = 0;
+    thread->mailbox = NULL;
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) != 0 ||
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0 ||
+        pthread_create(&thread->thread, &attr, script_worker_run, thread) != 0)
+    {
+        MYMPD_LOG_ERROR(NULL, "Can not create script worker thread %u", thread->idx);
+        FREE_PTR(thread);
+        return false;
+    }
+    script_worker_pool.threads++;
+    return true;
+}
+
+/**
+ * This is the main function of the script worker threads.
+ * @param arg void pointer to the t_script_worker_thread struct
+ */
+static void *script_worker_run(void *arg) {
+    struct t_script_worker_thread *thread = (struct t_script_worker_thread *) arg;
+    thread_logname = sds_replace(thread_logname, "scriptworker");
+    thread_logname = sdscatfmt(thread_logname, "%u", thread->idx);
     set_threadname(thread_logname);
-    struct t_script_thread_arg *script_arg = (struct t_script_thread_arg *) script_thread_arg;
+    thread->lua_vm = script_vm_new();
+    thread->mailbox = script_mailbox_new();
+    struct t_script_thread_arg *script_arg;
+    while ((script_arg = script_worker_shift()) != NULL) {
+        script_worker_job_run(thread, script_arg);
+        free_t_script_thread_arg(script_arg);
+        if (thread->mailbox != NULL) {
+            // discard responses for requests the script has not waited for
+            script_mailbox_clear(thread->mailbox);
+        }
+    }
+    if (thread->lua_vm != NULL) {
+        lua_close(thread->lua_vm);
+    }
+    if (thread->mailbox != NULL) {
+        script_mailbox_free(thread->mailbox);
+    }
+    FREE_PTR(thread);
+    FREE_SDS(thread_logname);
+    return NULL;
+}
+
+/**
+ * Waits for the next script.
+ * Threads above SCRIPT_WORKER_THREADS exit after SCRIPT_WORKER_IDLE_TIMEOUT seconds without a script.
+ * @return the script or NULL if the thread should exit
+ */
+static struct t_script_thread_arg *script_worker_shift(void) {
+    struct t_script_thread_arg *script_arg = NULL;
+    pthread_mutex_lock(&script_worker_pool.mutex);
+    script_worker_pool.idle++;
+    while (script_worker_pool.stop == false) {
+        struct t_list_node *node = list_shift_first(&script_worker_pool.jobs);
+        if (node != NULL) {
+            script_arg = (struct t_script_thread_arg *)node->user_data;
+            node->user_data = NULL;
+            list_node_free(node);
+            break;
+        }
+        if (script_worker_pool.threads > SCRIPT_WORKER_THREADS) {
+            struct timespec max_wait;
+            clock_gettime(CLOCK_REALTIME, &max_wait);
+            max_wait.tv_sec += SCRIPT_WORKER_IDLE_TIMEOUT;
+            if (pthread_cond_timedwait(&script_worker_pool.wakeup, &script_worker_pool.mutex, &max_wait) == ETIMEDOUT &&
+                script_worker_pool.jobs.head == NULL)
+            {
+                break;
+            }
+        }
+        else {
+            pthread_cond_wait(&script_worker_pool.wakeup, &script_worker_pool.mutex);
+        }
+    }
+    script_worker_pool.idle--;
+    if (script_arg == NULL) {
+        script_worker_pool.threads--;
+    }
+    pthread_mutex_unlock(&script_worker_pool.mutex);
+    return script_arg;
+}
 
-    MYMPD_LOG_DEBUG(NULL, "Start script");
-    bool rc = lua_pcall(script_arg->lua_vm, 0, 1, 0);
-    MYMPD_LOG_DEBUG(NULL, "End script");
+/**
+ * Executes a script in the lua instance of the thread.
+ * The lua instance is recreated after an error, if the script changed the shared state
+ * and after SCRIPT_WORKER_VM_RUNS_MAX runs.
+ * @param thread the worker thread
+ * @param script_arg pointer to t_script_thread_arg struct
+ */
+static void script_worker_job_run(struct t_script_worker_thread *thread, struct t_script_thread_arg *script_arg) {
+    if (thread->lua_vm == NULL) {
+        thread->lua_vm = script_vm_new();
+        thread->runs = 0;
+        if (thread->lua_vm == NULL) {
+            sds result = sdsnew("Error creating Lua instance.");
+            script_worker_respond(script_arg, LUA_ERRMEM, result);
+            FREE_SDS(result);
+            return;
+        }
+    }
+    if (thread->mailbox == NULL) {
+        sds result = sdsnew("Error creating script mailbox.");
+        script_worker_respond(script_arg, LUA_ERRMEM, result);
+        FREE_SDS(result);
+        return;
+    }
+    MYMPD_LOG_DEBUG(script_arg->partition, "Start script %s", script_arg->script_name);
+    int rc = script_vm_prepare(thread->lua_vm, script_arg, thread->mailbox);
+    if (rc == LUA_OK) {
+        rc = lua_pcall(thread->lua_vm, 0, 1, 0);
+    }
+    MYMPD_LOG_DEBUG(script_arg->partition, "End script %s", script_arg->script_name);
+    sds result = script_get_result(thread->lua_vm, rc);
+    script_worker_respond(script_arg, rc, result);
+    FREE_SDS(result);
+    lua_settop(thread->lua_vm, 0);
+    thread->runs++;
+    bool unchanged = lua_sandbox_check(thread->lua_vm);
+    if (unchanged == false) {
+        MYMPD_LOG_DEBUG(script_arg->partition, "Script %s changed the shared lua state", script_arg->script_name);
+    }
+    if (rc != LUA_OK ||
+        unchanged == false ||
+        thread->runs >= SCRIPT_WORKER_VM_RUNS_MAX)
+    {
+        // the response is already sent, prepare the new instance for the next script
+        lua_close(thread->lua_vm);
+        thread->lua_vm = script_vm_new();
+        thread->runs = 0;
+    }
+}
 
-    sds result = script_get_result(script_arg->lua_vm, rc);
-    if (rc == 0) {
+/**
+ * Sends the result of a script
+ * @param script_arg pointer to t_script_thread_arg struct
+ * @param rc lua return code
+ * @param result script return value or error string
+ */
+static void script_worker_respond(struct t_script_thread_arg *script_arg, int rc, sds result) {
+    if (rc == LUA_OK) {
         if (script_arg->start_event == SCRIPT_START_HTTP) {
             if (sdslen(result) == 0) {
                 send_script_raw_error(script_arg->conn_id, script_arg->partition, "Empty http response from script");
@@ -71,9 +332,12 @@ void *script_run(void *script_thread_arg) {
         }
         MYMPD_LOG_ERROR(script_arg->partition, "Error executing script %s: %s", script_arg->script_name, result);
     }
-    FREE_SDS(result);
-    free_t_script_thread_arg(script_arg);
-    script_worker_threads--;
-    FREE_SDS(thread_logname);
-    return NULL;
+}
+
+/**
+ * Callback function to free a pending script
+ * @param current list node
+ */
+static void free_job_cb(struct t_list_node *current) {
+    free_t_script_thread_arg((struct t_script_thread_arg *)current->user_data);
 }
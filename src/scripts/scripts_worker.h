@@ -7,10 +7,12 @@
 #ifndef MYMPD_SCRIPTS_WORKER_H
 #define MYMPD_SCRIPTS_WORKER_H
 
-#include <lauxlib.h>
-#include <lua.h>
-#include <lualib.h>
+#include "src/scripts/util.h"
 
-void *script_run(void *script_thread_arg);
+#include <stdbool.h>
+
+bool script_worker_pool_start(void);
+void script_worker_pool_stop(void);
+bool script_worker_push(struct t_script_thread_arg *script_arg);
 
 #endif
@@ -71,10 +71,10 @@ void scripts_state_free(struct t_scripts_state *scripts_state) {
  */
 void free_t_script_thread_arg(struct t_script_thread_arg *script_thread_arg) {
     FREE_SDS(script_thread_arg->script_name);
+    FREE_SDS(script_thread_arg->bytecode);
     FREE_SDS(script_thread_arg->partition);
-    if (script_thread_arg->lua_vm != NULL) {
-        lua_close(script_thread_arg->lua_vm);
-    }
+    list_clear(&script_thread_arg->arguments);
+    list_clear(&script_thread_arg->vars);
     FREE_PTR(script_thread_arg);
 }
 
@@ -28,21 +28,25 @@ struct t_scripts_state {
  * Userdata for script_list
  */
 struct t_script_list_data {
-    sds script;    //!< script itself
-    sds bytecode;  //!< precompiled script byte code
+    sds script;            //!< script itself
+    sds bytecode;          //!< precompiled script byte code
+    unsigned bytecode_id;  //!< unique id of the byte code, used to cache the loaded function in the script workers
 };
 
 /**
  * Struct for passing values to the script execute function
  */
 struct t_script_thread_arg {
-    lua_State *lua_vm;                     //!< new lua vm
     sds script_name;                       //!< name of the script
+    sds bytecode;                          //!< precompiled script byte code
+    unsigned bytecode_id;                  //!< id of the byte code, 0 = do not cache the loaded function
     sds partition;                         //!< execute the script in this partition
     enum script_start_events start_event;  //!< script start event
     unsigned long conn_id;                 //!< mongoose connection id
     unsigned request_id;                   //!< jsonrpc request id
     struct t_config *config;               //!< pointer to myMPD config
+    struct t_list arguments;               //!< script arguments
+    struct t_list vars;                    //!< user defined variables
 };
 
 void list_free_cb_script_list_user_data(struct t_list_node *current);
@@ -9,6 +9,7 @@
 
 #include "src/lib/api.h"
 #include "src/lib/cache_disk.h"
+#include "src/lib/cache_disk_images.h"
 #include "src/lib/convert.h"
 #include "src/lib/filehandler.h"
 #include "src/lib/jsonrpc.h"
@@ -19,6 +20,7 @@
 #include "src/lib/sds_extras.h"
 #include "src/lib/utility.h"
 #include "src/lib/validate.h"
+#include "src/web_server/image_worker.h"
 
 #include <libgen.h>
 
@@ -32,9 +34,11 @@
 #endif
 
 /**
- * Privat definitions
+ * Private definitions
  */
-static bool handle_coverextract(struct mg_connection *nc, sds cachedir, const char *uri, const char *media_file, bool covercache, int offset);
+
+static bool push_image_job(unsigned long conn_id, struct t_mg_user_data *mg_user_data,
+        enum image_job_types type, sds uri, sds file, int offset, bool thumbnail);
 
 /**
  * Public functions
@@ -79,8 +83,11 @@ void webserver_send_albumart(struct mg_connection *nc, sds data, sds binary) {
         strncmp(mime_type, "image/", 6) == 0)
     {
         MYMPD_LOG_DEBUG(NULL, "Serving albumart from memory (%s - %lu bytes) (%lu)", mime_type, (unsigned long)len, nc->id);
+        //thumbnails are only sent by the image worker threads
+        bool thumbnail = false;
+        json_get_bool(data, "$.result.thumbnail", &thumbnail, NULL);
         sds headers = sdscatfmt(sdsempty(), "Content-Type: %S\r\n", mime_type);
-        headers = sdscat(headers, EXTRA_HEADERS_IMAGE);
+        headers = sdscat(headers, (thumbnail == true ? EXTRA_HEADERS_THUMBNAIL : EXTRA_HEADERS_IMAGE));
         webserver_send_data(nc, binary, len, headers);
         FREE_SDS(headers);
     }
@@ -145,7 +152,28 @@ bool request_handler_albumart_by_uri(struct mg_connection *nc, struct mg_http_me
     MYMPD_LOG_DEBUG(NULL, "Handle albumart for uri \"%s\", offset %d", uri, offset);
 
     //check covercache and serve image from it if found
-    if (check_imagescache(nc, hm, mg_user_data, DIR_CACHE_COVER, uri, offset) == true) {
+    if (size == ALBUMART_THUMBNAIL &&
+        check_imagescache(nc, hm, mg_user_data, DIR_CACHE_COVER, uri, offset, true) == true)
+    {
+        FREE_SDS(uri);
+        return true;
+    }
+    #ifdef MYMPD_ENABLE_THUMBNAILS
+        if (size == ALBUMART_THUMBNAIL) {
+            //create the thumbnail from the cached image
+            sds cachefile = cache_disk_images_get_basename(config->cachedir, DIR_CACHE_COVER, uri, offset, false);
+            cachefile = webserver_find_image_file(cachefile);
+            if (sdslen(cachefile) > 0 &&
+                push_image_job(conn_id, mg_user_data, IMAGE_JOB_THUMBNAIL, uri, cachefile, offset, true) == true)
+            {
+                FREE_SDS(cachefile);
+                FREE_SDS(uri);
+                return false;
+            }
+            FREE_SDS(cachefile);
+        }
+    #endif
+    if (check_imagescache(nc, hm, mg_user_data, DIR_CACHE_COVER, uri, offset, false) == true) {
         FREE_SDS(uri);
         return true;
     }
@@ -216,8 +244,14 @@ bool request_handler_albumart_by_uri(struct mg_connection *nc, struct mg_http_me
         //create absolute file
         sds mediafile = sdscatfmt(sdsempty(), "%S/%S", mg_user_data->music_directory, uri);
         MYMPD_LOG_DEBUG(NULL, "Absolut media_file: %s", mediafile);
+        //skip the local lookups for songs without local coverimage
+        bool probe = negative_cache_check(&mg_user_data->negative_cache, uri, offset, size == ALBUMART_THUMBNAIL, mediafile) == false;
+        if (probe == false) {
+            MYMPD_LOG_DEBUG(NULL, "No local coverimage for \"%s\" in the negative cache", uri);
+        }
         //try image in folder under music_directory
-        if (mg_user_data->coverimage_names_len > 0 &&
+        if (probe == true &&
+            mg_user_data->coverimage_names_len > 0 &&
             offset == 0)
         {
             sds path = sdsdup(uri);
@@ -227,13 +261,31 @@ bool request_handler_albumart_by_uri(struct mg_connection *nc, struct mg_http_me
                 path = sds_dirname(path);
             }
             bool found = false;
+            bool found_thumbnail = false;
             sds coverfile = sdsempty();
             if (size == ALBUMART_THUMBNAIL) {
                 found = find_image_in_folder(&coverfile, mg_user_data->music_directory, path, mg_user_data->thumbnail_names, mg_user_data->thumbnail_names_len);
+                found_thumbnail = found;
             }
             if (found == false) {
                 found = find_image_in_folder(&coverfile, mg_user_data->music_directory, path, mg_user_data->coverimage_names, mg_user_data->coverimage_names_len);
             }
+            #ifdef MYMPD_ENABLE_THUMBNAILS
+                if (found == true &&
+                    size == ALBUMART_THUMBNAIL &&
+                    found_thumbnail == false &&
+                    push_image_job(conn_id, mg_user_data, IMAGE_JOB_THUMBNAIL, uri, coverfile, offset, true) == true)
+                {
+                    //create the thumbnail from the folder image
+                    FREE_SDS(uri);
+                    FREE_SDS(coverfile);
+                    FREE_SDS(mediafile);
+                    FREE_SDS(path);
+                    return false;
+                }
+            #else
+                (void) found_thumbnail;
+            #endif
             if (found == true) {
                 webserver_serve_file(nc, hm, mg_user_data->browse_directory, coverfile);
                 FREE_SDS(uri);
@@ -248,17 +300,19 @@ bool request_handler_albumart_by_uri(struct mg_connection *nc, struct mg_http_me
             FREE_SDS(path);
         }
 
-        if (testfile_read(mediafile) == true) {
-            //try to extract albumart from media file
-            bool covercache = mg_user_data->config->cache_cover_keep_days != CACHE_DISK_DISABLED
-                ? true
-                : false;
-            bool rc = handle_coverextract(nc, config->cachedir, uri, mediafile, covercache, offset);
-            if (rc == true) {
+        if (probe == true &&
+            testfile_read(mediafile) == true)
+        {
+            //extract albumart from media file in the image worker thread pool,
+            //it also asks mpd if no image could be extracted
+            if (push_image_job(conn_id, mg_user_data, IMAGE_JOB_EXTRACT, uri, mediafile, offset,
+                    size == ALBUMART_THUMBNAIL) == true)
+            {
                 FREE_SDS(uri);
                 FREE_SDS(mediafile);
-                return true;
+                return false;
             }
+            MYMPD_LOG_WARN(NULL, "Image worker queue is not available, skipping coverextract");
         }
         FREE_SDS(mediafile);
     }
@@ -283,22 +337,26 @@ bool request_handler_albumart_by_uri(struct mg_connection *nc, struct mg_http_me
 }
 
 /**
- * Extracts albumart from media files
- * @param nc mongoose connection
+ * Extracts albumart from media files.
+ * This function is called by the image worker threads.
  * @param cachedir covercache directory
  * @param uri song uri
  * @param media_file full path to the song
  * @param covercache true = covercache is enabled
  * @param offset number of embedded image to extract
+ * @param binary pointer to already allocated sds string to append the image
  * @return true on success, else false
  */
-static bool handle_coverextract(struct mg_connection *nc, sds cachedir,
-        const char *uri, const char *media_file, bool covercache, int offset)
+bool albumart_coverextract(sds cachedir, const char *uri, const char *media_file,
+        bool covercache, int offset, sds *binary)
 {
     #if !defined MYMPD_ENABLE_LIBID3TAG && !defined MYMPD_ENABLE_FLAC
-        (void) covercache;
         (void) cachedir;
+        (void) uri;
+        (void) media_file;
+        (void) covercache;
         (void) offset;
+        (void) binary;
         return false;
     #endif
 
@@ -306,30 +364,50 @@ static bool handle_coverextract(struct mg_connection *nc, sds cachedir,
     const char *mime_type_media_file = get_mime_type_by_ext(media_file);
     MYMPD_LOG_DEBUG(NULL, "Handle coverextract for uri \"%s\"", uri);
     MYMPD_LOG_DEBUG(NULL, "Mimetype of %s is %s", media_file, mime_type_media_file);
-    sds binary = sdsempty();
     if (strcmp(mime_type_media_file, "audio/mpeg") == 0) {
         #ifdef MYMPD_ENABLE_LIBID3TAG
-            rc = handle_coverextract_id3(cachedir, uri, media_file, &binary, covercache, offset);
+            rc = handle_coverextract_id3(cachedir, uri, media_file, binary, covercache, offset);
         #endif
     }
     else if (strcmp(mime_type_media_file, "audio/ogg") == 0) {
         #ifdef MYMPD_ENABLE_FLAC
-            rc = handle_coverextract_flac(cachedir, uri, media_file, &binary, true, covercache, offset);
+            rc = handle_coverextract_flac(cachedir, uri, media_file, binary, true, covercache, offset);
         #endif
     }
     else if (strcmp(mime_type_media_file, "audio/flac") == 0) {
         #ifdef MYMPD_ENABLE_FLAC
-            rc = handle_coverextract_flac(cachedir, uri, media_file, &binary, false, covercache, offset);
+            rc = handle_coverextract_flac(cachedir, uri, media_file, binary, false, covercache, offset);
         #endif
     }
     if (rc == true) {
-        const char *mime_type = get_mime_type_by_magic_stream(binary);
-        MYMPD_LOG_DEBUG(NULL, "Serving coverimage for \"%s\" (%s)", media_file, mime_type);
-        sds headers = sdscatfmt(sdsempty(), "Content-Type: %s\r\n", mime_type);
-        headers = sdscat(headers, EXTRA_HEADERS_IMAGE);
-        webserver_send_data(nc, binary,  sdslen(binary), headers);
-        FREE_SDS(headers);
+        MYMPD_LOG_DEBUG(NULL, "Extracted coverimage from \"%s\"", media_file);
     }
-    FREE_SDS(binary);
     return rc;
 }
+
+/**
+ * Private functions
+ */
+
+/**
+ * Pushes a job to the image worker thread pool
+ * @param conn_id mongoose connection id
+ * @param mg_user_data pointer to mongoose configuration
+ * @param type job type
+ * @param uri song uri
+ * @param file absolute path of the song or the image
+ * @param offset number of the embedded image
+ * @param thumbnail true = create a thumbnail
+ * @return true if the job was queued, else false
+ */
+static bool push_image_job(unsigned long conn_id, struct t_mg_user_data *mg_user_data,
+        enum image_job_types type, sds uri, sds file, int offset, bool thumbnail)
+{
+    bool covercache = mg_user_data->config->cache_cover_keep_days != CACHE_DISK_DISABLED
+        ? true
+        : false;
+    enum image_worker_push_rc rc = image_worker_push(conn_id, type, mg_user_data->config->cachedir, uri, file,
+        covercache, offset, thumbnail, mg_user_data->feat_albumart);
+    return rc == IMAGE_WORKER_ADDED ||
+        rc == IMAGE_WORKER_COALESCED;
+}
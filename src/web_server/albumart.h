@@ -24,4 +24,6 @@ void webserver_send_albumart(struct mg_connection *nc, sds data, sds binary);
 void request_handler_albumart_by_album_id(struct mg_http_message *hm, unsigned long conn_id, enum albumart_sizes size);
 bool request_handler_albumart_by_uri(struct mg_connection *nc, struct mg_http_message *hm,
     struct t_mg_user_data *mg_user_data, unsigned long conn_id, enum albumart_sizes size);
+bool albumart_coverextract(sds cachedir, const char *uri, const char *media_file,
+    bool covercache, int offset, sds *binary);
 #endif
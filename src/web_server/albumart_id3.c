@@ -49,7 +49,7 @@ bool handle_coverextract_id3(sds cachedir, const char *uri, const char *media_fi
             const char *mime_type = get_mime_type_by_magic_stream(*binary);
             if (mime_type != NULL) {
                 if (covercache == true) {
-                    sds filename = cache_disk_images_write_file(cachedir, DIR_CACHE_COVER, uri, mime_type, *binary, offset);
+                    sds filename = cache_disk_images_write_file(cachedir, DIR_CACHE_COVER, uri, mime_type, *binary, offset, false);
                     FREE_SDS(filename);
                 }
                 else {
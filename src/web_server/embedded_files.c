@@ -9,6 +9,7 @@
 
 #include "compile_time.h"
 #include "dist/incbin/incbin.h"
+#include "htdocs/etags.h"
 
 //compressed assets
 INCBIN(sw_js, "../htdocs/sw.js.gz");
@@ -27,6 +28,17 @@ INCBIN(combined_css, "../htdocs/css/combined.css.gz");
 INCBIN(combined_js, "../htdocs/js/combined.js.gz");
 INCBIN(MaterialIcons_Regular_woff2, "../htdocs/assets/MaterialIcons-Regular.woff2");
 INCBIN(ligatures_json, "../htdocs/assets/ligatures.json.gz");
+//precompressed variants
+#ifdef MYMPD_EMBEDDED_BROTLI
+    INCBIN(index_html_br, "../htdocs/index.html.br");
+    INCBIN(combined_css_br, "../htdocs/css/combined.css.br");
+    INCBIN(combined_js_br, "../htdocs/js/combined.js.br");
+#endif
+#ifdef MYMPD_EMBEDDED_ZSTD
+    INCBIN(index_html_zst, "../htdocs/index.html.zst");
+    INCBIN(combined_css_zst, "../htdocs/css/combined.css.zst");
+    INCBIN(combined_js_zst, "../htdocs/js/combined.js.zst");
+#endif
 //translation files
 #ifdef I18N_bg_BG
     INCBIN(i18n_bg_BG_json, "../htdocs/assets/i18n/bg-BG.json.gz");
@@ -0,0 +1,244 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/web_server/image_cache.h"
+
+#include "src/lib/jsonrpc.h"
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/sds_extras.h"
+
+/*
+ The image cache keeps the bodies of recently served images from the disk caches
+ in memory. It is only accessed by the web server thread and needs no locking.
+ Entries are kept in a doubly linked list in the order of their last use,
+ the least recently used entries are evicted if the byte budget is exceeded.
+ All entries are dropped if the disk caches were cropped.
+*/
+
+// private definitions
+
+static sds get_key(sds key, const char *type, sds uri, int offset, bool thumbnail);
+static void entry_unlink(struct t_image_cache *cache, struct t_image_cache_entry *entry);
+static void entry_link_head(struct t_image_cache *cache, struct t_image_cache_entry *entry);
+static void entry_remove(struct t_image_cache *cache, struct t_image_cache_entry *entry);
+
+// public functions
+
+/**
+ * Initializes the image cache
+ * @param cache pointer to the image cache
+ * @param size_max byte budget, 0 disables the cache
+ */
+void image_cache_init(struct t_image_cache *cache, size_t size_max) {
+    cache->index = raxNew();
+    cache->head = NULL;
+    cache->tail = NULL;
+    cache->size = 0;
+    cache->size_max = size_max;
+    cache->generation = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+/**
+ * Frees all entries and the index of the image cache
+ * @param cache pointer to the image cache
+ */
+void image_cache_clear(struct t_image_cache *cache) {
+    while (cache->head != NULL) {
+        entry_remove(cache, cache->head);
+    }
+    if (cache->index != NULL) {
+        raxFree(cache->index);
+        cache->index = NULL;
+    }
+}
+
+/**
+ * Drops all entries if the disk caches have changed
+ * @param cache pointer to the image cache
+ * @param generation current generation of the disk caches
+ */
+void image_cache_sync(struct t_image_cache *cache, unsigned generation) {
+    if (cache->generation == generation) {
+        return;
+    }
+    if (cache->head != NULL) {
+        MYMPD_LOG_DEBUG(NULL, "Disk caches were cropped, dropping %llu images from memory",
+            (unsigned long long)raxSize(cache->index));
+        while (cache->head != NULL) {
+            entry_remove(cache, cache->head);
+        }
+    }
+    cache->generation = generation;
+}
+
+/**
+ * Gets an image from the cache and marks it as most recently used
+ * @param cache pointer to the image cache
+ * @param type cache type: cover or thumbs
+ * @param uri image uri
+ * @param offset embedded image offset
+ * @param thumbnail true for the downscaled version of the image
+ * @return the cache entry or NULL if not found
+ */
+struct t_image_cache_entry *image_cache_get(struct t_image_cache *cache, const char *type,
+        sds uri, int offset, bool thumbnail)
+{
+    if (cache->size_max == 0) {
+        return NULL;
+    }
+    sds key = get_key(sdsempty(), type, uri, offset, thumbnail);
+    void *data = raxFind(cache->index, (unsigned char *)key, sdslen(key));
+    FREE_SDS(key);
+    if (data == raxNotFound) {
+        cache->misses++;
+        return NULL;
+    }
+    cache->hits++;
+    struct t_image_cache_entry *entry = (struct t_image_cache_entry *)data;
+    if (entry != cache->head) {
+        entry_unlink(cache, entry);
+        entry_link_head(cache, entry);
+    }
+    return entry;
+}
+
+/**
+ * Adds an image to the cache and evicts the least recently used entries
+ * to respect the byte budget.
+ * The caller must ensure that the image is not larger than image_cache_entry_max.
+ * @param cache pointer to the image cache
+ * @param type cache type: cover or thumbs
+ * @param uri image uri
+ * @param offset embedded image offset
+ * @param thumbnail true for the downscaled version of the image
+ * @param data the image, the cache takes the ownership
+ * @param mime_type mime type of the image
+ * @param etag quoted etag of the image file
+ * @return the new cache entry
+ */
+struct t_image_cache_entry *image_cache_put(struct t_image_cache *cache, const char *type,
+        sds uri, int offset, bool thumbnail, sds data, const char *mime_type, const char *etag)
+{
+    struct t_image_cache_entry *entry = malloc_assert(sizeof(struct t_image_cache_entry));
+    entry->key = get_key(sdsempty(), type, uri, offset, thumbnail);
+    entry->data = data;
+    entry->mime_type = sdsnew(mime_type);
+    entry->etag = sdsnew(etag);
+    void *old = NULL;
+    if (raxTryInsert(cache->index, (unsigned char *)entry->key, sdslen(entry->key), entry, &old) == 0) {
+        entry_remove(cache, (struct t_image_cache_entry *)old);
+        raxInsert(cache->index, (unsigned char *)entry->key, sdslen(entry->key), entry, NULL);
+    }
+    entry_link_head(cache, entry);
+    cache->size += sdslen(data);
+    while (cache->size > cache->size_max &&
+        cache->tail != entry)
+    {
+        entry_remove(cache, cache->tail);
+    }
+    return entry;
+}
+
+/**
+ * Returns the maximum size of a single image.
+ * Larger images would evict too many other entries.
+ * @param cache pointer to the image cache
+ * @return maximum size in bytes, 0 if the cache is disabled
+ */
+size_t image_cache_entry_max(struct t_image_cache *cache) {
+    return cache->size_max / 4;
+}
+
+/**
+ * Prints the image cache statistics as json object
+ * @param buffer already allocated sds string to append the object
+ * @param cache pointer to the image cache
+ * @return pointer to buffer
+ */
+sds image_cache_status(sds buffer, struct t_image_cache *cache) {
+    buffer = sdscatlen(buffer, "{", 1);
+    buffer = tojson_uint64(buffer, "entries", raxSize(cache->index), true);
+    buffer = tojson_uint64(buffer, "size", cache->size, true);
+    buffer = tojson_uint64(buffer, "sizeMax", cache->size_max, true);
+    buffer = tojson_uint64(buffer, "hits", cache->hits, true);
+    buffer = tojson_uint64(buffer, "misses", cache->misses, false);
+    buffer = sdscatlen(buffer, "}", 1);
+    return buffer;
+}
+
+// private functions
+
+/**
+ * Creates the cache key
+ * @param key already allocated sds string to append the key
+ * @param type cache type: cover or thumbs
+ * @param uri image uri
+ * @param offset embedded image offset
+ * @param thumbnail true for the downscaled version of the image
+ * @return pointer to key
+ */
+static sds get_key(sds key, const char *type, sds uri, int offset, bool thumbnail) {
+    return sdscatfmt(key, "%s:%i:%i:%S", type, (int)thumbnail, offset, uri);
+}
+
+/**
+ * Unlinks the entry from the usage list
+ * @param cache pointer to the image cache
+ * @param entry entry to unlink
+ */
+static void entry_unlink(struct t_image_cache *cache, struct t_image_cache_entry *entry) {
+    if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+    }
+    else {
+        cache->head = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->prev = entry->prev;
+    }
+    else {
+        cache->tail = entry->prev;
+    }
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+/**
+ * Links the entry as most recently used
+ * @param cache pointer to the image cache
+ * @param entry entry to link
+ */
+static void entry_link_head(struct t_image_cache *cache, struct t_image_cache_entry *entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+    if (cache->head != NULL) {
+        cache->head->prev = entry;
+    }
+    cache->head = entry;
+    if (cache->tail == NULL) {
+        cache->tail = entry;
+    }
+}
+
+/**
+ * Removes the entry from the cache and frees it
+ * @param cache pointer to the image cache
+ * @param entry entry to remove
+ */
+static void entry_remove(struct t_image_cache *cache, struct t_image_cache_entry *entry) {
+    entry_unlink(cache, entry);
+    raxRemove(cache->index, (unsigned char *)entry->key, sdslen(entry->key), NULL);
+    cache->size -= sdslen(entry->data);
+    FREE_SDS(entry->key);
+    FREE_SDS(entry->data);
+    FREE_SDS(entry->mime_type);
+    FREE_SDS(entry->etag);
+    FREE_PTR(entry);
+}
@@ -0,0 +1,52 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_WEB_SERVER_IMAGE_CACHE_H
+#define MYMPD_WEB_SERVER_IMAGE_CACHE_H
+
+#include "dist/rax/rax.h"
+#include "dist/sds/sds.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * An image in the memory cache
+ */
+struct t_image_cache_entry {
+    sds key;                            //!< cache type, size, offset and uri
+    sds data;                           //!< the image
+    sds mime_type;                      //!< mime type of the image
+    sds etag;                           //!< quoted etag of the image file
+    struct t_image_cache_entry *prev;   //!< more recently used entry
+    struct t_image_cache_entry *next;   //!< less recently used entry
+};
+
+/**
+ * Bounded in-memory LRU cache of recently served images from the disk caches
+ */
+struct t_image_cache {
+    rax *index;                         //!< key -> struct t_image_cache_entry
+    struct t_image_cache_entry *head;   //!< most recently used entry
+    struct t_image_cache_entry *tail;   //!< least recently used entry
+    size_t size;                        //!< bytes of all cached images
+    size_t size_max;                    //!< byte budget, 0 disables the cache
+    unsigned generation;                //!< disk cache generation the entries belong to
+    unsigned long hits;                 //!< number of cache hits
+    unsigned long misses;               //!< number of cache misses
+};
+
+void image_cache_init(struct t_image_cache *cache, size_t size_max);
+void image_cache_clear(struct t_image_cache *cache);
+void image_cache_sync(struct t_image_cache *cache, unsigned generation);
+struct t_image_cache_entry *image_cache_get(struct t_image_cache *cache, const char *type,
+        sds uri, int offset, bool thumbnail);
+struct t_image_cache_entry *image_cache_put(struct t_image_cache *cache, const char *type,
+        sds uri, int offset, bool thumbnail, sds data, const char *mime_type, const char *etag);
+size_t image_cache_entry_max(struct t_image_cache *cache);
+sds image_cache_status(sds buffer, struct t_image_cache *cache);
+
+#endif
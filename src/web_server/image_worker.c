@@ -0,0 +1,334 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/web_server/image_worker.h"
+
+#include "dist/rax/rax.h"
+#include "src/lib/api.h"
+#include "src/lib/cache_disk_images.h"
+#include "src/lib/filehandler.h"
+#include "src/lib/jsonrpc.h"
+#include "src/lib/list.h"
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/mimetype.h"
+#include "src/lib/msg_queue.h"
+#include "src/lib/sds_extras.h"
+#include "src/lib/thread.h"
+#include "src/web_server/albumart.h"
+
+#ifdef MYMPD_ENABLE_THUMBNAILS
+    #include "src/lib/thumbnail.h"
+#endif
+
+#include <pthread.h>
+#include <stdint.h>
+
+/*
+ Thread pool for the extraction of embedded images and the creation of thumbnails.
+ The web server thread pushes the jobs and continues to serve other connections,
+ the results are sent back through the web_server_queue by connection id.
+ Jobs for the same image are coalesced, every waiting connection gets the result.
+*/
+
+/**
+ * Private definitions
+ */
+
+/**
+ * An extraction job
+ */
+struct t_image_job {
+    enum image_job_types type;  //!< job type
+    sds key;              //!< size, offset and uri of the image, identifies identical jobs
+    sds cachedir;         //!< cache directory
+    sds uri;              //!< song uri
+    sds file;             //!< absolute path of the song or the image
+    bool covercache;      //!< true = write the image to the covercache
+    int offset;           //!< number of the embedded image
+    bool thumbnail;       //!< true = create a thumbnail
+    bool feat_albumart;   //!< true = ask mpd if no image was extracted
+    struct t_list conns;  //!< waiting connections, value_i is the connection id
+};
+
+/**
+ * The job queue of the thread pool
+ */
+struct t_image_worker_queue {
+    struct t_list pending;   //!< pending jobs, user_data is the job
+    rax *inflight;           //!< key -> job, for pending and running jobs
+    bool stop;               //!< true if the pool is not running
+    struct t_negative_cache *negative_cache;  //!< songs without local coverimage
+    pthread_mutex_t mutex;   //!< the mutex
+    pthread_cond_t wakeup;   //!< condition variable for the mutex
+};
+
+static struct t_image_worker_queue image_worker_queue = {
+    .inflight = NULL,
+    .stop = true,
+    .negative_cache = NULL,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .wakeup = PTHREAD_COND_INITIALIZER
+};
+static pthread_t image_worker_pool[IMAGE_WORKER_THREADS];
+
+static void *image_worker_run(void *arg);
+static void image_job_run(struct t_image_job *job);
+static bool image_job_thumbnail(struct t_image_job *job, sds *binary);
+static void image_job_free(struct t_image_job *job);
+
+/**
+ * Public functions
+ */
+
+/**
+ * Starts the image worker thread pool
+ * @param negative_cache songs without local coverimage, failed extractions are added
+ * @return true on success, else false
+ */
+bool image_worker_pool_start(struct t_negative_cache *negative_cache) {
+    list_init(&image_worker_queue.pending);
+    image_worker_queue.negative_cache = negative_cache;
+    image_worker_queue.inflight = raxNew();
+    image_worker_queue.stop = false;
+    MYMPD_LOG_NOTICE(NULL, "Starting %d image_worker threads", IMAGE_WORKER_THREADS);
+    bool rc = true;
+    for (unsigned i = 0; i < IMAGE_WORKER_THREADS; i++) {
+        if (pthread_create(&image_worker_pool[i], NULL, image_worker_run, (void *)(uintptr_t)i) != 0) {
+            MYMPD_LOG_ERROR(NULL, "Can not create image_worker thread %u", i);
+            image_worker_pool[i] = 0;
+            rc = false;
+        }
+    }
+    return rc;
+}
+
+/**
+ * Stops the image worker thread pool.
+ * Running jobs are finished, pending jobs are discarded.
+ */
+void image_worker_pool_stop(void) {
+    MYMPD_LOG_NOTICE(NULL, "Stopping image_worker threads");
+    pthread_mutex_lock(&image_worker_queue.mutex);
+    image_worker_queue.stop = true;
+    pthread_cond_broadcast(&image_worker_queue.wakeup);
+    pthread_mutex_unlock(&image_worker_queue.mutex);
+    for (unsigned i = 0; i < IMAGE_WORKER_THREADS; i++) {
+        if (image_worker_pool[i] > (pthread_t)0) {
+            pthread_join(image_worker_pool[i], NULL);
+        }
+    }
+    struct t_list_node *current;
+    while ((current = list_shift_first(&image_worker_queue.pending)) != NULL) {
+        image_job_free((struct t_image_job *)current->user_data);
+        current->user_data = NULL;
+        list_node_free(current);
+    }
+    raxFree(image_worker_queue.inflight);
+    image_worker_queue.inflight = NULL;
+}
+
+/**
+ * Queues the extraction of an embedded image or the creation of a thumbnail.
+ * The response is sent asynchronously to the connection.
+ * @param conn_id mongoose connection id
+ * @param type job type
+ * @param cachedir cache directory
+ * @param uri song uri
+ * @param file absolute path of the song for IMAGE_JOB_EXTRACT or of the image for IMAGE_JOB_THUMBNAIL
+ * @param covercache true = write the image to the covercache
+ * @param offset number of the embedded image
+ * @param thumbnail true = create a thumbnail
+ * @param feat_albumart true = ask mpd if no image was extracted
+ * @return enum image_worker_push_rc
+ */
+enum image_worker_push_rc image_worker_push(unsigned long conn_id, enum image_job_types type, sds cachedir,
+        sds uri, sds file, bool covercache, int offset, bool thumbnail, bool feat_albumart)
+{
+    enum image_worker_push_rc rc = IMAGE_WORKER_ADDED;
+    sds key = sdscatfmt(sdsempty(), "%i:%i:%S", (int)thumbnail, offset, uri);
+    pthread_mutex_lock(&image_worker_queue.mutex);
+    void *data;
+    if (image_worker_queue.stop == true) {
+        rc = IMAGE_WORKER_STOPPED;
+    }
+    else if ((data = raxFind(image_worker_queue.inflight, (unsigned char *)key, sdslen(key))) != raxNotFound) {
+        struct t_image_job *job = (struct t_image_job *)data;
+        list_push(&job->conns, "", (int64_t)conn_id, NULL, NULL);
+        rc = IMAGE_WORKER_COALESCED;
+    }
+    else if (image_worker_queue.pending.length >= IMAGE_WORKER_QUEUE_MAX) {
+        rc = IMAGE_WORKER_FULL;
+    }
+    else {
+        struct t_image_job *job = malloc_assert(sizeof(struct t_image_job));
+        job->type = type;
+        job->key = key;
+        job->cachedir = sdsdup(cachedir);
+        job->uri = sdsdup(uri);
+        job->file = sdsdup(file);
+        job->covercache = covercache;
+        job->offset = offset;
+        job->thumbnail = thumbnail;
+        job->feat_albumart = feat_albumart;
+        list_init(&job->conns);
+        list_push(&job->conns, "", (int64_t)conn_id, NULL, NULL);
+        raxInsert(image_worker_queue.inflight, (unsigned char *)job->key, sdslen(job->key), job, NULL);
+        list_push(&image_worker_queue.pending, job->key, 0, NULL, job);
+        pthread_cond_signal(&image_worker_queue.wakeup);
+        key = NULL;
+    }
+    pthread_mutex_unlock(&image_worker_queue.mutex);
+    FREE_SDS(key);
+    MYMPD_LOG_DEBUG(NULL, "Image job for \"%s\" (%lu): %d", uri, conn_id, rc);
+    return rc;
+}
+
+/**
+ * Private functions
+ */
+
+/**
+ * Main function of the worker threads
+ * @param arg index of the thread
+ * @return NULL
+ */
+static void *image_worker_run(void *arg) {
+    thread_logname = sds_replace(thread_logname, "imageworker");
+    thread_logname = sdscatfmt(thread_logname, "%u", (unsigned)(uintptr_t)arg);
+    set_threadname(thread_logname);
+    pthread_mutex_lock(&image_worker_queue.mutex);
+    while (image_worker_queue.stop == false) {
+        struct t_list_node *node = list_shift_first(&image_worker_queue.pending);
+        if (node == NULL) {
+            pthread_cond_wait(&image_worker_queue.wakeup, &image_worker_queue.mutex);
+            continue;
+        }
+        struct t_image_job *job = (struct t_image_job *)node->user_data;
+        node->user_data = NULL;
+        list_node_free(node);
+        pthread_mutex_unlock(&image_worker_queue.mutex);
+        image_job_run(job);
+        pthread_mutex_lock(&image_worker_queue.mutex);
+    }
+    pthread_mutex_unlock(&image_worker_queue.mutex);
+    FREE_SDS(thread_logname);
+    return NULL;
+}
+
+/**
+ * Extracts the image and sends the result to all waiting connections
+ * @param job the job to run, it is freed after completion
+ */
+static void image_job_run(struct t_image_job *job) {
+    sds binary = sdsempty();
+    bool rc = false;
+    if (job->type == IMAGE_JOB_EXTRACT) {
+        rc = albumart_coverextract(job->cachedir, job->uri, job->file, job->covercache, job->offset, &binary);
+        if (rc == false) {
+            //the folder was already probed
+            negative_cache_add(image_worker_queue.negative_cache, job->uri, job->offset, job->thumbnail, job->file);
+        }
+    }
+    else {
+        int nread = 0;
+        binary = sds_getfile_binary(binary, job->file, IMAGE_SIZE_MAX, &nread);
+        rc = nread > 0;
+    }
+    bool thumbnail = rc == true &&
+        job->thumbnail == true &&
+        image_job_thumbnail(job, &binary) == true;
+    const char *mime_type = rc == true
+        ? get_mime_type_by_magic_stream(binary)
+        : "";
+    // no more connections are added after the job left the inflight index
+    pthread_mutex_lock(&image_worker_queue.mutex);
+    raxRemove(image_worker_queue.inflight, (unsigned char *)job->key, sdslen(job->key), NULL);
+    pthread_mutex_unlock(&image_worker_queue.mutex);
+
+    struct t_list_node *current = job->conns.head;
+    while (current != NULL) {
+        unsigned long conn_id = (unsigned long)current->value_i;
+        if (rc == false &&
+            job->feat_albumart == true &&
+            job->offset == 0)
+        {
+            //ask mpd - mpd can read only first image
+            MYMPD_LOG_DEBUG(NULL, "Sending INTERNAL_API_ALBUMART_BY_URI to mympdapi_queue");
+            struct t_work_request *request = create_request(REQUEST_TYPE_DEFAULT, conn_id, 0, INTERNAL_API_ALBUMART_BY_URI, NULL, MPD_PARTITION_DEFAULT);
+            request->data = tojson_sds(request->data, "uri", job->uri, false);
+            request->data = jsonrpc_end(request->data);
+            mympd_queue_push(mympd_api_queue, request, 0);
+        }
+        else {
+            if (rc == false) {
+                MYMPD_LOG_INFO(NULL, "No coverimage found for \"%s\"", job->uri);
+            }
+            //an empty binary is answered with the placeholder image
+            struct t_work_response *response = create_response_new(RESPONSE_TYPE_DEFAULT, conn_id, 0, INTERNAL_API_ALBUMART_BY_URI, MPD_PARTITION_DEFAULT);
+            response->data = jsonrpc_respond_start(response->data, INTERNAL_API_ALBUMART_BY_URI, 0);
+            response->data = tojson_char(response->data, "mime_type", mime_type, true);
+            response->data = tojson_bool(response->data, "thumbnail", thumbnail, false);
+            response->data = jsonrpc_end(response->data);
+            if (rc == true) {
+                if (current->next == NULL) {
+                    //the last connection takes the image
+                    FREE_SDS(response->binary);
+                    response->binary = binary;
+                    binary = NULL;
+                }
+                else {
+                    response->binary = sdscatsds(response->binary, binary);
+                }
+            }
+            mympd_queue_push(web_server_queue, response, 0);
+        }
+        current = current->next;
+    }
+    FREE_SDS(binary);
+    image_job_free(job);
+}
+
+/**
+ * Replaces the image with a thumbnail and writes it to the covercache
+ * @param job the job
+ * @param binary pointer to the image, it is replaced on success
+ * @return true if the image was replaced by a thumbnail, else false
+ */
+static bool image_job_thumbnail(struct t_image_job *job, sds *binary) {
+    #ifdef MYMPD_ENABLE_THUMBNAILS
+        sds thumbnail = sdsempty();
+        if (thumbnail_create(*binary, THUMBNAIL_SIZE, &thumbnail) == false) {
+            FREE_SDS(thumbnail);
+            return false;
+        }
+        if (job->covercache == true) {
+            sds filename = cache_disk_images_write_file(job->cachedir, DIR_CACHE_COVER, job->uri, "image/jpeg", thumbnail, job->offset, true);
+            FREE_SDS(filename);
+        }
+        FREE_SDS(*binary);
+        *binary = thumbnail;
+        return true;
+    #else
+        (void) job;
+        (void) binary;
+        return false;
+    #endif
+}
+
+/**
+ * Frees the job
+ * @param job the job to free
+ */
+static void image_job_free(struct t_image_job *job) {
+    FREE_SDS(job->key);
+    FREE_SDS(job->cachedir);
+    FREE_SDS(job->uri);
+    FREE_SDS(job->file);
+    list_clear(&job->conns);
+    FREE_PTR(job);
+}
@@ -0,0 +1,38 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_WEB_SERVER_IMAGE_WORKER_H
+#define MYMPD_WEB_SERVER_IMAGE_WORKER_H
+
+#include "dist/sds/sds.h"
+#include "src/web_server/negative_cache.h"
+
+#include <stdbool.h>
+
+/**
+ * Types of image worker jobs
+ */
+enum image_job_types {
+    IMAGE_JOB_EXTRACT = 0,  //!< extracts an embedded image from a media file
+    IMAGE_JOB_THUMBNAIL     //!< creates a thumbnail from an image file
+};
+
+/**
+ * Return codes of image_worker_push
+ */
+enum image_worker_push_rc {
+    IMAGE_WORKER_ADDED = 0,  //!< a new extraction job was queued
+    IMAGE_WORKER_COALESCED,  //!< an identical job is in flight, the connection waits for its result
+    IMAGE_WORKER_FULL,       //!< too many pending jobs
+    IMAGE_WORKER_STOPPED     //!< the thread pool is not running
+};
+
+bool image_worker_pool_start(struct t_negative_cache *negative_cache);
+void image_worker_pool_stop(void);
+enum image_worker_push_rc image_worker_push(unsigned long conn_id, enum image_job_types type, sds cachedir,
+        sds uri, sds file, bool covercache, int offset, bool thumbnail, bool feat_albumart);
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/web_server/negative_cache.h"
+
+#include "src/lib/filehandler.h"
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/mpack.h"
+#include "src/lib/sds_extras.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ The negative cache remembers songs for that neither an image in the folder
+ nor an embedded image was found. Such requests are answered without probing
+ the folder and parsing the media file again.
+ An entry is valid as long as the modification times of the media file and its
+ directory are unchanged, adding a coverimage to the folder or embedding
+ an image invalidates it. All entries are dropped if the music directory or the
+ coverimage names are changed.
+*/
+
+// private definitions
+
+/**
+ * Modification times of a song without local coverimage
+ */
+struct t_negative_cache_entry {
+    time_t file_mtime;  //!< modification time of the media file
+    time_t dir_mtime;   //!< modification time of the directory of the media file
+};
+
+static sds get_key(sds key, sds uri, int offset, bool thumbnail);
+static void get_mtimes(const char *media_file, struct t_negative_cache_entry *entry);
+static bool insert_entry(struct t_negative_cache *cache, const char *key, size_t key_len,
+        time_t file_mtime, time_t dir_mtime);
+static void free_entries(rax *entries);
+
+// public functions
+
+/**
+ * Initializes the negative cache
+ * @param cache pointer to the negative cache
+ */
+void negative_cache_init(struct t_negative_cache *cache) {
+    cache->entries = raxNew();
+    cache->signature = sdsempty();
+    pthread_mutex_init(&cache->mutex, NULL);
+}
+
+/**
+ * Frees the negative cache
+ * @param cache pointer to the negative cache
+ */
+void negative_cache_clear(struct t_negative_cache *cache) {
+    free_entries(cache->entries);
+    cache->entries = NULL;
+    FREE_SDS(cache->signature);
+    pthread_mutex_destroy(&cache->mutex);
+}
+
+/**
+ * Sets the settings the entries depend on and drops all entries if they have changed
+ * @param cache pointer to the negative cache
+ * @param signature music directory and coverimage names
+ */
+void negative_cache_set_signature(struct t_negative_cache *cache, sds signature) {
+    pthread_mutex_lock(&cache->mutex);
+    if (strcmp(cache->signature, signature) != 0) {
+        if (raxSize(cache->entries) > 0) {
+            MYMPD_LOG_INFO(NULL, "Coverimage settings changed, clearing the negative cache");
+            free_entries(cache->entries);
+            cache->entries = raxNew();
+        }
+        cache->signature = sds_replace(cache->signature, signature);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/**
+ * Adds a song without local coverimage
+ * @param cache pointer to the negative cache
+ * @param uri song uri
+ * @param offset embedded image offset
+ * @param thumbnail true if a thumbnail was requested
+ * @param media_file absolute path of the song
+ * @return true on success, false if the cache is full
+ */
+bool negative_cache_add(struct t_negative_cache *cache, sds uri, int offset, bool thumbnail, const char *media_file) {
+    struct t_negative_cache_entry mtimes;
+    get_mtimes(media_file, &mtimes);
+    sds key = get_key(sdsempty(), uri, offset, thumbnail);
+    pthread_mutex_lock(&cache->mutex);
+    bool rc = insert_entry(cache, key, sdslen(key), mtimes.file_mtime, mtimes.dir_mtime);
+    pthread_mutex_unlock(&cache->mutex);
+    FREE_SDS(key);
+    return rc;
+}
+
+/**
+ * Checks if the song has no local coverimage
+ * @param cache pointer to the negative cache
+ * @param uri song uri
+ * @param offset embedded image offset
+ * @param thumbnail true if a thumbnail was requested
+ * @param media_file absolute path of the song
+ * @return true if a valid entry was found, else false
+ */
+bool negative_cache_check(struct t_negative_cache *cache, sds uri, int offset, bool thumbnail, const char *media_file) {
+    sds key = get_key(sdsempty(), uri, offset, thumbnail);
+    struct t_negative_cache_entry cached;
+    pthread_mutex_lock(&cache->mutex);
+    void *data = raxFind(cache->entries, (unsigned char *)key, sdslen(key));
+    if (data != raxNotFound) {
+        cached = *(struct t_negative_cache_entry *)data;
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    if (data == raxNotFound) {
+        FREE_SDS(key);
+        return false;
+    }
+    struct t_negative_cache_entry mtimes;
+    get_mtimes(media_file, &mtimes);
+    if (mtimes.file_mtime == cached.file_mtime &&
+        mtimes.dir_mtime == cached.dir_mtime)
+    {
+        FREE_SDS(key);
+        return true;
+    }
+    MYMPD_LOG_DEBUG(NULL, "Negative cache entry for \"%s\" is outdated", uri);
+    pthread_mutex_lock(&cache->mutex);
+    if (raxRemove(cache->entries, (unsigned char *)key, sdslen(key), &data) == 1) {
+        FREE_PTR(data);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    FREE_SDS(key);
+    return false;
+}
+
+/**
+ * Saves the negative cache to disc
+ * @param cache pointer to the negative cache
+ * @param workdir working directory
+ * @return true on success, else false
+ */
+bool negative_cache_save(struct t_negative_cache *cache, sds workdir) {
+    pthread_mutex_lock(&cache->mutex);
+    MYMPD_LOG_INFO(NULL, "Saving %llu negative cache entries to disc", (unsigned long long)raxSize(cache->entries));
+    mpack_writer_t writer;
+    sds tmp_file = sdscatfmt(sdsempty(), "%S/%s/%s.XXXXXX", workdir, DIR_WORK_TAGS, FILENAME_NEGATIVE_CACHE);
+    FILE *fp = open_tmp_file(tmp_file);
+    if (fp == NULL) {
+        pthread_mutex_unlock(&cache->mutex);
+        FREE_SDS(tmp_file);
+        return false;
+    }
+    // init mpack
+    mpack_writer_init_stdfile(&writer, fp, true);
+    mpack_writer_set_error_handler(&writer, log_mpack_write_error);
+
+    mpack_build_map(&writer);
+    mpack_write_kv(&writer, "signature", cache->signature);
+    mpack_write_cstr(&writer, "entries");
+    mpack_start_array(&writer, (uint32_t)raxSize(cache->entries));
+    raxIterator iter;
+    raxStart(&iter, cache->entries);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        struct t_negative_cache_entry *entry = (struct t_negative_cache_entry *)iter.data;
+        mpack_build_map(&writer);
+        mpack_write_cstr(&writer, "key");
+        mpack_write_str(&writer, (char *)iter.key, (uint32_t)iter.key_len);
+        mpack_write_kv(&writer, "file", (int64_t)entry->file_mtime);
+        mpack_write_kv(&writer, "dir", (int64_t)entry->dir_mtime);
+        mpack_complete_map(&writer);
+    }
+    raxStop(&iter);
+    mpack_finish_array(&writer);
+    mpack_complete_map(&writer);
+    pthread_mutex_unlock(&cache->mutex);
+    // finish writing
+    bool rc = mpack_writer_destroy(&writer) != mpack_ok
+        ? false
+        : true;
+
+    if (rc == false) {
+        rm_file(tmp_file);
+        MYMPD_LOG_ERROR(NULL, "An error occurred encoding the data");
+        FREE_SDS(tmp_file);
+        return false;
+    }
+    // rename tmp file
+    sds filepath = sdscatlen(sdsempty(), tmp_file, sdslen(tmp_file) - 7);
+    errno = 0;
+    if (rename(tmp_file, filepath) == -1) {
+        MYMPD_LOG_ERROR(NULL, "Rename file from \"%s\" to \"%s\" failed", tmp_file, filepath);
+        MYMPD_LOG_ERRNO(NULL, errno);
+        rm_file(tmp_file);
+        rc = false;
+    }
+    FREE_SDS(filepath);
+    FREE_SDS(tmp_file);
+    return rc;
+}
+
+/**
+ * Reads the negative cache from disc
+ * @param cache pointer to the negative cache
+ * @param workdir working directory
+ * @return true on success, else false
+ */
+bool negative_cache_read(struct t_negative_cache *cache, sds workdir) {
+    sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", workdir, DIR_WORK_TAGS, FILENAME_NEGATIVE_CACHE);
+    if (testfile_read(filepath) == false) {
+        FREE_SDS(filepath);
+        return false;
+    }
+    mpack_tree_t tree;
+    mpack_tree_init_filename(&tree, filepath, 0);
+    mpack_tree_set_error_handler(&tree, log_mpack_node_error);
+    mpack_tree_parse(&tree);
+    mpack_node_t root = mpack_tree_root(&tree);
+    pthread_mutex_lock(&cache->mutex);
+    mpack_node_t signature = mpack_node_map_cstr(root, "signature");
+    sdsclear(cache->signature);
+    cache->signature = sdscatlen(cache->signature, mpack_node_str(signature), mpack_node_strlen(signature));
+    mpack_node_t entries = mpack_node_map_cstr(root, "entries");
+    size_t len = mpack_node_array_length(entries);
+    for (size_t i = 0; i < len; i++) {
+        mpack_node_t entry = mpack_node_array_at(entries, i);
+        mpack_node_t key = mpack_node_map_cstr(entry, "key");
+        if (mpack_node_strlen(key) == 0 ||
+            insert_entry(cache, mpack_node_str(key), mpack_node_strlen(key),
+                (time_t)mpack_node_i64(mpack_node_map_cstr(entry, "file")),
+                (time_t)mpack_node_i64(mpack_node_map_cstr(entry, "dir"))) == false)
+        {
+            break;
+        }
+    }
+    // clean up and check for errors
+    bool rc = mpack_tree_destroy(&tree) != mpack_ok
+        ? false
+        : true;
+    if (rc == false) {
+        free_entries(cache->entries);
+        cache->entries = raxNew();
+        sdsclear(cache->signature);
+    }
+    MYMPD_LOG_INFO(NULL, "Read %llu negative cache entries from disc", (unsigned long long)raxSize(cache->entries));
+    pthread_mutex_unlock(&cache->mutex);
+    // the negative cache is saved again on shutdown
+    rm_file(filepath);
+    FREE_SDS(filepath);
+    return rc;
+}
+
+// private functions
+
+/**
+ * Creates the cache key
+ * @param key already allocated sds string to append the key
+ * @param uri song uri
+ * @param offset embedded image offset
+ * @param thumbnail true if a thumbnail was requested
+ * @return pointer to key
+ */
+static sds get_key(sds key, sds uri, int offset, bool thumbnail) {
+    return sdscatfmt(key, "%i:%i:%S", (int)thumbnail, offset, uri);
+}
+
+/**
+ * Gets the modification times of the media file and its directory
+ * @param media_file absolute path of the song
+ * @param entry struct to populate
+ */
+static void get_mtimes(const char *media_file, struct t_negative_cache_entry *entry) {
+    entry->file_mtime = get_mtime(media_file);
+    sds dir = sds_dirname(sdsnew(media_file));
+    entry->dir_mtime = get_mtime(dir);
+    FREE_SDS(dir);
+}
+
+/**
+ * Inserts or updates an entry, the caller must hold the mutex
+ * @param cache pointer to the negative cache
+ * @param key the key
+ * @param key_len length of the key
+ * @param file_mtime modification time of the media file
+ * @param dir_mtime modification time of the directory of the media file
+ * @return true on success, false if the cache is full
+ */
+static bool insert_entry(struct t_negative_cache *cache, const char *key, size_t key_len,
+        time_t file_mtime, time_t dir_mtime)
+{
+    void *data = raxFind(cache->entries, (unsigned char *)key, key_len);
+    if (data != raxNotFound) {
+        struct t_negative_cache_entry *entry = (struct t_negative_cache_entry *)data;
+        entry->file_mtime = file_mtime;
+        entry->dir_mtime = dir_mtime;
+        return true;
+    }
+    if (raxSize(cache->entries) >= NEGATIVE_CACHE_MAX) {
+        MYMPD_LOG_WARN(NULL, "Negative cache is full");
+        return false;
+    }
+    struct t_negative_cache_entry *entry = malloc_assert(sizeof(struct t_negative_cache_entry));
+    entry->file_mtime = file_mtime;
+    entry->dir_mtime = dir_mtime;
+    raxInsert(cache->entries, (unsigned char *)key, key_len, entry, NULL);
+    return true;
+}
+
+/**
+ * Frees the entries and the rax tree
+ * @param entries rax tree to free
+ */
+static void free_entries(rax *entries) {
+    if (entries != NULL) {
+        raxFreeWithCallback(entries, free);
+    }
+}
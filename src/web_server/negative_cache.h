@@ -0,0 +1,35 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_WEB_SERVER_NEGATIVE_CACHE_H
+#define MYMPD_WEB_SERVER_NEGATIVE_CACHE_H
+
+#include "dist/rax/rax.h"
+#include "dist/sds/sds.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * Songs without a local coverimage, the entries are valid as long as
+ * the song and its directory are unchanged
+ */
+struct t_negative_cache {
+    rax *entries;            //!< size, offset and uri -> struct t_negative_cache_entry
+    sds signature;           //!< settings the entries depend on
+    pthread_mutex_t mutex;   //!< shared by the web server and the image worker threads
+};
+
+void negative_cache_init(struct t_negative_cache *cache);
+void negative_cache_clear(struct t_negative_cache *cache);
+void negative_cache_set_signature(struct t_negative_cache *cache, sds signature);
+bool negative_cache_add(struct t_negative_cache *cache, sds uri, int offset, bool thumbnail, const char *media_file);
+bool negative_cache_check(struct t_negative_cache *cache, sds uri, int offset, bool thumbnail, const char *media_file);
+bool negative_cache_save(struct t_negative_cache *cache, sds workdir);
+bool negative_cache_read(struct t_negative_cache *cache, sds workdir);
+
+#endif
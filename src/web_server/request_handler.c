@@ -78,7 +78,7 @@ bool request_handler_api(struct mg_connection *nc, sds body, struct mg_str *auth
             auth_header->len == 20)
         {
             session = sdscatlen(session, auth_header->buf, auth_header->len);
-            rc = webserver_session_validate(&mg_user_data->session_list, session);
+            rc = webserver_session_validate(&mg_user_data->sessions, session);
         }
         else {
             MYMPD_LOG_ERROR(frontend_nc_data->partition, "No valid Authorization header found");
@@ -280,7 +280,7 @@ void request_handler_proxy_covercache(struct mg_connection *nc, struct mg_http_m
         //decode uri
         uri_decoded = sds_urldecode(uri_decoded, query, sdslen(query), false);
         struct t_mg_user_data *mg_user_data = (struct t_mg_user_data *)nc->mgr->userdata;
-        if (check_imagescache(nc, hm, mg_user_data, DIR_CACHE_COVER, uri_decoded, 0) == false) {
+        if (check_imagescache(nc, hm, mg_user_data, DIR_CACHE_COVER, uri_decoded, 0, false) == false) {
             create_backend_connection(nc, backend_nc, uri_decoded, forward_backend_to_frontend_covercache, false);
         }
     }
@@ -306,12 +306,15 @@ void request_handler_serverinfo(struct mg_connection *nc) {
             inet_ntop(AF_INET6, &(((struct sockaddr_in6*)&localip)->sin6_addr), addr_str, INET6_ADDRSTRLEN) :
             inet_ntop(AF_INET, &(((struct sockaddr_in*)&localip)->sin_addr), addr_str, INET6_ADDRSTRLEN);
         if (addr_str_ptr != NULL) {
-            response = tojson_char(response, "ip", addr_str_ptr, false);
+            response = tojson_char(response, "ip", addr_str_ptr, true);
         }
         else {
             MYMPD_LOG_ERROR(NULL, "Could not convert peer ip to string");
-            response = tojson_char_len(response, "ip", "", 0, false);
+            response = tojson_char_len(response, "ip", "", 0, true);
         }
+        struct t_mg_user_data *mg_user_data = (struct t_mg_user_data *)nc->mgr->userdata;
+        response = sdscat(response, "\"imageCache\":");
+        response = image_cache_status(response, &mg_user_data->image_cache);
         response = jsonrpc_end(response);
         webserver_send_data(nc, response, sdslen(response), EXTRA_HEADERS_JSON_CONTENT);
         FREE_SDS(response);
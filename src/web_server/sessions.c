@@ -7,16 +7,35 @@
 #include "compile_time.h"
 #include "src/web_server/sessions.h"
 
+#include "src/lib/filehandler.h"
 #include "src/lib/jsonrpc.h"
 #include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/mpack.h"
 #include "src/lib/pin.h"
 #include "src/lib/sds_extras.h"
 #include "src/lib/validate.h"
 #include "src/web_server/utility.h"
 
+#include <errno.h>
 #include <openssl/rand.h>
 #include <string.h>
-#include <time.h>
+
+/**
+ * Private definitions
+ */
+
+static struct t_session *session_add(struct t_sessions *sessions, const char *hash, size_t hash_len, time_t expires);
+static void session_delete(struct t_sessions *sessions, struct t_session *session);
+static void sessions_expire(struct t_sessions *sessions, time_t now);
+static bool heap_less(struct t_sessions *sessions, size_t a, size_t b);
+static void heap_swap(struct t_sessions *sessions, size_t a, size_t b);
+static void heap_sift_up(struct t_sessions *sessions, size_t idx);
+static void heap_sift_down(struct t_sessions *sessions, size_t idx);
+
+/**
+ * Public functions
+ */
 
 /**
  * Request handler for the session api
@@ -40,7 +59,7 @@ void webserver_session_api(struct mg_connection *nc, enum mympd_cmd_ids cmd_id,
             FREE_SDS(pin);
             sds response = sdsempty();
             if (is_valid == true) {
-                sds new_session = webserver_session_new(&mg_user_data->session_list);
+                sds new_session = webserver_session_new(&mg_user_data->sessions);
                 if (new_session != NULL) {
                     response = jsonrpc_respond_start(response, cmd_id, request_id);
                     response = tojson_sds(response, "session", new_session, false);
@@ -64,7 +83,7 @@ void webserver_session_api(struct mg_connection *nc, enum mympd_cmd_ids cmd_id,
             bool rc = false;
             sds response = sdsempty();
             if (sdslen(session) == 20) {
-                rc = webserver_session_remove(&mg_user_data->session_list, session);
+                rc = webserver_session_remove(&mg_user_data->sessions, session);
                 if (rc == true) {
                     response = jsonrpc_respond_message(response, cmd_id, request_id,
                         JSONRPC_FACILITY_SESSION, JSONRPC_SEVERITY_INFO, "Session removed");
@@ -94,12 +113,156 @@ void webserver_session_api(struct mg_connection *nc, enum mympd_cmd_ids cmd_id,
     }
 }
 
+/**
+ * Initializes the session store
+ * @param sessions pointer to the session store
+ */
+void webserver_sessions_init(struct t_sessions *sessions) {
+    sessions->index = raxNew();
+    sessions->heap = NULL;
+    sessions->len = 0;
+    sessions->capacity = 0;
+    sessions->usage = 0;
+}
+
+/**
+ * Frees all sessions
+ * @param sessions pointer to the session store
+ */
+void webserver_sessions_clear(struct t_sessions *sessions) {
+    for (size_t i = 0; i < sessions->len; i++) {
+        FREE_SDS(sessions->heap[i]->hash);
+        FREE_PTR(sessions->heap[i]);
+    }
+    FREE_PTR(sessions->heap);
+    if (sessions->index != NULL) {
+        raxFree(sessions->index);
+        sessions->index = NULL;
+    }
+    sessions->len = 0;
+    sessions->capacity = 0;
+}
+
+/**
+ * Saves the valid sessions to disc.
+ * The sessions are bound to the pin hash, they are discarded if the pin changes.
+ * @param sessions pointer to the session store
+ * @param workdir myMPD working directory
+ * @param pin_hash hash of the pin
+ * @return true on success, else false
+ */
+bool webserver_sessions_save(struct t_sessions *sessions, sds workdir, sds pin_hash) {
+    sessions_expire(sessions, time(NULL));
+    MYMPD_LOG_INFO(NULL, "Saving %lu sessions to disc", (unsigned long)sessions->len);
+    mpack_writer_t writer;
+    sds tmp_file = sdscatfmt(sdsempty(), "%S/%s/%s.XXXXXX", workdir, DIR_WORK_STATE, FILENAME_SESSIONS);
+    FILE *fp = open_tmp_file(tmp_file);
+    if (fp == NULL) {
+        FREE_SDS(tmp_file);
+        return false;
+    }
+    // init mpack
+    mpack_writer_init_stdfile(&writer, fp, true);
+    mpack_writer_set_error_handler(&writer, log_mpack_write_error);
+
+    mpack_build_map(&writer);
+    mpack_write_kv(&writer, "pin_hash", pin_hash);
+    mpack_write_cstr(&writer, "sessions");
+    mpack_start_array(&writer, (uint32_t)sessions->len);
+    for (size_t i = 0; i < sessions->len; i++) {
+        mpack_build_map(&writer);
+        mpack_write_kv(&writer, "session", sessions->heap[i]->hash);
+        mpack_write_kv(&writer, "expires", (int64_t)sessions->heap[i]->expires);
+        mpack_complete_map(&writer);
+    }
+    mpack_finish_array(&writer);
+    mpack_complete_map(&writer);
+    // finish writing
+    bool rc = mpack_writer_destroy(&writer) != mpack_ok
+        ? false
+        : true;
+
+    if (rc == false) {
+        rm_file(tmp_file);
+        MYMPD_LOG_ERROR(NULL, "An error occurred encoding the data");
+        FREE_SDS(tmp_file);
+        return false;
+    }
+    // rename tmp file
+    sds filepath = sdscatlen(sdsempty(), tmp_file, sdslen(tmp_file) - 7);
+    errno = 0;
+    if (rename(tmp_file, filepath) == -1) {
+        MYMPD_LOG_ERROR(NULL, "Rename file from \"%s\" to \"%s\" failed", tmp_file, filepath);
+        MYMPD_LOG_ERRNO(NULL, errno);
+        rm_file(tmp_file);
+        rc = false;
+    }
+    FREE_SDS(filepath);
+    FREE_SDS(tmp_file);
+    return rc;
+}
+
+/**
+ * Reads the saved sessions from disc and removes the file.
+ * The sessions are discarded if they were saved with another pin hash.
+ * @param sessions pointer to the session store
+ * @param workdir myMPD working directory
+ * @param pin_hash hash of the pin
+ * @return true on success, else false
+ */
+bool webserver_sessions_read(struct t_sessions *sessions, sds workdir, sds pin_hash) {
+    sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", workdir, DIR_WORK_STATE, FILENAME_SESSIONS);
+    if (testfile_read(filepath) == false) {
+        FREE_SDS(filepath);
+        return false;
+    }
+    time_t now = time(NULL);
+    mpack_tree_t tree;
+    mpack_tree_init_filename(&tree, filepath, 0);
+    mpack_tree_set_error_handler(&tree, log_mpack_node_error);
+    mpack_tree_parse(&tree);
+    mpack_node_t root = mpack_tree_root(&tree);
+    mpack_node_t saved_pin_hash = mpack_node_map_cstr(root, "pin_hash");
+    if (mpack_tree_error(&tree) != mpack_ok ||
+        mpack_node_strlen(saved_pin_hash) != sdslen(pin_hash) ||
+        memcmp(mpack_node_str(saved_pin_hash), pin_hash, sdslen(pin_hash)) != 0)
+    {
+        MYMPD_LOG_NOTICE(NULL, "Saved sessions do not match the pin, discarding them");
+        mpack_tree_destroy(&tree);
+        rm_file(filepath);
+        FREE_SDS(filepath);
+        return false;
+    }
+    mpack_node_t list = mpack_node_map_cstr(root, "sessions");
+    size_t len = mpack_node_array_length(list);
+    for (size_t i = 0; i < len; i++) {
+        mpack_node_t entry = mpack_node_array_at(list, i);
+        time_t expires = (time_t)mpack_node_i64(mpack_node_map_cstr(entry, "expires"));
+        mpack_node_t hash = mpack_node_map_cstr(entry, "session");
+        if (mpack_node_strlen(hash) == 20 &&
+            expires > now &&
+            sessions->len < HTTP_SESSIONS_MAX)
+        {
+            session_add(sessions, mpack_node_str(hash), mpack_node_strlen(hash), expires);
+        }
+    }
+    // clean up and check for errors
+    bool rc = mpack_tree_destroy(&tree) != mpack_ok
+        ? false
+        : true;
+    MYMPD_LOG_INFO(NULL, "Read %lu sessions from disc", (unsigned long)sessions->len);
+    // sessions are saved again on shutdown
+    rm_file(filepath);
+    FREE_SDS(filepath);
+    return rc;
+}
+
 /**
  * Creates a new session
- * @param session_list the session list
+ * @param sessions pointer to the session store
  * @return newly allocated sds string with the session hash or NULL on error
  */
-sds webserver_session_new(struct t_list *session_list) {
+sds webserver_session_new(struct t_sessions *sessions) {
     unsigned char buf[10];
     if (RAND_bytes((unsigned char *)&buf, sizeof(buf)) != 1) {
         return NULL;
@@ -108,74 +271,195 @@ sds webserver_session_new(struct t_list *session_list) {
     for (int i = 0; i < 10; i++) {
         session = sdscatprintf(session, "%02x", buf[i]);
     }
+    time_t now = time(NULL);
     //timeout old sessions
-    webserver_session_validate(session_list, NULL);
-    //add new session with 30 min timeout
-    list_push(session_list, session, (time(NULL) + HTTP_SESSION_TIMEOUT), NULL, NULL);
-    MYMPD_LOG_DEBUG(NULL, "Created session %s", session);
-    //limit sessions to 10
-    if (session_list->length > HTTP_SESSIONS_MAX) {
-        list_remove_node(session_list, 0);
+    sessions_expire(sessions, now);
+    //limit sessions, the session that expires first is the least recently used one
+    if (sessions->len >= HTTP_SESSIONS_MAX) {
         MYMPD_LOG_WARN(NULL, "To many sessions, discarding oldest session");
+        session_delete(sessions, sessions->heap[0]);
     }
+    if (session_add(sessions, session, sdslen(session), now + HTTP_SESSION_TIMEOUT) == NULL) {
+        FREE_SDS(session);
+        return NULL;
+    }
+    MYMPD_LOG_DEBUG(NULL, "Created session %s", session);
     return session;
 }
 
 /**
- * Validates a session
- * @param session_list the session list 
+ * Validates and extends a session
+ * @param sessions pointer to the session store
  * @param session session hash to validate
  * @return true on success, else false
  */
-bool webserver_session_validate(struct t_list *session_list, const char *session) {
+bool webserver_session_validate(struct t_sessions *sessions, const char *session) {
     time_t now = time(NULL);
-    struct t_list_node *current = session_list->head;
-    unsigned i = 0;
-    while (current != NULL) {
-        if (current->value_i < now) {
-            MYMPD_LOG_DEBUG(NULL, "Session %s timed out", current->key);
-            struct t_list_node *next = current->next;
-            list_remove_node(session_list, i);
-            current = next;
-        }
-        else {
-            //validate session
-            if (session != NULL &&
-                strcmp(current->key, session) == 0)
-            {
-                MYMPD_LOG_DEBUG(NULL, "Extending session \"%s\"", session);
-                current->value_i = time(NULL) + 1800;
-                return true;
-            }
-            //skip to next entrie
-            i++;
-            current = current->next;
-        }
-    }
-    if (session != NULL) {
+    sessions_expire(sessions, now);
+    void *data = raxFind(sessions->index, (unsigned char *)session, strlen(session));
+    if (data == raxNotFound) {
         MYMPD_LOG_WARN(NULL, "Session \"%s\" not found", session);
+        return false;
     }
-    return false;
+    struct t_session *entry = (struct t_session *)data;
+    MYMPD_LOG_DEBUG(NULL, "Extending session \"%s\"", session);
+    entry->expires = now + HTTP_SESSION_TIMEOUT;
+    entry->used = ++sessions->usage;
+    heap_sift_down(sessions, entry->heap_idx);
+    return true;
 }
 
 /**
- * 
- * @param session_list the session list
+ * Removes a session
+ * @param sessions pointer to the session store
  * @param session session hash to remove
  * @return true on success, else false
  */
-bool webserver_session_remove(struct t_list *session_list, const char *session) {
-    struct t_list_node *current = session_list->head;
-    unsigned i = 0;
-    while (current != NULL) {
-        if (strcmp(current->key, session) == 0) {
-            MYMPD_LOG_DEBUG(NULL, "Session %s removed", current->key);
-            list_remove_node(session_list, i);
-            return true;
+bool webserver_session_remove(struct t_sessions *sessions, const char *session) {
+    void *data = raxFind(sessions->index, (unsigned char *)session, strlen(session));
+    if (data == raxNotFound) {
+        MYMPD_LOG_DEBUG(NULL, "Session %s not found", session);
+        return false;
+    }
+    MYMPD_LOG_DEBUG(NULL, "Session %s removed", session);
+    session_delete(sessions, (struct t_session *)data);
+    return true;
+}
+
+/**
+ * Private functions
+ */
+
+/**
+ * Adds a session to the index and the expiry heap
+ * @param sessions pointer to the session store
+ * @param hash session hash
+ * @param hash_len length of the session hash
+ * @param expires expiry timestamp
+ * @return pointer to the new session or NULL if the session already exists
+ */
+static struct t_session *session_add(struct t_sessions *sessions, const char *hash, size_t hash_len, time_t expires) {
+    struct t_session *entry = malloc_assert(sizeof(struct t_session));
+    if (raxTryInsert(sessions->index, (unsigned char *)hash, hash_len, entry, NULL) == 0) {
+        FREE_PTR(entry);
+        return NULL;
+    }
+    if (sessions->len == sessions->capacity) {
+        sessions->capacity = sessions->capacity == 0
+            ? 16
+            : sessions->capacity * 2;
+        sessions->heap = realloc_assert(sessions->heap, sessions->capacity * sizeof(struct t_session *));
+    }
+    entry->hash = sdsnewlen(hash, hash_len);
+    entry->expires = expires;
+    entry->used = ++sessions->usage;
+    entry->heap_idx = sessions->len;
+    sessions->heap[sessions->len] = entry;
+    sessions->len++;
+    heap_sift_up(sessions, entry->heap_idx);
+    return entry;
+}
+
+/**
+ * Removes a session from the index and the expiry heap and frees it
+ * @param sessions pointer to the session store
+ * @param session session to remove
+ */
+static void session_delete(struct t_sessions *sessions, struct t_session *session) {
+    size_t idx = session->heap_idx;
+    sessions->len--;
+    if (idx != sessions->len) {
+        heap_swap(sessions, idx, sessions->len);
+        heap_sift_down(sessions, idx);
+        heap_sift_up(sessions, idx);
+    }
+    raxRemove(sessions->index, (unsigned char *)session->hash, sdslen(session->hash), NULL);
+    FREE_SDS(session->hash);
+    FREE_PTR(session);
+}
+
+/**
+ * Removes all expired sessions
+ * @param sessions pointer to the session store
+ * @param now current timestamp
+ */
+static void sessions_expire(struct t_sessions *sessions, time_t now) {
+    while (sessions->len > 0 &&
+        sessions->heap[0]->expires < now)
+    {
+        MYMPD_LOG_DEBUG(NULL, "Session %s timed out", sessions->heap[0]->hash);
+        session_delete(sessions, sessions->heap[0]);
+    }
+}
+
+/**
+ * Compares two heap entries by expiry and usage
+ * @param sessions pointer to the session store
+ * @param a first position
+ * @param b second position
+ * @return true if the entry at a expires before the entry at b
+ */
+static bool heap_less(struct t_sessions *sessions, size_t a, size_t b) {
+    if (sessions->heap[a]->expires != sessions->heap[b]->expires) {
+        return sessions->heap[a]->expires < sessions->heap[b]->expires;
+    }
+    return sessions->heap[a]->used < sessions->heap[b]->used;
+}
+
+/**
+ * Swaps two heap entries
+ * @param sessions pointer to the session store
+ * @param a first position
+ * @param b second position
+ */
+static void heap_swap(struct t_sessions *sessions, size_t a, size_t b) {
+    struct t_session *tmp = sessions->heap[a];
+    sessions->heap[a] = sessions->heap[b];
+    sessions->heap[b] = tmp;
+    sessions->heap[a]->heap_idx = a;
+    sessions->heap[b]->heap_idx = b;
+}
+
+/**
+ * Moves a heap entry up until the heap property is restored
+ * @param sessions pointer to the session store
+ * @param idx position of the entry
+ */
+static void heap_sift_up(struct t_sessions *sessions, size_t idx) {
+    while (idx > 0) {
+        size_t parent = (idx - 1) / 2;
+        if (heap_less(sessions, idx, parent) == false) {
+            break;
+        }
+        heap_swap(sessions, parent, idx);
+        idx = parent;
+    }
+}
+
+/**
+ * Moves a heap entry down until the heap property is restored
+ * @param sessions pointer to the session store
+ * @param idx position of the entry
+ */
+static void heap_sift_down(struct t_sessions *sessions, size_t idx) {
+    while (true) {
+        size_t smallest = idx;
+        size_t left = 2 * idx + 1;
+        size_t right = left + 1;
+        if (left < sessions->len &&
+            heap_less(sessions, left, smallest) == true)
+        {
+            smallest = left;
+        }
+        if (right < sessions->len &&
+            heap_less(sessions, right, smallest) == true)
+        {
+            smallest = right;
+        }
+        if (smallest == idx) {
+            break;
         }
-        current = current->next;
-        i++;
+        heap_swap(sessions, idx, smallest);
+        idx = smallest;
     }
-    MYMPD_LOG_DEBUG(NULL, "Session %s not found", session);
-    return false;
 }
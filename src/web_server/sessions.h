@@ -8,17 +8,45 @@
 #define MYMPD_WEB_SERVER_SESSIONS_H
 
 #include "dist/mongoose/mongoose.h"
+#include "dist/rax/rax.h"
 #include "dist/sds/sds.h"
 #include "src/lib/api.h"
-#include "src/lib/list.h"
-#include "src/web_server/utility.h"
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+struct t_mg_user_data;
+
+/**
+ * A myMPD session (pin protection mode)
+ */
+struct t_session {
+    sds hash;         //!< session hash
+    time_t expires;   //!< expiry timestamp
+    uint64_t used;    //!< usage counter, orders sessions with the same expiry
+    size_t heap_idx;  //!< position in the expiry heap
+};
+
+/**
+ * Session store: sessions are indexed by hash and ordered by expiry in a min-heap
+ */
+struct t_sessions {
+    rax *index;               //!< session hash -> struct t_session
+    struct t_session **heap;  //!< min-heap ordered by expires
+    size_t len;               //!< number of sessions
+    size_t capacity;          //!< allocated heap slots
+    uint64_t usage;           //!< global usage counter
+};
 
 void webserver_session_api(struct mg_connection *nc, enum mympd_cmd_ids cmd_id, sds body, unsigned request_id,
         sds session, struct t_mg_user_data *mg_user_data);
-sds webserver_session_new(struct t_list *session_list);
-bool webserver_session_validate(struct t_list *session_list, const char *check_session);
-bool webserver_session_remove(struct t_list *session_list, const char *session);
+void webserver_sessions_init(struct t_sessions *sessions);
+void webserver_sessions_clear(struct t_sessions *sessions);
+bool webserver_sessions_save(struct t_sessions *sessions, sds workdir, sds pin_hash);
+bool webserver_sessions_read(struct t_sessions *sessions, sds workdir, sds pin_hash);
+sds webserver_session_new(struct t_sessions *sessions);
+bool webserver_session_validate(struct t_sessions *sessions, const char *session);
+bool webserver_session_remove(struct t_sessions *sessions, const char *session);
 
 #endif
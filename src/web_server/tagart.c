@@ -45,7 +45,7 @@ bool request_handler_tagart(struct mg_connection *nc, struct mg_http_message *hm
     MYMPD_LOG_DEBUG(NULL, "Handle tagart for \"%s\": \"%s\"", tag, value);
 
     //check thumbs cache and serve image from it if found
-    if (check_imagescache(nc, hm, mg_user_data, DIR_CACHE_THUMBS, value, 0) == true) {
+    if (check_imagescache(nc, hm, mg_user_data, DIR_CACHE_THUMBS, value, 0, false) == true) {
         FREE_SDS(tag);
         FREE_SDS(value);
         return true;
@@ -7,6 +7,7 @@
 #include "compile_time.h"
 #include "src/web_server/utility.h"
 
+#include "src/lib/cache_disk.h"
 #include "src/lib/cache_disk_images.h"
 #include "src/lib/config_def.h"
 #include "src/lib/filehandler.h"
@@ -16,11 +17,29 @@
 #include "src/lib/sds_extras.h"
 #include "src/lib/utility.h"
 
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
 #ifdef MYMPD_EMBEDDED_ASSETS
     //embedded files for release build
     #include "embedded_files.c"
 #endif
 
+/**
+ * Private definitions
+ */
+
+static void send_image_cache_entry(struct mg_connection *nc, struct mg_http_message *hm,
+        struct t_image_cache_entry *entry, const char *extra_headers);
+static sds get_file_etag(sds etag, const char *filepath, size_t size);
+static struct mg_str str_trim(struct mg_str s);
+static bool etag_matches(struct mg_str *header, const char *etag);
+#ifdef MYMPD_EMBEDDED_ASSETS
+    static int embedded_file_cmp(const void *key, const void *member);
+    static bool accepts_encoding(struct mg_str *header, const char *encoding);
+#endif
+
 /**
  * Public functions
  */
@@ -98,7 +117,10 @@ void *mg_user_data_free(struct t_mg_user_data *mg_user_data) {
     sdsfreesplitres(mg_user_data->coverimage_names, mg_user_data->coverimage_names_len);
     sdsfreesplitres(mg_user_data->thumbnail_names, mg_user_data->thumbnail_names_len);
     list_clear(&mg_user_data->stream_uris);
-    list_clear(&mg_user_data->session_list);
+    webserver_sessions_clear(&mg_user_data->sessions);
+    websocket_subscribers_clear(&mg_user_data->ws_subscribers);
+    image_cache_clear(&mg_user_data->image_cache);
+    negative_cache_clear(&mg_user_data->negative_cache);
     FREE_SDS(mg_user_data->placeholder_booklet);
     FREE_SDS(mg_user_data->placeholder_mympd);
     FREE_SDS(mg_user_data->placeholder_na);
@@ -120,20 +142,48 @@ void *mg_user_data_free(struct t_mg_user_data *mg_user_data) {
  * @param type cache type: cover or thumbs
  * @param uri_decoded image uri
  * @param offset embedded image offset
+ * @param thumbnail true to serve the downscaled version of the image
  * @return true if an image is served,
  *         false if no image was found in cache
  */
 bool check_imagescache(struct mg_connection *nc, struct mg_http_message *hm,
-        struct t_mg_user_data *mg_user_data, const char *type, sds uri_decoded, int offset)
+        struct t_mg_user_data *mg_user_data, const char *type, sds uri_decoded, int offset, bool thumbnail)
 {
-    sds imagescachefile = cache_disk_images_get_basename(mg_user_data->config->cachedir, type, uri_decoded, offset);
+    const char *extra_headers = thumbnail == true
+        ? EXTRA_HEADERS_THUMBNAIL
+        : EXTRA_HEADERS_IMAGE;
+    struct t_image_cache *image_cache = &mg_user_data->image_cache;
+    image_cache_sync(image_cache, cache_disk_get_generation());
+    struct t_image_cache_entry *entry = image_cache_get(image_cache, type, uri_decoded, offset, thumbnail);
+    if (entry != NULL) {
+        MYMPD_LOG_DEBUG(NULL, "Serving %s from memory (%s)", entry->key, entry->mime_type);
+        send_image_cache_entry(nc, hm, entry, extra_headers);
+        return true;
+    }
+    sds imagescachefile = cache_disk_images_get_basename(mg_user_data->config->cachedir, type, uri_decoded, offset, thumbnail);
     imagescachefile = webserver_find_image_file(imagescachefile);
     if (sdslen(imagescachefile) > 0) {
         const char *mime_type = get_mime_type_by_ext(imagescachefile);
+        size_t entry_max = image_cache_entry_max(image_cache);
+        if (entry_max > 0) {
+            //keep the image in memory for the next requests
+            int nread = 0;
+            sds data = sds_getfile_binary(sdsempty(), imagescachefile, entry_max, &nread);
+            if (nread > 0) {
+                MYMPD_LOG_DEBUG(NULL, "Serving file %s (%s)", imagescachefile, mime_type);
+                sds etag = get_file_etag(sdsempty(), imagescachefile, sdslen(data));
+                entry = image_cache_put(image_cache, type, uri_decoded, offset, thumbnail, data, mime_type, etag);
+                send_image_cache_entry(nc, hm, entry, extra_headers);
+                FREE_SDS(etag);
+                FREE_SDS(imagescachefile);
+                return true;
+            }
+            FREE_SDS(data);
+        }
         MYMPD_LOG_DEBUG(NULL, "Serving file %s (%s)", imagescachefile, mime_type);
         static struct mg_http_serve_opts s_http_server_opts;
         s_http_server_opts.root_dir = mg_user_data->browse_directory;
-        s_http_server_opts.extra_headers = EXTRA_HEADERS_IMAGE;
+        s_http_server_opts.extra_headers = extra_headers;
         s_http_server_opts.mime_types = EXTRA_MIME_TYPES;
         mg_http_serve_file(nc, hm, imagescachefile, &s_http_server_opts);
         webserver_handle_connection_close(nc);
@@ -251,6 +301,47 @@ void webserver_send_data(struct mg_connection *nc, const char *data, size_t len,
     webserver_handle_connection_close(nc);
 }
 
+/**
+ * Sends a part of a streamed json response with chunked transfer encoding.
+ * The header is sent with the first part.
+ * @param nc mongoose connection
+ * @param data data to send
+ * @param len length of the data to send
+ */
+void webserver_send_json_chunk(struct mg_connection *nc, const char *data, size_t len) {
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+    if (frontend_nc_data->chunked == false) {
+        mg_printf(nc, "HTTP/1.1 200 OK\r\n"
+            EXTRA_HEADERS_JSON_CONTENT
+            "Transfer-Encoding: chunked\r\n\r\n");
+        frontend_nc_data->chunked = true;
+    }
+    MYMPD_LOG_DEBUG(NULL, "Sending chunk of %lu bytes to %lu", (unsigned long)len, nc->id);
+    mg_http_write_chunk(nc, data, len);
+}
+
+/**
+ * Sends the last part of a streamed json response.
+ * An empty last part means the response was aborted, the connection is closed
+ * without finishing the chunked transfer to signal the error to the client.
+ * @param nc mongoose connection
+ * @param data data to send
+ * @param len length of the data to send
+ */
+void webserver_send_json_chunk_end(struct mg_connection *nc, const char *data, size_t len) {
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+    frontend_nc_data->chunked = false;
+    if (len == 0) {
+        MYMPD_LOG_DEBUG(NULL, "Closing connection %lu with aborted response", nc->id);
+        nc->is_draining = 1;
+        nc->is_resp = 0;
+        return;
+    }
+    mg_http_write_chunk(nc, data, len);
+    mg_http_write_chunk(nc, "", 0);
+    webserver_handle_connection_close(nc);
+}
+
 /**
  * Sends a raw reply
  * @param nc mongoose connection
@@ -381,94 +472,145 @@ void webserver_serve_placeholder_image(struct mg_connection *nc, enum placeholde
 }
 
 #ifdef MYMPD_EMBEDDED_ASSETS
+/**
+ * Struct holding a precompressed variant of an embedded file
+ */
+struct embedded_variant {
+    const char *encoding;           //!< content coding
+    const unsigned char *data;      //!< compressed data
+    const unsigned int *size;       //!< size of the data
+    const char *etag;               //!< quoted content hash of the data
+};
+
 /**
  * Struct holding embedded file information
  */
 struct embedded_file {
-    const char *uri;
-    const char *mimetype;
-    bool compressed;
-    bool cache;
-    const unsigned char *data;
-    const unsigned size;
+    const char *uri;                            //!< uri of the asset
+    const char *mimetype;                       //!< mime type of the asset
+    bool compressed;                            //!< data is gzip compressed
+    bool cache;                                 //!< allow caching without revalidation
+    const unsigned char *data;                  //!< data of the asset
+    const unsigned int *size;                   //!< size of the data
+    const char *etag;                           //!< quoted content hash of the data
+    const struct embedded_variant *variants;    //!< alternative encodings in order of preference or NULL
+};
+
+/**
+ * Precompressed variants of the largest assets
+ */
+static const struct embedded_variant index_html_variants[] = {
+    #ifdef MYMPD_EMBEDDED_BROTLI
+        {"br", index_html_br_data, &index_html_br_size, ETAG_index_html_br},
+    #endif
+    #ifdef MYMPD_EMBEDDED_ZSTD
+        {"zstd", index_html_zst_data, &index_html_zst_size, ETAG_index_html_zst},
+    #endif
+    {NULL, NULL, NULL, NULL}
+};
+
+static const struct embedded_variant combined_css_variants[] = {
+    #ifdef MYMPD_EMBEDDED_BROTLI
+        {"br", combined_css_br_data, &combined_css_br_size, ETAG_combined_css_br},
+    #endif
+    #ifdef MYMPD_EMBEDDED_ZSTD
+        {"zstd", combined_css_zst_data, &combined_css_zst_size, ETAG_combined_css_zst},
+    #endif
+    {NULL, NULL, NULL, NULL}
+};
+
+static const struct embedded_variant combined_js_variants[] = {
+    #ifdef MYMPD_EMBEDDED_BROTLI
+        {"br", combined_js_br_data, &combined_js_br_size, ETAG_combined_js_br},
+    #endif
+    #ifdef MYMPD_EMBEDDED_ZSTD
+        {"zstd", combined_js_zst_data, &combined_js_zst_size, ETAG_combined_js_zst},
+    #endif
+    {NULL, NULL, NULL, NULL}
+};
+
+/**
+ * Embedded files, this list must be sorted by uri for the binary search
+ */
+static const struct embedded_file embedded_files[] = {
+    {"/", "text/html; charset=utf-8", true, false, index_html_data, &index_html_size, ETAG_index_html_gz, index_html_variants},
+    {"/assets/MaterialIcons-Regular.woff2", "font/woff2", false, true, MaterialIcons_Regular_woff2_data, &MaterialIcons_Regular_woff2_size, ETAG_MaterialIcons_Regular_woff2, NULL},
+    {"/assets/appicon-192.png", "image/png", false, true, appicon_192_png_data, &appicon_192_png_size, ETAG_appicon_192_png, NULL},
+    {"/assets/appicon-512.png", "image/png", false, true, appicon_512_png_data, &appicon_512_png_size, ETAG_appicon_512_png, NULL},
+    {"/assets/coverimage-booklet.svg", "image/svg+xml", true, true, coverimage_booklet_svg_data, &coverimage_booklet_svg_size, ETAG_coverimage_booklet_svg_gz, NULL},
+    {"/assets/coverimage-folder.svg", "image/svg+xml", true, true, coverimage_folder_svg_data, &coverimage_folder_svg_size, ETAG_coverimage_folder_svg_gz, NULL},
+    {"/assets/coverimage-mympd.svg", "image/svg+xml", true, true, coverimage_mympd_svg_data, &coverimage_mympd_svg_size, ETAG_coverimage_mympd_svg_gz, NULL},
+    {"/assets/coverimage-notavailable.svg", "image/svg+xml", true, true, coverimage_notavailable_svg_data, &coverimage_notavailable_svg_size, ETAG_coverimage_notavailable_svg_gz, NULL},
+    {"/assets/coverimage-playlist.svg", "image/svg+xml", true, true, coverimage_playlist_svg_data, &coverimage_playlist_svg_size, ETAG_coverimage_playlist_svg_gz, NULL},
+    {"/assets/coverimage-smartpls.svg", "image/svg+xml", true, true, coverimage_smartpls_svg_data, &coverimage_smartpls_svg_size, ETAG_coverimage_smartpls_svg_gz, NULL},
+    {"/assets/coverimage-stream.svg", "image/svg+xml", true, true, coverimage_stream_svg_data, &coverimage_stream_svg_size, ETAG_coverimage_stream_svg_gz, NULL},
+    #ifdef I18N_bg_BG
+        {"/assets/i18n/bg-BG.json", "application/json", true, true, i18n_bg_BG_json_data, &i18n_bg_BG_json_size, ETAG_i18n_bg_BG_json_gz, NULL},
+    #endif
+    #ifdef I18N_de_DE
+        {"/assets/i18n/de-DE.json", "application/json", true, true, i18n_de_DE_json_data, &i18n_de_DE_json_size, ETAG_i18n_de_DE_json_gz, NULL},
+    #endif
+    #ifdef I18N_en_US
+        {"/assets/i18n/en-US.json", "application/json", true, true, i18n_en_US_json_data, &i18n_en_US_json_size, ETAG_i18n_en_US_json_gz, NULL},
+    #endif
+    #ifdef I18N_es_AR
+        {"/assets/i18n/es-AR.json", "application/json", true, true, i18n_es_AR_json_data, &i18n_es_AR_json_size, ETAG_i18n_es_AR_json_gz, NULL},
+    #endif
+    #ifdef I18N_es_ES
+        {"/assets/i18n/es-ES.json", "application/json", true, true, i18n_es_ES_json_data, &i18n_es_ES_json_size, ETAG_i18n_es_ES_json_gz, NULL},
+    #endif
+    #ifdef I18N_es_VE
+        {"/assets/i18n/es-VE.json", "application/json", true, true, i18n_es_VE_json_data, &i18n_es_VE_json_size, ETAG_i18n_es_VE_json_gz, NULL},
+    #endif
+    #ifdef I18N_fi_FI
+        {"/assets/i18n/fi-FI.json", "application/json", true, true, i18n_fi_FI_json_data, &i18n_fi_FI_json_size, ETAG_i18n_fi_FI_json_gz, NULL},
+    #endif
+    #ifdef I18N_fr_FR
+        {"/assets/i18n/fr-FR.json", "application/json", true, true, i18n_fr_FR_json_data, &i18n_fr_FR_json_size, ETAG_i18n_fr_FR_json_gz, NULL},
+    #endif
+    #ifdef I18N_it_IT
+        {"/assets/i18n/it-IT.json", "application/json", true, true, i18n_it_IT_json_data, &i18n_it_IT_json_size, ETAG_i18n_it_IT_json_gz, NULL},
+    #endif
+    #ifdef I18N_ja_JP
+        {"/assets/i18n/ja-JP.json", "application/json", true, true, i18n_ja_JP_json_data, &i18n_ja_JP_json_size, ETAG_i18n_ja_JP_json_gz, NULL},
+    #endif
+    #ifdef I18N_ko_KR
+        {"/assets/i18n/ko-KR.json", "application/json", true, true, i18n_ko_KR_json_data, &i18n_ko_KR_json_size, ETAG_i18n_ko_KR_json_gz, NULL},
+    #endif
+    #ifdef I18N_nl_NL
+        {"/assets/i18n/nl-NL.json", "application/json", true, true, i18n_nl_NL_json_data, &i18n_nl_NL_json_size, ETAG_i18n_nl_NL_json_gz, NULL},
+    #endif
+    #ifdef I18N_pl_PL
+        {"/assets/i18n/pl-PL.json", "application/json", true, true, i18n_pl_PL_json_data, &i18n_pl_PL_json_size, ETAG_i18n_pl_PL_json_gz, NULL},
+    #endif
+    #ifdef I18N_ru_RU
+        {"/assets/i18n/ru-RU.json", "application/json", true, true, i18n_ru_RU_json_data, &i18n_ru_RU_json_size, ETAG_i18n_ru_RU_json_gz, NULL},
+    #endif
+    #ifdef I18N_zh_Hans
+        {"/assets/i18n/zh-Hans.json", "application/json", true, true, i18n_zh_Hans_json_data, &i18n_zh_Hans_json_size, ETAG_i18n_zh_Hans_json_gz, NULL},
+    #endif
+    #ifdef I18N_zh_Hant
+        {"/assets/i18n/zh-Hant.json", "application/json", true, true, i18n_zh_Hant_json_data, &i18n_zh_Hant_json_size, ETAG_i18n_zh_Hant_json_gz, NULL},
+    #endif
+    {"/assets/ligatures.json", "application/json", true, true, ligatures_json_data, &ligatures_json_size, ETAG_ligatures_json_gz, NULL},
+    {"/assets/mympd-background-dark.svg", "image/svg+xml", true, true, mympd_background_dark_svg_data, &mympd_background_dark_svg_size, ETAG_mympd_background_dark_svg_gz, NULL},
+    {"/assets/mympd-background-light.svg", "image/svg+xml", true, true, mympd_background_light_svg_data, &mympd_background_light_svg_size, ETAG_mympd_background_light_svg_gz, NULL},
+    {"/css/combined.css", "text/css; charset=utf-8", true, false, combined_css_data, &combined_css_size, ETAG_combined_css_gz, combined_css_variants},
+    {"/js/combined.js", "application/javascript; charset=utf-8", true, false, combined_js_data, &combined_js_size, ETAG_combined_js_gz, combined_js_variants},
+    {"/mympd.webmanifest", "application/manifest+json", true, false, mympd_webmanifest_data, &mympd_webmanifest_size, ETAG_mympd_webmanifest_gz, NULL},
+    {"/sw.js", "application/javascript; charset=utf-8", true, false, sw_js_data, &sw_js_size, ETAG_sw_js_gz, NULL}
 };
 
 /**
- * Serves the embedded files
+ * Serves the embedded files.
+ * The precompressed variants are selected by the Accept-Encoding header,
+ * requests with a matching If-None-Match header are answered with 304.
  * @param nc mongoose connection
+ * @param hm http message
  * @param uri uri to server
  * @return true on success, else false
  */
-bool webserver_serve_embedded_files(struct mg_connection *nc, sds uri) {
-    const struct embedded_file embedded_files[] = {
-        {"/", "text/html; charset=utf-8", true, false, index_html_data, index_html_size},
-        {"/css/combined.css", "text/css; charset=utf-8", true, false, combined_css_data, combined_css_size},
-        {"/js/combined.js", "application/javascript; charset=utf-8", true, false, combined_js_data, combined_js_size},
-        {"/sw.js", "application/javascript; charset=utf-8", true, false, sw_js_data, sw_js_size},
-        {"/mympd.webmanifest", "application/manifest+json", true, false, mympd_webmanifest_data, mympd_webmanifest_size},
-        {"/assets/coverimage-notavailable.svg", "image/svg+xml", true, true, coverimage_notavailable_svg_data, coverimage_notavailable_svg_size},
-        {"/assets/MaterialIcons-Regular.woff2", "font/woff2", false, true, MaterialIcons_Regular_woff2_data, MaterialIcons_Regular_woff2_size},
-        {"/assets/coverimage-stream.svg", "image/svg+xml", true, true, coverimage_stream_svg_data, coverimage_stream_svg_size},
-        {"/assets/coverimage-booklet.svg", "image/svg+xml", true, true, coverimage_booklet_svg_data, coverimage_booklet_svg_size},
-        {"/assets/coverimage-mympd.svg", "image/svg+xml", true, true, coverimage_mympd_svg_data, coverimage_mympd_svg_size},
-        {"/assets/coverimage-playlist.svg", "image/svg+xml", true, true, coverimage_playlist_svg_data, coverimage_playlist_svg_size},
-        {"/assets/coverimage-smartpls.svg", "image/svg+xml", true, true, coverimage_smartpls_svg_data, coverimage_smartpls_svg_size},
-        {"/assets/coverimage-folder.svg", "image/svg+xml", true, true, coverimage_folder_svg_data, coverimage_folder_svg_size},
-        {"/assets/mympd-background-dark.svg", "image/svg+xml", true, true, mympd_background_dark_svg_data, mympd_background_dark_svg_size},
-        {"/assets/mympd-background-light.svg", "image/svg+xml", true, true, mympd_background_light_svg_data, mympd_background_light_svg_size},
-        {"/assets/appicon-192.png", "image/png", false, true, appicon_192_png_data, appicon_192_png_size},
-        {"/assets/appicon-512.png", "image/png", false, true, appicon_512_png_data, appicon_512_png_size},
-        {"/assets/ligatures.json", "application/json", true, true, ligatures_json_data, ligatures_json_size},
-        #ifdef I18N_bg_BG
-            {"/assets/i18n/bg-BG.json", "application/json", true, true, i18n_bg_BG_json_data, i18n_bg_BG_json_size},
-        #endif
-        #ifdef I18N_de_DE
-            {"/assets/i18n/de-DE.json", "application/json", true, true, i18n_de_DE_json_data, i18n_de_DE_json_size},
-        #endif
-        #ifdef I18N_en_US
-        {"/assets/i18n/en-US.json", "application/json", true, true, i18n_en_US_json_data, i18n_en_US_json_size},
-        #endif
-        #ifdef I18N_es_AR
-        {"/assets/i18n/es-AR.json", "application/json", true, true, i18n_es_AR_json_data, i18n_es_AR_json_size},
-        #endif
-        #ifdef I18N_es_ES
-        {"/assets/i18n/es-ES.json", "application/json", true, true, i18n_es_ES_json_data, i18n_es_ES_json_size},
-        #endif
-        #ifdef I18N_es_VE
-        {"/assets/i18n/es-VE.json", "application/json", true, true, i18n_es_VE_json_data, i18n_es_VE_json_size},
-        #endif
-        #ifdef I18N_fi_FI
-        {"/assets/i18n/fi-FI.json", "application/json", true, true, i18n_fi_FI_json_data, i18n_fi_FI_json_size},
-        #endif
-        #ifdef I18N_fr_FR
-        {"/assets/i18n/fr-FR.json", "application/json", true, true, i18n_fr_FR_json_data, i18n_fr_FR_json_size},
-        #endif
-        #ifdef I18N_it_IT
-        {"/assets/i18n/it-IT.json", "application/json", true, true, i18n_it_IT_json_data, i18n_it_IT_json_size},
-        #endif
-        #ifdef I18N_ja_JP
-        {"/assets/i18n/ja-JP.json", "application/json", true, true, i18n_ja_JP_json_data, i18n_ja_JP_json_size},
-        #endif
-        #ifdef I18N_ko_KR
-        {"/assets/i18n/ko-KR.json", "application/json", true, true, i18n_ko_KR_json_data, i18n_ko_KR_json_size},
-        #endif
-        #ifdef I18N_nl_NL
-        {"/assets/i18n/nl-NL.json", "application/json", true, true, i18n_nl_NL_json_data, i18n_nl_NL_json_size},
-        #endif
-        #ifdef I18N_pl_PL
-        {"/assets/i18n/pl-PL.json", "application/json", true, true, i18n_pl_PL_json_data, i18n_pl_PL_json_size},
-        #endif
-        #ifdef I18N_ru_RU
-        {"/assets/i18n/ru-RU.json", "application/json", true, true, i18n_ru_RU_json_data, i18n_ru_RU_json_size},
-        #endif
-        #ifdef I18N_zh_Hans
-        {"/assets/i18n/zh-Hans.json", "application/json", true, true, i18n_zh_Hans_json_data, i18n_zh_Hans_json_size},
-        #endif
-        #ifdef I18N_zh_Hant
-        {"/assets/i18n/zh-Hant.json", "application/json", true, true, i18n_zh_Hant_json_data, i18n_zh_Hant_json_size},
-        #endif
-        {NULL, NULL, false, false, NULL, 0}
-    };
+bool webserver_serve_embedded_files(struct mg_connection *nc, struct mg_http_message *hm, sds uri) {
     //decode uri
     sds uri_decoded = sds_urldecode(sdsempty(), uri, sdslen(uri), false);
     if (sdslen(uri_decoded) == 0) {
@@ -477,36 +619,206 @@ bool webserver_serve_embedded_files(struct mg_connection *nc, sds uri) {
         return false;
     }
     //find fileinfo
-    const struct embedded_file *p = NULL;
-    for (p = embedded_files; p->uri != NULL; p++) {
-        if (strcmp(p->uri, uri_decoded) == 0){
-            break;
+    const struct embedded_file *p = bsearch(uri_decoded, embedded_files,
+        sizeof(embedded_files) / sizeof(embedded_files[0]), sizeof(embedded_files[0]), embedded_file_cmp);
+    if (p == NULL) {
+        sds errormsg = sdscatfmt(sdsempty(), "Embedded asset \"%S\" not found", uri_decoded);
+        webserver_send_error(nc, 404, errormsg);
+        FREE_SDS(errormsg);
+        FREE_SDS(uri_decoded);
+        return false;
+    }
+    FREE_SDS(uri_decoded);
+
+    //select the encoding
+    const unsigned char *data = p->data;
+    unsigned size = *p->size;
+    const char *etag = p->etag;
+    const char *encoding = p->compressed == true ? "gzip" : NULL;
+    bool vary = false;
+    if (p->variants != NULL &&
+        p->variants[0].encoding != NULL)
+    {
+        vary = true;
+        struct mg_str *accept_encoding = mg_http_get_header(hm, "Accept-Encoding");
+        for (const struct embedded_variant *v = p->variants; v->encoding != NULL; v++) {
+            if (accepts_encoding(accept_encoding, v->encoding) == true) {
+                data = v->data;
+                size = *v->size;
+                etag = v->etag;
+                encoding = v->encoding;
+                break;
+            }
         }
     }
+    sds headers = sdscatfmt(sdsempty(), "ETag: %s\r\n%s%s",
+        etag,
+        (p->cache == true ? EXTRA_HEADERS_CACHE : EXTRA_HEADERS_REVALIDATE),
+        (vary == true ? EXTRA_HEADER_VARY_ENCODING : ""));
 
-    if (p->uri != NULL) {
-        //send header
-        mg_printf(nc, "HTTP/1.1 200 OK\r\n"
-            EXTRA_HEADERS_SAFE
-            "%s"
-            "Content-Length: %d\r\n"
-            "Content-Type: %s\r\n"
+    //conditional request
+    if (etag_matches(mg_http_get_header(hm, "If-None-Match"), etag) == true) {
+        mg_printf(nc, "HTTP/1.1 304 Not Modified\r\n"
             "%s\r\n",
-            (p->cache == true ? EXTRA_HEADERS_CACHE : ""),
-            p->size,
-            p->mimetype,
-            (p->compressed == true ? EXTRA_HEADER_CONTENT_ENCODING : "")
-        );
-        //send data
-        mg_send(nc, p->data, p->size);
+            headers);
         webserver_handle_connection_close(nc);
-        FREE_SDS(uri_decoded);
+        FREE_SDS(headers);
         return true;
     }
-    sds errormsg = sdscatfmt(sdsempty(), "Embedded asset \"%S\" not found", uri_decoded);
-    webserver_send_error(nc, 404, errormsg);
-    FREE_SDS(errormsg);
-    FREE_SDS(uri_decoded);
+
+    //send header
+    if (encoding != NULL) {
+        headers = sdscatfmt(headers, "Content-Encoding: %s\r\n", encoding);
+    }
+    mg_printf(nc, "HTTP/1.1 200 OK\r\n"
+        EXTRA_HEADERS_SAFE
+        "%s"
+        "Content-Length: %u\r\n"
+        "Content-Type: %s\r\n"
+        "\r\n",
+        headers,
+        size,
+        p->mimetype
+    );
+    //send data
+    mg_send(nc, data, size);
+    webserver_handle_connection_close(nc);
+    FREE_SDS(headers);
+    return true;
+}
+#endif
+
+/**
+ * Private functions
+ */
+
+/**
+ * Sends an image from the in-memory image cache,
+ * requests with a matching If-None-Match header are answered with 304.
+ * @param nc mongoose connection
+ * @param hm http message
+ * @param entry image cache entry
+ * @param extra_headers extra headers to send
+ */
+static void send_image_cache_entry(struct mg_connection *nc, struct mg_http_message *hm,
+        struct t_image_cache_entry *entry, const char *extra_headers)
+{
+    sds headers = sdscatfmt(sdsempty(), "ETag: %S\r\n%s", entry->etag, extra_headers);
+    if (etag_matches(mg_http_get_header(hm, "If-None-Match"), entry->etag) == true) {
+        mg_printf(nc, "HTTP/1.1 304 Not Modified\r\n"
+            "%s\r\n",
+            headers);
+        webserver_handle_connection_close(nc);
+        FREE_SDS(headers);
+        return;
+    }
+    headers = sdscatfmt(headers, "Content-Type: %S\r\n", entry->mime_type);
+    webserver_send_data(nc, entry->data, sdslen(entry->data), headers);
+    FREE_SDS(headers);
+}
+
+/**
+ * Creates the etag for a file in the format of mongoose,
+ * images served from memory and from disk share the same etag.
+ * @param etag already allocated sds string to append the etag
+ * @param filepath file to get the modification time from
+ * @param size size of the file
+ * @return pointer to etag
+ */
+static sds get_file_etag(sds etag, const char *filepath, size_t size) {
+    return sdscatprintf(etag, "\"%lld.%lld\"", (long long)get_mtime(filepath), (long long)size);
+}
+
+/**
+ * Strips leading and trailing whitespace
+ * @param s string to strip
+ * @return the stripped string
+ */
+static struct mg_str str_trim(struct mg_str s) {
+    while (s.len > 0 && isspace((unsigned char)s.buf[0])) {
+        s.buf++;
+        s.len--;
+    }
+    while (s.len > 0 && isspace((unsigned char)s.buf[s.len - 1])) {
+        s.len--;
+    }
+    return s;
+}
+
+/**
+ * Checks if the If-None-Match header matches the etag
+ * @param header If-None-Match header or NULL
+ * @param etag quoted etag to check
+ * @return true on match, else false
+ */
+static bool etag_matches(struct mg_str *header, const char *etag) {
+    if (header == NULL) {
+        return false;
+    }
+    struct mg_str rest = *header;
+    struct mg_str entry;
+    while (mg_span(rest, &entry, &rest, ',')) {
+        entry = str_trim(entry);
+        if (entry.len == 1 && entry.buf[0] == '*') {
+            return true;
+        }
+        //weak comparison
+        if (entry.len > 2 && entry.buf[0] == 'W' && entry.buf[1] == '/') {
+            entry.buf += 2;
+            entry.len -= 2;
+        }
+        if (mg_strcmp(entry, mg_str(etag)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef MYMPD_EMBEDDED_ASSETS
+/**
+ * Compares an uri with the uri of an embedded file, used by bsearch
+ * @param key uri to search
+ * @param member embedded file to compare
+ * @return result of strcmp
+ */
+static int embedded_file_cmp(const void *key, const void *member) {
+    return strcmp((const char *)key, ((const struct embedded_file *)member)->uri);
+}
+
+/**
+ * Checks if the content coding is accepted by the client,
+ * codings with a quality value of zero are not accepted.
+ * @param header Accept-Encoding header or NULL
+ * @param encoding content coding to check
+ * @return true if accepted, else false
+ */
+static bool accepts_encoding(struct mg_str *header, const char *encoding) {
+    if (header == NULL) {
+        return false;
+    }
+    struct mg_str rest = *header;
+    struct mg_str entry;
+    while (mg_span(rest, &entry, &rest, ',')) {
+        struct mg_str name;
+        struct mg_str params;
+        mg_span(entry, &name, &params, ';');
+        if (mg_strcasecmp(str_trim(name), mg_str(encoding)) != 0) {
+            continue;
+        }
+        params = str_trim(params);
+        if (params.len < 2 ||
+            (params.buf[0] != 'q' && params.buf[0] != 'Q') ||
+            params.buf[1] != '=')
+        {
+            return true;
+        }
+        for (size_t i = 2; i < params.len; i++) {
+            if (params.buf[i] != '0' && params.buf[i] != '.') {
+                return true;
+            }
+        }
+        return false;
+    }
     return false;
 }
 #endif
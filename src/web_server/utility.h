@@ -9,8 +9,13 @@
 
 #include "dist/mongoose/mongoose.h"
 #include "dist/sds/sds.h"
+#include "src/lib/api.h"
 #include "src/lib/config_def.h"
 #include "src/lib/list.h"
+#include "src/web_server/image_cache.h"
+#include "src/web_server/negative_cache.h"
+#include "src/web_server/sessions.h"
+#include "src/web_server/websocket.h"
 
 #include <stdbool.h>
 
@@ -30,7 +35,7 @@ struct t_mg_user_data {
     bool publish_music;          //!< true if mpd music directory is accessible
     int connection_count;        //!< number of http connections
     struct t_list stream_uris;   //!< uri for the mpd stream reverse proxy
-    struct t_list session_list;  //!< list of myMPD sessions (pin protection mode)
+    struct t_sessions sessions;  //!< myMPD sessions (pin protection mode)
     sds placeholder_booklet;     //!< name of custom booklet image
     sds placeholder_mympd;       //!< name of custom mympd image
     sds placeholder_na;          //!< name of custom not available image
@@ -43,6 +48,9 @@ struct t_mg_user_data {
     sds key_content;             //!< the server key
     struct mg_str cert;          //!< pointer to ssl cert_content
     struct mg_str key;           //!< pointer to ssl key_content
+    struct t_ws_subscribers ws_subscribers;  //!< websocket connections by partition and client id
+    struct t_image_cache image_cache;        //!< recently served images from the disk caches
+    struct t_negative_cache negative_cache;  //!< songs without local coverimage
 };
 
 /**
@@ -50,10 +58,13 @@ struct t_mg_user_data {
  */
 struct t_frontend_nc_data {
     struct mg_connection *backend_nc;  //!< pointer to backend connection
+    bool chunked;                      //!< a streamed api response is in progress
+    struct t_stream_window *stream_window; //!< flow control of the streamed api response or NULL
     //for websocket connections only
     sds partition;                     //!< partition
     unsigned id;                       //!< jsonrpc id (client id)
     time_t last_ws_ping;               //!< last websocket ping from client
+    unsigned ws_dropped;               //!< bitmask of coalesced notifications dropped by backpressure
 };
 
 enum placeholder_types {
@@ -67,19 +78,21 @@ enum placeholder_types {
 };
 
 #ifdef MYMPD_EMBEDDED_ASSETS
-bool webserver_serve_embedded_files(struct mg_connection *nc, sds uri);
+bool webserver_serve_embedded_files(struct mg_connection *nc, struct mg_http_message *hm, sds uri);
 #endif
 sds get_uri_param(struct mg_str *query, const char *name);
 sds print_ip(sds s, struct mg_addr *addr);
 bool get_partition_from_uri(struct mg_connection *nc, struct mg_http_message *hm, struct t_frontend_nc_data *frontend_nc_data);
 bool check_imagescache(struct mg_connection *nc, struct mg_http_message *hm,
-        struct t_mg_user_data *mg_user_data, const char *type, sds uri_decoded, int offset);
+        struct t_mg_user_data *mg_user_data, const char *type, sds uri_decoded, int offset, bool thumbnail);
 sds webserver_find_image_file(sds basefilename);
 bool find_image_in_folder(sds *coverfile, sds music_directory, sds path, sds *names, int names_len);
 void webserver_send_error(struct mg_connection *nc, int code, const char *msg);
 void webserver_serve_file(struct mg_connection *nc, struct mg_http_message *hm, const char *path, const char *file);
 void webserver_serve_placeholder_image(struct mg_connection *nc, enum placeholder_types placeholder_type);
 void webserver_send_header_ok(struct mg_connection *nc, size_t len, const char *extra_headers);
+void webserver_send_json_chunk(struct mg_connection *nc, const char *data, size_t len);
+void webserver_send_json_chunk_end(struct mg_connection *nc, const char *data, size_t len);
 void webserver_send_header_redirect(struct mg_connection *nc, const char *location, const char *headers);
 void webserver_send_header_found(struct mg_connection *nc, const char *location, const char *headers);
 void webserver_send_cors_reply(struct mg_connection *nc);
@@ -20,10 +20,12 @@
 #include "src/lib/thread.h"
 #include "src/web_server/albumart.h"
 #include "src/web_server/folderart.h"
+#include "src/web_server/image_worker.h"
 #include "src/web_server/playlistart.h"
 #include "src/web_server/proxy.h"
 #include "src/web_server/request_handler.h"
 #include "src/web_server/tagart.h"
+#include "src/web_server/websocket.h"
 
 #ifdef MYMPD_ENABLE_LUA
     #include "src/web_server/scripts.h"
@@ -46,6 +48,7 @@ static void send_ws_notify_client(struct mg_mgr *mgr, struct t_work_response *re
 static struct mg_connection *get_nc_by_id(struct mg_mgr *mgr, unsigned long id);
 static void send_raw_response(struct mg_mgr *mgr, struct t_work_response *response);
 static void send_api_response(struct mg_mgr *mgr, struct t_work_response *response);
+static void send_api_chunk(struct mg_mgr *mgr, struct t_work_response *response);
 static bool enforce_acl(struct mg_connection *nc, sds acl);
 static bool enforce_conn_limit(struct mg_connection *nc, int connection_count);
 static void mongoose_log(char ch, void *param);
@@ -84,12 +87,21 @@ bool web_server_init(struct mg_mgr *mgr, struct t_config *config, struct t_mg_us
     mg_user_data->feat_albumart = false;
     mg_user_data->connection_count = 2; // listening + wakup
     list_init(&mg_user_data->stream_uris);
-    list_init(&mg_user_data->session_list);
+    webserver_sessions_init(&mg_user_data->sessions);
+    if (config->save_sessions == true) {
+        webserver_sessions_read(&mg_user_data->sessions, config->workdir, config->pin_hash);
+    }
     mg_user_data->mympd_api_started = false;
     mg_user_data->cert_content = sdsempty();
     mg_user_data->cert = mg_str("");
     mg_user_data->key_content = sdsempty();
     mg_user_data->key = mg_str("");
+    websocket_subscribers_init(&mg_user_data->ws_subscribers);
+    image_cache_init(&mg_user_data->image_cache, (size_t)config->cache_cover_memory_kb * 1024);
+    negative_cache_init(&mg_user_data->negative_cache);
+    if (config->save_caches == true) {
+        negative_cache_read(&mg_user_data->negative_cache, config->workdir);
+    }
 
     //init monogoose mgr
     mg_mgr_init(mgr);
@@ -203,9 +215,19 @@ void *web_server_loop(void *arg_mgr) {
         MYMPD_LOG_DEBUG(NULL, "Using certificate: %s", mg_user_data->config->ssl_cert);
         MYMPD_LOG_DEBUG(NULL, "Using private key: %s", mg_user_data->config->ssl_key);
     }
+    //embedded images are extracted outside of the event loop
+    image_worker_pool_start(&mg_user_data->negative_cache);
     while (s_signal_received == 0) {
-        //webserver polling
-        mg_mgr_poll(mgr, -1);
+        //webserver polling, wakes up for coalesced websocket notifications
+        mg_mgr_poll(mgr, websocket_coalesce_timeout(&mg_user_data->ws_subscribers, (int64_t)mg_millis()));
+        websocket_coalesce_flush(&mg_user_data->ws_subscribers, (int64_t)mg_millis(), time(NULL) - WS_PING_TIMEOUT);
+    }
+    image_worker_pool_stop();
+    if (mg_user_data->config->save_caches == true) {
+        negative_cache_save(&mg_user_data->negative_cache, mg_user_data->config->workdir);
+    }
+    if (mg_user_data->config->save_sessions == true) {
+        webserver_sessions_save(&mg_user_data->sessions, mg_user_data->config->workdir, mg_user_data->config->pin_hash);
     }
     MYMPD_LOG_DEBUG(NULL, "Stopping web_server thread");
     FREE_SDS(thread_logname);
@@ -252,6 +274,10 @@ static void read_queue(struct mg_mgr *mgr) {
                 MYMPD_LOG_DEBUG(response->partition, "Got API response for id \"%lu\"", response->conn_id);
                 send_api_response(mgr, response);
                 break;
+            case RESPONSE_TYPE_CHUNK:
+                MYMPD_LOG_DEBUG(response->partition, "Got response chunk for id \"%lu\" with %lu bytes", response->conn_id, (unsigned long)sdslen(response->data));
+                send_api_chunk(mgr, response);
+                break;
             case RESPONSE_TYPE_RAW:
                 MYMPD_LOG_DEBUG(response->partition, "Got raw response for id \"%lu\" with %lu bytes", response->conn_id, (unsigned long)sdslen(response->data));
                 send_raw_response(mgr, response);
@@ -304,6 +330,10 @@ static bool parse_internal_message(struct t_work_response *response, struct t_mg
         MYMPD_LOG_DEBUG(NULL, "Document root: \"%s\"", mg_user_data->browse_directory);
 
         //coverimage names
+        sds signature = sdscatfmt(sdsempty(), "%S\n%S\n%S", mg_user_data->music_directory,
+            new_mg_user_data->coverimage_names, new_mg_user_data->thumbnail_names);
+        negative_cache_set_signature(&mg_user_data->negative_cache, signature);
+        FREE_SDS(signature);
         sdsfreesplitres(mg_user_data->coverimage_names, mg_user_data->coverimage_names_len);
         mg_user_data->coverimage_names = sds_split_comma_trim(new_mg_user_data->coverimage_names, &mg_user_data->coverimage_names_len);
         FREE_SDS(new_mg_user_data->coverimage_names);
@@ -381,37 +411,17 @@ static void get_placeholder_image(sds workdir, const char *name, sds *result) {
  * @param response jsonrpc notification
  */
 static void send_ws_notify(struct mg_mgr *mgr, struct t_work_response *response) {
-    struct mg_connection *nc = mgr->conns;
-    int send_count = 0;
-    int conn_count = 0;
+    struct t_mg_user_data *mg_user_data = (struct t_mg_user_data *) mgr->userdata;
     time_t last_ping = time(NULL) - WS_PING_TIMEOUT;
-    while (nc != NULL) {
-        if (nc->is_websocket == 1U) {
-            struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
-            if (frontend_nc_data->last_ws_ping < last_ping) {
-                MYMPD_LOG_INFO(NULL, "Closing stale websocket connection \"%lu\"", nc->id);
-                nc->is_closing = 1;
-            }
-            else if (strcmp(response->partition, frontend_nc_data->partition) == 0 ||
-                strcmp(response->partition, MPD_PARTITION_ALL) == 0)
-            {
-                MYMPD_LOG_DEBUG(response->partition, "Sending notify to conn_id \"%lu\": %s", nc->id, response->data);
-                mg_ws_send(nc, response->data, sdslen(response->data), WEBSOCKET_OP_TEXT);
-                send_count++;
-            }
-        }
-        nc = nc->next;
-        conn_count++;
-    }
+    unsigned send_count = websocket_notify(&mg_user_data->ws_subscribers, response->partition,
+        response->data, sdslen(response->data), (int64_t)mg_millis(), last_ping);
     if (send_count == 0) {
-        MYMPD_LOG_DEBUG(NULL, "No websocket client connected, discarding message: %s", response->data);
+        MYMPD_LOG_DEBUG(NULL, "No websocket client connected or message coalesced: %s", response->data);
     }
-    free_response(response);
-    struct t_mg_user_data *mg_user_data = (struct t_mg_user_data *) mgr->userdata;
-    if (conn_count != mg_user_data->connection_count) {
-        MYMPD_LOG_DEBUG(NULL, "Correcting connection count from %d to %d", mg_user_data->connection_count, conn_count);
-        mg_user_data->connection_count = conn_count;
+    else {
+        MYMPD_LOG_DEBUG(response->partition, "Sent notify to %u websocket connections: %s", send_count, response->data);
     }
+    free_response(response);
 }
 
 /**
@@ -421,23 +431,13 @@ static void send_ws_notify(struct mg_mgr *mgr, struct t_work_response *response)
  * @param response jsonrpc notification
  */
 static void send_ws_notify_client(struct mg_mgr *mgr, struct t_work_response *response) {
-    struct mg_connection *nc = mgr->conns;
-    int send_count = 0;
+    struct t_mg_user_data *mg_user_data = (struct t_mg_user_data *) mgr->userdata;
     const unsigned client_id = response->id / 1000;
     //const unsigned request_id = response->id % 1000;
-    while (nc != NULL) {
-        if (nc->is_websocket == 1U) {
-            struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
-            if (client_id == frontend_nc_data->id) {
-                MYMPD_LOG_DEBUG(response->partition, "Sending notify to conn_id \"%lu\", jsonrpc client id %u: %s", nc->id, client_id, response->data);
-                mg_ws_send(nc, response->data, sdslen(response->data), WEBSOCKET_OP_TEXT);
-                send_count++;
-                break;
-            }
-        }
-        nc = nc->next;
+    if (websocket_send_client(&mg_user_data->ws_subscribers, client_id, response->data, sdslen(response->data)) == true) {
+        MYMPD_LOG_DEBUG(response->partition, "Sending notify to jsonrpc client id %u: %s", client_id, response->data);
     }
-    if (send_count == 0) {
+    else {
         MYMPD_LOG_DEBUG(NULL, "No websocket client connected, discarding message: %s", response->data);
     }
     free_response(response);
@@ -492,6 +492,20 @@ static void send_api_response(struct mg_mgr *mgr, struct t_work_response *respon
                 webserver_serve_placeholder_image(nc, PLACEHOLDER_NA);
                 break;
             default:
+                if (response->chunks > 0) {
+                    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+                    if (frontend_nc_data->stream_window != NULL) {
+                        stream_window_unref(frontend_nc_data->stream_window);
+                        frontend_nc_data->stream_window = NULL;
+                    }
+                    if (stream_window_is_aborted(response->window) == true) {
+                        //the client stalled, close the connection
+                        sdsclear(response->data);
+                    }
+                    MYMPD_LOG_DEBUG(response->partition, "Sending last chunk to conn_id \"%lu\" (length: %lu)", nc->id, (unsigned long)sdslen(response->data));
+                    webserver_send_json_chunk_end(nc, response->data, sdslen(response->data));
+                    break;
+                }
                 MYMPD_LOG_DEBUG(response->partition, "Sending response to conn_id \"%lu\" (length: %lu): %s", nc->id, (unsigned long)sdslen(response->data), response->data);
                 webserver_send_data(nc, response->data, sdslen(response->data), EXTRA_HEADERS_JSON_CONTENT);
         }
@@ -499,6 +513,28 @@ static void send_api_response(struct mg_mgr *mgr, struct t_work_response *respon
     free_response(response);
 }
 
+/**
+ * Sends a part of a streamed api response and updates its flow control
+ * @param mgr mongoose mgr
+ * @param response part of the jsonrpc response
+ */
+static void send_api_chunk(struct mg_mgr *mgr, struct t_work_response *response) {
+    struct mg_connection *nc = get_nc_by_id(mgr, response->conn_id);
+    if (nc != NULL) {
+        struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+        if (frontend_nc_data->stream_window == NULL) {
+            frontend_nc_data->stream_window = stream_window_ref(response->window);
+        }
+        webserver_send_json_chunk(nc, response->data, sdslen(response->data));
+        stream_window_sent(response->window, sdslen(response->data), nc->send.len);
+    }
+    else {
+        //connection is gone, drop the remaining parts
+        stream_window_abort(response->window);
+    }
+    free_response(response);
+}
+
 /**
  * Matches the acl against the client ip and
  * sends an error response / drains the connection if acl is not matched
@@ -581,7 +617,10 @@ static void ev_handler(struct mg_connection *nc, int ev, void *ev_data) {
                 frontend_nc_data->partition = NULL;           // populated on websocket handshake
                 frontend_nc_data->id = 0;                     // populated through websocket message
                 frontend_nc_data->last_ws_ping = time(NULL);  // websocket ping timestamp
+                frontend_nc_data->ws_dropped = 0;             // notifications dropped by backpressure
                 frontend_nc_data->backend_nc = NULL;          // used for reverse proxy function
+                frontend_nc_data->chunked = false;            // streamed api response in progress
+                frontend_nc_data->stream_window = NULL;       // flow control of the streamed api response
                 nc->fn_data = frontend_nc_data;
                 //set labels
                 nc->data[0] = 'F'; // connection type
@@ -593,6 +632,18 @@ static void ev_handler(struct mg_connection *nc, int ev, void *ev_data) {
         case MG_EV_WAKEUP:
             read_queue(nc->mgr);
             break;
+        case MG_EV_WRITE:
+            if (nc->is_websocket == 1U) {
+                //send dropped notifications after the send buffer has drained
+                websocket_resync(&mg_user_data->ws_subscribers, nc);
+            }
+            else if (frontend_nc_data != NULL &&
+                frontend_nc_data->stream_window != NULL)
+            {
+                //let the producer of a streamed response continue
+                stream_window_sent(frontend_nc_data->stream_window, 0, nc->send.len);
+            }
+            break;
         case MG_EV_ACCEPT:
             if (loglevel == LOG_DEBUG) {
                 sds ip = print_ip(sdsempty(), &nc->rem);
@@ -629,7 +680,7 @@ static void ev_handler(struct mg_connection *nc, int ev, void *ev_data) {
                 sent = mg_ws_send(nc, "pong", 4, WEBSOCKET_OP_TEXT);
             }
             else if (mg_match(wm->data, mg_str("id:*"), matches)) {
-                frontend_nc_data->id = mg_str_to_uint(&matches[0]);
+                websocket_set_client_id(&mg_user_data->ws_subscribers, nc, mg_str_to_uint(&matches[0]));
                 MYMPD_LOG_INFO(frontend_nc_data->partition, "Setting websocket id to \"%u\"", frontend_nc_data->id);
                 sent = mg_ws_send(nc, "ok", 2, WEBSOCKET_OP_TEXT);
             }
@@ -764,6 +815,7 @@ static void ev_handler(struct mg_connection *nc, int ev, void *ev_data) {
                     break;
                 }
                 mg_ws_upgrade(nc, hm, NULL);
+                websocket_subscribe(&mg_user_data->ws_subscribers, nc);
                 MYMPD_LOG_INFO(frontend_nc_data->partition, "New Websocket connection established (%lu)", nc->id);
                 sds response = jsonrpc_event(sdsempty(), JSONRPC_EVENT_WELCOME);
                 mg_ws_send(nc, response, sdslen(response), WEBSOCKET_OP_TEXT);
@@ -863,7 +915,7 @@ static void ev_handler(struct mg_connection *nc, int ev, void *ev_data) {
                 #else
                     //serve embedded files
                     sds uri = sdsnewlen(hm->uri.buf, hm->uri.len);
-                    webserver_serve_embedded_files(nc, uri);
+                    webserver_serve_embedded_files(nc, hm, uri);
                     FREE_SDS(uri);
                 #endif
             }
@@ -886,6 +938,14 @@ static void ev_handler(struct mg_connection *nc, int ev, void *ev_data) {
                 //close backend connection
                 frontend_nc_data->backend_nc->is_closing = 1;
             }
+            if (nc->is_websocket == 1U) {
+                websocket_unsubscribe(&mg_user_data->ws_subscribers, nc);
+            }
+            if (frontend_nc_data->stream_window != NULL) {
+                //drop the remaining parts of the streamed response
+                stream_window_abort(frontend_nc_data->stream_window);
+                stream_window_unref(frontend_nc_data->stream_window);
+            }
             FREE_SDS(frontend_nc_data->partition);
             FREE_PTR(frontend_nc_data);
             nc->fn_data = NULL;
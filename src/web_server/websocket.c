@@ -0,0 +1,572 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "src/web_server/websocket.h"
+
+#include "dist/mjson/mjson.h"
+#include "src/lib/list.h"
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/sds_extras.h"
+#include "src/web_server/utility.h"
+
+#include <string.h>
+
+/*
+ Websocket connections are indexed by partition and by jsonrpc client id.
+ Notifications are serialized once into a websocket frame, the frame is
+ appended to the send buffer of each recipient.
+
+ Notifications that only describe a state are coalesced: the first one is sent
+ immediately, further ones within the window of the method are merged (last value wins)
+ and sent at the end of the window. These notifications are not sent to clients with a
+ full send buffer, the last value is sent after the buffer has drained.
+*/
+
+// private definitions
+
+/**
+ * Notifications that can be coalesced and their windows
+ */
+static const struct t_ws_coalesce_method {
+    const char *name;   //!< jsonrpc method
+    int64_t window_ms;  //!< minimum time between two notifications
+} ws_coalesce_methods[] = {
+    {"update_database", 1000},
+    {"update_home", 500},
+    {"update_jukebox", 500},
+    {"update_last_played", 500},
+    {"update_options", 250},
+    {"update_outputs", 250},
+    {"update_queue", 250},
+    {"update_stored_playlist", 500},
+    {"update_volume", 100}
+};
+
+#define WS_COALESCE_METHODS_LEN (int)(sizeof(ws_coalesce_methods) / sizeof(ws_coalesce_methods[0]))
+
+/**
+ * State of a coalesced notification per partition
+ */
+struct t_ws_coalesce_entry {
+    int method_idx;     //!< index in ws_coalesce_methods
+    sds partition;      //!< partition name or MPD_PARTITION_ALL
+    sds last;           //!< last sent notification
+    sds pending;        //!< notification waiting for the end of the window, NULL if none
+    int64_t last_sent;  //!< timestamp in ms of the last sent notification
+};
+
+static void remove_from_partition(struct t_ws_subscribers *subscribers, struct mg_connection *nc, const char *partition);
+static void remove_client_id(struct t_ws_subscribers *subscribers, struct mg_connection *nc, unsigned id);
+static unsigned broadcast(struct t_ws_subscribers *subscribers, const char *partition,
+        const char *data, size_t len, time_t last_ping, int method_idx);
+static unsigned send_frame_to_list(struct t_list *list, const char *frame, size_t len, time_t last_ping, int method_idx);
+static int get_coalesce_method(const char *data, size_t len);
+static sds get_coalesce_key(sds key, int method_idx, const char *partition);
+static struct t_ws_coalesce_entry *get_coalesce_entry(struct t_ws_subscribers *subscribers, int method_idx,
+        const char *partition, bool create);
+static void free_coalesce_entry(void *data);
+
+// public functions
+
+/**
+ * Initializes the websocket subscriber index
+ * @param subscribers pointer to the index
+ */
+void websocket_subscribers_init(struct t_ws_subscribers *subscribers) {
+    subscribers->partitions = raxNew();
+    subscribers->clients = raxNew();
+    subscribers->count = 0;
+    subscribers->coalesce = raxNew();
+    subscribers->pending = 0;
+}
+
+/**
+ * Frees the websocket subscriber index, the connections are not touched
+ * @param subscribers pointer to the index
+ */
+void websocket_subscribers_clear(struct t_ws_subscribers *subscribers) {
+    if (subscribers->partitions != NULL) {
+        raxIterator iter;
+        raxStart(&iter, subscribers->partitions);
+        raxSeek(&iter, "^", NULL, 0);
+        while (raxNext(&iter)) {
+            list_free((struct t_list *)iter.data);
+        }
+        raxStop(&iter);
+        raxFree(subscribers->partitions);
+        subscribers->partitions = NULL;
+    }
+    if (subscribers->clients != NULL) {
+        raxFree(subscribers->clients);
+        subscribers->clients = NULL;
+    }
+    if (subscribers->coalesce != NULL) {
+        raxFreeWithCallback(subscribers->coalesce, free_coalesce_entry);
+        subscribers->coalesce = NULL;
+    }
+    subscribers->count = 0;
+    subscribers->pending = 0;
+}
+
+/**
+ * Adds a websocket connection to the subscriber list of its partition
+ * @param subscribers pointer to the index
+ * @param nc websocket connection with populated partition
+ */
+void websocket_subscribe(struct t_ws_subscribers *subscribers, struct mg_connection *nc) {
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+    const char *partition = frontend_nc_data->partition;
+    size_t partition_len = strlen(partition);
+    void *data = raxFind(subscribers->partitions, (unsigned char *)partition, partition_len);
+    struct t_list *list;
+    if (data == raxNotFound) {
+        list = list_new();
+        raxInsert(subscribers->partitions, (unsigned char *)partition, partition_len, list, NULL);
+    }
+    else {
+        list = (struct t_list *)data;
+    }
+    list_push(list, "", (int64_t)nc->id, NULL, nc);
+    subscribers->count++;
+    MYMPD_LOG_DEBUG(partition, "Websocket connection \"%lu\" subscribed, %u subscribers", nc->id, list->length);
+}
+
+/**
+ * Removes a websocket connection from the index
+ * @param subscribers pointer to the index
+ * @param nc websocket connection
+ */
+void websocket_unsubscribe(struct t_ws_subscribers *subscribers, struct mg_connection *nc) {
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+    if (frontend_nc_data->partition != NULL) {
+        remove_from_partition(subscribers, nc, frontend_nc_data->partition);
+    }
+    if (frontend_nc_data->id > 0) {
+        remove_client_id(subscribers, nc, frontend_nc_data->id);
+    }
+}
+
+/**
+ * Sets the jsonrpc client id of a websocket connection
+ * @param subscribers pointer to the index
+ * @param nc websocket connection
+ * @param id the new client id
+ */
+void websocket_set_client_id(struct t_ws_subscribers *subscribers, struct mg_connection *nc, unsigned id) {
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+    if (frontend_nc_data->id > 0) {
+        remove_client_id(subscribers, nc, frontend_nc_data->id);
+    }
+    frontend_nc_data->id = id;
+    if (id > 0) {
+        // the last connection with this id wins
+        raxInsert(subscribers->clients, (unsigned char *)&id, sizeof(id), nc, NULL);
+    }
+}
+
+/**
+ * Serializes a websocket text frame for the server side (unmasked)
+ * @param buffer already allocated sds string to append the frame
+ * @param data payload
+ * @param len payload length
+ * @return pointer to buffer
+ */
+sds websocket_frame(sds buffer, const char *data, size_t len) {
+    unsigned char header[10];
+    size_t header_len;
+    header[0] = 0x80 | WEBSOCKET_OP_TEXT;
+    if (len < 126) {
+        header[1] = (unsigned char)len;
+        header_len = 2;
+    }
+    else if (len < 65536) {
+        header[1] = 126;
+        header[2] = (unsigned char)(len >> 8);
+        header[3] = (unsigned char)len;
+        header_len = 4;
+    }
+    else {
+        header[1] = 127;
+        for (int i = 0; i < 8; i++) {
+            header[2 + i] = (unsigned char)((uint64_t)len >> (56 - 8 * i));
+        }
+        header_len = 10;
+    }
+    buffer = sdsMakeRoomFor(buffer, header_len + len);
+    buffer = sdscatlen(buffer, header, header_len);
+    buffer = sdscatlen(buffer, data, len);
+    return buffer;
+}
+
+/**
+ * Sends a notification to all websocket connections of a partition.
+ * Connections without a ping since last_ping are closed.
+ * @param subscribers pointer to the index
+ * @param partition partition name or MPD_PARTITION_ALL
+ * @param data payload
+ * @param len payload length
+ * @param last_ping minimum timestamp of the last ping
+ * @return number of recipients
+ */
+unsigned websocket_broadcast(struct t_ws_subscribers *subscribers, const char *partition,
+        const char *data, size_t len, time_t last_ping)
+{
+    return broadcast(subscribers, partition, data, len, last_ping, -1);
+}
+
+/**
+ * Sends a notification to all websocket connections of a partition
+ * and coalesces notifications that describe a state.
+ * @param subscribers pointer to the index
+ * @param partition partition name or MPD_PARTITION_ALL
+ * @param data payload
+ * @param len payload length
+ * @param now_ms current monotonic time in ms
+ * @param last_ping minimum timestamp of the last ping
+ * @return number of recipients, 0 if the notification was delayed
+ */
+unsigned websocket_notify(struct t_ws_subscribers *subscribers, const char *partition,
+        const char *data, size_t len, int64_t now_ms, time_t last_ping)
+{
+    int method_idx = get_coalesce_method(data, len);
+    if (method_idx < 0) {
+        return broadcast(subscribers, partition, data, len, last_ping, -1);
+    }
+    struct t_ws_coalesce_entry *entry = get_coalesce_entry(subscribers, method_idx, partition, true);
+    if (entry->pending == NULL &&
+        now_ms >= entry->last_sent + ws_coalesce_methods[method_idx].window_ms)
+    {
+        entry->last = sds_replacelen(entry->last, data, len);
+        entry->last_sent = now_ms;
+        return broadcast(subscribers, partition, data, len, last_ping, method_idx);
+    }
+    // within the window, last value wins
+    if (entry->pending == NULL) {
+        entry->pending = sdsnewlen(data, len);
+        subscribers->pending++;
+    }
+    else {
+        entry->pending = sds_replacelen(entry->pending, data, len);
+    }
+    MYMPD_LOG_DEBUG(partition, "Coalescing websocket notification \"%s\"", ws_coalesce_methods[method_idx].name);
+    return 0;
+}
+
+/**
+ * Sends the coalesced notifications with an elapsed window
+ * @param subscribers pointer to the index
+ * @param now_ms current monotonic time in ms
+ * @param last_ping minimum timestamp of the last ping
+ * @return number of sent notifications
+ */
+unsigned websocket_coalesce_flush(struct t_ws_subscribers *subscribers, int64_t now_ms, time_t last_ping) {
+    if (subscribers->pending == 0) {
+        return 0;
+    }
+    unsigned sent = 0;
+    raxIterator iter;
+    raxStart(&iter, subscribers->coalesce);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        struct t_ws_coalesce_entry *entry = (struct t_ws_coalesce_entry *)iter.data;
+        if (entry->pending != NULL &&
+            now_ms >= entry->last_sent + ws_coalesce_methods[entry->method_idx].window_ms)
+        {
+            broadcast(subscribers, entry->partition, entry->pending, sdslen(entry->pending), last_ping, entry->method_idx);
+            FREE_SDS(entry->last);
+            entry->last = entry->pending;
+            entry->pending = NULL;
+            entry->last_sent = now_ms;
+            subscribers->pending--;
+            sent++;
+        }
+    }
+    raxStop(&iter);
+    return sent;
+}
+
+/**
+ * Calculates the poll timeout for the next coalesced notification
+ * @param subscribers pointer to the index
+ * @param now_ms current monotonic time in ms
+ * @return timeout in ms or -1 if there are no pending notifications
+ */
+int websocket_coalesce_timeout(struct t_ws_subscribers *subscribers, int64_t now_ms) {
+    if (subscribers->pending == 0) {
+        return -1;
+    }
+    int64_t timeout = INT64_MAX;
+    raxIterator iter;
+    raxStart(&iter, subscribers->coalesce);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        struct t_ws_coalesce_entry *entry = (struct t_ws_coalesce_entry *)iter.data;
+        if (entry->pending != NULL) {
+            int64_t due = entry->last_sent + ws_coalesce_methods[entry->method_idx].window_ms - now_ms;
+            if (due < timeout) {
+                timeout = due;
+            }
+        }
+    }
+    raxStop(&iter);
+    return timeout < 0
+        ? 0
+        : (int)timeout;
+}
+
+/**
+ * Sends the last value of the notifications that were dropped for a connection,
+ * after its send buffer has drained.
+ * @param subscribers pointer to the index
+ * @param nc websocket connection
+ */
+void websocket_resync(struct t_ws_subscribers *subscribers, struct mg_connection *nc) {
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+    if (frontend_nc_data->ws_dropped == 0 ||
+        nc->send.len > WS_SEND_BUFFER_MAX / 2)
+    {
+        return;
+    }
+    for (int i = 0; i < WS_COALESCE_METHODS_LEN; i++) {
+        if ((frontend_nc_data->ws_dropped & (1U << i)) == 0) {
+            continue;
+        }
+        // send the newer one of the partition specific and the global notification
+        struct t_ws_coalesce_entry *entry = get_coalesce_entry(subscribers, i, frontend_nc_data->partition, false);
+        struct t_ws_coalesce_entry *entry_all = get_coalesce_entry(subscribers, i, MPD_PARTITION_ALL, false);
+        if (entry == NULL ||
+            (entry_all != NULL && entry_all->last_sent > entry->last_sent))
+        {
+            entry = entry_all;
+        }
+        if (entry != NULL) {
+            MYMPD_LOG_DEBUG(frontend_nc_data->partition, "Resending websocket notification \"%s\" to connection \"%lu\"",
+                ws_coalesce_methods[i].name, nc->id);
+            mg_ws_send(nc, entry->last, sdslen(entry->last), WEBSOCKET_OP_TEXT);
+        }
+    }
+    frontend_nc_data->ws_dropped = 0;
+}
+
+/**
+ * Sends a notification to the websocket connection with the jsonrpc client id
+ * @param subscribers pointer to the index
+ * @param client_id jsonrpc client id
+ * @param data payload
+ * @param len payload length
+ * @return true if the client was found, else false
+ */
+bool websocket_send_client(struct t_ws_subscribers *subscribers, unsigned client_id,
+        const char *data, size_t len)
+{
+    void *nc = raxFind(subscribers->clients, (unsigned char *)&client_id, sizeof(client_id));
+    if (nc == raxNotFound) {
+        return false;
+    }
+    mg_ws_send((struct mg_connection *)nc, data, len, WEBSOCKET_OP_TEXT);
+    return true;
+}
+
+// private functions
+
+/**
+ * Removes a connection from the subscriber list of a partition
+ * @param subscribers pointer to the index
+ * @param nc websocket connection
+ * @param partition partition name
+ */
+static void remove_from_partition(struct t_ws_subscribers *subscribers, struct mg_connection *nc, const char *partition) {
+    size_t partition_len = strlen(partition);
+    void *data = raxFind(subscribers->partitions, (unsigned char *)partition, partition_len);
+    if (data == raxNotFound) {
+        return;
+    }
+    struct t_list *list = (struct t_list *)data;
+    unsigned idx = 0;
+    struct t_list_node *current = list->head;
+    while (current != NULL) {
+        if (current->user_data == nc) {
+            list_node_free(list_node_extract(list, idx));
+            subscribers->count--;
+            break;
+        }
+        idx++;
+        current = current->next;
+    }
+    if (list->length == 0) {
+        raxRemove(subscribers->partitions, (unsigned char *)partition, partition_len, NULL);
+        list_free(list);
+    }
+}
+
+/**
+ * Removes the client id mapping if it points to this connection
+ * @param subscribers pointer to the index
+ * @param nc websocket connection
+ * @param id client id
+ */
+static void remove_client_id(struct t_ws_subscribers *subscribers, struct mg_connection *nc, unsigned id) {
+    void *data = raxFind(subscribers->clients, (unsigned char *)&id, sizeof(id));
+    if (data == nc) {
+        raxRemove(subscribers->clients, (unsigned char *)&id, sizeof(id), NULL);
+    }
+}
+
+/**
+ * Sends a notification to all websocket connections of a partition
+ * @param subscribers pointer to the index
+ * @param partition partition name or MPD_PARTITION_ALL
+ * @param data payload
+ * @param len payload length
+ * @param last_ping minimum timestamp of the last ping
+ * @param method_idx index of the coalesced method, -1 if the notification can not be dropped
+ * @return number of recipients
+ */
+static unsigned broadcast(struct t_ws_subscribers *subscribers, const char *partition,
+        const char *data, size_t len, time_t last_ping, int method_idx)
+{
+    if (subscribers->count == 0) {
+        return 0;
+    }
+    sds frame = websocket_frame(sdsempty(), data, len);
+    unsigned send_count = 0;
+    if (strcmp(partition, MPD_PARTITION_ALL) == 0) {
+        raxIterator iter;
+        raxStart(&iter, subscribers->partitions);
+        raxSeek(&iter, "^", NULL, 0);
+        while (raxNext(&iter)) {
+            send_count += send_frame_to_list((struct t_list *)iter.data, frame, sdslen(frame), last_ping, method_idx);
+        }
+        raxStop(&iter);
+    }
+    else {
+        void *list = raxFind(subscribers->partitions, (unsigned char *)partition, strlen(partition));
+        if (list != raxNotFound) {
+            send_count = send_frame_to_list((struct t_list *)list, frame, sdslen(frame), last_ping, method_idx);
+        }
+    }
+    FREE_SDS(frame);
+    return send_count;
+}
+
+/**
+ * Appends a serialized frame to the send buffers of all connections in the list
+ * @param list subscriber list
+ * @param frame serialized websocket frame
+ * @param len frame length
+ * @param last_ping minimum timestamp of the last ping
+ * @param method_idx index of the coalesced method, -1 if the notification can not be dropped
+ * @return number of recipients
+ */
+static unsigned send_frame_to_list(struct t_list *list, const char *frame, size_t len, time_t last_ping, int method_idx) {
+    unsigned send_count = 0;
+    struct t_list_node *current = list->head;
+    while (current != NULL) {
+        struct mg_connection *nc = (struct mg_connection *)current->user_data;
+        struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+        if (frontend_nc_data->last_ws_ping < last_ping) {
+            if (nc->is_closing == 0) {
+                MYMPD_LOG_INFO(NULL, "Closing stale websocket connection \"%lu\"", nc->id);
+                nc->is_closing = 1;
+            }
+        }
+        else if (nc->is_closing == 0) {
+            if (method_idx < 0) {
+                mg_send(nc, frame, len);
+                send_count++;
+            }
+            else if (nc->send.len > WS_SEND_BUFFER_MAX) {
+                // slow client, the last value is sent by websocket_resync
+                MYMPD_LOG_DEBUG(frontend_nc_data->partition, "Send buffer of connection \"%lu\" is full, dropping \"%s\"",
+                    nc->id, ws_coalesce_methods[method_idx].name);
+                frontend_nc_data->ws_dropped |= 1U << method_idx;
+            }
+            else {
+                mg_send(nc, frame, len);
+                frontend_nc_data->ws_dropped &= ~(1U << method_idx);
+                send_count++;
+            }
+        }
+        current = current->next;
+    }
+    return send_count;
+}
+
+/**
+ * Gets the index of a coalesced method from a jsonrpc notification
+ * @param data jsonrpc notification
+ * @param len length of data
+ * @return index in ws_coalesce_methods or -1 if the notification is not coalesced
+ */
+static int get_coalesce_method(const char *data, size_t len) {
+    char method[32];
+    if (mjson_get_string(data, (int)len, "$.method", method, sizeof(method)) <= 0) {
+        return -1;
+    }
+    for (int i = 0; i < WS_COALESCE_METHODS_LEN; i++) {
+        if (strcmp(method, ws_coalesce_methods[i].name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Creates the key for the coalesce rax
+ * @param key already allocated sds string to set the key
+ * @param method_idx index in ws_coalesce_methods
+ * @param partition partition name or MPD_PARTITION_ALL
+ * @return pointer to key
+ */
+static sds get_coalesce_key(sds key, int method_idx, const char *partition) {
+    sdsclear(key);
+    key = sdscatfmt(key, "%i:%s", method_idx, partition);
+    return key;
+}
+
+/**
+ * Gets the coalesce state for a method and partition
+ * @param subscribers pointer to the index
+ * @param method_idx index in ws_coalesce_methods
+ * @param partition partition name or MPD_PARTITION_ALL
+ * @param create create the entry if it does not exist
+ * @return the entry or NULL if not found
+ */
+static struct t_ws_coalesce_entry *get_coalesce_entry(struct t_ws_subscribers *subscribers, int method_idx,
+        const char *partition, bool create)
+{
+    sds key = get_coalesce_key(sdsempty(), method_idx, partition);
+    void *data = raxFind(subscribers->coalesce, (unsigned char *)key, sdslen(key));
+    struct t_ws_coalesce_entry *entry = NULL;
+    if (data != raxNotFound) {
+        entry = (struct t_ws_coalesce_entry *)data;
+    }
+    else if (create == true) {
+        entry = malloc_assert(sizeof(struct t_ws_coalesce_entry));
+        entry->method_idx = method_idx;
+        entry->partition = sdsnew(partition);
+        entry->last = sdsempty();
+        entry->pending = NULL;
+        entry->last_sent = INT64_MIN / 2;
+        raxInsert(subscribers->coalesce, (unsigned char *)key, sdslen(key), entry, NULL);
+    }
+    FREE_SDS(key);
+    return entry;
+}
+
+/**
+ * Frees a coalesce entry, callback for raxFreeWithCallback
+ * @param data the entry
+ */
+static void free_coalesce_entry(void *data) {
+    struct t_ws_coalesce_entry *entry = (struct t_ws_coalesce_entry *)data;
+    FREE_SDS(entry->partition);
+    FREE_SDS(entry->last);
+    FREE_SDS(entry->pending);
+    FREE_PTR(entry);
+}
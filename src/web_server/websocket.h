@@ -0,0 +1,46 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#ifndef MYMPD_WEB_SERVER_WEBSOCKET_H
+#define MYMPD_WEB_SERVER_WEBSOCKET_H
+
+#include "dist/mongoose/mongoose.h"
+#include "dist/rax/rax.h"
+#include "dist/sds/sds.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Index of the websocket connections, maintained on connect and close,
+ * and the state of the coalesced notifications
+ */
+struct t_ws_subscribers {
+    rax *partitions;   //!< partition name -> struct t_list of connections, value_i is the connection id
+    rax *clients;      //!< jsonrpc client id -> connection
+    unsigned count;    //!< number of websocket connections
+    rax *coalesce;     //!< method index + partition name -> struct t_ws_coalesce_entry
+    unsigned pending;  //!< number of coalesced notifications waiting for the end of their window
+};
+
+void websocket_subscribers_init(struct t_ws_subscribers *subscribers);
+void websocket_subscribers_clear(struct t_ws_subscribers *subscribers);
+void websocket_subscribe(struct t_ws_subscribers *subscribers, struct mg_connection *nc);
+void websocket_unsubscribe(struct t_ws_subscribers *subscribers, struct mg_connection *nc);
+void websocket_set_client_id(struct t_ws_subscribers *subscribers, struct mg_connection *nc, unsigned id);
+sds websocket_frame(sds buffer, const char *data, size_t len);
+unsigned websocket_broadcast(struct t_ws_subscribers *subscribers, const char *partition,
+        const char *data, size_t len, time_t last_ping);
+unsigned websocket_notify(struct t_ws_subscribers *subscribers, const char *partition,
+        const char *data, size_t len, int64_t now_ms, time_t last_ping);
+unsigned websocket_coalesce_flush(struct t_ws_subscribers *subscribers, int64_t now_ms, time_t last_ping);
+int websocket_coalesce_timeout(struct t_ws_subscribers *subscribers, int64_t now_ms);
+void websocket_resync(struct t_ws_subscribers *subscribers, struct mg_connection *nc);
+bool websocket_send_client(struct t_ws_subscribers *subscribers, unsigned client_id,
+        const char *data, size_t len);
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/mpack/mpack.h"
+#include "dist/utest/utest.h"
+#include "src/lib/cache_rax_album.h"
+#include "src/lib/mem.h"
+#include "src/lib/sds_extras.h"
+#include "src/mpd_client/tags.h"
+
+#include <stdio.h>
+
+#define BENCH_ALBUM_COUNT 60000
+
+/**
+ * Writes the album cache in the mpack format of older myMPD versions
+ */
+static bool legacy_write(struct t_cache *album_cache, const struct t_tags *album_tags, const struct t_albums_config *album_config) {
+    sds filepath = sdscatfmt(sdsempty(), "%S/%s/%s", workdir, DIR_WORK_TAGS, FILENAME_ALBUMCACHE_MPACK);
+    mpack_writer_t writer;
+    mpack_writer_init_filename(&writer, filepath);
+    FREE_SDS(filepath);
+    mpack_build_map(&writer);
+    mpack_write_kv(&writer, "albumMode", album_config->mode);
+    mpack_write_kv(&writer, "albumGroupTag", album_config->group_tag);
+    mpack_write_cstr(&writer, "tags");
+    mpack_start_array(&writer, (uint32_t)album_tags->len);
+    for (unsigned tagnr = 0; tagnr < album_tags->len; ++tagnr) {
+        mpack_write_cstr(&writer, mpd_tag_name(album_tags->tags[tagnr]));
+    }
+    mpack_finish_array(&writer);
+    mpack_write_cstr(&writer, "albums");
+    mpack_start_array(&writer, (uint32_t)album_cache->cache->numele);
+    raxIterator iter;
+    raxStart(&iter, album_cache->cache);
+    raxSeek(&iter, "^", NULL, 0);
+    while (raxNext(&iter)) {
+        const struct mpd_song *album = (struct mpd_song *)iter.data;
+        mpack_build_map(&writer);
+        mpack_write_kv(&writer, "uri", mpd_song_get_uri(album));
+        mpack_write_kv(&writer, "Discs", album_get_discs(album));
+        mpack_write_kv(&writer, "Songs", album_get_song_count(album));
+        mpack_write_kv(&writer, "Duration", mpd_song_get_duration(album));
+        mpack_write_kv(&writer, "Last-Modified", (uint64_t)mpd_song_get_last_modified(album));
+        mpack_write_kv(&writer, "Added", (uint64_t)mpd_song_get_added(album));
+        mpack_write_cstr(&writer, "AlbumId");
+        mpack_write_str(&writer, (char *)iter.key, (uint32_t)iter.key_len);
+        for (unsigned tagnr = 0; tagnr < album_tags->len; ++tagnr) {
+            enum mpd_tag_type tag = album_tags->tags[tagnr];
+            if (mpd_song_get_tag(album, tag, 0) == NULL) {
+                continue;
+            }
+            if (is_multivalue_tag(tag) == true) {
+                const char *value;
+                unsigned count = 0;
+                mpack_write_cstr(&writer, mpd_tag_name(tag));
+                mpack_build_array(&writer);
+                while ((value = mpd_song_get_tag(album, tag, count)) != NULL) {
+                    mpack_write_cstr(&writer, value);
+                    count++;
+                }
+                mpack_complete_array(&writer);
+            }
+            else {
+                mpack_write_kv(&writer, mpd_tag_name(tag), mpd_song_get_tag(album, tag, 0));
+            }
+        }
+        mpack_complete_map(&writer);
+    }
+    raxStop(&iter);
+    mpack_finish_array(&writer);
+    mpack_complete_map(&writer);
+    return mpack_writer_destroy(&writer) == mpack_ok;
+}
+
+static void fill_album_cache(struct t_cache *album_cache, const struct t_albums_config *album_config) {
+    album_cache->cache = raxNew();
+    sds key = sdsempty();
+    for (unsigned i = 0; i < BENCH_ALBUM_COUNT; i++) {
+        struct mpd_song *album = new_album(i);
+        key = album_cache_get_key(key, album, album_config);
+        raxInsert(album_cache->cache, (unsigned char *)key, sdslen(key), album, NULL);
+    }
+    FREE_SDS(key);
+}
+
+UTEST(benchmark_album_cache, read) {
+    init_testenv();
+    struct t_albums_config album_config = {
+        .group_tag = MPD_TAG_UNKNOWN,
+        .mode = ALBUM_MODE_ADV
+    };
+    struct t_tags album_tags = {
+        .len = 5,
+        .tags = { MPD_TAG_ARTIST, MPD_TAG_ALBUM_ARTIST, MPD_TAG_ALBUM, MPD_TAG_GENRE, MPD_TAG_DATE }
+    };
+    struct t_cache album_cache;
+    cache_init(&album_cache);
+    struct timespec tic;
+    struct timespec toc;
+
+    // legacy mpack format
+    fill_album_cache(&album_cache, &album_config);
+    ASSERT_TRUE(legacy_write(&album_cache, &album_tags, &album_config));
+    album_cache_free(&album_cache);
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    ASSERT_TRUE(album_cache_read(&album_cache, workdir, &album_config));
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("read mpack album cache", &tic, &toc, BENCH_ALBUM_COUNT);
+    ASSERT_EQ((uint64_t)BENCH_ALBUM_COUNT, album_cache.cache->numele);
+
+    // binary format, the write removes the mpack file
+    ASSERT_TRUE(album_cache_write(&album_cache, workdir, &album_tags, &album_config, true));
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    ASSERT_TRUE(album_cache_read(&album_cache, workdir, &album_config));
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("read binary album cache", &tic, &toc, BENCH_ALBUM_COUNT);
+    ASSERT_EQ((uint64_t)BENCH_ALBUM_COUNT, album_cache.cache->numele);
+
+    album_cache_free(&album_cache);
+    cache_free(&album_cache);
+    clean_testenv();
+}
@@ -0,0 +1,107 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/log.h"
+#include "src/lib/mem.h"
+#include "src/lib/msg_queue.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#define BENCH_PRODUCERS 8
+#define BENCH_MSGS_PER_PRODUCER 50000
+#define BENCH_MSGS (BENCH_PRODUCERS * BENCH_MSGS_PER_PRODUCER)
+
+/**
+ * A benchmark message, stamped by the producer before the push
+ */
+struct t_bench_msg {
+    struct timespec pushed;
+};
+
+/**
+ * Arguments for a producer thread
+ */
+struct t_bench_producer {
+    pthread_t thread;
+    struct t_mympd_queue *queue;
+    struct t_bench_msg *msgs;
+};
+
+static void *bench_producer(void *arg) {
+    struct t_bench_producer *producer = (struct t_bench_producer *)arg;
+    for (unsigned i = 0; i < BENCH_MSGS_PER_PRODUCER; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &producer->msgs[i].pushed);
+        mympd_queue_push(producer->queue, &producer->msgs[i], 0);
+    }
+    return NULL;
+}
+
+static int cmp_latency(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Pushes BENCH_MSGS_PER_PRODUCER messages from each producer thread,
+ * the calling thread is the consumer
+ */
+static void bench_queue(const char *name, struct t_mympd_queue *queue) {
+    struct t_bench_msg *msgs = malloc_assert(BENCH_MSGS * sizeof(struct t_bench_msg));
+    int64_t *latencies = malloc_assert(BENCH_MSGS * sizeof(int64_t));
+    struct t_bench_producer producers[BENCH_PRODUCERS];
+
+    struct timespec tic;
+    struct timespec toc;
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    for (unsigned i = 0; i < BENCH_PRODUCERS; i++) {
+        producers[i].queue = queue;
+        producers[i].msgs = msgs + (size_t)i * BENCH_MSGS_PER_PRODUCER;
+        pthread_create(&producers[i].thread, NULL, bench_producer, &producers[i]);
+    }
+    unsigned received = 0;
+    while (received < BENCH_MSGS) {
+        struct t_bench_msg *msg = mympd_queue_shift(queue, 0, 0);
+        if (msg == NULL) {
+            continue;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        latencies[received++] = (int64_t)(now.tv_sec - msg->pushed.tv_sec) * 1000000000 + (now.tv_nsec - msg->pushed.tv_nsec);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    for (unsigned i = 0; i < BENCH_PRODUCERS; i++) {
+        pthread_join(producers[i].thread, NULL);
+    }
+    bench_print(name, &tic, &toc, BENCH_MSGS);
+    qsort(latencies, BENCH_MSGS, sizeof(int64_t), cmp_latency);
+    printf("%-40s p50 %10" PRId64 " ns, p99 %10" PRId64 " ns\n", name,
+        latencies[BENCH_MSGS / 2], latencies[BENCH_MSGS / 100 * 99]);
+    FREE_PTR(latencies);
+    FREE_PTR(msgs);
+}
+
+UTEST(benchmark_msg_queue, push_shift) {
+    // the overflow warnings of the ring would dominate the results
+    set_loglevel(LOG_ERR);
+
+    struct t_mympd_queue *list_queue = mympd_queue_create("bench", QUEUE_TYPE_REQUEST, false);
+    bench_queue("linked list: 8 producers", list_queue);
+    ASSERT_EQ(0U, list_queue->length);
+    mympd_queue_free(list_queue);
+
+    struct t_mympd_queue *ring_queue = mympd_queue_create_mpsc("bench", QUEUE_TYPE_REQUEST, MSG_QUEUE_RING_SIZE);
+    bench_queue("mpsc ring: 8 producers", ring_queue);
+    ASSERT_EQ(0U, ring_queue->length);
+    mympd_queue_free(ring_queue);
+
+    set_loglevel(LOG_DEBUG);
+}
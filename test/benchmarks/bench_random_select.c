@@ -0,0 +1,153 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/list.h"
+#include "src/lib/mem.h"
+#include "src/lib/mympd_state.h"
+#include "src/lib/random.h"
+#include "src/lib/sds_extras.h"
+#include "src/lib/song_index.h"
+#include "src/mpd_client/random_select.h"
+
+#include <string.h>
+
+#define BENCH_SONG_COUNT 200000
+#define BENCH_ARTIST_COUNT 20000
+#define BENCH_QUEUE_LEN 500
+#define BENCH_ADD_SONGS 500
+
+/**
+ * Populates the song index with synthetic songs
+ * @param song_index song index to populate
+ */
+static void populate_song_index(struct t_song_index *song_index) {
+    song_index->tags.tags[song_index->tags.len++] = MPD_TAG_ARTIST;
+    song_index->size = BENCH_SONG_COUNT;
+    song_index->songs = malloc_assert(BENCH_SONG_COUNT * sizeof(struct t_song_index_entry));
+    for (unsigned i = 0; i < BENCH_SONG_COUNT; i++) {
+        struct t_song_index_entry *entry = &song_index->songs[song_index->len++];
+        entry->uri = sdscatfmt(sdsempty(), "music/artist %u/album %u/track %u.flac", i % BENCH_ARTIST_COUNT, i / 10, i);
+        entry->duration = 180 + i % 240;
+        entry->last_modified = 1699304451 + (time_t)i;
+        entry->values = malloc_assert(sizeof(sds));
+        entry->values[0] = sdscatfmt(sdsempty(), "Artist %u", i % BENCH_ARTIST_COUNT);
+    }
+}
+
+/**
+ * Uniq check like the random selection did before the radix trees:
+ * both lists are walked for each candidate.
+ */
+static bool legacy_check_uniq(const char *uri, const char *value, struct t_list *queue_list, struct t_list *add_list) {
+    struct t_list *lists[2] = { queue_list, add_list };
+    for (unsigned i = 0; i < 2; i++) {
+        struct t_list_node *current = lists[i]->head;
+        while (current != NULL) {
+            if (strcmp(current->key, uri) == 0 ||
+                strcmp(current->value_p, value) == 0)
+            {
+                return false;
+            }
+            current = current->next;
+        }
+    }
+    return true;
+}
+
+/**
+ * Reservoir sampling like the random selection did before the reservoir array:
+ * the linked list is walked to replace an entry.
+ */
+static unsigned legacy_select(struct t_song_index *song_index, unsigned add_songs, struct t_list *queue_list, struct t_list *add_list) {
+    unsigned lineno = 1;
+    for (unsigned i = 0; i < song_index->len; i++) {
+        const struct t_song_index_entry *entry = &song_index->songs[i];
+        const char *value = entry->values[0];
+        if (legacy_check_uniq(entry->uri, value, queue_list, add_list) == false) {
+            continue;
+        }
+        if (randrange(0, lineno) < add_songs) {
+            if (add_list->length < add_songs) {
+                list_push(add_list, entry->uri, lineno, value, NULL);
+            }
+            else {
+                list_replace(add_list, randrange(0, add_songs), entry->uri, lineno, value, NULL);
+            }
+        }
+        lineno++;
+    }
+    return add_list->length;
+}
+
+UTEST(benchmark_random_select, jukebox_fill) {
+    struct t_song_index song_index;
+    song_index_init(&song_index);
+    populate_song_index(&song_index);
+
+    struct t_mpd_state *mpd_state = malloc_assert(sizeof(struct t_mpd_state));
+    mpd_state_default(mpd_state, NULL);
+    // the selection from the song index needs only the name and the mpd state
+    struct t_partition_state partition_state;
+    partition_state.name = sdsnew("default");
+    partition_state.mpd_state = mpd_state;
+
+    // current queue and last played songs
+    struct t_list queue_list;
+    list_init(&queue_list);
+    for (unsigned i = 0; i < BENCH_QUEUE_LEN; i++) {
+        const struct t_song_index_entry *entry = &song_index.songs[i * 7];
+        list_push(&queue_list, entry->uri, 0, entry->values[0], NULL);
+    }
+
+    struct t_random_add_constraints constraints = {
+        .filter_include = NULL,
+        .filter_exclude = NULL,
+        .uniq_tag = MPD_TAG_ARTIST,
+        .last_played = 0,
+        .ignore_hated = false,
+        .weighting = JUKEBOX_WEIGHTING_OFF,
+        .min_song_duration = 0,
+        .max_song_duration = 0
+    };
+
+    struct timespec tic;
+    struct timespec toc;
+
+    struct t_list add_list;
+    list_init(&add_list);
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    unsigned len = legacy_select(&song_index, BENCH_ADD_SONGS, &queue_list, &add_list);
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("legacy: list walk", &tic, &toc, BENCH_SONG_COUNT);
+    ASSERT_EQ((unsigned)BENCH_ADD_SONGS, len);
+    list_clear(&add_list);
+
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    len = random_select_songs(&partition_state, NULL, &song_index, BENCH_ADD_SONGS, "Database", &queue_list, &add_list, &constraints);
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("radix trees + reservoir array", &tic, &toc, BENCH_SONG_COUNT);
+    ASSERT_EQ((unsigned)BENCH_ADD_SONGS, len);
+    // the uniq constraint must hold
+    struct t_list checked;
+    list_init(&checked);
+    struct t_list_node *current = add_list.head;
+    while (current != NULL) {
+        ASSERT_TRUE(legacy_check_uniq(current->key, current->value_p, &queue_list, &checked));
+        list_push(&checked, current->key, 0, current->value_p, NULL);
+        current = current->next;
+    }
+    list_clear(&checked);
+    list_clear(&add_list);
+
+    list_clear(&queue_list);
+    FREE_SDS(partition_state.name);
+    mpd_state_free(mpd_state);
+    song_index_free(&song_index);
+}
@@ -0,0 +1,160 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/sds_extras.h"
+#include "src/scripts/sandbox.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_SCRIPT_RUNS 2000
+
+/**
+ * A typical trigger script: reads the environment and returns a json string
+ */
+static const char *bench_script =
+    "local result = { partition = mympd_env.partition, arguments = mympd_arguments }\n"
+    "counter = (counter or 0) + 1\n"
+    "return json.encode(result)\n";
+
+/**
+ * Global variables that are set for each run by bench_globals
+ */
+static const char * const run_globals[] = {
+    "mympd_arguments",
+    "mympd_env",
+    NULL
+};
+
+/**
+ * A script run like it is passed to the script worker
+ */
+struct t_bench_run {
+    lua_State *lua_vm;
+    sds bytecode;
+    bool pooled;
+    bool rc;
+};
+
+static int dump_cb(lua_State *lua_vm, const void *p, size_t sz, void *ud) {
+    (void)lua_vm;
+    sds *bytecode = (sds *)ud;
+    *bytecode = sdscatlen(*bytecode, p, sz);
+    return 0;
+}
+
+static lua_State *bench_vm_new(void) {
+    lua_State *lua_vm = luaL_newstate();
+    luaL_openlibs(lua_vm);
+    if (luaL_dofile(lua_vm, MYMPD_SOURCE_DIR"/contrib/lualibs/json.lua") != LUA_OK) {
+        lua_close(lua_vm);
+        return NULL;
+    }
+    lua_settop(lua_vm, 0);
+    return lua_vm;
+}
+
+static void bench_globals(lua_State *lua_vm) {
+    lua_newtable(lua_vm);
+    lua_pushstring(lua_vm, "default");
+    lua_setfield(lua_vm, -2, "partition");
+    lua_setglobal(lua_vm, "mympd_env");
+    lua_newtable(lua_vm);
+    lua_pushstring(lua_vm, "value");
+    lua_setfield(lua_vm, -2, "key");
+    lua_setglobal(lua_vm, "mympd_arguments");
+}
+
+/**
+ * Runs the script like the script worker before the thread pool:
+ * new thread, new lua instance, libraries and byte code loaded for each run
+ */
+static void *bench_run(void *arg) {
+    struct t_bench_run *run = (struct t_bench_run *)arg;
+    lua_State *lua_vm = run->pooled == true
+        ? run->lua_vm
+        : bench_vm_new();
+    run->rc = false;
+    if (lua_vm == NULL) {
+        return NULL;
+    }
+    bench_globals(lua_vm);
+    int rc = run->pooled == true
+        ? lua_sandbox_load(lua_vm, "bench", 1, run->bytecode, sdslen(run->bytecode))
+        : luaL_loadbuffer(lua_vm, run->bytecode, sdslen(run->bytecode), "bench");
+    if (rc == LUA_OK) {
+        if (run->pooled == true) {
+            lua_sandbox_env(lua_vm);
+        }
+        rc = lua_pcall(lua_vm, 0, 1, 0);
+    }
+    run->rc = rc == LUA_OK &&
+        lua_gettop(lua_vm) == 1 &&
+        strncmp(lua_tostring(lua_vm, 1), "{", 1) == 0;
+    if (run->pooled == true) {
+        lua_settop(lua_vm, 0);
+        // the script worker compares the shared state after each run
+        run->rc = run->rc &&
+            lua_sandbox_check(lua_vm);
+    }
+    else {
+        lua_close(lua_vm);
+    }
+    return NULL;
+}
+
+static void bench_print_rate(const char *name, const struct timespec *tic, const struct timespec *toc) {
+    double sec = (double)(toc->tv_sec - tic->tv_sec) + (double)(toc->tv_nsec - tic->tv_nsec) / 1e9;
+    bench_print(name, tic, toc, BENCH_SCRIPT_RUNS);
+    printf("%-40s %10.0f invocations/s\n", name, sec > 0 ? BENCH_SCRIPT_RUNS / sec : 0);
+}
+
+UTEST(benchmark_scripts_pool, script_invocations) {
+    struct t_bench_run run;
+    run.bytecode = sdsempty();
+    run.lua_vm = luaL_newstate();
+    ASSERT_EQ(LUA_OK, luaL_loadstring(run.lua_vm, bench_script));
+    ASSERT_EQ(0, lua_dump(run.lua_vm, dump_cb, &run.bytecode, false));
+    lua_close(run.lua_vm);
+
+    struct timespec tic;
+    struct timespec toc;
+
+    // thread and lua instance per run
+    run.pooled = false;
+    run.lua_vm = NULL;
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    for (unsigned i = 0; i < BENCH_SCRIPT_RUNS; i++) {
+        pthread_t thread;
+        ASSERT_EQ(0, pthread_create(&thread, NULL, bench_run, &run));
+        pthread_join(thread, NULL);
+        ASSERT_TRUE(run.rc);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print_rate("new thread + new lua instance", &tic, &toc);
+
+    // reused lua instance with cached function and per run environment
+    run.pooled = true;
+    run.lua_vm = bench_vm_new();
+    ASSERT_TRUE(run.lua_vm != NULL);
+    lua_sandbox_seal(run.lua_vm, run_globals);
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    for (unsigned i = 0; i < BENCH_SCRIPT_RUNS; i++) {
+        bench_run(&run);
+        ASSERT_TRUE(run.rc);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print_rate("pooled lua instance", &tic, &toc);
+    // globals of the script are not leaked into the lua instance
+    ASSERT_EQ(LUA_TNIL, lua_getglobal(run.lua_vm, "counter"));
+    lua_close(run.lua_vm);
+    FREE_SDS(run.bytecode);
+}
@@ -0,0 +1,150 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "dist/utf8/utf8.h"
+#include "src/lib/cache_rax_album.h"
+#include "src/lib/fields.h"
+#include "src/lib/mem.h"
+#include "src/mpd_client/search_local.h"
+
+#include <mpd/client.h>
+#include <string.h>
+
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+
+#define BENCH_ALBUM_COUNT 100000
+
+/**
+ * Matching like the search expression engine did before the compile step:
+ * both sides are case folded on every comparison and the regex is
+ * interpreted with per call match data.
+ */
+static bool legacy_contains(const struct mpd_song *album, enum mpd_tag_type tag, const char *needle) {
+    const char *value;
+    unsigned i = 0;
+    while ((value = mpd_song_get_tag(album, tag, i)) != NULL) {
+        if (utf8casestr(value, needle) != NULL) {
+            return true;
+        }
+        i++;
+    }
+    return false;
+}
+
+static bool legacy_regex(const struct mpd_song *album, enum mpd_tag_type tag, pcre2_code *re_compiled) {
+    const char *value;
+    unsigned i = 0;
+    while ((value = mpd_song_get_tag(album, tag, i)) != NULL) {
+        char *lower = strdup(value);
+        utf8lwr(lower);
+        pcre2_match_data *match_data = pcre2_match_data_create_from_pattern(re_compiled, NULL);
+        int rc = pcre2_match(re_compiled, (PCRE2_SPTR)lower, strlen(value), 0, 0, match_data, NULL);
+        pcre2_match_data_free(match_data);
+        FREE_PTR(lower);
+        if (rc >= 0) {
+            return true;
+        }
+        i++;
+    }
+    return false;
+}
+
+UTEST(benchmark_search_local, album_filter) {
+    struct mpd_song **albums = malloc_assert(BENCH_ALBUM_COUNT * sizeof(struct mpd_song *));
+    for (unsigned i = 0; i < BENCH_ALBUM_COUNT; i++) {
+        albums[i] = new_album(i);
+    }
+    struct t_tags tags;
+    tags_reset(&tags);
+    tags.tags[tags.len++] = MPD_TAG_ALBUM_ARTIST;
+    tags.tags[tags.len++] = MPD_TAG_ALBUM;
+
+    struct timespec tic;
+    struct timespec toc;
+
+    // legacy evaluation
+    int errornumber;
+    PCRE2_SIZE erroroffset;
+    pcre2_code *re_compiled = pcre2_compile((PCRE2_SPTR)"album 1.*7$", PCRE2_ZERO_TERMINATED, 0, &errornumber, &erroroffset, NULL);
+    ASSERT_TRUE(re_compiled != NULL);
+    unsigned legacy_matches = 0;
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    for (unsigned i = 0; i < BENCH_ALBUM_COUNT; i++) {
+        if (legacy_contains(albums[i], MPD_TAG_ALBUM_ARTIST, "ARTIST 4") == true &&
+            legacy_regex(albums[i], MPD_TAG_ALBUM, re_compiled) == true)
+        {
+            legacy_matches++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("legacy: contains + regex", &tic, &toc, BENCH_ALBUM_COUNT);
+    pcre2_code_free(re_compiled);
+
+    // compiled expression
+    const char *expression = "((AlbumArtist contains 'ARTIST 4') AND (Album =~ 'album 1.*7$'))";
+    unsigned matches = 0;
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    struct t_list *expr_list = parse_search_expression_to_list(expression);
+    for (unsigned i = 0; i < BENCH_ALBUM_COUNT; i++) {
+        if (search_song_expression(albums[i], expr_list, &tags) == true) {
+            matches++;
+        }
+    }
+    free_search_expression_list(expr_list);
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("compiled: contains + regex", &tic, &toc, BENCH_ALBUM_COUNT);
+    ASSERT_EQ(legacy_matches, matches);
+
+    // compiled expression with case folded album cache
+    struct t_cache album_cache;
+    cache_init(&album_cache);
+    album_cache.cache = raxNew();
+    char key[16];
+    for (unsigned i = 0; i < BENCH_ALBUM_COUNT; i++) {
+        int len = snprintf(key, sizeof(key), "%u", i);
+        raxInsert(album_cache.cache, (unsigned char *)key, (size_t)len, albums[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    album_cache_fold_tags(&album_cache);
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("fold album cache tags", &tic, &toc, BENCH_ALBUM_COUNT);
+    matches = 0;
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    expr_list = parse_search_expression_to_list(expression);
+    for (unsigned i = 0; i < BENCH_ALBUM_COUNT; i++) {
+        if (search_album_expression(albums[i], expr_list, &tags, &album_cache) == true) {
+            matches++;
+        }
+    }
+    free_search_expression_list(expr_list);
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("folded: contains + regex", &tic, &toc, BENCH_ALBUM_COUNT);
+    ASSERT_EQ(legacy_matches, matches);
+
+    // any tag
+    matches = 0;
+    clock_gettime(CLOCK_MONOTONIC, &tic);
+    expr_list = parse_search_expression_to_list("((any contains 'album 99'))");
+    for (unsigned i = 0; i < BENCH_ALBUM_COUNT; i++) {
+        if (search_song_expression(albums[i], expr_list, &tags) == true) {
+            matches++;
+        }
+    }
+    free_search_expression_list(expr_list);
+    clock_gettime(CLOCK_MONOTONIC, &toc);
+    bench_print("compiled: any contains", &tic, &toc, BENCH_ALBUM_COUNT);
+    ASSERT_GT(matches, 0U);
+
+    // albums are freed with the album cache
+    album_cache_free(&album_cache);
+    cache_free(&album_cache);
+    FREE_PTR(albums);
+}
@@ -13,11 +13,12 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+//signal handler
+sig_atomic_t s_signal_received;
 //message queues
 struct t_mympd_queue *web_server_queue;
 struct t_mympd_queue *mympd_api_queue;
 struct t_mympd_queue *script_queue;
-struct t_mympd_queue *script_worker_queue;
 
 UTEST_STATE();
 
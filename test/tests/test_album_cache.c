@@ -11,6 +11,7 @@
 #include "dist/utest/utest.h"
 #include "dist/libmympdclient/src/isong.h"
 #include "src/lib/cache_rax_album.h"
+#include "src/lib/fields.h"
 #include "src/mpd_client/tags.h"
 
 #include <mpd/client.h>
@@ -129,3 +130,119 @@ UTEST(album_cache, test_album_cache_inc_song_count) {
 
     mpd_song_free(album);
 }
+
+UTEST(album_cache, test_album_cache_write_read) {
+    init_testenv();
+    struct t_albums_config album_config = {
+        .group_tag = MPD_TAG_DATE,
+        .mode = ALBUM_MODE_ADV
+    };
+    struct t_tags album_tags = {
+        .len = 3,
+        .tags = { MPD_TAG_ARTIST, MPD_TAG_ALBUM_ARTIST, MPD_TAG_ALBUM }
+    };
+    struct t_cache album_cache;
+    cache_init(&album_cache);
+    album_cache.cache = raxNew();
+    struct mpd_song *album = new_song();
+    album_cache_set_song_count(album, 12);
+    album_cache_set_disc_count(album, 2);
+    album_cache_set_total_time(album, 3600);
+    album->duration_ms = 3600456;
+    album->last_modified = 1699304602;
+    album->added = 1699304451;
+    sds key = album_cache_get_key(sdsempty(), album, &album_config);
+    raxInsert(album_cache.cache, (unsigned char *)key, sdslen(key), album, NULL);
+
+    bool rc = album_cache_write(&album_cache, workdir, &album_tags, &album_config, true);
+    ASSERT_TRUE(rc);
+    ASSERT_TRUE(album_cache.cache == NULL);
+
+    rc = album_cache_read(&album_cache, workdir, &album_config);
+    ASSERT_TRUE(rc);
+    ASSERT_EQ((uint64_t)1, album_cache.cache->numele);
+    album = album_cache_get_album(&album_cache, key);
+    ASSERT_TRUE(album != NULL);
+    ASSERT_STREQ("/music/test.mp3", mpd_song_get_uri(album));
+    ASSERT_STREQ("Einstürzende Neubauten", mpd_song_get_tag(album, MPD_TAG_ARTIST, 0));
+    ASSERT_STREQ("Blixa Bargeld", mpd_song_get_tag(album, MPD_TAG_ARTIST, 1));
+    ASSERT_STREQ("Tabula Rasa", mpd_song_get_tag(album, MPD_TAG_ALBUM, 0));
+    ASSERT_TRUE(mpd_song_get_tag(album, MPD_TAG_TITLE, 0) == NULL);
+    ASSERT_EQ((unsigned)12, album_get_song_count(album));
+    ASSERT_EQ((unsigned)2, album_get_discs(album));
+    ASSERT_EQ((unsigned)3600, album_get_total_time(album));
+    ASSERT_EQ((unsigned)3600456, mpd_song_get_duration_ms(album));
+    ASSERT_EQ(1699304602, mpd_song_get_last_modified(album));
+    ASSERT_EQ(1699304451, mpd_song_get_added(album));
+
+    // album mode mismatch invalidates the cache
+    album_cache_free(&album_cache);
+    album_config.mode = ALBUM_MODE_SIMPLE;
+    rc = album_cache_read(&album_cache, workdir, &album_config);
+    ASSERT_FALSE(rc);
+    ASSERT_TRUE(album_cache.cache == NULL);
+
+    album_cache_free(&album_cache);
+    cache_free(&album_cache);
+    sdsfree(key);
+    clean_testenv();
+}
+
+UTEST(album_cache, test_album_cache_index) {
+    struct t_cache album_cache;
+    cache_init(&album_cache);
+    album_cache.cache = raxNew();
+    const char *names[] = {"Blue", "alpha", "Charlie"};
+    const char *uris[] = {"/music/1.mp3", "/music/2.mp3", "/music/3.mp3"};
+    for (int i = 0; i < 3; i++) {
+        struct mpd_song *album = new_song();
+        free(album->tags[MPD_TAG_ALBUM].value);
+        album->tags[MPD_TAG_ALBUM].value = strdup(names[i]);
+        album_cache_set_uri(album, uris[i]);
+        album->added = 1000 - i;
+        raxInsert(album_cache.cache, (unsigned char *)uris[i], strlen(uris[i]), album, NULL);
+    }
+    struct t_album_cache_index album_index;
+    album_cache_index_init(&album_index);
+
+    const struct t_album_cache_sorted *sorted = album_cache_index_get(&album_index, &album_cache, SORT_BY_TAG, MPD_TAG_ALBUM);
+    ASSERT_TRUE(sorted != NULL);
+    ASSERT_EQ((size_t)3, sorted->len);
+    ASSERT_STREQ("alpha", mpd_song_get_tag(sorted->albums[0], MPD_TAG_ALBUM, 0));
+    ASSERT_STREQ("Blue", mpd_song_get_tag(sorted->albums[1], MPD_TAG_ALBUM, 0));
+    ASSERT_STREQ("Charlie", mpd_song_get_tag(sorted->albums[2], MPD_TAG_ALBUM, 0));
+    // the index is reused
+    ASSERT_TRUE(sorted == album_cache_index_get(&album_index, &album_cache, SORT_BY_TAG, MPD_TAG_ALBUM));
+
+    sorted = album_cache_index_get(&album_index, &album_cache, SORT_BY_ADDED, MPD_TAG_UNKNOWN);
+    ASSERT_TRUE(sorted != NULL);
+    ASSERT_STREQ("/music/3.mp3", mpd_song_get_uri(sorted->albums[0]));
+    ASSERT_STREQ("/music/1.mp3", mpd_song_get_uri(sorted->albums[2]));
+
+    ASSERT_TRUE(album_cache_index_get(&album_index, &album_cache, SORT_BY_FILENAME, MPD_TAG_UNKNOWN) == NULL);
+
+    album_cache_index_clear(&album_index);
+    album_cache_free(&album_cache);
+    cache_free(&album_cache);
+}
+
+UTEST(album_cache, test_album_cache_fold_tags) {
+    struct t_cache album_cache;
+    cache_init(&album_cache);
+    album_cache.cache = raxNew();
+    struct mpd_song *album = new_song();
+    raxInsert(album_cache.cache, (unsigned char *)"1", 1, album, NULL);
+    ASSERT_TRUE(album_cache_get_folded(&album_cache, mpd_song_get_tag(album, MPD_TAG_ARTIST, 0)) == NULL);
+
+    album_cache_fold_tags(&album_cache);
+    ASSERT_TRUE(album_cache.folded);
+    // the original values are unchanged
+    ASSERT_STREQ("Einstürzende Neubauten", mpd_song_get_tag(album, MPD_TAG_ARTIST, 0));
+    ASSERT_STREQ("einstürzende neubauten", album_cache_get_folded(&album_cache, mpd_song_get_tag(album, MPD_TAG_ARTIST, 0)));
+    ASSERT_STREQ("blixa bargeld", album_cache_get_folded(&album_cache, mpd_song_get_tag(album, MPD_TAG_ARTIST, 1)));
+    ASSERT_STREQ("tabula rasa", album_cache_get_folded(&album_cache, mpd_song_get_tag(album, MPD_TAG_ALBUM, 0)));
+
+    album_cache_free(&album_cache);
+    ASSERT_FALSE(album_cache.folded);
+    cache_free(&album_cache);
+}
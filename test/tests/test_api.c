@@ -9,6 +9,8 @@
 
 #include "dist/utest/utest.h"
 #include "src/lib/api.h"
+#include "src/lib/msg_queue.h"
+#include "src/lib/sds_extras.h"
 
 UTEST(api, test_get_cmd_id) {
     enum mympd_cmd_ids cmd_id = get_cmd_id("MYMPD_API_VIEW_SAVE");
@@ -59,3 +61,104 @@ UTEST(api, test_request_result) {
     free_request(request);
     free_response(response);
 }
+
+UTEST(api, test_response_stream) {
+    web_server_queue = mympd_queue_create("test_web_server_queue", QUEUE_TYPE_RESPONSE, false);
+    struct t_work_response *response = create_response_new(RESPONSE_TYPE_DEFAULT, 1, 1, MYMPD_API_QUEUE_SEARCH, MPD_PARTITION_DEFAULT);
+
+    // below the chunk size nothing is sent
+    response->data = sdscatlen(response->data, "[", 1);
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_EQ(0U, web_server_queue->length);
+    ASSERT_EQ(0U, response->chunks);
+    response->data = response_stream_abort(response, response->data);
+    ASSERT_EQ(1U, (unsigned)sdslen(response->data));
+
+    // the buffer is handed over to the webserver
+    while (sdslen(response->data) < JSONRPC_CHUNK_SIZE) {
+        response->data = sdscat(response->data, "\"test\",");
+    }
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_EQ(1U, web_server_queue->length);
+    ASSERT_EQ(1U, response->chunks);
+    ASSERT_EQ(0U, (unsigned)sdslen(response->data));
+    struct t_work_response *chunk = mympd_queue_shift(web_server_queue, 50, 0);
+    ASSERT_TRUE(chunk->type == RESPONSE_TYPE_CHUNK);
+    ASSERT_EQ(response->conn_id, chunk->conn_id);
+    ASSERT_EQ('[', chunk->data[0]);
+    ASSERT_TRUE(chunk->window == response->window);
+    free_response(chunk);
+
+    // the connection is gone, the remaining parts are dropped
+    stream_window_abort(response->window);
+    response->data = sdsgrowzero(response->data, JSONRPC_CHUNK_SIZE);
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_EQ(0U, web_server_queue->length);
+    ASSERT_EQ(1U, response->chunks);
+    ASSERT_EQ(0U, (unsigned)sdslen(response->data));
+    ASSERT_TRUE(stream_window_is_aborted(response->window));
+
+    // an error can not be appended to the already sent parts
+    response->data = sdscat(response->data, "error");
+    response->data = response_stream_abort(response, response->data);
+    ASSERT_EQ(0U, (unsigned)sdslen(response->data));
+    free_response(response);
+
+    // script responses are not streamed
+    response = create_response_new(RESPONSE_TYPE_SCRIPT, 0, 1, MYMPD_API_QUEUE_SEARCH, MPD_PARTITION_DEFAULT);
+    response->data = sdsgrowzero(response->data, JSONRPC_CHUNK_SIZE);
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_EQ(0U, web_server_queue->length);
+    ASSERT_EQ((unsigned)JSONRPC_CHUNK_SIZE, (unsigned)sdslen(response->data));
+    free_response(response);
+
+    mympd_queue_free(web_server_queue);
+    web_server_queue = NULL;
+}
+
+UTEST(api, test_response_stream_window) {
+    web_server_queue = mympd_queue_create("test_web_server_queue", QUEUE_TYPE_RESPONSE, false);
+    struct t_work_response *response = create_response_new(RESPONSE_TYPE_DEFAULT, 1, 1, MYMPD_API_QUEUE_SEARCH, MPD_PARTITION_DEFAULT);
+    response->data = sdsgrowzero(response->data, JSONRPC_CHUNK_SIZE);
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_EQ(1U, response->chunks);
+    struct t_work_response *chunk = mympd_queue_shift(web_server_queue, 50, 0);
+    free_response(chunk);
+
+    // the client is behind, the mympd_api thread keeps the part and does not wait
+    stream_window_sent(response->window, JSONRPC_CHUNK_SIZE, JSONRPC_STREAM_WINDOW + 1);
+    time_t start = time(NULL);
+    response->data = sdsgrowzero(response->data, JSONRPC_CHUNK_SIZE);
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_TRUE(time(NULL) - start < 1);
+    ASSERT_EQ(0U, web_server_queue->length);
+    ASSERT_EQ(1U, response->chunks);
+    ASSERT_EQ((unsigned)JSONRPC_CHUNK_SIZE, (unsigned)sdslen(response->data));
+    ASSERT_FALSE(stream_window_is_aborted(response->window));
+
+    // the client has received the data, the kept part is sent
+    stream_window_sent(response->window, 0, 0);
+    response->data = sdscat(response->data, "\"test\"");
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_EQ(1U, web_server_queue->length);
+    ASSERT_EQ(2U, response->chunks);
+    ASSERT_EQ(0U, (unsigned)sdslen(response->data));
+    chunk = mympd_queue_shift(web_server_queue, 50, 0);
+    ASSERT_EQ((unsigned)JSONRPC_CHUNK_SIZE + 6, (unsigned)sdslen(chunk->data));
+    free_response(chunk);
+
+    // a worker thread waits for the client and aborts if it stalls
+    response->stream_wait = true;
+    response->window->stall_timeout = 1;
+    stream_window_sent(response->window, 0, JSONRPC_STREAM_WINDOW + 1);
+    response->data = sdsgrowzero(response->data, JSONRPC_CHUNK_SIZE);
+    response->data = response_stream_flush(response, response->data);
+    ASSERT_EQ(0U, web_server_queue->length);
+    ASSERT_EQ(2U, response->chunks);
+    ASSERT_EQ(0U, (unsigned)sdslen(response->data));
+    ASSERT_TRUE(stream_window_is_aborted(response->window));
+    free_response(response);
+
+    mympd_queue_free(web_server_queue);
+    web_server_queue = NULL;
+}
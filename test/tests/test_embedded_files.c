@@ -0,0 +1,127 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#ifdef MYMPD_EMBEDDED_ASSETS
+
+#include "dist/utest/utest.h"
+#include "src/lib/mem.h"
+#include "src/lib/sds_extras.h"
+#include "src/web_server/utility.h"
+
+#include <string.h>
+
+static struct mg_connection *serve(const char *request) {
+    struct mg_connection *nc = malloc_assert(sizeof(struct mg_connection));
+    memset(nc, 0, sizeof(struct mg_connection));
+    struct mg_http_message hm;
+    mg_http_parse(request, strlen(request), &hm);
+    sds uri = sdsnewlen(hm.uri.buf, hm.uri.len);
+    webserver_serve_embedded_files(nc, &hm, uri);
+    FREE_SDS(uri);
+    return nc;
+}
+
+static void free_conn(struct mg_connection *nc) {
+    mg_iobuf_free(&nc->send);
+    FREE_PTR(nc);
+}
+
+static sds get_header(struct mg_connection *nc, const char *name) {
+    struct mg_http_message hm;
+    if (mg_http_parse((const char *)nc->send.buf, nc->send.len, &hm) <= 0) {
+        return NULL;
+    }
+    struct mg_str *value = mg_http_get_header(&hm, name);
+    return value == NULL
+        ? NULL
+        : sdsnewlen(value->buf, value->len);
+}
+
+static bool is_status(struct mg_connection *nc, const char *status) {
+    return nc->send.len > 12 &&
+        strncmp((const char *)nc->send.buf + 9, status, 3) == 0;
+}
+
+UTEST(embedded_files, test_lookup) {
+    const char *uris[] = {"/", "/assets/MaterialIcons-Regular.woff2", "/assets/i18n/en-US.json",
+        "/assets/mympd-background-light.svg", "/js/combined.js", "/sw.js", NULL};
+    for (const char **p = uris; *p != NULL; p++) {
+        sds request = sdscatfmt(sdsempty(), "GET %s HTTP/1.1\r\n\r\n", *p);
+        struct mg_connection *nc = serve(request);
+        ASSERT_TRUE(is_status(nc, "200"));
+        sds etag = get_header(nc, "ETag");
+        ASSERT_TRUE(etag != NULL);
+        ASSERT_EQ('"', etag[0]);
+        FREE_SDS(etag);
+        FREE_SDS(request);
+        free_conn(nc);
+    }
+    struct mg_connection *nc = serve("GET /assets/unknown.svg HTTP/1.1\r\n\r\n");
+    ASSERT_TRUE(is_status(nc, "404"));
+    free_conn(nc);
+}
+
+UTEST(embedded_files, test_conditional) {
+    struct mg_connection *nc = serve("GET /assets/coverimage-stream.svg HTTP/1.1\r\n\r\n");
+    sds etag = get_header(nc, "ETag");
+    ASSERT_TRUE(etag != NULL);
+    free_conn(nc);
+
+    sds request = sdscatfmt(sdsempty(), "GET /assets/coverimage-stream.svg HTTP/1.1\r\n"
+        "If-None-Match: \"other\", W/%S\r\n\r\n", etag);
+    nc = serve(request);
+    ASSERT_TRUE(is_status(nc, "304"));
+    sds etag2 = get_header(nc, "ETag");
+    ASSERT_STREQ(etag, etag2);
+    FREE_SDS(etag2);
+    free_conn(nc);
+
+    nc = serve("GET /assets/coverimage-stream.svg HTTP/1.1\r\nIf-None-Match: \"other\"\r\n\r\n");
+    ASSERT_TRUE(is_status(nc, "200"));
+    free_conn(nc);
+
+    FREE_SDS(request);
+    FREE_SDS(etag);
+}
+
+UTEST(embedded_files, test_encoding) {
+    // gzip is the default
+    struct mg_connection *nc = serve("GET /js/combined.js HTTP/1.1\r\n\r\n");
+    sds encoding = get_header(nc, "Content-Encoding");
+    ASSERT_STREQ("gzip", encoding);
+    FREE_SDS(encoding);
+    sds vary = get_header(nc, "Vary");
+    sds cache_control = get_header(nc, "Cache-Control");
+    ASSERT_STREQ("no-cache", cache_control);
+    FREE_SDS(cache_control);
+    free_conn(nc);
+    #ifdef MYMPD_EMBEDDED_ZSTD
+        ASSERT_STREQ("Accept-Encoding", vary);
+        nc = serve("GET /js/combined.js HTTP/1.1\r\nAccept-Encoding: gzip, zstd\r\n\r\n");
+        encoding = get_header(nc, "Content-Encoding");
+        ASSERT_STREQ("zstd", encoding);
+        FREE_SDS(encoding);
+        free_conn(nc);
+
+        nc = serve("GET /js/combined.js HTTP/1.1\r\nAccept-Encoding: gzip, zstd;q=0\r\n\r\n");
+        encoding = get_header(nc, "Content-Encoding");
+        ASSERT_STREQ("gzip", encoding);
+        FREE_SDS(encoding);
+        free_conn(nc);
+    #endif
+    FREE_SDS(vary);
+
+    // uncompressed asset
+    nc = serve("GET /assets/appicon-192.png HTTP/1.1\r\nAccept-Encoding: gzip, br, zstd\r\n\r\n");
+    encoding = get_header(nc, "Content-Encoding");
+    ASSERT_TRUE(encoding == NULL);
+    free_conn(nc);
+}
+
+#endif
@@ -117,6 +117,31 @@ UTEST(filehandler, test_sds_getfile) {
     clean_testenv();
 }
 
+UTEST(filehandler, test_sds_getfile_binary) {
+    init_testenv();
+
+    create_testfile();
+
+    // content is not trimmed
+    int nread = 0;
+    sds data = sds_getfile_binary(sdsempty(), "/tmp/mympd-test/state/test", 1000, &nread);
+    ASSERT_EQ(nread, (int)strlen(TESTFILE_CONTENT"\n"));
+    ASSERT_STREQ(data, TESTFILE_CONTENT"\n");
+
+    // too big
+    nread = 0;
+    data = sds_getfile_binary(data, "/tmp/mympd-test/state/test", 5, &nread);
+    ASSERT_EQ(nread, -2);
+    ASSERT_EQ(0U, sdslen(data));
+
+    // not existing
+    data = sds_getfile_binary(data, "/tmp/mympd-test/state/notexisting", 1000, &nread);
+    ASSERT_EQ(nread, -1);
+    sdsfree(data);
+
+    clean_testenv();
+}
+
 UTEST(filehandler, test_sds_getline) {
     init_testenv();
 
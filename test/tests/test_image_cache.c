@@ -0,0 +1,96 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/sds_extras.h"
+#include "src/web_server/image_cache.h"
+
+static struct t_image_cache_entry *put_image(struct t_image_cache *cache, const char *uri, size_t len) {
+    sds s_uri = sdsnew(uri);
+    sds data = sdsgrowzero(sdsempty(), len);
+    struct t_image_cache_entry *entry = image_cache_put(cache, DIR_CACHE_COVER, s_uri, 0, false, data, "image/jpeg", "\"1.100\"");
+    sdsfree(s_uri);
+    return entry;
+}
+
+static struct t_image_cache_entry *get_image(struct t_image_cache *cache, const char *uri, bool thumbnail) {
+    sds s_uri = sdsnew(uri);
+    struct t_image_cache_entry *entry = image_cache_get(cache, DIR_CACHE_COVER, s_uri, 0, thumbnail);
+    sdsfree(s_uri);
+    return entry;
+}
+
+UTEST(image_cache, test_get_put) {
+    struct t_image_cache cache;
+    image_cache_init(&cache, 1000);
+    ASSERT_EQ(250U, image_cache_entry_max(&cache));
+    ASSERT_TRUE(get_image(&cache, "a.mp3", false) == NULL);
+    put_image(&cache, "a.mp3", 100);
+    struct t_image_cache_entry *entry = get_image(&cache, "a.mp3", false);
+    ASSERT_TRUE(entry != NULL);
+    ASSERT_EQ(100U, sdslen(entry->data));
+    ASSERT_STREQ("image/jpeg", entry->mime_type);
+    ASSERT_STREQ("\"1.100\"", entry->etag);
+    // the size is part of the key
+    ASSERT_TRUE(get_image(&cache, "a.mp3", true) == NULL);
+    ASSERT_EQ(1LU, cache.hits);
+    ASSERT_EQ(2LU, cache.misses);
+
+    // replace
+    put_image(&cache, "a.mp3", 200);
+    ASSERT_EQ(200U, cache.size);
+    ASSERT_EQ(1U, (unsigned)raxSize(cache.index));
+    image_cache_clear(&cache);
+}
+
+UTEST(image_cache, test_lru) {
+    struct t_image_cache cache;
+    image_cache_init(&cache, 1000);
+    put_image(&cache, "a.mp3", 250);
+    put_image(&cache, "b.mp3", 250);
+    put_image(&cache, "c.mp3", 250);
+    put_image(&cache, "d.mp3", 250);
+    ASSERT_EQ(1000U, cache.size);
+    // a is now the most recently used entry
+    ASSERT_TRUE(get_image(&cache, "a.mp3", false) != NULL);
+    // evicts b
+    put_image(&cache, "e.mp3", 250);
+    ASSERT_EQ(1000U, cache.size);
+    ASSERT_TRUE(get_image(&cache, "b.mp3", false) == NULL);
+    ASSERT_TRUE(get_image(&cache, "a.mp3", false) != NULL);
+    ASSERT_TRUE(get_image(&cache, "c.mp3", false) != NULL);
+    // evicts d and e
+    put_image(&cache, "f.mp3", 250);
+    put_image(&cache, "g.mp3", 250);
+    ASSERT_TRUE(get_image(&cache, "d.mp3", false) == NULL);
+    ASSERT_TRUE(get_image(&cache, "e.mp3", false) == NULL);
+    ASSERT_EQ(4U, (unsigned)raxSize(cache.index));
+    image_cache_clear(&cache);
+}
+
+UTEST(image_cache, test_sync) {
+    struct t_image_cache cache;
+    image_cache_init(&cache, 1000);
+    put_image(&cache, "a.mp3", 100);
+    image_cache_sync(&cache, 0);
+    ASSERT_TRUE(get_image(&cache, "a.mp3", false) != NULL);
+    // the disk caches were cropped
+    image_cache_sync(&cache, 1);
+    ASSERT_TRUE(get_image(&cache, "a.mp3", false) == NULL);
+    ASSERT_EQ(0U, cache.size);
+    image_cache_clear(&cache);
+}
+
+UTEST(image_cache, test_disabled) {
+    struct t_image_cache cache;
+    image_cache_init(&cache, 0);
+    ASSERT_EQ(0U, image_cache_entry_max(&cache));
+    ASSERT_TRUE(get_image(&cache, "a.mp3", false) == NULL);
+    image_cache_clear(&cache);
+}
@@ -84,9 +84,15 @@ UTEST(m3u, test_get_webradio_from_uri) {
     init_testenv();
     webradio_save();
 
-    sds m3u = get_webradio_from_uri(workdir, "http://yumicoradio.net:8000/stream");
+    struct t_webradio_favorites favorites;
+    webradio_favorites_init(&favorites, workdir);
+    sds m3u = get_webradio_from_uri(&favorites, "http://yumicoradio.net:8000/stream");
     ASSERT_GT(sdslen(m3u), (size_t)0);
     sdsfree(m3u);
+    m3u = get_webradio_from_uri(&favorites, "http://unknown.net/stream");
+    ASSERT_EQ((size_t)0, sdslen(m3u));
+    sdsfree(m3u);
+    webradio_favorites_clear(&favorites);
 
     clean_testenv();
 }
@@ -95,8 +101,10 @@ UTEST(m3u, test_mympd_api_webradio_list) {
     init_testenv();
     webradio_save();
 
+    struct t_webradio_favorites favorites;
+    webradio_favorites_init(&favorites, workdir);
     sds searchstr = sdsempty();
-    sds buffer = mympd_api_webradio_list(workdir, sdsempty(), 0, searchstr, 0, 10);
+    sds buffer = mympd_api_webradio_list(&favorites, sdsempty(), 0, searchstr, 0, 10);
     struct t_jsonrpc_parse_error parse_error;
     jsonrpc_parse_error_init(&parse_error);
     int result;
@@ -104,8 +112,42 @@ UTEST(m3u, test_mympd_api_webradio_list) {
     ASSERT_TRUE(rc);
     ASSERT_EQ(result, 1);
     jsonrpc_parse_error_clear(&parse_error);
+
+    // search is case insensitive
+    searchstr = sdscat(searchstr, "City POP");
+    sdsclear(buffer);
+    buffer = mympd_api_webradio_list(&favorites, buffer, 0, searchstr, 0, 10);
+    rc = json_get_int_max(buffer, "$.result.totalEntities", &result, &parse_error);
+    ASSERT_TRUE(rc);
+    ASSERT_EQ(result, 1);
+    jsonrpc_parse_error_clear(&parse_error);
+    sdsclear(searchstr);
+    searchstr = sdscat(searchstr, "jazz");
+    sdsclear(buffer);
+    buffer = mympd_api_webradio_list(&favorites, buffer, 0, searchstr, 0, 10);
+    rc = json_get_int_max(buffer, "$.result.totalEntities", &result, &parse_error);
+    ASSERT_TRUE(rc);
+    ASSERT_EQ(result, 0);
+    jsonrpc_parse_error_clear(&parse_error);
+
+    // the index is reloaded after a change of the directory
+    struct t_list filenames;
+    list_init(&filenames);
+    list_push(&filenames, "http___yumicoradio_net_8000_stream.m3u", 0, NULL, NULL);
+    rc = mympd_api_webradio_delete(workdir, &filenames);
+    list_clear(&filenames);
+    ASSERT_TRUE(rc);
+    sdsclear(searchstr);
+    sdsclear(buffer);
+    buffer = mympd_api_webradio_list(&favorites, buffer, 0, searchstr, 0, 10);
+    rc = json_get_int_max(buffer, "$.result.totalEntities", &result, &parse_error);
+    ASSERT_TRUE(rc);
+    ASSERT_EQ(result, 0);
+    jsonrpc_parse_error_clear(&parse_error);
+
     sdsfree(searchstr);
     sdsfree(buffer);
+    webradio_favorites_clear(&favorites);
 
     clean_testenv();
 }
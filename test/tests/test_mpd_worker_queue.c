@@ -0,0 +1,178 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/api.h"
+#include "src/mpd_worker/job_queue.h"
+
+static struct t_mpd_worker_job *new_job(enum mympd_cmd_ids cmd_id, enum mpd_worker_job_prio prio, const char *key) {
+    return mpd_worker_job_new(cmd_id, "default", prio, key, NULL);
+}
+
+UTEST(mpd_worker_queue, test_prio) {
+    struct t_mpd_worker_queue queue;
+    mpd_worker_queue_init(&queue, 10);
+    struct t_mpd_worker_job *low = new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_LOW, NULL);
+    struct t_mpd_worker_job *normal = new_job(MYMPD_API_SMARTPLS_UPDATE, MPD_WORKER_PRIO_NORMAL, NULL);
+    struct t_mpd_worker_job *high = new_job(INTERNAL_API_JUKEBOX_REFILL, MPD_WORKER_PRIO_HIGH, NULL);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, low) == MPD_WORKER_QUEUE_ADDED);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, normal) == MPD_WORKER_QUEUE_ADDED);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, high) == MPD_WORKER_QUEUE_ADDED);
+    ASSERT_EQ(1U, low->id);
+    ASSERT_EQ(3U, high->id);
+
+    struct t_mpd_worker_job *job = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(job == high);
+    ASSERT_EQ(1U, queue.running.length);
+    mpd_worker_queue_done(&queue, job);
+    ASSERT_EQ(0U, queue.running.length);
+    mpd_worker_job_free(job);
+
+    job = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(job == normal);
+    mpd_worker_queue_done(&queue, job);
+    mpd_worker_job_free(job);
+
+    job = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(job == low);
+    mpd_worker_queue_done(&queue, job);
+    mpd_worker_job_free(job);
+
+    mpd_worker_queue_clear(&queue);
+}
+
+UTEST(mpd_worker_queue, test_dedup) {
+    struct t_mpd_worker_queue queue;
+    mpd_worker_queue_init(&queue, 10);
+    struct t_mpd_worker_job *job1 = new_job(MYMPD_API_SMARTPLS_UPDATE, MPD_WORKER_PRIO_NORMAL, "key1");
+    struct t_mpd_worker_job *job2 = new_job(MYMPD_API_SMARTPLS_UPDATE, MPD_WORKER_PRIO_NORMAL, "key1");
+    struct t_mpd_worker_job *job3 = new_job(MYMPD_API_SMARTPLS_UPDATE, MPD_WORKER_PRIO_NORMAL, "key2");
+    struct t_mpd_worker_job *job4 = new_job(MYMPD_API_SMARTPLS_UPDATE, MPD_WORKER_PRIO_NORMAL, NULL);
+    struct t_mpd_worker_job *job5 = new_job(MYMPD_API_SMARTPLS_UPDATE, MPD_WORKER_PRIO_NORMAL, NULL);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job1) == MPD_WORKER_QUEUE_ADDED);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job2) == MPD_WORKER_QUEUE_DUPLICATE);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job3) == MPD_WORKER_QUEUE_ADDED);
+    // empty keys are never deduplicated
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job4) == MPD_WORKER_QUEUE_ADDED);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job5) == MPD_WORKER_QUEUE_ADDED);
+    mpd_worker_job_free(job2);
+
+    // running jobs do not block a new job with the same key
+    struct t_mpd_worker_job *job = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(job == job1);
+    job2 = new_job(MYMPD_API_SMARTPLS_UPDATE, MPD_WORKER_PRIO_NORMAL, "key1");
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job2) == MPD_WORKER_QUEUE_ADDED);
+    mpd_worker_queue_done(&queue, job);
+    mpd_worker_job_free(job);
+
+    mpd_worker_queue_clear(&queue);
+}
+
+UTEST(mpd_worker_queue, test_full) {
+    struct t_mpd_worker_queue queue;
+    mpd_worker_queue_init(&queue, 2);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_LOW, NULL)) == MPD_WORKER_QUEUE_ADDED);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_HIGH, NULL)) == MPD_WORKER_QUEUE_ADDED);
+    struct t_mpd_worker_job *job = new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_NORMAL, NULL);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job) == MPD_WORKER_QUEUE_FULL);
+    mpd_worker_job_free(job);
+    mpd_worker_queue_clear(&queue);
+}
+
+UTEST(mpd_worker_queue, test_cancel) {
+    struct t_mpd_worker_queue queue;
+    mpd_worker_queue_init(&queue, 10);
+    struct t_mpd_worker_job *job1 = new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_LOW, NULL);
+    struct t_mpd_worker_job *job2 = new_job(MYMPD_API_SMARTPLS_UPDATE_ALL, MPD_WORKER_PRIO_LOW, NULL);
+    mpd_worker_queue_push(&queue, job1);
+    mpd_worker_queue_push(&queue, job2);
+
+    struct t_mpd_worker_job *running = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(running == job1);
+
+    struct t_mpd_worker_job *canceled = NULL;
+    ASSERT_TRUE(mpd_worker_queue_cancel(&queue, 100, &canceled) == MPD_WORKER_CANCEL_NOT_FOUND);
+    ASSERT_TRUE(canceled == NULL);
+
+    ASSERT_TRUE(mpd_worker_queue_cancel(&queue, job2->id, &canceled) == MPD_WORKER_CANCEL_PENDING);
+    ASSERT_TRUE(canceled == job2);
+    ASSERT_EQ(0U, queue.pending[MPD_WORKER_PRIO_LOW].length);
+    mpd_worker_job_free(canceled);
+
+    ASSERT_TRUE(mpd_worker_queue_cancel(&queue, job1->id, &canceled) == MPD_WORKER_CANCEL_RUNNING);
+    ASSERT_TRUE(canceled == NULL);
+    ASSERT_TRUE(running->canceled);
+    mpd_worker_queue_done(&queue, running);
+    mpd_worker_job_free(running);
+
+    mpd_worker_queue_clear(&queue);
+}
+
+UTEST(mpd_worker_queue, test_stop) {
+    struct t_mpd_worker_queue queue;
+    mpd_worker_queue_init(&queue, 10);
+    struct t_mpd_worker_job *job1 = new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_LOW, NULL);
+    struct t_mpd_worker_job *job2 = new_job(MYMPD_API_SMARTPLS_UPDATE_ALL, MPD_WORKER_PRIO_LOW, NULL);
+    mpd_worker_queue_push(&queue, job1);
+    mpd_worker_queue_push(&queue, job2);
+    struct t_mpd_worker_job *running = mpd_worker_queue_shift(&queue);
+
+    mpd_worker_queue_stop(&queue);
+    ASSERT_TRUE(running->canceled);
+    ASSERT_TRUE(mpd_worker_queue_shift(&queue) == NULL);
+    struct t_mpd_worker_job *job3 = new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_LOW, NULL);
+    ASSERT_TRUE(mpd_worker_queue_push(&queue, job3) == MPD_WORKER_QUEUE_STOPPED);
+    mpd_worker_job_free(job3);
+
+    mpd_worker_queue_done(&queue, running);
+    mpd_worker_job_free(running);
+    // frees the pending job2
+    mpd_worker_queue_clear(&queue);
+}
+
+UTEST(mpd_worker_queue, test_low_running_max) {
+    struct t_mpd_worker_queue queue;
+    mpd_worker_queue_init(&queue, 10);
+    queue.low_running_max = 2;
+    struct t_mpd_worker_job *low1 = new_job(MYMPD_API_CACHES_CREATE, MPD_WORKER_PRIO_LOW, NULL);
+    struct t_mpd_worker_job *low2 = new_job(MYMPD_API_SMARTPLS_UPDATE_ALL, MPD_WORKER_PRIO_LOW, NULL);
+    struct t_mpd_worker_job *low3 = new_job(MYMPD_API_CACHE_DISK_CROP, MPD_WORKER_PRIO_LOW, NULL);
+    struct t_mpd_worker_job *normal = new_job(MYMPD_API_DATABASE_SEARCH, MPD_WORKER_PRIO_NORMAL, NULL);
+    mpd_worker_queue_push(&queue, low1);
+    mpd_worker_queue_push(&queue, low2);
+    mpd_worker_queue_push(&queue, low3);
+
+    struct t_mpd_worker_job *running1 = mpd_worker_queue_shift(&queue);
+    struct t_mpd_worker_job *running2 = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(running1 == low1);
+    ASSERT_TRUE(running2 == low2);
+    ASSERT_EQ(2U, queue.low_running);
+
+    // the remaining thread is reserved for the interactive request
+    mpd_worker_queue_push(&queue, normal);
+    struct t_mpd_worker_job *running3 = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(running3 == normal);
+    ASSERT_EQ(1U, queue.pending[MPD_WORKER_PRIO_LOW].length);
+    mpd_worker_queue_done(&queue, running3);
+    mpd_worker_job_free(running3);
+
+    // a finished low priority job releases its slot
+    mpd_worker_queue_done(&queue, running1);
+    mpd_worker_job_free(running1);
+    ASSERT_EQ(1U, queue.low_running);
+    running1 = mpd_worker_queue_shift(&queue);
+    ASSERT_TRUE(running1 == low3);
+
+    mpd_worker_queue_done(&queue, running1);
+    mpd_worker_job_free(running1);
+    mpd_worker_queue_done(&queue, running2);
+    mpd_worker_job_free(running2);
+    ASSERT_EQ(0U, queue.low_running);
+    mpd_worker_queue_clear(&queue);
+}
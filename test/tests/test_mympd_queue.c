@@ -129,3 +129,93 @@ UTEST(mympd_queue, event) {
     ASSERT_TRUE(rc);
     mympd_queue_free(test_queue);
 }
+
+UTEST(mympd_queue, mpsc_push_shift) {
+    struct t_mympd_queue *test_queue = mympd_queue_create_mpsc("test", QUEUE_TYPE_REQUEST, 4);
+    sds test_data[6];
+    for (int i = 0; i < 6; i++) {
+        test_data[i] = sdscatfmt(sdsempty(), "test%i", i);
+        // the ring has 4 slots, the last two entries are stored in the overflow list
+        ASSERT_TRUE(mympd_queue_push(test_queue, test_data[i], 0));
+    }
+    ASSERT_EQ(2U, test_queue->length);
+    // only the first push writes the eventfd
+    ASSERT_TRUE(event_eventfd_read(test_queue->event_fd));
+
+    for (int i = 0; i < 6; i++) {
+        sds test_data_out = mympd_queue_shift(test_queue, 50, 0);
+        ASSERT_STREQ(test_data[i], test_data_out);
+    }
+    ASSERT_EQ(0U, test_queue->length);
+    ASSERT_TRUE(mympd_queue_shift(test_queue, -1, 0) == NULL);
+    // timeout
+    ASSERT_TRUE(mympd_queue_shift(test_queue, 10, 0) == NULL);
+
+    mympd_queue_free(test_queue);
+    for (int i = 0; i < 6; i++) {
+        sdsfree(test_data[i]);
+    }
+}
+
+UTEST(mympd_queue, mpsc_overflow_order) {
+    struct t_mympd_queue *test_queue = mympd_queue_create_mpsc("test", QUEUE_TYPE_REQUEST, 4);
+    sds test_data[8];
+    for (int i = 0; i < 8; i++) {
+        test_data[i] = sdscatfmt(sdsempty(), "test%i", i);
+    }
+    for (int i = 0; i < 6; i++) {
+        ASSERT_TRUE(mympd_queue_push(test_queue, test_data[i], 0));
+    }
+    ASSERT_EQ(2U, test_queue->length);
+    // the ring has room again, but the overflow list is not empty
+    sds test_data_out = mympd_queue_shift(test_queue, 50, 0);
+    ASSERT_STREQ(test_data[0], test_data_out);
+    ASSERT_TRUE(mympd_queue_push(test_queue, test_data[6], 0));
+    ASSERT_EQ(3U, test_queue->length);
+    for (int i = 1; i < 7; i++) {
+        test_data_out = mympd_queue_shift(test_queue, 50, 0);
+        ASSERT_STREQ(test_data[i], test_data_out);
+    }
+    // the overflow list is drained, the ring is used again
+    ASSERT_TRUE(mympd_queue_push(test_queue, test_data[7], 0));
+    ASSERT_EQ(0U, test_queue->length);
+    test_data_out = mympd_queue_shift(test_queue, 50, 0);
+    ASSERT_STREQ(test_data[7], test_data_out);
+
+    mympd_queue_free(test_queue);
+    for (int i = 0; i < 8; i++) {
+        sdsfree(test_data[i]);
+    }
+}
+
+UTEST(mympd_queue, mpsc_event) {
+    struct t_mympd_queue *test_queue = mympd_queue_create_mpsc("test", QUEUE_TYPE_REQUEST, 16);
+    sds test_data_in0 = sdsnew("test0");
+    sds test_data_in1 = sdsnew("test1");
+    mympd_queue_push(test_queue, test_data_in0, 0);
+    mympd_queue_push(test_queue, test_data_in1, 0);
+
+    // poll loop consumer: one eventfd read per shifted entry
+    ASSERT_TRUE(event_eventfd_read(test_queue->event_fd));
+    sds test_data_out = mympd_queue_shift(test_queue, -1, 0);
+    ASSERT_STREQ(test_data_in0, test_data_out);
+    ASSERT_TRUE(event_eventfd_read(test_queue->event_fd));
+    test_data_out = mympd_queue_shift(test_queue, -1, 0);
+    ASSERT_STREQ(test_data_in1, test_data_out);
+    // queue is empty, eventfd is not readable
+    ASSERT_FALSE(event_eventfd_read(test_queue->event_fd));
+
+    mympd_queue_free(test_queue);
+    sdsfree(test_data_in0);
+    sdsfree(test_data_in1);
+}
+
+UTEST(mympd_queue, mpsc_free) {
+    struct t_mympd_queue *test_queue = mympd_queue_create_mpsc("test", QUEUE_TYPE_REQUEST, 4);
+    for (int i = 0; i < 10; i++) {
+        struct t_work_request *request = create_request(REQUEST_TYPE_DEFAULT, 0, 0, MYMPD_API_VIEW_SAVE, "test", MPD_PARTITION_DEFAULT);
+        mympd_queue_push(test_queue, request, 0);
+    }
+    ASSERT_EQ(10, mympd_queue_expire_age(test_queue, 0));
+    mympd_queue_free(test_queue);
+}
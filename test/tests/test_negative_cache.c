@@ -0,0 +1,110 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/filehandler.h"
+#include "src/lib/sds_extras.h"
+#include "src/web_server/negative_cache.h"
+
+#include <sys/stat.h>
+#include <utime.h>
+
+#define TEST_MEDIA_DIR "/tmp/mympd-test/music"
+#define TEST_MEDIA_FILE TEST_MEDIA_DIR"/song.mp3"
+
+static void set_mtime(const char *path, time_t mtime) {
+    struct utimbuf times;
+    times.actime = mtime;
+    times.modtime = mtime;
+    utime(path, &times);
+}
+
+static void create_media_file(void) {
+    mkdir(TEST_MEDIA_DIR, 0770);
+    write_data_to_file(TEST_MEDIA_FILE, "test", 4);
+    set_mtime(TEST_MEDIA_FILE, 1000);
+    set_mtime(TEST_MEDIA_DIR, 1000);
+}
+
+UTEST(negative_cache, test_add_check) {
+    init_testenv();
+    create_media_file();
+    struct t_negative_cache cache;
+    negative_cache_init(&cache);
+    sds uri = sdsnew("song.mp3");
+
+    ASSERT_FALSE(negative_cache_check(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    ASSERT_TRUE(negative_cache_add(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    ASSERT_TRUE(negative_cache_check(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    // offset and size are part of the key
+    ASSERT_FALSE(negative_cache_check(&cache, uri, 1, false, TEST_MEDIA_FILE));
+    ASSERT_FALSE(negative_cache_check(&cache, uri, 0, true, TEST_MEDIA_FILE));
+
+    // a new file in the directory invalidates the entry
+    set_mtime(TEST_MEDIA_DIR, 2000);
+    ASSERT_FALSE(negative_cache_check(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    ASSERT_EQ(0U, (unsigned)raxSize(cache.entries));
+
+    // a changed media file invalidates the entry
+    ASSERT_TRUE(negative_cache_add(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    set_mtime(TEST_MEDIA_FILE, 2000);
+    ASSERT_FALSE(negative_cache_check(&cache, uri, 0, false, TEST_MEDIA_FILE));
+
+    sdsfree(uri);
+    negative_cache_clear(&cache);
+    clean_testenv();
+}
+
+UTEST(negative_cache, test_signature) {
+    init_testenv();
+    create_media_file();
+    struct t_negative_cache cache;
+    negative_cache_init(&cache);
+    sds uri = sdsnew("song.mp3");
+    sds signature = sdsnew("/music\ncover,folder\ncover-sm");
+
+    negative_cache_set_signature(&cache, signature);
+    ASSERT_TRUE(negative_cache_add(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    // unchanged settings keep the entries
+    negative_cache_set_signature(&cache, signature);
+    ASSERT_TRUE(negative_cache_check(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    // changed settings drop the entries
+    signature = sdscat(signature, ",back");
+    negative_cache_set_signature(&cache, signature);
+    ASSERT_FALSE(negative_cache_check(&cache, uri, 0, false, TEST_MEDIA_FILE));
+
+    sdsfree(signature);
+    sdsfree(uri);
+    negative_cache_clear(&cache);
+    clean_testenv();
+}
+
+UTEST(negative_cache, test_save_read) {
+    init_testenv();
+    create_media_file();
+    sds uri = sdsnew("song.mp3");
+    sds signature = sdsnew("/music\ncover,folder\ncover-sm");
+
+    struct t_negative_cache cache;
+    negative_cache_init(&cache);
+    negative_cache_set_signature(&cache, signature);
+    ASSERT_TRUE(negative_cache_add(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    ASSERT_TRUE(negative_cache_save(&cache, workdir));
+    negative_cache_clear(&cache);
+
+    negative_cache_init(&cache);
+    ASSERT_TRUE(negative_cache_read(&cache, workdir));
+    ASSERT_STREQ(signature, cache.signature);
+    ASSERT_TRUE(negative_cache_check(&cache, uri, 0, false, TEST_MEDIA_FILE));
+    negative_cache_clear(&cache);
+
+    sdsfree(signature);
+    sdsfree(uri);
+    clean_testenv();
+}
@@ -0,0 +1,138 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/list.h"
+#include "src/lib/mem.h"
+#include "src/lib/mympd_state.h"
+#include "src/lib/sds_extras.h"
+#include "src/lib/song_index.h"
+#include "src/mpd_client/random_select.h"
+
+#include <string.h>
+
+static void add_song(struct t_song_index *song_index, unsigned nr, const char *artist) {
+    if (song_index->len == song_index->size) {
+        song_index->size = song_index->size == 0 ? 64 : song_index->size * 2;
+        song_index->songs = realloc_assert(song_index->songs, song_index->size * sizeof(struct t_song_index_entry));
+    }
+    struct t_song_index_entry *entry = &song_index->songs[song_index->len++];
+    entry->uri = sdscatfmt(sdsempty(), "music/%s/%u.flac", artist, nr);
+    entry->duration = 180;
+    entry->last_modified = 1699304451;
+    entry->values = malloc_assert(sizeof(sds));
+    entry->values[0] = sdsnew(artist);
+}
+
+/**
+ * Selects one song from 999 songs of artist A and one song of artist B
+ * @param weighting the weighting
+ * @return how often the song of artist B was selected
+ */
+static unsigned count_minority_selected(enum jukebox_weightings weighting) {
+    struct t_song_index song_index;
+    song_index_init(&song_index);
+    song_index.tags.tags[song_index.tags.len++] = MPD_TAG_ARTIST;
+    for (unsigned i = 0; i < 999; i++) {
+        add_song(&song_index, i, "A");
+    }
+    add_song(&song_index, 999, "B");
+
+    struct t_mpd_state *mpd_state = malloc_assert(sizeof(struct t_mpd_state));
+    mpd_state_default(mpd_state, NULL);
+    struct t_partition_state partition_state;
+    partition_state.name = sdsnew("default");
+    partition_state.mpd_state = mpd_state;
+
+    struct t_random_add_constraints constraints = {
+        .filter_include = NULL,
+        .filter_exclude = NULL,
+        .uniq_tag = MPD_TAG_ARTIST,
+        .last_played = 0,
+        .ignore_hated = false,
+        .weighting = weighting,
+        .min_song_duration = 0,
+        .max_song_duration = 0
+    };
+    unsigned count = 0;
+    struct t_list add_list;
+    list_init(&add_list);
+    for (unsigned i = 0; i < 200; i++) {
+        random_select_songs(&partition_state, NULL, &song_index, 1, "Database", NULL, &add_list, &constraints);
+        if (add_list.head != NULL &&
+            strcmp(add_list.head->value_p, "B") == 0)
+        {
+            count++;
+        }
+        list_clear(&add_list);
+    }
+    FREE_SDS(partition_state.name);
+    mpd_state_free(mpd_state);
+    song_index_free(&song_index);
+    return count;
+}
+
+UTEST(random_select, test_uniform) {
+    // expected: 0.2
+    ASSERT_LT(count_minority_selected(JUKEBOX_WEIGHTING_OFF), 20U);
+}
+
+UTEST(random_select, test_stratified) {
+    // expected: 100
+    ASSERT_GT(count_minority_selected(JUKEBOX_WEIGHTING_STRATIFIED), 50U);
+}
+
+UTEST(random_select, test_uniq) {
+    struct t_song_index song_index;
+    song_index_init(&song_index);
+    song_index.tags.tags[song_index.tags.len++] = MPD_TAG_ARTIST;
+    const char *artists[] = {"A", "B", "C", "D", "E", "F", NULL};
+    for (unsigned i = 0; i < 60; i++) {
+        add_song(&song_index, i, artists[i % 6]);
+    }
+
+    struct t_mpd_state *mpd_state = malloc_assert(sizeof(struct t_mpd_state));
+    mpd_state_default(mpd_state, NULL);
+    struct t_partition_state partition_state;
+    partition_state.name = sdsnew("default");
+    partition_state.mpd_state = mpd_state;
+
+    struct t_list queue_list;
+    list_init(&queue_list);
+    list_push(&queue_list, "music/A/0.flac", 0, "A", NULL);
+    struct t_random_add_constraints constraints = {
+        .filter_include = NULL,
+        .filter_exclude = NULL,
+        .uniq_tag = MPD_TAG_ARTIST,
+        .last_played = 0,
+        .ignore_hated = false,
+        .weighting = JUKEBOX_WEIGHTING_STRATIFIED,
+        .min_song_duration = 0,
+        .max_song_duration = 0
+    };
+    struct t_list add_list;
+    list_init(&add_list);
+    unsigned len = random_select_songs(&partition_state, NULL, &song_index, 5, "Database", &queue_list, &add_list, &constraints);
+    ASSERT_EQ(5U, len);
+    // all artists but A
+    unsigned seen = 0;
+    struct t_list_node *current = add_list.head;
+    while (current != NULL) {
+        ASSERT_STRNE("A", current->value_p);
+        seen |= 1U << (current->value_p[0] - 'A');
+        current = current->next;
+    }
+    ASSERT_EQ(0x3eU, seen);
+
+    list_clear(&add_list);
+    list_clear(&queue_list);
+    FREE_SDS(partition_state.name);
+    mpd_state_free(mpd_state);
+    song_index_free(&song_index);
+}
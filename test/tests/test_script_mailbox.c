@@ -0,0 +1,134 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/api.h"
+#include "src/lib/sds_extras.h"
+#include "src/lib/utility.h"
+#include "src/scripts/mailbox.h"
+
+#include <pthread.h>
+
+static struct t_work_response *create_test_response(unsigned request_id, const char *data) {
+    struct t_work_response *response = create_response_new(RESPONSE_TYPE_SCRIPT, 0, request_id, MYMPD_API_SCRIPT_LIST, MPD_PARTITION_DEFAULT);
+    response->data = sds_replace(response->data, data);
+    return response;
+}
+
+static void *deliver_thread(void *arg) {
+    struct t_work_response *response = (struct t_work_response *)arg;
+    my_msleep(100);
+    script_mailbox_deliver(response);
+    return NULL;
+}
+
+UTEST(script_mailbox, deliver_wait) {
+    struct t_script_mailbox *mailbox = script_mailbox_new();
+    ASSERT_TRUE(mailbox != NULL);
+    unsigned request_id = script_mailbox_request_id(mailbox);
+    ASSERT_GT(request_id, 0U);
+    ASSERT_EQ(1U, mailbox->pending.length);
+
+    ASSERT_TRUE(script_mailbox_deliver(create_test_response(request_id, "test")));
+    struct t_work_response *response = script_mailbox_wait(mailbox, request_id, time(NULL) + 5);
+    ASSERT_TRUE(response != NULL);
+    ASSERT_STREQ("test", response->data);
+    ASSERT_EQ(0U, mailbox->pending.length);
+    script_response_free(response);
+    script_mailbox_free(mailbox);
+}
+
+UTEST(script_mailbox, wakeup) {
+    struct t_script_mailbox *mailbox = script_mailbox_new();
+    ASSERT_TRUE(mailbox != NULL);
+    unsigned request_id = script_mailbox_request_id(mailbox);
+    pthread_t thread;
+    ASSERT_EQ(0, pthread_create(&thread, NULL, deliver_thread, create_test_response(request_id, "test")));
+    struct t_work_response *response = script_mailbox_wait(mailbox, request_id, time(NULL) + 5);
+    pthread_join(thread, NULL);
+    ASSERT_TRUE(response != NULL);
+    ASSERT_STREQ("test", response->data);
+    script_response_free(response);
+    script_mailbox_free(mailbox);
+}
+
+UTEST(script_mailbox, out_of_order) {
+    struct t_script_mailbox *mailbox = script_mailbox_new();
+    ASSERT_TRUE(mailbox != NULL);
+    unsigned request_id1 = script_mailbox_request_id(mailbox);
+    unsigned request_id2 = script_mailbox_request_id(mailbox);
+    ASSERT_NE(request_id1, request_id2);
+
+    ASSERT_TRUE(script_mailbox_deliver(create_test_response(request_id2, "test2")));
+    ASSERT_TRUE(script_mailbox_deliver(create_test_response(request_id1, "test1")));
+    struct t_work_response *response = script_mailbox_wait(mailbox, request_id1, time(NULL) + 5);
+    ASSERT_TRUE(response != NULL);
+    ASSERT_STREQ("test1", response->data);
+    script_response_free(response);
+    response = script_mailbox_wait(mailbox, request_id2, time(NULL) + 5);
+    ASSERT_TRUE(response != NULL);
+    ASSERT_STREQ("test2", response->data);
+    script_response_free(response);
+    script_mailbox_free(mailbox);
+}
+
+UTEST(script_mailbox, separate_mailboxes) {
+    struct t_script_mailbox *mailbox1 = script_mailbox_new();
+    struct t_script_mailbox *mailbox2 = script_mailbox_new();
+    ASSERT_TRUE(mailbox1 != NULL);
+    ASSERT_TRUE(mailbox2 != NULL);
+    unsigned request_id1 = script_mailbox_request_id(mailbox1);
+    unsigned request_id2 = script_mailbox_request_id(mailbox2);
+    ASSERT_NE(request_id1, request_id2);
+
+    ASSERT_TRUE(script_mailbox_deliver(create_test_response(request_id2, "test2")));
+    // the response is not in the first mailbox
+    struct t_work_response *response = script_mailbox_wait(mailbox1, request_id2, time(NULL) + 5);
+    ASSERT_TRUE(response == NULL);
+    response = script_mailbox_wait(mailbox2, request_id2, time(NULL) + 5);
+    ASSERT_TRUE(response != NULL);
+    ASSERT_STREQ("test2", response->data);
+    script_response_free(response);
+    script_mailbox_free(mailbox1);
+    script_mailbox_free(mailbox2);
+}
+
+UTEST(script_mailbox, discard) {
+    struct t_script_mailbox *mailbox = script_mailbox_new();
+    ASSERT_TRUE(mailbox != NULL);
+    unsigned request_id = script_mailbox_request_id(mailbox);
+    // unknown request
+    ASSERT_FALSE(script_mailbox_deliver(create_test_response(request_id + 1, "test")));
+    // no mailbox
+    ASSERT_FALSE(script_mailbox_deliver(create_test_response(1, "test")));
+    // timeout
+    struct t_work_response *response = script_mailbox_wait(mailbox, request_id, time(NULL) + 1);
+    ASSERT_TRUE(response == NULL);
+    ASSERT_EQ(0U, mailbox->pending.length);
+    // late response
+    ASSERT_FALSE(script_mailbox_deliver(create_test_response(request_id, "test")));
+    // not fetched response
+    request_id = script_mailbox_request_id(mailbox);
+    ASSERT_TRUE(script_mailbox_deliver(create_test_response(request_id, "test")));
+    script_mailbox_clear(mailbox);
+    ASSERT_EQ(0U, mailbox->pending.length);
+    script_mailbox_free(mailbox);
+}
+
+UTEST(script_mailbox, pending_max) {
+    struct t_script_mailbox *mailbox = script_mailbox_new();
+    ASSERT_TRUE(mailbox != NULL);
+    for (unsigned i = 0; i < SCRIPT_API_PENDING_MAX; i++) {
+        ASSERT_GT(script_mailbox_request_id(mailbox), 0U);
+    }
+    ASSERT_EQ(0U, script_mailbox_request_id(mailbox));
+    script_mailbox_clear(mailbox);
+    ASSERT_GT(script_mailbox_request_id(mailbox), 0U);
+    script_mailbox_free(mailbox);
+}
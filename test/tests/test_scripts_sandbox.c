@@ -0,0 +1,106 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/scripts/sandbox.h"
+
+#include <string.h>
+
+static const char * const run_globals[] = {
+    "mympd_arguments",
+    "mympd_env",
+    NULL
+};
+
+static lua_State *sandbox_vm_new(void) {
+    lua_State *lua_vm = luaL_newstate();
+    luaL_openlibs(lua_vm);
+    if (luaL_dofile(lua_vm, MYMPD_SOURCE_DIR"/contrib/lualibs/json.lua") != LUA_OK) {
+        lua_close(lua_vm);
+        return NULL;
+    }
+    lua_settop(lua_vm, 0);
+    lua_sandbox_seal(lua_vm, run_globals);
+    return lua_vm;
+}
+
+/**
+ * Runs the script like the script worker does
+ */
+static bool sandbox_run(lua_State *lua_vm, const char *script) {
+    lua_newtable(lua_vm);
+    lua_setglobal(lua_vm, "mympd_env");
+    int rc = lua_sandbox_load(lua_vm, "test", 1, script, strlen(script));
+    if (rc == LUA_OK) {
+        lua_sandbox_env(lua_vm);
+        rc = lua_pcall(lua_vm, 0, 0, 0);
+    }
+    lua_settop(lua_vm, 0);
+    return rc == LUA_OK;
+}
+
+/**
+ * Runs the script in a new sealed instance
+ * @return 1 if the shared state is unchanged, 0 if it was changed, -1 on error
+ */
+static int sandbox_check_script(const char *script) {
+    lua_State *lua_vm = sandbox_vm_new();
+    if (lua_vm == NULL) {
+        return -1;
+    }
+    int rc = sandbox_run(lua_vm, script) == false
+        ? -1
+        : lua_sandbox_check(lua_vm) == true
+            ? 1
+            : 0;
+    lua_close(lua_vm);
+    return rc;
+}
+
+UTEST(scripts_sandbox, test_globals_reset) {
+    lua_State *lua_vm = sandbox_vm_new();
+    ASSERT_TRUE(lua_vm != NULL);
+    const char *script = "counter = (counter or 0) + 1\n"
+        "mympd_env.counter = counter\n"
+        "local t = { json.encode({ a = 1 }) }\n"
+        "table.insert(t, string.upper('a'))\n";
+    ASSERT_TRUE(sandbox_run(lua_vm, script));
+    ASSERT_TRUE(sandbox_run(lua_vm, script));
+    ASSERT_TRUE(lua_sandbox_check(lua_vm));
+    // globals of the script are discarded
+    ASSERT_EQ(LUA_TNIL, lua_getglobal(lua_vm, "counter"));
+    lua_pop(lua_vm, 1);
+    // per run globals are not part of the shared state
+    lua_newtable(lua_vm);
+    lua_setglobal(lua_vm, "mympd_arguments");
+    ASSERT_TRUE(lua_sandbox_check(lua_vm));
+    lua_close(lua_vm);
+}
+
+UTEST(scripts_sandbox, test_global_table) {
+    ASSERT_EQ(1, sandbox_check_script("local x = _G.print; counter = 1"));
+    ASSERT_EQ(0, sandbox_check_script("_G.counter = 1"));
+    ASSERT_EQ(0, sandbox_check_script("_G.print = nil"));
+    ASSERT_EQ(0, sandbox_check_script("setmetatable(_G, {})"));
+}
+
+UTEST(scripts_sandbox, test_libraries) {
+    ASSERT_EQ(1, sandbox_check_script("local s = string.upper(json.encode({ a = 1 }))"));
+    ASSERT_EQ(0, sandbox_check_script("json.encode = function() return '' end"));
+    ASSERT_EQ(0, sandbox_check_script("string.trim = function(s) return s end"));
+    ASSERT_EQ(0, sandbox_check_script("table.insert = nil"));
+    ASSERT_EQ(0, sandbox_check_script("package.loaded.mylib = {}"));
+    ASSERT_EQ(0, sandbox_check_script("getmetatable('').__index = {}"));
+}
+
+UTEST(scripts_sandbox, test_not_sealed) {
+    lua_State *lua_vm = luaL_newstate();
+    ASSERT_FALSE(lua_sandbox_check(lua_vm));
+    lua_close(lua_vm);
+}
@@ -82,6 +82,12 @@ UTEST(search_local, test_search_mpd_song_expression) {
 
     ASSERT_TRUE(search_by_expression("((added-since '2023-10-10'))"));
     ASSERT_FALSE(search_by_expression("((added-since '2023-11-17'))"));
+
+    //combined expressions are evaluated in cost order
+    ASSERT_TRUE(search_by_expression("((Album =~ 'tab.*') AND (Artist == 'BLIXA bargeld') AND (modified-since '2023-10-10'))"));
+    ASSERT_FALSE(search_by_expression("((Album =~ 'tab.*') AND (Artist == 'BLIXA bargeld') AND (modified-since '2023-11-17'))"));
+    ASSERT_TRUE(search_by_expression("((any contains 'RASA') AND (file contains 'TEST.mp3'))"));
+    ASSERT_FALSE(search_by_expression("((any contains 'RASA') AND (file contains 'other.mp3'))"));
 }
 
 long try_parse(const char *expr) {
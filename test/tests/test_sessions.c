@@ -0,0 +1,122 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/sds_extras.h"
+#include "src/web_server/sessions.h"
+
+UTEST(sessions, test_session_new_validate_remove) {
+    struct t_sessions sessions;
+    webserver_sessions_init(&sessions);
+    sds session1 = webserver_session_new(&sessions);
+    sds session2 = webserver_session_new(&sessions);
+    ASSERT_TRUE(session1 != NULL);
+    ASSERT_TRUE(session2 != NULL);
+    ASSERT_EQ((size_t)20, sdslen(session1));
+    ASSERT_EQ((size_t)2, sessions.len);
+
+    ASSERT_TRUE(webserver_session_validate(&sessions, session1));
+    ASSERT_FALSE(webserver_session_validate(&sessions, "00000000000000000000"));
+    ASSERT_TRUE(webserver_session_remove(&sessions, session1));
+    ASSERT_FALSE(webserver_session_remove(&sessions, session1));
+    ASSERT_FALSE(webserver_session_validate(&sessions, session1));
+    ASSERT_TRUE(webserver_session_validate(&sessions, session2));
+    ASSERT_EQ((size_t)1, sessions.len);
+
+    FREE_SDS(session1);
+    FREE_SDS(session2);
+    webserver_sessions_clear(&sessions);
+}
+
+UTEST(sessions, test_session_expire) {
+    struct t_sessions sessions;
+    webserver_sessions_init(&sessions);
+    sds session1 = webserver_session_new(&sessions);
+    sds session2 = webserver_session_new(&sessions);
+    sds session3 = webserver_session_new(&sessions);
+    // expire the second session, the heap is reordered
+    struct t_session *entry = (struct t_session *)raxFind(sessions.index, (unsigned char *)session2, sdslen(session2));
+    entry->expires = time(NULL) - 10;
+    for (size_t i = 0; i < sessions.len; i++) {
+        if (sessions.heap[i] == entry && i > 0) {
+            struct t_session *tmp = sessions.heap[0];
+            sessions.heap[0] = entry;
+            sessions.heap[i] = tmp;
+            tmp->heap_idx = i;
+            entry->heap_idx = 0;
+            break;
+        }
+    }
+    ASSERT_FALSE(webserver_session_validate(&sessions, session2));
+    ASSERT_EQ((size_t)2, sessions.len);
+    ASSERT_TRUE(webserver_session_validate(&sessions, session1));
+    ASSERT_TRUE(webserver_session_validate(&sessions, session3));
+
+    FREE_SDS(session1);
+    FREE_SDS(session2);
+    FREE_SDS(session3);
+    webserver_sessions_clear(&sessions);
+}
+
+UTEST(sessions, test_session_max) {
+    struct t_sessions sessions;
+    webserver_sessions_init(&sessions);
+    sds first = webserver_session_new(&sessions);
+    for (unsigned i = 1; i < HTTP_SESSIONS_MAX; i++) {
+        sds session = webserver_session_new(&sessions);
+        FREE_SDS(session);
+    }
+    ASSERT_EQ((size_t)HTTP_SESSIONS_MAX, sessions.len);
+    // the validated session is extended, another one is discarded
+    ASSERT_TRUE(webserver_session_validate(&sessions, first));
+    sds last = webserver_session_new(&sessions);
+    ASSERT_EQ((size_t)HTTP_SESSIONS_MAX, sessions.len);
+    ASSERT_TRUE(webserver_session_validate(&sessions, first));
+    ASSERT_TRUE(webserver_session_validate(&sessions, last));
+
+    FREE_SDS(first);
+    FREE_SDS(last);
+    webserver_sessions_clear(&sessions);
+}
+
+UTEST(sessions, test_sessions_save_read) {
+    init_testenv();
+    struct t_sessions sessions;
+    webserver_sessions_init(&sessions);
+    sds session1 = webserver_session_new(&sessions);
+    sds session2 = webserver_session_new(&sessions);
+    sds pin_hash = sdsnew("7c4a8d09ca3762af61e59520943dc26494f8941b");
+    ASSERT_TRUE(webserver_sessions_save(&sessions, workdir, pin_hash));
+    webserver_sessions_clear(&sessions);
+
+    webserver_sessions_init(&sessions);
+    ASSERT_TRUE(webserver_sessions_read(&sessions, workdir, pin_hash));
+    ASSERT_EQ((size_t)2, sessions.len);
+    ASSERT_TRUE(webserver_session_validate(&sessions, session1));
+    ASSERT_TRUE(webserver_session_validate(&sessions, session2));
+    // the file is removed after reading
+    ASSERT_FALSE(webserver_sessions_read(&sessions, workdir, pin_hash));
+
+    // the sessions are discarded if the pin has changed
+    ASSERT_TRUE(webserver_sessions_save(&sessions, workdir, pin_hash));
+    webserver_sessions_clear(&sessions);
+    webserver_sessions_init(&sessions);
+    sds new_pin_hash = sdsempty();
+    ASSERT_FALSE(webserver_sessions_read(&sessions, workdir, new_pin_hash));
+    ASSERT_EQ((size_t)0, sessions.len);
+    ASSERT_FALSE(webserver_session_validate(&sessions, session1));
+    ASSERT_FALSE(webserver_sessions_read(&sessions, workdir, pin_hash));
+
+    FREE_SDS(pin_hash);
+    FREE_SDS(new_pin_hash);
+    FREE_SDS(session1);
+    FREE_SDS(session2);
+    webserver_sessions_clear(&sessions);
+    clean_testenv();
+}
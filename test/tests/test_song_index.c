@@ -0,0 +1,76 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "dist/libmympdclient/src/isong.h"
+#include "src/lib/sds_extras.h"
+#include "src/lib/song_index.h"
+#include "src/mpd_client/tags.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+UTEST(song_index, test_add) {
+    struct t_song_index song_index;
+    song_index_init(&song_index);
+    song_index.tags.tags[song_index.tags.len++] = MPD_TAG_ARTIST;
+    song_index.tags.tags[song_index.tags.len++] = MPD_TAG_TITLE;
+    ASSERT_TRUE(song_index_has_tag(&song_index, MPD_TAG_TITLE));
+    ASSERT_FALSE(song_index_has_tag(&song_index, MPD_TAG_ALBUM));
+
+    struct mpd_song *song = new_song();
+    for (unsigned i = 0; i < 1500; i++) {
+        song_index_add(&song_index, song);
+    }
+    ASSERT_EQ(1500U, song_index.len);
+    const struct t_song_index_entry *entry = &song_index.songs[1499];
+    ASSERT_STREQ("/music/test.mp3", entry->uri);
+    ASSERT_EQ(10U, entry->duration);
+    ASSERT_EQ((time_t)1699304451, entry->last_modified);
+
+    sds artist = mpd_client_get_tag_value_string(song, MPD_TAG_ARTIST, sdsempty());
+    ASSERT_STREQ(artist, song_index_get_value(&song_index, entry, MPD_TAG_ARTIST));
+    ASSERT_STREQ("Tabula Rasa", song_index_get_value(&song_index, entry, MPD_TAG_TITLE));
+    ASSERT_TRUE(song_index_get_value(&song_index, entry, MPD_TAG_ALBUM) == NULL);
+    FREE_SDS(artist);
+
+    // title falls back to the filename
+    free(song->tags[MPD_TAG_TITLE].value);
+    song->tags[MPD_TAG_TITLE].value = NULL;
+    song_index_add(&song_index, song);
+    ASSERT_STREQ("test.mp3", song_index_get_value(&song_index, &song_index.songs[1500], MPD_TAG_TITLE));
+
+    mpd_song_free(song);
+    song_index_free(&song_index);
+}
+
+UTEST(song_index, test_replace) {
+    struct t_song_index song_index;
+    song_index_init(&song_index);
+    struct t_song_index new_index;
+    song_index_init(&new_index);
+    new_index.tags.tags[new_index.tags.len++] = MPD_TAG_ALBUM;
+    new_index.db_mtime = 100;
+
+    struct mpd_song *song = new_song();
+    song_index_add(&song_index, song);
+    song_index_add(&new_index, song);
+    song_index_add(&new_index, song);
+    mpd_song_free(song);
+
+    song_index_replace(&song_index, &new_index);
+    ASSERT_EQ(2U, song_index.len);
+    ASSERT_EQ((time_t)100, song_index.db_mtime);
+    ASSERT_STREQ("Tabula Rasa", song_index_get_value(&song_index, &song_index.songs[0], MPD_TAG_ALBUM));
+    ASSERT_EQ(0U, new_index.len);
+    ASSERT_TRUE(new_index.songs == NULL);
+
+    song_index_free(&new_index);
+    song_index_free(&song_index);
+}
@@ -0,0 +1,115 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/rax/rax.h"
+#include "dist/utest/utest.h"
+#include "src/lib/mem.h"
+#include "src/lib/mympd_state.h"
+#include "src/lib/sticker.h"
+#include "src/mpd_client/stickerdb.h"
+
+static struct t_stickerdb_state *stickerdb_cache_new(void) {
+    struct t_stickerdb_state *stickerdb = malloc_assert(sizeof(struct t_stickerdb_state));
+    stickerdb_state_default(stickerdb, NULL);
+    stickerdb->cache = raxNew();
+    // simulate a successful cache update
+    stickerdb->cache_dirty = false;
+    return stickerdb;
+}
+
+UTEST(stickerdb_cache, test_own_change) {
+    struct t_stickerdb_state *stickerdb = stickerdb_cache_new();
+    struct t_sticker sticker;
+
+    stickerdb_cache_own_change(stickerdb, "song.mp3", "playCount", "5");
+    stickerdb_cache_own_change(stickerdb, "song.mp3", "like", "2");
+    ASSERT_EQ(2U, stickerdb->cache_own_changes);
+    ASSERT_TRUE(stickerdb_get_all(stickerdb, "song.mp3", &sticker, false) != NULL);
+    ASSERT_EQ(5, sticker.mympd[STICKER_PLAY_COUNT]);
+    ASSERT_EQ(STICKER_LIKE_LOVE, sticker.mympd[STICKER_LIKE]);
+    sticker_struct_clear(&sticker);
+
+    // the merged event for the own writes keeps the cache valid
+    stickerdb_cache_idle_event(stickerdb, MPD_IDLE_STICKER, true);
+    ASSERT_FALSE(stickerdb->cache_dirty);
+    ASSERT_EQ(0U, stickerdb->cache_own_changes);
+
+    // removed stickers are reset to the default value
+    stickerdb_cache_own_change(stickerdb, "song.mp3", "like", NULL);
+    stickerdb_cache_idle_event(stickerdb, MPD_IDLE_STICKER, true);
+    ASSERT_FALSE(stickerdb->cache_dirty);
+    ASSERT_TRUE(stickerdb_get_all(stickerdb, "song.mp3", &sticker, false) != NULL);
+    ASSERT_EQ(STICKER_LIKE_NEUTRAL, sticker.mympd[STICKER_LIKE]);
+    sticker_struct_clear(&sticker);
+
+    stickerdb_state_free(stickerdb);
+}
+
+UTEST(stickerdb_cache, test_user_defined_own_change) {
+    struct t_stickerdb_state *stickerdb = stickerdb_cache_new();
+
+    // user defined stickers are not cached, but cause a sticker event
+    stickerdb_cache_own_change(stickerdb, "song.mp3", "myName", "value");
+    ASSERT_EQ(1U, stickerdb->cache_own_changes);
+    ASSERT_EQ(0U, (unsigned)raxSize(stickerdb->cache));
+    stickerdb_cache_idle_event(stickerdb, MPD_IDLE_STICKER, true);
+    ASSERT_FALSE(stickerdb->cache_dirty);
+
+    stickerdb_state_free(stickerdb);
+}
+
+UTEST(stickerdb_cache, test_foreign_change) {
+    struct t_stickerdb_state *stickerdb = stickerdb_cache_new();
+
+    // events without the sticker flag are ignored
+    stickerdb_cache_idle_event(stickerdb, 0, false);
+    ASSERT_FALSE(stickerdb->cache_dirty);
+
+    // events received while idling invalidate the cache
+    stickerdb_cache_idle_event(stickerdb, MPD_IDLE_STICKER, false);
+    ASSERT_TRUE(stickerdb->cache_dirty);
+
+    // a foreign change after the event of the own write is not absorbed
+    stickerdb->cache_dirty = false;
+    stickerdb_cache_own_change(stickerdb, "song.mp3", "playCount", "5");
+    stickerdb_cache_idle_event(stickerdb, MPD_IDLE_STICKER, true);
+    ASSERT_FALSE(stickerdb->cache_dirty);
+    stickerdb_cache_idle_event(stickerdb, MPD_IDLE_STICKER, false);
+    ASSERT_TRUE(stickerdb->cache_dirty);
+
+    stickerdb_state_free(stickerdb);
+}
+
+UTEST(stickerdb_cache, test_missing_own_event) {
+    struct t_stickerdb_state *stickerdb = stickerdb_cache_new();
+
+    // no own writes are pending
+    stickerdb_cache_idle_event(stickerdb, MPD_IDLE_STICKER, true);
+    ASSERT_TRUE(stickerdb->cache_dirty);
+
+    // own writes without an acknowledging event
+    stickerdb->cache_dirty = false;
+    stickerdb_cache_own_change(stickerdb, "song.mp3", "playCount", "5");
+    stickerdb_cache_idle_event(stickerdb, 0, true);
+    ASSERT_TRUE(stickerdb->cache_dirty);
+    ASSERT_EQ(0U, stickerdb->cache_own_changes);
+
+    stickerdb_state_free(stickerdb);
+}
+
+UTEST(stickerdb_cache, test_disabled) {
+    struct t_stickerdb_state *stickerdb = malloc_assert(sizeof(struct t_stickerdb_state));
+    stickerdb_state_default(stickerdb, NULL);
+
+    // own changes are not counted without a cache
+    stickerdb_cache_own_change(stickerdb, "song.mp3", "playCount", "5");
+    ASSERT_EQ(0U, stickerdb->cache_own_changes);
+
+    stickerdb_state_free(stickerdb);
+}
@@ -0,0 +1,102 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/mem.h"
+#include "src/lib/mimetype.h"
+#include "src/lib/thumbnail.h"
+
+#include <jpeglib.h>
+#include <png.h>
+#include <string.h>
+
+static sds create_png(unsigned width, unsigned height) {
+    png_image png;
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    png.width = width;
+    png.height = height;
+    png.format = PNG_FORMAT_RGB;
+    unsigned char *pixels = malloc_assert(PNG_IMAGE_SIZE(png));
+    for (unsigned y = 0; y < height; y++) {
+        for (unsigned x = 0; x < width; x++) {
+            unsigned char *p = pixels + ((size_t)y * width + x) * 3;
+            p[0] = (unsigned char)(x * 255 / width);
+            p[1] = (unsigned char)(y * 255 / height);
+            p[2] = (unsigned char)((x ^ y) & 0xff);
+        }
+    }
+    png_alloc_size_t len = 0;
+    png_image_write_to_memory(&png, NULL, &len, 0, pixels, 0, NULL);
+    sds png_data = sdsnewlen(NULL, len);
+    png_image_write_to_memory(&png, png_data, &len, 0, pixels, 0, NULL);
+    sdssetlen(png_data, len);
+    FREE_PTR(pixels);
+    return png_data;
+}
+
+static void get_jpeg_size(sds jpeg, unsigned *width, unsigned *height) {
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, (const unsigned char *)jpeg, (unsigned long)sdslen(jpeg));
+    jpeg_read_header(&cinfo, TRUE);
+    *width = cinfo.image_width;
+    *height = cinfo.image_height;
+    jpeg_destroy_decompress(&cinfo);
+}
+
+UTEST(thumbnail, test_png) {
+    sds png = create_png(2000, 1000);
+    sds jpeg = sdsempty();
+    ASSERT_TRUE(thumbnail_create(png, 1000, &jpeg));
+    ASSERT_STREQ("image/jpeg", get_mime_type_by_magic_stream(jpeg));
+    unsigned width;
+    unsigned height;
+    get_jpeg_size(jpeg, &width, &height);
+    ASSERT_EQ(1000U, width);
+    ASSERT_EQ(500U, height);
+
+    // jpeg source, scaled by libjpeg while decoding
+    sds thumb = sdsempty();
+    ASSERT_TRUE(thumbnail_create(jpeg, 400, &thumb));
+    get_jpeg_size(thumb, &width, &height);
+    ASSERT_EQ(400U, width);
+    ASSERT_EQ(200U, height);
+    ASSERT_LT(sdslen(thumb), sdslen(jpeg));
+
+    sdsfree(png);
+    sdsfree(jpeg);
+    sdsfree(thumb);
+}
+
+UTEST(thumbnail, test_small) {
+    // small images are served as they are
+    sds png = create_png(100, 150);
+    sds jpeg = sdsempty();
+    ASSERT_FALSE(thumbnail_create(png, 400, &jpeg));
+    ASSERT_EQ(0U, sdslen(jpeg));
+    sdsfree(png);
+    sdsfree(jpeg);
+}
+
+UTEST(thumbnail, test_invalid) {
+    sds data = sdsnew("not an image");
+    sds jpeg = sdsempty();
+    ASSERT_FALSE(thumbnail_create(data, 400, &jpeg));
+    // broken png
+    sds png = create_png(1000, 1000);
+    sdsrange(png, 0, 100);
+    ASSERT_FALSE(thumbnail_create(png, 400, &jpeg));
+    ASSERT_EQ(0U, sdslen(jpeg));
+    sdsfree(data);
+    sdsfree(png);
+    sdsfree(jpeg);
+}
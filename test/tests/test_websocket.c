@@ -0,0 +1,217 @@
+/*
+ SPDX-License-Identifier: GPL-3.0-or-later
+ myMPD (c) 2018-2024 Juergen Mang <mail@jcgames.de>
+ https://github.com/jcorporation/mympd
+*/
+
+#include "compile_time.h"
+#include "utility.h"
+
+#include "dist/utest/utest.h"
+#include "src/lib/mem.h"
+#include "src/lib/sds_extras.h"
+#include "src/web_server/utility.h"
+#include "src/web_server/websocket.h"
+
+#include <string.h>
+
+static struct mg_connection *new_ws_conn(unsigned long id, const char *partition) {
+    struct mg_connection *nc = malloc_assert(sizeof(struct mg_connection));
+    memset(nc, 0, sizeof(struct mg_connection));
+    nc->id = id;
+    nc->is_websocket = 1;
+    struct t_frontend_nc_data *frontend_nc_data = malloc_assert(sizeof(struct t_frontend_nc_data));
+    frontend_nc_data->partition = sdsnew(partition);
+    frontend_nc_data->id = 0;
+    frontend_nc_data->last_ws_ping = time(NULL);
+    frontend_nc_data->ws_dropped = 0;
+    frontend_nc_data->backend_nc = NULL;
+    nc->fn_data = frontend_nc_data;
+    return nc;
+}
+
+static void free_ws_conn(struct mg_connection *nc) {
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc->fn_data;
+    FREE_SDS(frontend_nc_data->partition);
+    FREE_PTR(frontend_nc_data);
+    mg_iobuf_free(&nc->send);
+    FREE_PTR(nc);
+}
+
+UTEST(websocket, test_frame) {
+    char data[70000];
+    memset(data, 'a', sizeof(data));
+    sds frame = websocket_frame(sdsempty(), data, 125);
+    ASSERT_EQ((size_t)(2 + 125), sdslen(frame));
+    ASSERT_EQ(0x81, (unsigned char)frame[0]);
+    ASSERT_EQ(125, frame[1]);
+    sdsclear(frame);
+    frame = websocket_frame(frame, data, 126);
+    ASSERT_EQ((size_t)(4 + 126), sdslen(frame));
+    ASSERT_EQ(126, frame[1]);
+    ASSERT_EQ(0, frame[2]);
+    ASSERT_EQ(126, frame[3]);
+    sdsclear(frame);
+    frame = websocket_frame(frame, data, sizeof(data));
+    ASSERT_EQ((size_t)(10 + sizeof(data)), sdslen(frame));
+    ASSERT_EQ(127, frame[1]);
+    ASSERT_EQ(0x01, (unsigned char)frame[7]);
+    ASSERT_EQ(0x11, (unsigned char)frame[8]);
+    ASSERT_EQ(0x70, (unsigned char)frame[9]);
+    sdsfree(frame);
+}
+
+UTEST(websocket, test_broadcast) {
+    struct t_ws_subscribers subscribers;
+    websocket_subscribers_init(&subscribers);
+    struct mg_connection *nc1 = new_ws_conn(1, "default");
+    struct mg_connection *nc2 = new_ws_conn(2, "default");
+    struct mg_connection *nc3 = new_ws_conn(3, "partition2");
+    websocket_subscribe(&subscribers, nc1);
+    websocket_subscribe(&subscribers, nc2);
+    websocket_subscribe(&subscribers, nc3);
+    ASSERT_EQ(3U, subscribers.count);
+
+    const char *msg = "{\"jsonrpc\":\"2.0\",\"method\":\"update_state\"}";
+    size_t msg_len = strlen(msg);
+    time_t last_ping = time(NULL) - WS_PING_TIMEOUT;
+    ASSERT_EQ(2U, websocket_broadcast(&subscribers, "default", msg, msg_len, last_ping));
+    ASSERT_EQ(2 + msg_len, nc1->send.len);
+    ASSERT_EQ(2 + msg_len, nc2->send.len);
+    ASSERT_EQ(0U, nc3->send.len);
+    ASSERT_EQ(0, memcmp(nc1->send.buf + 2, msg, msg_len));
+
+    ASSERT_EQ(3U, websocket_broadcast(&subscribers, MPD_PARTITION_ALL, msg, msg_len, last_ping));
+    ASSERT_EQ(2 + msg_len, nc3->send.len);
+    ASSERT_EQ(0U, websocket_broadcast(&subscribers, "unknown", msg, msg_len, last_ping));
+
+    // stale connection is closed
+    ((struct t_frontend_nc_data *)nc2->fn_data)->last_ws_ping = last_ping - 1;
+    ASSERT_EQ(1U, websocket_broadcast(&subscribers, "default", msg, msg_len, last_ping));
+    ASSERT_TRUE(nc2->is_closing == 1);
+
+    websocket_unsubscribe(&subscribers, nc2);
+    websocket_unsubscribe(&subscribers, nc3);
+    ASSERT_EQ(1U, subscribers.count);
+    ASSERT_EQ(1U, websocket_broadcast(&subscribers, MPD_PARTITION_ALL, msg, msg_len, last_ping));
+
+    websocket_unsubscribe(&subscribers, nc1);
+    ASSERT_EQ(0U, subscribers.count);
+    ASSERT_EQ(0U, (unsigned)raxSize(subscribers.partitions));
+
+    websocket_subscribers_clear(&subscribers);
+    free_ws_conn(nc1);
+    free_ws_conn(nc2);
+    free_ws_conn(nc3);
+}
+
+UTEST(websocket, test_client_id) {
+    struct t_ws_subscribers subscribers;
+    websocket_subscribers_init(&subscribers);
+    struct mg_connection *nc1 = new_ws_conn(1, "default");
+    struct mg_connection *nc2 = new_ws_conn(2, "default");
+    websocket_subscribe(&subscribers, nc1);
+    websocket_subscribe(&subscribers, nc2);
+    websocket_set_client_id(&subscribers, nc1, 100);
+    websocket_set_client_id(&subscribers, nc2, 200);
+
+    ASSERT_TRUE(websocket_send_client(&subscribers, 200, "test", 4));
+    ASSERT_EQ(0U, nc1->send.len);
+    ASSERT_EQ(6U, nc2->send.len);
+    ASSERT_FALSE(websocket_send_client(&subscribers, 300, "test", 4));
+
+    // changing the id removes the old mapping
+    websocket_set_client_id(&subscribers, nc1, 300);
+    ASSERT_FALSE(websocket_send_client(&subscribers, 100, "test", 4));
+    ASSERT_TRUE(websocket_send_client(&subscribers, 300, "test", 4));
+    ASSERT_EQ(6U, nc1->send.len);
+
+    websocket_unsubscribe(&subscribers, nc1);
+    ASSERT_FALSE(websocket_send_client(&subscribers, 300, "test", 4));
+
+    websocket_subscribers_clear(&subscribers);
+    free_ws_conn(nc1);
+    free_ws_conn(nc2);
+}
+
+UTEST(websocket, test_coalesce) {
+    struct t_ws_subscribers subscribers;
+    websocket_subscribers_init(&subscribers);
+    struct mg_connection *nc1 = new_ws_conn(1, "default");
+    websocket_subscribe(&subscribers, nc1);
+    time_t last_ping = time(NULL) - WS_PING_TIMEOUT;
+    const char *queue1 = "{\"jsonrpc\":\"2.0\",\"method\":\"update_queue\",\"params\":{\"length\":1}}";
+    const char *queue2 = "{\"jsonrpc\":\"2.0\",\"method\":\"update_queue\",\"params\":{\"length\":2}}";
+    const char *queue3 = "{\"jsonrpc\":\"2.0\",\"method\":\"update_queue\",\"params\":{\"length\":3}}";
+    const char *state = "{\"jsonrpc\":\"2.0\",\"method\":\"update_state\"}";
+
+    // first notification is sent immediately
+    ASSERT_EQ(-1, websocket_coalesce_timeout(&subscribers, 1000));
+    ASSERT_EQ(1U, websocket_notify(&subscribers, "default", queue1, strlen(queue1), 1000, last_ping));
+    size_t len = nc1->send.len;
+    ASSERT_EQ(2 + strlen(queue1), len);
+
+    // burst within the window is merged, last value wins
+    ASSERT_EQ(0U, websocket_notify(&subscribers, "default", queue2, strlen(queue2), 1010, last_ping));
+    ASSERT_EQ(0U, websocket_notify(&subscribers, "default", queue3, strlen(queue3), 1020, last_ping));
+    ASSERT_EQ(len, nc1->send.len);
+    ASSERT_EQ(1U, subscribers.pending);
+    ASSERT_EQ(230, websocket_coalesce_timeout(&subscribers, 1020));
+
+    // other notifications are not delayed
+    ASSERT_EQ(1U, websocket_notify(&subscribers, "default", state, strlen(state), 1030, last_ping));
+    len = nc1->send.len;
+
+    // flush after the window
+    ASSERT_EQ(0U, websocket_coalesce_flush(&subscribers, 1100, last_ping));
+    ASSERT_EQ(1U, websocket_coalesce_flush(&subscribers, 1250, last_ping));
+    ASSERT_EQ(len + 2 + strlen(queue3), nc1->send.len);
+    ASSERT_EQ(0, memcmp(nc1->send.buf + len + 2, queue3, strlen(queue3)));
+    ASSERT_EQ(0U, subscribers.pending);
+    ASSERT_EQ(-1, websocket_coalesce_timeout(&subscribers, 1250));
+
+    websocket_subscribers_clear(&subscribers);
+    free_ws_conn(nc1);
+}
+
+UTEST(websocket, test_backpressure) {
+    struct t_ws_subscribers subscribers;
+    websocket_subscribers_init(&subscribers);
+    struct mg_connection *nc1 = new_ws_conn(1, "default");
+    struct mg_connection *nc2 = new_ws_conn(2, "default");
+    websocket_subscribe(&subscribers, nc1);
+    websocket_subscribe(&subscribers, nc2);
+    time_t last_ping = time(NULL) - WS_PING_TIMEOUT;
+    const char *volume = "{\"jsonrpc\":\"2.0\",\"method\":\"update_volume\"}";
+    const char *notify = "{\"jsonrpc\":\"2.0\",\"method\":\"notify\"}";
+
+    // fill the send buffer of the slow client
+    char *fill = malloc_assert(WS_SEND_BUFFER_MAX + 1);
+    memset(fill, 'a', WS_SEND_BUFFER_MAX + 1);
+    mg_send(nc2, fill, WS_SEND_BUFFER_MAX + 1);
+    size_t len = nc2->send.len;
+
+    // coalesced notifications are dropped, others are queued
+    ASSERT_EQ(1U, websocket_notify(&subscribers, "default", volume, strlen(volume), 1000, last_ping));
+    ASSERT_EQ(len, nc2->send.len);
+    struct t_frontend_nc_data *frontend_nc_data = (struct t_frontend_nc_data *)nc2->fn_data;
+    ASSERT_NE(0U, frontend_nc_data->ws_dropped);
+    ASSERT_EQ(2U, websocket_notify(&subscribers, "default", notify, strlen(notify), 1000, last_ping));
+    ASSERT_EQ(len + 2 + strlen(notify), nc2->send.len);
+
+    // no resync before the buffer has drained
+    websocket_resync(&subscribers, nc2);
+    ASSERT_NE(0U, frontend_nc_data->ws_dropped);
+
+    // last value is sent after the buffer has drained
+    mg_iobuf_del(&nc2->send, 0, nc2->send.len);
+    websocket_resync(&subscribers, nc2);
+    ASSERT_EQ(0U, frontend_nc_data->ws_dropped);
+    ASSERT_EQ(2 + strlen(volume), nc2->send.len);
+    ASSERT_EQ(0, memcmp(nc2->send.buf + 2, volume, strlen(volume)));
+
+    FREE_PTR(fill);
+    websocket_subscribers_clear(&subscribers);
+    free_ws_conn(nc1);
+    free_ws_conn(nc2);
+}
@@ -7,9 +7,11 @@
 #include "utility.h"
 
 #include "dist/libmympdclient/src/isong.h"
+#include "src/lib/cache_rax_album.h"
 #include "src/lib/filehandler.h"
 #include "src/mpd_client/tags.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,6 +21,7 @@ void init_testenv(void) {
     mkdir("/tmp/mympd-test", 0770);
     mkdir("/tmp/mympd-test/state", 0770);
     mkdir("/tmp/mympd-test/state/default", 0770);
+    mkdir("/tmp/mympd-test/tags", 0770);
     mkdir("/tmp/mympd-test/webradios", 0770);
     unsetenv("TESTVAR");
 }
@@ -76,3 +79,43 @@ struct mpd_song *new_song(void) {
 
     return song;
 }
+
+/**
+ * Creates a synthetic album for benchmarks.
+ * The tag values are derived from the album number.
+ * @param nr album number
+ * @return the album
+ */
+struct mpd_song *new_album(unsigned nr) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "/music/artist %u/album %u/01.mp3", nr % 5000, nr);
+    struct mpd_song *album = mpd_song_new(buf);
+    snprintf(buf, sizeof(buf), "Artist %u", nr % 5000);
+    mympd_mpd_song_add_tag_dedup(album, MPD_TAG_ALBUM_ARTIST, buf);
+    mympd_mpd_song_add_tag_dedup(album, MPD_TAG_ARTIST, buf);
+    snprintf(buf, sizeof(buf), "Album %u", nr);
+    mympd_mpd_song_add_tag_dedup(album, MPD_TAG_ALBUM, buf);
+    snprintf(buf, sizeof(buf), "Genre %u", nr % 50);
+    mympd_mpd_song_add_tag_dedup(album, MPD_TAG_GENRE, buf);
+    snprintf(buf, sizeof(buf), "%u", 1950 + nr % 75);
+    mympd_mpd_song_add_tag_dedup(album, MPD_TAG_DATE, buf);
+    album->duration = 3600;
+    album->duration_ms = 3600000;
+    album->last_modified = 1699304451 + (time_t)nr;
+    album->added = 1699304451 + (time_t)nr;
+    album_cache_set_song_count(album, 10);
+    album_cache_set_disc_count(album, 1);
+    return album;
+}
+
+/**
+ * Prints the result of a benchmark
+ * @param name name of the benchmark
+ * @param tic start time
+ * @param toc end time
+ * @param count number of processed items
+ */
+void bench_print(const char *name, const struct timespec *tic, const struct timespec *toc, unsigned count) {
+    int64_t usec = (int64_t)(toc->tv_sec - tic->tv_sec) * 1000000 + (toc->tv_nsec - tic->tv_nsec) / 1000;
+    printf("%-40s %10" PRId64 " us %10.1f ns/item\n", name, usec, count > 0 ? (double)usec * 1000 / count : 0);
+}